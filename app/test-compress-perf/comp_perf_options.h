@@ -12,6 +12,7 @@
 #define EXPANSE_RATIO 1.1
 #define MAX_MBUF_DATA_SIZE (UINT16_MAX - RTE_PKTMBUF_HEADROOM)
 #define MAX_SEG_SIZE ((int)(MAX_MBUF_DATA_SIZE / EXPANSE_RATIO))
+#define MAX_QUEUE_DEPTH 512
 
 extern const char *comp_perf_test_type_strs[];
 
@@ -28,7 +29,8 @@ enum cleanup_st {
 enum cperf_test_type {
 	CPERF_TEST_TYPE_THROUGHPUT,
 	CPERF_TEST_TYPE_VERIFY,
-	CPERF_TEST_TYPE_PMDCC
+	CPERF_TEST_TYPE_PMDCC,
+	CPERF_TEST_TYPE_BLOCK
 };
 
 enum comp_operation {
@@ -45,13 +47,23 @@ struct range_list {
 	uint8_t list[MAX_LIST];
 };
 
+/* Block of a storage workload, compressed by one operation */
+struct cperf_block {
+	uint32_t size;
+	/* Filled with random data instead of input data */
+	uint8_t incompressible;
+};
+
 struct comp_test_data {
 	char driver_name[RTE_DEV_NAME_MAX_LEN];
 	char input_file[PATH_MAX];
+	char dict_file[PATH_MAX];
 	enum cperf_test_type test;
 
 	uint8_t *input_data;
 	size_t input_data_sz;
+	uint8_t *dict;
+	size_t dict_sz;
 	uint16_t nb_qps;
 	uint16_t seg_sz;
 	uint16_t out_seg_sz;
@@ -65,6 +77,7 @@ struct comp_test_data {
 	enum rte_comp_huffman huffman_enc;
 	enum comp_operation test_op;
 	enum rte_comp_algorithm test_algo;
+	enum rte_comp_checksum_type chksum;
 
 	int window_sz;
 	struct range_list level_lst;
@@ -76,6 +89,13 @@ struct comp_test_data {
 	int perf_comp_force_stop;
 
 	uint32_t cyclecount_delay;
+
+	/* block-trace-specific */
+	char block_trace[PATH_MAX];
+	struct cperf_block *blocks;
+	uint32_t nb_blocks;
+	uint8_t incompressible_pct;
+	uint16_t queue_depth;
 };
 
 int
@@ -28,6 +28,8 @@
 #define CPERF_ALGO		("algo")
 #define CPERF_HUFFMAN_ENC	("huffman-enc")
 #define CPERF_LZ4_FLAGS		("lz4-flags")
+#define CPERF_CHECKSUM		("checksum")
+#define CPERF_DICT_FILE		("dict-file")
 #define CPERF_LEVEL		("compress-level")
 #define CPERF_WINDOW_SIZE	("window-sz")
 #define CPERF_EXTERNAL_MBUFS	("external-mbufs")
@@ -35,6 +37,11 @@
 /* cyclecount-specific options */
 #define CPERF_CYCLECOUNT_DELAY_US ("cc-delay-us")
 
+/* block-trace-specific options */
+#define CPERF_BLOCK_TRACE	("block-trace")
+#define CPERF_INCOMPRESSIBLE	("incompressible-pct")
+#define CPERF_QUEUE_DEPTH	("queue-depth")
+
 struct name_id_map {
 	const char *name;
 	uint32_t id;
@@ -44,9 +51,9 @@ static void
 usage(char *progname)
 {
 	printf("%s [EAL options] --\n"
-		" --ptest throughput / verify / pmd-cyclecount\n"
+		" --ptest throughput / verify / pmd-cyclecount / block-trace\n"
 		" --driver-name NAME: compress driver to use\n"
-		" --input-file NAME: file to compress and decompress\n"
+		" --input-file NAME: file or directory of files to compress and decompress\n"
 		" --extended-input-sz N: extend file data up to this size (default: no extension)\n"
 		" --seg-sz N: size of segment to store the data (default: 2048)\n"
 		" --burst-sz N: compress operation burst size\n"
@@ -58,11 +65,14 @@ usage(char *progname)
 		"		compressed/decompressed (default: 10000)\n"
 		" --operation [comp/decomp/comp_and_decomp]: perform test on\n"
 		"		compression, decompression or both operations\n"
-		" --algo [null/deflate/lzs/lz4]: perform test on algorithm\n"
-		"		null(DMA), deflate, lzs or lz4 (default: deflate)\n"
+		" --algo [null/deflate/lzs/lz4/zstd]: perform test on algorithm\n"
+		"		null(DMA), deflate, lzs, lz4 or zstd (default: deflate)\n"
 		" --huffman-enc [fixed/dynamic/default]: Huffman encoding\n"
 		"		(default: dynamic)\n"
 		" --lz4-flags N: flags to configure LZ4 algorithm (default: 0)\n"
+		" --checksum [none/crc32/adler32/crc32-adler32/xxhash32]:\n"
+		"		checksum generated on the uncompressed data (default: none)\n"
+		" --dict-file NAME: pre-trained dictionary for zstd algorithm\n"
 		" --compress-level N: compression level, which could be a single value, list or range\n"
 		"		(default: range between 1 and 9)\n"
 		" --window-sz N: base two log value of compression window size\n"
@@ -71,6 +81,12 @@ usage(char *progname)
 		"		keeping the data directly in mbuf area\n"
 		" --cc-delay-us N: delay between enqueue and dequeue operations in microseconds\n"
 		"		valid only for cyclecount perf test (default: 500 us)\n"
+		" --block-trace NAME: file giving the size of each block, one per line,\n"
+		"		valid only for block-trace perf test (default: segments of seg-sz)\n"
+		" --incompressible-pct N: percentage of blocks filled with random data,\n"
+		"		valid only for block-trace perf test (default: 0)\n"
+		" --queue-depth N: maximum number of operations in flight,\n"
+		"		valid only for block-trace perf test (default: 32)\n"
 		" -h: prints this help\n",
 		progname);
 }
@@ -105,6 +121,10 @@ parse_cperf_test_type(struct comp_test_data *test_data, const char *arg)
 		{
 			comp_perf_test_type_strs[CPERF_TEST_TYPE_PMDCC],
 			CPERF_TEST_TYPE_PMDCC
+		},
+		{
+			comp_perf_test_type_strs[CPERF_TEST_TYPE_BLOCK],
+			CPERF_TEST_TYPE_BLOCK
 		}
 	};
 
@@ -462,6 +482,17 @@ parse_test_file(struct comp_test_data *test_data, const char *arg)
 	return 0;
 }
 
+static int
+parse_dict_file(struct comp_test_data *test_data, const char *arg)
+{
+	if (strlen(arg) > (sizeof(test_data->dict_file) - 1))
+		return -1;
+
+	strlcpy(test_data->dict_file, arg, sizeof(test_data->dict_file));
+
+	return 0;
+}
+
 static int
 parse_op_type(struct comp_test_data *test_data, const char *arg)
 {
@@ -511,6 +542,10 @@ parse_algo(struct comp_test_data *test_data, const char *arg)
 		{
 			"lz4",
 			RTE_COMP_ALGO_LZ4
+		},
+		{
+			"zstd",
+			RTE_COMP_ALGO_ZSTD
 		}
 	};
 
@@ -569,6 +604,44 @@ parse_lz4_flags(struct comp_test_data *test_data, const char *arg)
 	return 0;
 }
 
+static int
+parse_checksum(struct comp_test_data *test_data, const char *arg)
+{
+	struct name_id_map chksum_namemap[] = {
+		{
+			"none",
+			RTE_COMP_CHECKSUM_NONE
+		},
+		{
+			"crc32",
+			RTE_COMP_CHECKSUM_CRC32
+		},
+		{
+			"adler32",
+			RTE_COMP_CHECKSUM_ADLER32
+		},
+		{
+			"crc32-adler32",
+			RTE_COMP_CHECKSUM_CRC32_ADLER32
+		},
+		{
+			"xxhash32",
+			RTE_COMP_CHECKSUM_XXHASH32
+		}
+	};
+
+	int id = get_str_key_id_mapping(chksum_namemap,
+			RTE_DIM(chksum_namemap), arg);
+	if (id < 0) {
+		RTE_LOG(ERR, USER1, "Invalid checksum type specified\n");
+		return -1;
+	}
+
+	test_data->chksum = (enum rte_comp_checksum_type)id;
+
+	return 0;
+}
+
 static int
 parse_level(struct comp_test_data *test_data, const char *arg)
 {
@@ -622,6 +695,48 @@ parse_cyclecount_delay_us(struct comp_test_data *test_data,
 	return 0;
 }
 
+static int
+parse_block_trace(struct comp_test_data *test_data, const char *arg)
+{
+	if (strlen(arg) > (sizeof(test_data->block_trace) - 1))
+		return -1;
+
+	strlcpy(test_data->block_trace, arg, sizeof(test_data->block_trace));
+
+	return 0;
+}
+
+static int
+parse_incompressible_pct(struct comp_test_data *test_data, const char *arg)
+{
+	int ret = parse_uint8_t(&test_data->incompressible_pct, arg);
+
+	if (ret || test_data->incompressible_pct > 100) {
+		RTE_LOG(ERR, USER1,
+			"Failed to parse percentage of incompressible blocks\n");
+		return -1;
+	}
+	return 0;
+}
+
+static int
+parse_queue_depth(struct comp_test_data *test_data, const char *arg)
+{
+	int ret = parse_uint16_t(&test_data->queue_depth, arg);
+
+	if (ret) {
+		RTE_LOG(ERR, USER1, "Failed to parse queue depth\n");
+		return -1;
+	}
+	if (test_data->queue_depth == 0 ||
+			test_data->queue_depth > MAX_QUEUE_DEPTH) {
+		RTE_LOG(ERR, USER1, "Queue depth must be between 1 and %u\n",
+			MAX_QUEUE_DEPTH);
+		return -1;
+	}
+	return 0;
+}
+
 typedef int (*option_parser_t)(struct comp_test_data *test_data,
 		const char *arg);
 
@@ -644,10 +759,15 @@ static struct option lgopts[] = {
 	{ CPERF_ALGO, required_argument, 0, 0 },
 	{ CPERF_HUFFMAN_ENC, required_argument, 0, 0 },
 	{ CPERF_LZ4_FLAGS, required_argument, 0, 0 },
+	{ CPERF_CHECKSUM, required_argument, 0, 0 },
+	{ CPERF_DICT_FILE, required_argument, 0, 0 },
 	{ CPERF_LEVEL, required_argument, 0, 0 },
 	{ CPERF_WINDOW_SIZE, required_argument, 0, 0 },
 	{ CPERF_EXTERNAL_MBUFS, 0, 0, 0 },
 	{ CPERF_CYCLECOUNT_DELAY_US, required_argument, 0, 0 },
+	{ CPERF_BLOCK_TRACE, required_argument, 0, 0 },
+	{ CPERF_INCOMPRESSIBLE, required_argument, 0, 0 },
+	{ CPERF_QUEUE_DEPTH, required_argument, 0, 0 },
 	{ NULL, 0, 0, 0 }
 };
 
@@ -668,10 +788,15 @@ comp_perf_opts_parse_long(int opt_idx, struct comp_test_data *test_data)
 		{ CPERF_ALGO,		parse_algo },
 		{ CPERF_HUFFMAN_ENC,	parse_huffman_enc },
 		{ CPERF_LZ4_FLAGS,	parse_lz4_flags },
+		{ CPERF_CHECKSUM,	parse_checksum },
+		{ CPERF_DICT_FILE,	parse_dict_file },
 		{ CPERF_LEVEL,		parse_level },
 		{ CPERF_WINDOW_SIZE,	parse_window_sz },
 		{ CPERF_EXTERNAL_MBUFS,	parse_external_mbufs },
 		{ CPERF_CYCLECOUNT_DELAY_US,	parse_cyclecount_delay_us },
+		{ CPERF_BLOCK_TRACE,	parse_block_trace },
+		{ CPERF_INCOMPRESSIBLE,	parse_incompressible_pct },
+		{ CPERF_QUEUE_DEPTH,	parse_queue_depth },
 	};
 	unsigned int i;
 
@@ -724,6 +849,7 @@ comp_perf_options_default(struct comp_test_data *test_data)
 	test_data->huffman_enc = RTE_COMP_HUFFMAN_DYNAMIC;
 	test_data->test_op = COMPRESS_DECOMPRESS;
 	test_data->test_algo = RTE_COMP_ALGO_DEFLATE;
+	test_data->chksum = RTE_COMP_CHECKSUM_NONE;
 	test_data->window_sz = -1;
 	test_data->level_lst.min = RTE_COMP_LEVEL_MIN;
 	test_data->level_lst.max = RTE_COMP_LEVEL_MAX;
@@ -731,6 +857,7 @@ comp_perf_options_default(struct comp_test_data *test_data)
 	test_data->test = CPERF_TEST_TYPE_THROUGHPUT;
 	test_data->use_external_mbufs = 0;
 	test_data->cyclecount_delay = 500;
+	test_data->queue_depth = 32;
 }
 
 int
@@ -746,5 +873,24 @@ comp_perf_options_check(struct comp_test_data *test_data)
 		return -1;
 	}
 
+	if (test_data->dict_file[0] != '\0' &&
+			test_data->test_algo != RTE_COMP_ALGO_ZSTD) {
+		RTE_LOG(ERR, USER1, "Dictionary is only supported with zstd\n");
+		return -1;
+	}
+
+	if (test_data->test == CPERF_TEST_TYPE_BLOCK &&
+			!(test_data->test_op & COMPRESS)) {
+		RTE_LOG(ERR, USER1, "Block trace test needs compression\n");
+		return -1;
+	}
+
+	if (test_data->block_trace[0] != '\0' &&
+			test_data->test != CPERF_TEST_TYPE_BLOCK) {
+		RTE_LOG(ERR, USER1,
+			"Block trace is only supported with block-trace test\n");
+		return -1;
+	}
+
 	return 0;
 }
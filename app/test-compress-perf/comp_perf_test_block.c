@@ -0,0 +1,774 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_compressdev.h>
+#include <rte_cycles.h>
+#include <rte_eal.h>
+#include <rte_log.h>
+#include <rte_malloc.h>
+#include <rte_spinlock.h>
+
+#include "comp_perf_test_block.h"
+
+/* Room for the format overhead of tiny incompressible blocks */
+#define BLOCK_OUT_OVERHEAD	64
+/* Most latency samples kept per direction */
+#define BLOCK_MAX_SAMPLES	(1 << 20)
+/* Block kind not given by the trace */
+#define BLOCK_KIND_UNSET	UINT8_MAX
+
+enum block_ratio_bucket {
+	BLOCK_RATIO_25,
+	BLOCK_RATIO_50,
+	BLOCK_RATIO_75,
+	BLOCK_RATIO_100,
+	BLOCK_RATIO_EXPANDED,
+	BLOCK_RATIO_MAX
+};
+
+/* User data following each operation */
+struct block_op_priv {
+	uint64_t tsc;
+	uint32_t block_id;
+};
+
+struct block_stats {
+	double gbps;
+	double mops;
+	double mean_us;
+	double p50_us;
+	double p90_us;
+	double p99_us;
+	double p999_us;
+};
+
+static inline struct block_op_priv *
+block_op_priv(struct rte_comp_op *op)
+{
+	return (struct block_op_priv *)(op + 1);
+}
+
+static int
+block_trace_parse(struct comp_test_data *test_data)
+{
+	struct cperf_block *blocks = NULL, *tmp;
+	uint32_t nb_blocks = 0, max_blocks = 0, line_nb = 0;
+	char *line = NULL, *p, *end;
+	size_t line_sz = 0;
+	unsigned long size;
+	uint8_t kind;
+	int ret = -1;
+	FILE *f;
+
+	f = fopen(test_data->block_trace, "r");
+	if (f == NULL) {
+		RTE_LOG(ERR, USER1, "Block trace file could not be opened\n");
+		return -1;
+	}
+
+	while (getline(&line, &line_sz, f) > 0) {
+		line_nb++;
+		p = line + strspn(line, " \t");
+		if (*p == '#' || *p == '\n' || *p == '\r' || *p == '\0')
+			continue;
+
+		errno = 0;
+		size = strtoul(p, &end, 0);
+		if (end == p || errno != 0 || size == 0 ||
+				size > (unsigned long)MAX_SEG_SIZE) {
+			RTE_LOG(ERR, USER1,
+				"Line %u: block size must be between 1 and %d\n",
+				line_nb, MAX_SEG_SIZE);
+			goto end;
+		}
+
+		p = end + strspn(end, " \t");
+		switch (*p) {
+		case 'c':
+			kind = 0;
+			break;
+		case 'i':
+			kind = 1;
+			break;
+		case '#':
+		case '\n':
+		case '\r':
+		case '\0':
+			kind = BLOCK_KIND_UNSET;
+			break;
+		default:
+			RTE_LOG(ERR, USER1,
+				"Line %u: block kind must be 'c' or 'i'\n",
+				line_nb);
+			goto end;
+		}
+
+		if (nb_blocks == max_blocks) {
+			max_blocks = max_blocks ? max_blocks * 2 : 1024;
+			tmp = rte_realloc(blocks, max_blocks * sizeof(*blocks),
+					0);
+			if (tmp == NULL) {
+				RTE_LOG(ERR, USER1,
+					"Memory to hold the block trace could not be allocated\n");
+				goto end;
+			}
+			blocks = tmp;
+		}
+		blocks[nb_blocks].size = size;
+		blocks[nb_blocks].incompressible = kind;
+		nb_blocks++;
+	}
+
+	if (nb_blocks == 0) {
+		RTE_LOG(ERR, USER1, "Block trace file has no block\n");
+		goto end;
+	}
+
+	test_data->blocks = blocks;
+	test_data->nb_blocks = nb_blocks;
+	blocks = NULL;
+	ret = 0;
+
+end:
+	rte_free(blocks);
+	free(line);
+	fclose(f);
+	return ret;
+}
+
+int
+cperf_block_trace_load(struct comp_test_data *test_data)
+{
+	size_t remaining = test_data->input_data_sz;
+	uint32_t i, nb_unset = 0, nb_incompressible = 0;
+	struct cperf_block *block;
+
+	if (test_data->block_trace[0] != '\0') {
+		if (block_trace_parse(test_data) < 0)
+			return -1;
+	} else {
+		if (test_data->seg_sz > MAX_SEG_SIZE) {
+			RTE_LOG(ERR, USER1,
+				"Block size must be at most %d\n",
+				MAX_SEG_SIZE);
+			return -1;
+		}
+		/* Split the input data in blocks of the segment size */
+		test_data->nb_blocks = (remaining + test_data->seg_sz - 1) /
+				test_data->seg_sz;
+		test_data->blocks = rte_zmalloc(NULL,
+				test_data->nb_blocks * sizeof(*block), 0);
+		if (test_data->blocks == NULL) {
+			RTE_LOG(ERR, USER1,
+				"Memory to hold the blocks could not be allocated\n");
+			return -1;
+		}
+		for (i = 0; i < test_data->nb_blocks; i++) {
+			block = &test_data->blocks[i];
+			block->size = RTE_MIN(remaining,
+					(size_t)test_data->seg_sz);
+			block->incompressible = BLOCK_KIND_UNSET;
+			remaining -= block->size;
+		}
+	}
+
+	/*
+	 * Spread the requested share of incompressible blocks evenly over
+	 * the blocks of unspecified kind, so that every run and every
+	 * driver sees the same workload.
+	 */
+	for (i = 0; i < test_data->nb_blocks; i++) {
+		block = &test_data->blocks[i];
+		if (block->incompressible == BLOCK_KIND_UNSET) {
+			block->incompressible =
+				(nb_unset + 1) * test_data->incompressible_pct / 100 !=
+				nb_unset * test_data->incompressible_pct / 100;
+			nb_unset++;
+		}
+		nb_incompressible += block->incompressible;
+	}
+
+	RTE_LOG(INFO, USER1, "%u blocks, %u of them incompressible\n",
+		test_data->nb_blocks, nb_incompressible);
+
+	return 0;
+}
+
+/* Fill a block with data from the input, wrapping around at its end */
+static void
+block_fill_input(struct comp_test_data *test_data, uint8_t *data,
+		uint32_t size, size_t *offset)
+{
+	size_t chunk;
+
+	while (size > 0) {
+		chunk = RTE_MIN((size_t)size,
+				test_data->input_data_sz - *offset);
+		memcpy(data, test_data->input_data + *offset, chunk);
+		data += chunk;
+		size -= chunk;
+		*offset += chunk;
+		if (*offset == test_data->input_data_sz)
+			*offset = 0;
+	}
+}
+
+/* Fill a block with pseudo-random data, the same on every run */
+static void
+block_fill_random(uint8_t *data, uint32_t size, uint32_t block_id)
+{
+	uint64_t x = (block_id + 1) * UINT64_C(0x9E3779B97F4A7C15);
+	uint32_t i;
+
+	for (i = 0; i < size; i += sizeof(x)) {
+		x ^= x << 13;
+		x ^= x >> 7;
+		x ^= x << 17;
+		memcpy(&data[i], &x, RTE_MIN((uint32_t)sizeof(x), size - i));
+	}
+}
+
+void
+cperf_block_test_destructor(void *arg)
+{
+	struct cperf_block_ctx *ctx = arg;
+	uint32_t i;
+
+	if (ctx == NULL)
+		return;
+
+	for (i = 0; i < ctx->options->nb_blocks; i++) {
+		if (ctx->src_bufs != NULL)
+			rte_pktmbuf_free(ctx->src_bufs[i]);
+		if (ctx->comp_bufs != NULL)
+			rte_pktmbuf_free(ctx->comp_bufs[i]);
+		if (ctx->decomp_bufs != NULL)
+			rte_pktmbuf_free(ctx->decomp_bufs[i]);
+	}
+
+	rte_free(ctx->src_bufs);
+	rte_free(ctx->comp_bufs);
+	rte_free(ctx->decomp_bufs);
+	rte_free(ctx->comp_sz);
+	rte_free(ctx->lat);
+	rte_mempool_free(ctx->op_pool);
+	rte_mempool_free(ctx->decomp_pool);
+	rte_mempool_free(ctx->comp_pool);
+	rte_mempool_free(ctx->src_pool);
+	rte_free(ctx);
+}
+
+static int
+block_allocate_memory(struct cperf_block_ctx *ctx)
+{
+	struct comp_test_data *test_data = ctx->options;
+	uint32_t nb_blocks = test_data->nb_blocks;
+	uint32_t i, max_size = 0;
+	char pool_name[32];
+
+	for (i = 0; i < nb_blocks; i++)
+		max_size = RTE_MAX(max_size, test_data->blocks[i].size);
+
+	ctx->out_sz = RTE_MIN((uint32_t)(max_size * EXPANSE_RATIO) +
+			BLOCK_OUT_OVERHEAD, (uint32_t)MAX_MBUF_DATA_SIZE);
+
+	snprintf(pool_name, sizeof(pool_name), "blk_src_pool_%u_qp_%u",
+			ctx->dev_id, ctx->qp_id);
+	ctx->src_pool = rte_pktmbuf_pool_create(pool_name, nb_blocks, 0, 0,
+			max_size + RTE_PKTMBUF_HEADROOM, rte_socket_id());
+
+	snprintf(pool_name, sizeof(pool_name), "blk_comp_pool_%u_qp_%u",
+			ctx->dev_id, ctx->qp_id);
+	ctx->comp_pool = rte_pktmbuf_pool_create(pool_name, nb_blocks, 0, 0,
+			ctx->out_sz + RTE_PKTMBUF_HEADROOM, rte_socket_id());
+
+	snprintf(pool_name, sizeof(pool_name), "blk_decomp_pool_%u_qp_%u",
+			ctx->dev_id, ctx->qp_id);
+	ctx->decomp_pool = rte_pktmbuf_pool_create(pool_name, nb_blocks, 0, 0,
+			max_size + RTE_PKTMBUF_HEADROOM, rte_socket_id());
+
+	if (ctx->src_pool == NULL || ctx->comp_pool == NULL ||
+			ctx->decomp_pool == NULL) {
+		RTE_LOG(ERR, USER1, "Mbuf mempool could not be created\n");
+		return -1;
+	}
+
+	/* In flight, plus the ones waiting to be accepted by the device */
+	snprintf(pool_name, sizeof(pool_name), "blk_op_pool_%u_qp_%u",
+			ctx->dev_id, ctx->qp_id);
+	ctx->op_pool = rte_comp_op_pool_create(pool_name,
+			test_data->queue_depth + 2 * test_data->burst_sz, 0,
+			sizeof(struct block_op_priv), rte_socket_id());
+	if (ctx->op_pool == NULL) {
+		RTE_LOG(ERR, USER1, "Comp op mempool could not be created\n");
+		return -1;
+	}
+
+	ctx->src_bufs = rte_zmalloc_socket(NULL,
+			nb_blocks * sizeof(struct rte_mbuf *), 0,
+			rte_socket_id());
+	ctx->comp_bufs = rte_zmalloc_socket(NULL,
+			nb_blocks * sizeof(struct rte_mbuf *), 0,
+			rte_socket_id());
+	ctx->decomp_bufs = rte_zmalloc_socket(NULL,
+			nb_blocks * sizeof(struct rte_mbuf *), 0,
+			rte_socket_id());
+	ctx->comp_sz = rte_zmalloc_socket(NULL,
+			nb_blocks * sizeof(uint32_t), 0, rte_socket_id());
+
+	/* Keep the samples of as many last iterations as the limit allows */
+	ctx->rec_iters = RTE_MAX(1U, RTE_MIN(test_data->num_iter,
+			BLOCK_MAX_SAMPLES / nb_blocks));
+	ctx->lat = rte_malloc_socket(NULL,
+			(size_t)nb_blocks * ctx->rec_iters * sizeof(uint64_t),
+			0, rte_socket_id());
+
+	if (ctx->src_bufs == NULL || ctx->comp_bufs == NULL ||
+			ctx->decomp_bufs == NULL || ctx->comp_sz == NULL ||
+			ctx->lat == NULL) {
+		RTE_LOG(ERR, USER1,
+			"Memory to hold the blocks could not be allocated\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+block_prepare_bufs(struct cperf_block_ctx *ctx)
+{
+	struct comp_test_data *test_data = ctx->options;
+	struct cperf_block *block;
+	size_t offset = 0;
+	uint8_t *data;
+	uint32_t i;
+
+	for (i = 0; i < test_data->nb_blocks; i++) {
+		block = &test_data->blocks[i];
+
+		ctx->src_bufs[i] = rte_pktmbuf_alloc(ctx->src_pool);
+		ctx->comp_bufs[i] = rte_pktmbuf_alloc(ctx->comp_pool);
+		ctx->decomp_bufs[i] = rte_pktmbuf_alloc(ctx->decomp_pool);
+		if (ctx->src_bufs[i] == NULL || ctx->comp_bufs[i] == NULL ||
+				ctx->decomp_bufs[i] == NULL) {
+			RTE_LOG(ERR, USER1, "Could not allocate mbuf\n");
+			return -1;
+		}
+
+		data = (uint8_t *)rte_pktmbuf_append(ctx->src_bufs[i],
+				block->size);
+		if (data == NULL) {
+			RTE_LOG(ERR, USER1, "Could not append data\n");
+			return -1;
+		}
+
+		if (block->incompressible)
+			block_fill_random(data, block->size, i);
+		else
+			block_fill_input(test_data, data, block->size,
+					&offset);
+	}
+
+	return 0;
+}
+
+void *
+cperf_block_test_constructor(uint8_t dev_id, uint16_t qp_id,
+		struct comp_test_data *options)
+{
+	struct cperf_block_ctx *ctx;
+
+	ctx = rte_zmalloc(NULL, sizeof(struct cperf_block_ctx), 0);
+	if (ctx == NULL)
+		return NULL;
+
+	ctx->dev_id = dev_id;
+	ctx->qp_id = qp_id;
+	ctx->options = options;
+
+	if (!block_allocate_memory(ctx) && !block_prepare_bufs(ctx))
+		return ctx;
+
+	cperf_block_test_destructor(ctx);
+	return NULL;
+}
+
+static void
+block_op_setup(struct cperf_block_ctx *ctx, struct rte_comp_op *op,
+		enum rte_comp_xform_type type, uint32_t block_id,
+		void *priv_xform)
+{
+	struct rte_mbuf *src, *dst;
+
+	if (type == RTE_COMP_COMPRESS) {
+		src = ctx->src_bufs[block_id];
+		dst = ctx->comp_bufs[block_id];
+	} else {
+		src = ctx->comp_bufs[block_id];
+		dst = ctx->decomp_bufs[block_id];
+	}
+
+	/* Give the whole output buffer to the device */
+	dst->data_len = dst->buf_len - dst->data_off;
+	dst->pkt_len = dst->data_len;
+
+	op->m_src = src;
+	op->m_dst = dst;
+	op->src.offset = 0;
+	op->src.length = rte_pktmbuf_pkt_len(src);
+	op->dst.offset = 0;
+	op->flush_flag = RTE_COMP_FLUSH_FINAL;
+	op->input_chksum = block_id;
+	op->private_xform = priv_xform;
+	block_op_priv(op)->block_id = block_id;
+}
+
+/*
+ * Run all the blocks through the device num_iter times, keeping at most
+ * queue_depth operations in flight: a new block is only submitted when
+ * a previous one completed, as a storage stack would do.
+ */
+static int
+block_phase(struct cperf_block_ctx *ctx, enum rte_comp_xform_type type,
+		uint64_t *duration)
+{
+	struct comp_test_data *test_data = ctx->options;
+	uint32_t nb_blocks = test_data->nb_blocks;
+	uint16_t queue_depth = test_data->queue_depth;
+	uint16_t burst_sz = test_data->burst_sz;
+	uint32_t first_rec_iter = test_data->num_iter - ctx->rec_iters;
+	struct rte_comp_op **ops, **deq_ops;
+	struct rte_comp_xform xform;
+	void *priv_xform = NULL;
+	uint16_t nb_pending = 0;
+	uint64_t *lat = NULL;
+	uint32_t iter, i;
+	int res = 0;
+
+	ops = rte_zmalloc_socket(NULL,
+		2 * burst_sz * sizeof(struct rte_comp_op *),
+		0, rte_socket_id());
+	if (ops == NULL) {
+		RTE_LOG(ERR, USER1,
+			"Can't allocate memory for ops structures\n");
+		return -1;
+	}
+	deq_ops = &ops[burst_sz];
+
+	if (type == RTE_COMP_COMPRESS) {
+		xform = (struct rte_comp_xform) {
+			.type = RTE_COMP_COMPRESS,
+			.compress = {
+				.algo = test_data->test_algo,
+				.level = test_data->level,
+				.window_size = test_data->window_sz,
+				.chksum = test_data->chksum,
+				.hash_algo = RTE_COMP_HASH_ALGO_NONE,
+				.zstd = {
+					.dict = test_data->dict,
+					.dict_len = test_data->dict_sz
+				}
+			}
+		};
+		if (test_data->test_algo == RTE_COMP_ALGO_DEFLATE)
+			xform.compress.deflate.huffman = test_data->huffman_enc;
+		else if (test_data->test_algo == RTE_COMP_ALGO_LZ4)
+			xform.compress.lz4.flags = test_data->lz4_flags;
+	} else {
+		xform = (struct rte_comp_xform) {
+			.type = RTE_COMP_DECOMPRESS,
+			.decompress = {
+				.algo = test_data->test_algo,
+				.chksum = test_data->chksum,
+				.window_size = test_data->window_sz,
+				.hash_algo = RTE_COMP_HASH_ALGO_NONE,
+				.zstd = {
+					.dict = test_data->dict,
+					.dict_len = test_data->dict_sz
+				}
+			}
+		};
+		if (test_data->test_algo == RTE_COMP_ALGO_LZ4)
+			xform.decompress.lz4.flags = test_data->lz4_flags;
+	}
+
+	if (rte_compressdev_private_xform_create(ctx->dev_id, &xform,
+			&priv_xform) < 0) {
+		RTE_LOG(ERR, USER1, "Private xform could not be created\n");
+		res = -1;
+		goto end;
+	}
+
+	*duration = 0;
+
+	for (iter = 0; iter < test_data->num_iter; iter++) {
+		uint32_t next_block = 0;
+		uint32_t nb_done = 0;
+		uint16_t inflight = 0;
+		uint64_t tsc_start, now;
+
+		if (iter >= first_rec_iter)
+			lat = &ctx->lat[(size_t)(iter - first_rec_iter) *
+					nb_blocks];
+		else
+			lat = NULL;
+
+		tsc_start = rte_rdtsc_precise();
+
+		while (nb_done < nb_blocks) {
+			uint16_t room = RTE_MIN(queue_depth - inflight,
+					burst_sz);
+			uint16_t nb_new, nb_enq, nb_deq;
+
+			if (unlikely(test_data->perf_comp_force_stop))
+				goto end;
+
+			/* Top up the operations waiting to be submitted */
+			if (room > nb_pending && next_block < nb_blocks) {
+				nb_new = RTE_MIN((uint32_t)(room - nb_pending),
+						nb_blocks - next_block);
+				if (!rte_comp_op_bulk_alloc(ctx->op_pool,
+						&ops[nb_pending], nb_new)) {
+					RTE_LOG(ERR, USER1,
+						"Could not allocate enough operations\n");
+					res = -1;
+					goto end;
+				}
+				for (i = 0; i < nb_new; i++)
+					block_op_setup(ctx, ops[nb_pending + i],
+						type, next_block + i,
+						priv_xform);
+				nb_pending += nb_new;
+				next_block += nb_new;
+			}
+
+			if (nb_pending > 0 && room > 0) {
+				uint16_t nb_ops = RTE_MIN(nb_pending, room);
+
+				now = rte_rdtsc();
+				for (i = 0; i < nb_ops; i++)
+					block_op_priv(ops[i])->tsc = now;
+
+				nb_enq = rte_compressdev_enqueue_burst(
+						ctx->dev_id, ctx->qp_id,
+						ops, nb_ops);
+				if (nb_enq == 0) {
+					struct rte_compressdev_stats stats;
+
+					rte_compressdev_stats_get(ctx->dev_id,
+							&stats);
+					if (stats.enqueue_err_count) {
+						res = -1;
+						goto end;
+					}
+				}
+
+				nb_pending -= nb_enq;
+				memmove(ops, &ops[nb_enq],
+					nb_pending * sizeof(struct rte_comp_op *));
+				inflight += nb_enq;
+			}
+
+			nb_deq = rte_compressdev_dequeue_burst(ctx->dev_id,
+					ctx->qp_id, deq_ops, burst_sz);
+			if (nb_deq == 0)
+				continue;
+
+			now = rte_rdtsc();
+			for (i = 0; i < nb_deq; i++) {
+				struct rte_comp_op *op = deq_ops[i];
+				uint32_t block_id = block_op_priv(op)->block_id;
+
+				if (op->status ==
+				    RTE_COMP_OP_STATUS_OUT_OF_SPACE_TERMINATED ||
+				    op->status ==
+				    RTE_COMP_OP_STATUS_OUT_OF_SPACE_RECOVERABLE) {
+					RTE_LOG(ERR, USER1,
+						"Out of space error occurred on block %u\n",
+						block_id);
+					res = -1;
+				} else if (op->status !=
+						RTE_COMP_OP_STATUS_SUCCESS) {
+					RTE_LOG(ERR, USER1,
+						"Operation on block %u was not successful\n",
+						block_id);
+					res = -1;
+				} else if (type == RTE_COMP_COMPRESS) {
+					/* Output is the next phase input */
+					ctx->comp_sz[block_id] = op->produced;
+					op->m_dst->data_len = op->produced;
+					op->m_dst->pkt_len = op->produced;
+				} else if (op->produced !=
+					   test_data->blocks[block_id].size) {
+					RTE_LOG(ERR, USER1,
+						"Decompressed size of block %u is %u, expected %u\n",
+						block_id, op->produced,
+						test_data->blocks[block_id].size);
+					res = -1;
+				}
+
+				if (lat != NULL)
+					lat[nb_done + i] = now -
+						block_op_priv(op)->tsc;
+			}
+
+			rte_mempool_put_bulk(ctx->op_pool, (void **)deq_ops,
+					nb_deq);
+			inflight -= nb_deq;
+			nb_done += nb_deq;
+
+			if (res < 0)
+				goto end;
+		}
+
+		*duration += rte_rdtsc_precise() - tsc_start;
+	}
+
+end:
+	rte_mempool_put_bulk(ctx->op_pool, (void **)ops, nb_pending);
+	rte_compressdev_private_xform_free(ctx->dev_id, priv_xform);
+	rte_free(ops);
+
+	if (test_data->perf_comp_force_stop) {
+		RTE_LOG(ERR, USER1,
+		      "lcore: %u Perf. test has been aborted by user\n",
+			ctx->lcore_id);
+		res = -1;
+	}
+
+	return res;
+}
+
+static int
+block_cmp_lat(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a;
+	uint64_t y = *(const uint64_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+/* Sample of the given rank, in per mille, converted to microseconds */
+static double
+block_percentile_us(const uint64_t *lat, size_t nb, unsigned int per_mille)
+{
+	size_t rank = (nb * per_mille + 999) / 1000;
+
+	return (double)lat[RTE_MAX(rank, (size_t)1) - 1] * 1000000 /
+			rte_get_tsc_hz();
+}
+
+static void
+block_compute_stats(struct cperf_block_ctx *ctx, uint64_t duration,
+		uint64_t bytes, struct block_stats *stats)
+{
+	struct comp_test_data *test_data = ctx->options;
+	size_t nb = (size_t)test_data->nb_blocks * ctx->rec_iters;
+	double seconds = (double)duration / rte_get_tsc_hz();
+	uint64_t sum = 0;
+	size_t i;
+
+	qsort(ctx->lat, nb, sizeof(uint64_t), block_cmp_lat);
+	for (i = 0; i < nb; i++)
+		sum += ctx->lat[i];
+
+	stats->gbps = (double)bytes * test_data->num_iter * 8 / seconds /
+			1000000000;
+	stats->mops = (double)test_data->nb_blocks * test_data->num_iter /
+			seconds / 1000000;
+	stats->mean_us = (double)sum / nb * 1000000 / rte_get_tsc_hz();
+	stats->p50_us = block_percentile_us(ctx->lat, nb, 500);
+	stats->p90_us = block_percentile_us(ctx->lat, nb, 900);
+	stats->p99_us = block_percentile_us(ctx->lat, nb, 990);
+	stats->p999_us = block_percentile_us(ctx->lat, nb, 999);
+}
+
+static void
+block_print_stats(const struct cperf_block_ctx *ctx, const char *op,
+		const struct block_stats *stats)
+{
+	printf("%12u%6u%8s%12.2f%12.3f%12.2f%12.2f%12.2f%12.2f%12.2f\n",
+		ctx->lcore_id, ctx->options->level, op,
+		stats->gbps, stats->mops, stats->mean_us, stats->p50_us,
+		stats->p90_us, stats->p99_us, stats->p999_us);
+}
+
+int
+cperf_block_test_runner(void *test_ctx)
+{
+	static rte_spinlock_t print_lock = RTE_SPINLOCK_INITIALIZER;
+	static int display_once;
+	struct cperf_block_ctx *ctx = test_ctx;
+	struct comp_test_data *test_data = ctx->options;
+	uint32_t ratio_hist[BLOCK_RATIO_MAX] = { 0 };
+	struct block_stats comp_stats, decomp_stats;
+	uint64_t in_bytes = 0, out_bytes = 0;
+	uint64_t duration;
+	uint32_t i, size, bucket;
+
+	ctx->lcore_id = rte_lcore_id();
+
+	if (block_phase(ctx, RTE_COMP_COMPRESS, &duration) < 0)
+		return EXIT_FAILURE;
+
+	for (i = 0; i < test_data->nb_blocks; i++) {
+		size = test_data->blocks[i].size;
+		in_bytes += size;
+		out_bytes += ctx->comp_sz[i];
+		bucket = (uint64_t)ctx->comp_sz[i] * 4 / size;
+		ratio_hist[RTE_MIN(bucket, (uint32_t)BLOCK_RATIO_EXPANDED)]++;
+	}
+	block_compute_stats(ctx, duration, in_bytes, &comp_stats);
+
+	if (test_data->test_op & DECOMPRESS) {
+		if (block_phase(ctx, RTE_COMP_DECOMPRESS, &duration) < 0)
+			return EXIT_FAILURE;
+
+		for (i = 0; i < test_data->nb_blocks; i++) {
+			if (memcmp(rte_pktmbuf_mtod(ctx->decomp_bufs[i],
+					uint8_t *),
+					rte_pktmbuf_mtod(ctx->src_bufs[i],
+					uint8_t *),
+					test_data->blocks[i].size) != 0) {
+				RTE_LOG(ERR, USER1,
+					"Decompressed block %u is not the same as the original\n",
+					i);
+				return EXIT_FAILURE;
+			}
+		}
+		block_compute_stats(ctx, duration, in_bytes, &decomp_stats);
+	}
+
+	rte_spinlock_lock(&print_lock);
+	if (!display_once) {
+		display_once = 1;
+		printf("\nBlock trace on %s: %u blocks, %" PRIu64
+			" bytes, queue depth %u\n",
+			test_data->driver_name, test_data->nb_blocks,
+			in_bytes, test_data->queue_depth);
+		printf("%12s%6s%8s%12s%12s%12s%12s%12s%12s%12s\n",
+			"lcore id", "Level", "Op", "[Gbps]", "[Mops]",
+			"Mean [us]", "p50 [us]", "p90 [us]", "p99 [us]",
+			"p99.9 [us]");
+	}
+	block_print_stats(ctx, "comp", &comp_stats);
+	if (test_data->test_op & DECOMPRESS)
+		block_print_stats(ctx, "decomp", &decomp_stats);
+	printf("%12u%6u    ratio %.2f%%, blocks compressed to"
+		" <25%%: %u, <50%%: %u, <75%%: %u, <100%%: %u, >=100%%: %u\n",
+		ctx->lcore_id, test_data->level,
+		(double)out_bytes * 100 / in_bytes,
+		ratio_hist[BLOCK_RATIO_25], ratio_hist[BLOCK_RATIO_50],
+		ratio_hist[BLOCK_RATIO_75], ratio_hist[BLOCK_RATIO_100],
+		ratio_hist[BLOCK_RATIO_EXPANDED]);
+	rte_spinlock_unlock(&print_lock);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,53 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#ifndef _COMP_PERF_TEST_BLOCK_
+#define _COMP_PERF_TEST_BLOCK_
+
+#include <stdint.h>
+
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+
+#include "comp_perf_options.h"
+
+struct cperf_block_ctx {
+	struct comp_test_data *options;
+	uint8_t dev_id;
+	uint16_t qp_id;
+	uint32_t lcore_id;
+
+	struct rte_mempool *src_pool;
+	struct rte_mempool *comp_pool;
+	struct rte_mempool *decomp_pool;
+	struct rte_mempool *op_pool;
+
+	/* One mbuf of each kind per block */
+	struct rte_mbuf **src_bufs;
+	struct rte_mbuf **comp_bufs;
+	struct rte_mbuf **decomp_bufs;
+	uint16_t out_sz;
+
+	/* Compressed size of each block */
+	uint32_t *comp_sz;
+
+	/* Latency samples of the last iterations, in TSC cycles */
+	uint64_t *lat;
+	uint32_t rec_iters;
+};
+
+int
+cperf_block_trace_load(struct comp_test_data *test_data);
+
+void
+cperf_block_test_destructor(void *arg);
+
+int
+cperf_block_test_runner(void *test_ctx);
+
+void *
+cperf_block_test_constructor(uint8_t dev_id, uint16_t qp_id,
+		struct comp_test_data *options);
+
+#endif
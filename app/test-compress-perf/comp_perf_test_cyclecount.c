@@ -196,8 +196,12 @@ main_loop(struct cperf_cyclecount_ctx *ctx, enum rte_comp_xform_type type)
 				.algo = test_data->test_algo,
 				.level = test_data->level,
 				.window_size = test_data->window_sz,
-				.chksum = RTE_COMP_CHECKSUM_NONE,
-				.hash_algo = RTE_COMP_HASH_ALGO_NONE
+				.chksum = test_data->chksum,
+				.hash_algo = RTE_COMP_HASH_ALGO_NONE,
+				.zstd = {
+					.dict = test_data->dict,
+					.dict_len = test_data->dict_sz
+				}
 			}
 		};
 		if (test_data->test_algo == RTE_COMP_ALGO_DEFLATE)
@@ -212,9 +216,13 @@ main_loop(struct cperf_cyclecount_ctx *ctx, enum rte_comp_xform_type type)
 			.type = RTE_COMP_DECOMPRESS,
 			.decompress = {
 				.algo = test_data->test_algo,
-				.chksum = RTE_COMP_CHECKSUM_NONE,
+				.chksum = test_data->chksum,
 				.window_size = test_data->window_sz,
-				.hash_algo = RTE_COMP_HASH_ALGO_NONE
+				.hash_algo = RTE_COMP_HASH_ALGO_NONE,
+				.zstd = {
+					.dict = test_data->dict,
+					.dict_len = test_data->dict_sz
+				}
 			}
 		};
 		if (test_data->test_algo == RTE_COMP_ALGO_LZ4)
@@ -87,8 +87,12 @@ main_loop(struct cperf_benchmark_ctx *ctx, enum rte_comp_xform_type type)
 				.algo = test_data->test_algo,
 				.level = test_data->level,
 				.window_size = test_data->window_sz,
-				.chksum = RTE_COMP_CHECKSUM_NONE,
-				.hash_algo = RTE_COMP_HASH_ALGO_NONE
+				.chksum = test_data->chksum,
+				.hash_algo = RTE_COMP_HASH_ALGO_NONE,
+				.zstd = {
+					.dict = test_data->dict,
+					.dict_len = test_data->dict_sz
+				}
 			}
 		};
 		if (test_data->test_algo == RTE_COMP_ALGO_DEFLATE)
@@ -103,9 +107,13 @@ main_loop(struct cperf_benchmark_ctx *ctx, enum rte_comp_xform_type type)
 			.type = RTE_COMP_DECOMPRESS,
 			.decompress = {
 				.algo = test_data->test_algo,
-				.chksum = RTE_COMP_CHECKSUM_NONE,
+				.chksum = test_data->chksum,
 				.window_size = test_data->window_sz,
-				.hash_algo = RTE_COMP_HASH_ALGO_NONE
+				.hash_algo = RTE_COMP_HASH_ALGO_NONE,
+				.zstd = {
+					.dict = test_data->dict,
+					.dict_len = test_data->dict_sz
+				}
 			}
 		};
 		if (test_data->test_algo == RTE_COMP_ALGO_LZ4)
@@ -385,9 +393,13 @@ cperf_throughput_test_runner(void *test_ctx)
 						       test_data->input_data_sz;
 		ctx->comp_gbps = rte_get_tsc_hz() / ctx->comp_tsc_byte * 8 /
 								     1000000000;
+		ctx->comp_mops = (double)rte_get_tsc_hz() *
+			ctx->ver.mem.total_bufs /
+			ctx->comp_tsc_duration[test_data->level] / 1000000;
 	} else {
 		ctx->comp_tsc_byte = 0;
 		ctx->comp_gbps = 0;
+		ctx->comp_mops = 0;
 	}
 
 	if (test_data->test_op & DECOMPRESS) {
@@ -407,24 +419,31 @@ cperf_throughput_test_runner(void *test_ctx)
 						       test_data->input_data_sz;
 		ctx->decomp_gbps = rte_get_tsc_hz() / ctx->decomp_tsc_byte * 8 /
 								     1000000000;
+		ctx->decomp_mops = (double)rte_get_tsc_hz() *
+			ctx->ver.mem.total_bufs /
+			ctx->decomp_tsc_duration[test_data->level] / 1000000;
 	} else {
 		ctx->decomp_tsc_byte = 0;
 		ctx->decomp_gbps = 0;
+		ctx->decomp_mops = 0;
 	}
 
 	exp = 0;
 	if (__atomic_compare_exchange_n(&display_once, &exp, 1, 0,
 			__ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
-		printf("\n%12s%6s%12s%17s%15s%16s\n",
+		printf("\n%12s%6s%12s%17s%15s%16s%15s%16s\n",
 			"lcore id", "Level", "Comp size", "Comp ratio [%]",
-			"Comp [Gbps]", "Decomp [Gbps]");
+			"Comp [Gbps]", "Decomp [Gbps]",
+			"Comp [Mops]", "Decomp [Mops]");
 	}
 
-	printf("%12u%6u%12zu%17.2f%15.2f%16.2f\n",
+	printf("%12u%6u%12zu%17.2f%15.2f%16.2f%15.3f%16.3f\n",
 		ctx->ver.mem.lcore_id,
 		test_data->level, ctx->ver.comp_data_sz, ctx->ver.ratio,
 		ctx->comp_gbps,
-		ctx->decomp_gbps);
+		ctx->decomp_gbps,
+		ctx->comp_mops,
+		ctx->decomp_mops);
 
 end:
 	return ret;
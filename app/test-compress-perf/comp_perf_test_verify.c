@@ -60,6 +60,8 @@ main_loop(struct cperf_verify_ctx *ctx, enum rte_comp_xform_type type)
 	void *priv_xform = NULL;
 	struct rte_comp_xform xform;
 	size_t output_size = 0;
+	uint64_t *output_chksum;
+	uint64_t chksum = 0;
 	struct rte_mbuf **input_bufs, **output_bufs;
 	int res = 0;
 	int allocated = 0;
@@ -90,8 +92,12 @@ main_loop(struct cperf_verify_ctx *ctx, enum rte_comp_xform_type type)
 				.algo = test_data->test_algo,
 				.level = test_data->level,
 				.window_size = test_data->window_sz,
-				.chksum = RTE_COMP_CHECKSUM_NONE,
-				.hash_algo = RTE_COMP_HASH_ALGO_NONE
+				.chksum = test_data->chksum,
+				.hash_algo = RTE_COMP_HASH_ALGO_NONE,
+				.zstd = {
+					.dict = test_data->dict,
+					.dict_len = test_data->dict_sz
+				}
 			}
 		};
 		if (test_data->test_algo == RTE_COMP_ALGO_DEFLATE)
@@ -100,6 +106,7 @@ main_loop(struct cperf_verify_ctx *ctx, enum rte_comp_xform_type type)
 			xform.compress.lz4.flags = test_data->lz4_flags;
 		output_data_ptr = ctx->mem.compressed_data;
 		output_data_sz = &ctx->comp_data_sz;
+		output_chksum = &ctx->comp_chksum;
 		input_bufs = mem->decomp_bufs;
 		output_bufs = mem->comp_bufs;
 		out_seg_sz = test_data->out_seg_sz;
@@ -108,15 +115,20 @@ main_loop(struct cperf_verify_ctx *ctx, enum rte_comp_xform_type type)
 			.type = RTE_COMP_DECOMPRESS,
 			.decompress = {
 				.algo = test_data->test_algo,
-				.chksum = RTE_COMP_CHECKSUM_NONE,
+				.chksum = test_data->chksum,
 				.window_size = test_data->window_sz,
-				.hash_algo = RTE_COMP_HASH_ALGO_NONE
+				.hash_algo = RTE_COMP_HASH_ALGO_NONE,
+				.zstd = {
+					.dict = test_data->dict,
+					.dict_len = test_data->dict_sz
+				}
 			}
 		};
 		if (test_data->test_algo == RTE_COMP_ALGO_LZ4)
 			xform.decompress.lz4.flags = test_data->lz4_flags;
 		output_data_ptr = ctx->mem.decompressed_data;
 		output_data_sz = &ctx->decomp_data_sz;
+		output_chksum = &ctx->decomp_chksum;
 		input_bufs = mem->comp_bufs;
 		output_bufs = mem->decomp_bufs;
 		out_seg_sz = (test_data->test_op & COMPRESS) ?
@@ -259,6 +271,7 @@ main_loop(struct cperf_verify_ctx *ctx, enum rte_comp_xform_type type)
 						   op->produced);
 				output_data_ptr += op->produced;
 				output_size += op->produced;
+				chksum ^= op->output_chksum;
 
 			}
 
@@ -344,6 +357,7 @@ main_loop(struct cperf_verify_ctx *ctx, enum rte_comp_xform_type type)
 						   op->produced);
 				output_data_ptr += op->produced;
 				output_size += op->produced;
+				chksum ^= op->output_chksum;
 
 			}
 
@@ -375,6 +389,7 @@ main_loop(struct cperf_verify_ctx *ctx, enum rte_comp_xform_type type)
 
 	if (output_data_sz)
 		*output_data_sz = output_size;
+	*output_chksum = chksum;
 end:
 	rte_mempool_put_bulk(mem->op_pool, (void **)ops, allocated);
 	rte_compressdev_private_xform_free(dev_id, priv_xform);
@@ -446,6 +461,18 @@ cperf_verify_test_runner(void *test_ctx)
 				goto end;
 			}
 		}
+
+		/*
+		 * Both directions seed each op with the same buffer index,
+		 * so the checksums of every buffer must match pairwise.
+		 */
+		if (test_data->chksum != RTE_COMP_CHECKSUM_NONE &&
+				ctx->comp_chksum != ctx->decomp_chksum) {
+			RTE_LOG(ERR, USER1,
+				"Checksum of decompressed data is not the same as on compression\n");
+			ret = EXIT_FAILURE;
+			goto end;
+		}
 	}
 
 	ctx->ratio = (double) ctx->comp_data_sz /
@@ -17,6 +17,8 @@ struct cperf_verify_ctx {
 	int silent;
 	size_t comp_data_sz;
 	size_t decomp_data_sz;
+	uint64_t comp_chksum;
+	uint64_t decomp_chksum;
 	double ratio;
 };
 
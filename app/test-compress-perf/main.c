@@ -2,8 +2,10 @@
  * Copyright(c) 2018 Intel Corporation
  */
 
+#include <dirent.h>
 #include <stdlib.h>
 #include <signal.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
@@ -14,6 +16,7 @@
 
 #include "comp_perf.h"
 #include "comp_perf_options.h"
+#include "comp_perf_test_block.h"
 #include "comp_perf_test_common.h"
 #include "comp_perf_test_cyclecount.h"
 #include "comp_perf_test_throughput.h"
@@ -26,7 +29,8 @@ __extension__
 const char *comp_perf_test_type_strs[] = {
 	[CPERF_TEST_TYPE_THROUGHPUT] = "throughput",
 	[CPERF_TEST_TYPE_VERIFY] = "verify",
-	[CPERF_TEST_TYPE_PMDCC] = "pmd-cyclecount"
+	[CPERF_TEST_TYPE_PMDCC] = "pmd-cyclecount",
+	[CPERF_TEST_TYPE_BLOCK] = "block-trace"
 };
 
 __extension__
@@ -47,6 +51,12 @@ static const struct cperf_test cperf_testmap[] = {
 			cperf_cyclecount_test_constructor,
 			cperf_cyclecount_test_runner,
 			cperf_cyclecount_test_destructor
+	},
+
+	[CPERF_TEST_TYPE_BLOCK] = {
+			cperf_block_test_constructor,
+			cperf_block_test_runner,
+			cperf_block_test_destructor
 	}
 };
 
@@ -103,6 +113,14 @@ comp_perf_check_capabilities(struct comp_test_data *test_data, uint8_t cdev_id)
 			return -1;
 		}
 		break;
+	case RTE_COMP_ALGO_ZSTD:
+		if (test_data->dict_file[0] != '\0' &&
+		    (comp_flags & RTE_COMP_FF_ZSTD_DICT) == 0) {
+			RTE_LOG(ERR, USER1,
+				"Compress device does not support zstd dictionaries\n");
+			return -1;
+		}
+		break;
 	case RTE_COMP_ALGO_LZS:
 	case RTE_COMP_ALGO_NULL:
 		break;
@@ -110,6 +128,20 @@ comp_perf_check_capabilities(struct comp_test_data *test_data, uint8_t cdev_id)
 		return -1;
 	}
 
+	/* Checksum */
+	if ((test_data->chksum == RTE_COMP_CHECKSUM_CRC32 &&
+	     (comp_flags & RTE_COMP_FF_CRC32_CHECKSUM) == 0) ||
+	    (test_data->chksum == RTE_COMP_CHECKSUM_ADLER32 &&
+	     (comp_flags & RTE_COMP_FF_ADLER32_CHECKSUM) == 0) ||
+	    (test_data->chksum == RTE_COMP_CHECKSUM_CRC32_ADLER32 &&
+	     (comp_flags & RTE_COMP_FF_CRC32_ADLER32_CHECKSUM) == 0) ||
+	    (test_data->chksum == RTE_COMP_CHECKSUM_XXHASH32 &&
+	     (comp_flags & RTE_COMP_FF_XXHASH32_CHECKSUM) == 0)) {
+		RTE_LOG(ERR, USER1,
+			"Compress device does not support this checksum type\n");
+		return -1;
+	}
+
 	/* Window size */
 	if (test_data->window_sz != -1) {
 		if (param_range_check(test_data->window_sz, &cap->window_size)
@@ -252,12 +284,115 @@ comp_perf_initialize_compressdev(struct comp_test_data *test_data,
 	return enabled_cdev_count;
 }
 
+/* Read the regular files of a directory, in name order, as one input */
+static int
+comp_perf_dump_corpus(struct comp_test_data *test_data)
+{
+	struct dirent **names = NULL;
+	char path[PATH_MAX * 2];
+	size_t corpus_sz = 0;
+	size_t remaining_data;
+	uint8_t *data;
+	struct stat st;
+	int nb_names, i;
+	int ret = -1;
+	FILE *f;
+
+	if (!(test_data->test_op & COMPRESS)) {
+		RTE_LOG(ERR, USER1,
+			"Input directory is only supported with compression\n");
+		return -1;
+	}
+
+	nb_names = scandir(test_data->input_file, &names, NULL, alphasort);
+	if (nb_names < 0) {
+		RTE_LOG(ERR, USER1, "Input directory could not be read\n");
+		return -1;
+	}
+
+	for (i = 0; i < nb_names; i++) {
+		snprintf(path, sizeof(path), "%s/%s", test_data->input_file,
+			names[i]->d_name);
+		if (stat(path, &st) == 0 && S_ISREG(st.st_mode))
+			corpus_sz += st.st_size;
+	}
+
+	if (corpus_sz == 0) {
+		RTE_LOG(ERR, USER1, "Input directory has no data\n");
+		goto end;
+	}
+
+	if (test_data->input_data_sz == 0)
+		test_data->input_data_sz = corpus_sz;
+
+	test_data->input_data = rte_zmalloc_socket(NULL,
+				test_data->input_data_sz, 0, rte_socket_id());
+	if (test_data->input_data == NULL) {
+		RTE_LOG(ERR, USER1, "Memory to hold the data from the input "
+				"directory could not be allocated\n");
+		goto end;
+	}
+
+	/* Go through the corpus as many times as needed to fill the input */
+	remaining_data = test_data->input_data_sz;
+	data = test_data->input_data;
+	while (remaining_data > 0) {
+		size_t pass_start = remaining_data;
+
+		for (i = 0; i < nb_names && remaining_data > 0; i++) {
+			size_t data_read;
+
+			snprintf(path, sizeof(path), "%s/%s",
+				test_data->input_file, names[i]->d_name);
+			if (stat(path, &st) != 0 || !S_ISREG(st.st_mode))
+				continue;
+
+			f = fopen(path, "r");
+			if (f == NULL) {
+				RTE_LOG(ERR, USER1,
+					"Input file %s could not be opened\n",
+					path);
+				goto end;
+			}
+			data_read = fread(data, 1, remaining_data, f);
+			fclose(f);
+
+			data += data_read;
+			remaining_data -= data_read;
+		}
+
+		if (remaining_data == pass_start) {
+			RTE_LOG(ERR, USER1, "Input directory could not be read\n");
+			goto end;
+		}
+	}
+
+	printf("\n");
+	RTE_LOG(INFO, USER1,
+		"%zu bytes read from %zu bytes of files in directory %s\n",
+		test_data->input_data_sz, corpus_sz, test_data->input_file);
+
+	ret = 0;
+
+end:
+	for (i = 0; i < nb_names; i++)
+		free(names[i]);
+	free(names);
+	return ret;
+}
+
 static int
 comp_perf_dump_input_data(struct comp_test_data *test_data)
 {
-	FILE *f = fopen(test_data->input_file, "r");
+	struct stat st;
+	FILE *f;
 	int ret = -1;
 
+	if (stat(test_data->input_file, &st) == 0 && S_ISDIR(st.st_mode))
+		return comp_perf_dump_corpus(test_data);
+
+	f = fopen(test_data->input_file, "r");
+
 	if (f == NULL) {
 		RTE_LOG(ERR, USER1, "Input file could not be opened\n");
 		return -1;
@@ -335,6 +470,51 @@ comp_perf_dump_input_data(struct comp_test_data *test_data)
 	return ret;
 }
 
+static int
+comp_perf_dump_dict(struct comp_test_data *test_data)
+{
+	FILE *f;
+	long sz;
+	int ret = -1;
+
+	if (test_data->dict_file[0] == '\0')
+		return 0;
+
+	f = fopen(test_data->dict_file, "r");
+	if (f == NULL) {
+		RTE_LOG(ERR, USER1, "Dictionary file could not be opened\n");
+		return -1;
+	}
+
+	if (fseek(f, 0, SEEK_END) != 0 || (sz = ftell(f)) <= 0 ||
+			fseek(f, 0, SEEK_SET) != 0) {
+		RTE_LOG(ERR, USER1, "Size of dictionary could not be calculated\n");
+		goto end;
+	}
+
+	test_data->dict = rte_zmalloc_socket(NULL, sz, 0, rte_socket_id());
+	if (test_data->dict == NULL) {
+		RTE_LOG(ERR, USER1, "Memory to hold the dictionary "
+				"could not be allocated\n");
+		goto end;
+	}
+
+	if (fread(test_data->dict, sz, 1, f) != 1) {
+		RTE_LOG(ERR, USER1, "Dictionary file could not be read\n");
+		goto end;
+	}
+	test_data->dict_sz = sz;
+
+	RTE_LOG(INFO, USER1, "%zu bytes of dictionary read from file %s\n",
+		test_data->dict_sz, test_data->dict_file);
+
+	ret = 0;
+
+end:
+	fclose(f);
+	return ret;
+}
+
 static void
 comp_perf_cleanup_on_signal(int signalNumber __rte_unused)
 {
@@ -408,6 +588,17 @@ main(int argc, char **argv)
 
 	test_data->cleanup = ST_INPUT_DATA;
 
+	if (comp_perf_dump_dict(test_data) < 0) {
+		ret = EXIT_FAILURE;
+		goto end;
+	}
+
+	if (test_data->test == CPERF_TEST_TYPE_BLOCK &&
+			cperf_block_trace_load(test_data) < 0) {
+		ret = EXIT_FAILURE;
+		goto end;
+	}
+
 	if (test_data->level_lst.inc != 0)
 		test_data->level = test_data->level_lst.min;
 	else
@@ -419,6 +610,8 @@ main(int argc, char **argv)
 	if (test_data->test == CPERF_TEST_TYPE_PMDCC)
 		printf("Cycle-count delay = %u [us]\n",
 		       test_data->cyclecount_delay);
+	if (test_data->test == CPERF_TEST_TYPE_BLOCK)
+		printf("Queue depth = %u\n", test_data->queue_depth);
 
 	test_data->cleanup = ST_DURING_TEST;
 	total_nb_qps = nb_compressdevs * test_data->nb_qps;
@@ -445,7 +638,8 @@ main(int argc, char **argv)
 		i++;
 	}
 
-	print_test_dynamics(test_data);
+	if (test_data->test != CPERF_TEST_TYPE_BLOCK)
+		print_test_dynamics(test_data);
 
 	while (test_data->level <= test_data->level_lst.max) {
 
@@ -497,6 +691,8 @@ main(int argc, char **argv)
 		}
 		/* fallthrough */
 	case ST_INPUT_DATA:
+		rte_free(test_data->blocks);
+		rte_free(test_data->dict);
 		rte_free(test_data->input_data);
 		/* fallthrough */
 	case ST_COMPDEV:
@@ -7,6 +7,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 
+#include <rte_bitops.h>
 #include <rte_time.h>
 #include <rte_mbuf.h>
 #include <rte_dmadev.h>
@@ -26,10 +27,34 @@
 
 #define CSV_TOTAL_LINE_FMT "Scenario %u Summary, , , , , ,%u,%.2lf,%.1lf,%.3lf,%.3lf\n"
 
+#define CSV_LAT_FMT ",%.1lf,%.1lf,%.1lf,%.1lf\n"
+
+/*
+ * Log-linear latency histogram, in the style of HDR histograms:
+ * each power of two is split in LAT_HIST_SUB_NB linear buckets,
+ * so a recorded value is known within 1 / LAT_HIST_SUB_NB of its magnitude.
+ */
+#define LAT_HIST_SUB_BITS 5
+#define LAT_HIST_SUB_NB (1u << LAT_HIST_SUB_BITS)
+#define LAT_HIST_BUCKET_NB ((64 - LAT_HIST_SUB_BITS + 1) * LAT_HIST_SUB_NB)
+
+struct lat_hist {
+	uint64_t count;
+	uint64_t max;
+	uint64_t buckets[LAT_HIST_BUCKET_NB];
+};
+
+struct lat_info {
+	uint64_t *enq_tsc; /* TSC at enqueue, indexed by the op ring index */
+	uint16_t mask;
+	struct lat_hist *hist;
+};
+
 struct worker_info {
 	bool ready_flag;
 	bool start_flag;
 	bool stop_flag;
+	bool measure_flag;
 	uint32_t total_cpl;
 	uint32_t test_cpl;
 };
@@ -47,13 +72,18 @@ struct lcore_params {
 	char *dma_name;
 	uint16_t worker_id;
 	uint16_t dev_id;
+	uint16_t vchan_id;
 	uint32_t nr_buf;
 	uint16_t kick_batch;
 	uint32_t buf_size;
+	uint32_t avg_size;
+	uint32_t *buf_sizes;
+	uint64_t pattern;
 	uint16_t test_secs;
 	struct rte_mbuf **srcs;
 	struct rte_mbuf **dsts;
 	struct sge_info sge;
+	struct lat_info lat;
 	volatile struct worker_info worker_info;
 };
 
@@ -79,10 +109,101 @@ print_err(const char *func, int lineno, const char *format, ...)
 	return ret;
 }
 
+static inline unsigned int
+lat_hist_index(uint64_t cycles)
+{
+	unsigned int shift;
+
+	if (cycles < LAT_HIST_SUB_NB)
+		return cycles;
+
+	shift = rte_fls_u64(cycles) - 1 - LAT_HIST_SUB_BITS;
+	return (shift + 1) * LAT_HIST_SUB_NB + (cycles >> shift) - LAT_HIST_SUB_NB;
+}
+
+/* Highest value counted in a bucket. */
+static uint64_t
+lat_hist_value(unsigned int idx)
+{
+	unsigned int shift;
+
+	if (idx < LAT_HIST_SUB_NB)
+		return idx;
+
+	shift = idx / LAT_HIST_SUB_NB - 1;
+	return ((uint64_t)(idx % LAT_HIST_SUB_NB + LAT_HIST_SUB_NB + 1) << shift) - 1;
+}
+
 static inline void
-calc_result(uint32_t buf_size, uint32_t nr_buf, uint16_t nb_workers, uint16_t test_secs,
-				uint32_t total_cnt, float *memory, uint32_t *ave_cycle,
-				float *bandwidth, float *mops)
+lat_hist_add(struct lat_hist *hist, uint64_t cycles)
+{
+	hist->buckets[lat_hist_index(cycles)]++;
+	hist->count++;
+	if (cycles > hist->max)
+		hist->max = cycles;
+}
+
+static void
+lat_hist_merge(struct lat_hist *dst, const struct lat_hist *src)
+{
+	unsigned int i;
+
+	for (i = 0; i < LAT_HIST_BUCKET_NB; i++)
+		dst->buckets[i] += src->buckets[i];
+	dst->count += src->count;
+	dst->max = RTE_MAX(dst->max, src->max);
+}
+
+static uint64_t
+lat_hist_percentile(const struct lat_hist *hist, double percent)
+{
+	double rank = hist->count * percent / 100;
+	uint64_t target = (uint64_t)rank;
+	uint64_t sum = 0;
+	unsigned int i;
+
+	if (target < rank || target == 0)
+		target++;
+
+	for (i = 0; i < LAT_HIST_BUCKET_NB; i++) {
+		sum += hist->buckets[i];
+		if (sum >= target)
+			return RTE_MIN(lat_hist_value(i), hist->max);
+	}
+
+	return hist->max;
+}
+
+static inline double
+cycles_to_ns(uint64_t cycles)
+{
+	return (double)cycles * 1E9 / rte_get_tsc_hz();
+}
+
+/* Record the enqueue time of an op. */
+static inline void
+lat_stamp(struct lat_info *lat, uint16_t ring_idx)
+{
+	if (lat->enq_tsc != NULL)
+		lat->enq_tsc[ring_idx & lat->mask] = rte_rdtsc();
+}
+
+/* Account the latency of the nr_cpl ops completed up to ring index last_idx. */
+static inline void
+lat_record(struct lat_info *lat, uint16_t last_idx, uint16_t nr_cpl)
+{
+	uint64_t now = rte_rdtsc();
+	uint16_t i;
+
+	for (i = 0; i < nr_cpl; i++)
+		lat_hist_add(lat->hist,
+			now - lat->enq_tsc[(uint16_t)(last_idx - i) & lat->mask]);
+}
+
+static inline void
+calc_result(uint32_t buf_size, uint32_t xfer_size, uint32_t nr_buf, uint16_t nb_workers,
+				uint16_t test_secs, uint32_t total_cnt, float *memory,
+				uint32_t *ave_cycle, float *bandwidth, float *mops)
 {
 	float ops;
 
@@ -90,7 +211,25 @@ calc_result(uint32_t buf_size, uint32_t nr_buf, uint16_t nb_workers, uint16_t te
 	*ave_cycle = test_secs * rte_get_timer_hz() / total_cnt;
 	ops = (float)total_cnt / test_secs;
 	*mops = ops / (1000 * 1000);
-	*bandwidth = (ops * buf_size * 8) / (1000 * 1000 * 1000);
+	*bandwidth = (ops * xfer_size * 8) / (1000 * 1000 * 1000);
+}
+
+/* Print the latency percentiles and append them as columns of a CSV line. */
+static void
+output_latency(const struct lat_hist *hist, char *line)
+{
+	size_t len = strlen(line);
+	double p50 = cycles_to_ns(lat_hist_percentile(hist, 50));
+	double p99 = cycles_to_ns(lat_hist_percentile(hist, 99));
+	double p999 = cycles_to_ns(lat_hist_percentile(hist, 99.9));
+	double max = cycles_to_ns(hist->max);
+
+	printf("Latency p50: %.1lf ns, p99: %.1lf ns, p99.9: %.1lf ns, max: %.1lf ns, ops: %" PRIu64 "\n",
+			p50, p99, p999, max, hist->count);
+
+	if (len > 0 && line[len - 1] == '\n')
+		len--;
+	snprintf(line + len, MAX_OUTPUT_STR_LEN - len, CSV_LAT_FMT, p50, p99, p999, max);
 }
 
 static void
@@ -104,8 +243,8 @@ output_result(struct test_configure *cfg, struct lcore_params *para,
 	char *dma_name = para->dma_name;
 
 	if (cfg->is_dma) {
-		printf("lcore %u, DMA %s, DMA Ring Size: %u, Kick Batch Size: %u", lcore_id,
-		       dma_name, ring_size, kick_batch);
+		printf("lcore %u, DMA %s, vchan %u, DMA Ring Size: %u, Kick Batch Size: %u",
+		       lcore_id, dma_name, para->vchan_id, ring_size, kick_batch);
 		if (cfg->is_sg)
 			printf(" DMA src sges: %u, dst sges: %u",
 			       para->sge.nb_srcs, para->sge.nb_dsts);
@@ -126,6 +265,9 @@ output_result(struct test_configure *cfg, struct lcore_params *para,
 		snprintf(output_str[lcore_id], MAX_OUTPUT_STR_LEN, CSV_LINE_CPU_FMT,
 			scenario_id, lcore_id, buf_size,
 			nr_buf, memory, ave_cycle, bandwidth, mops);
+
+	if (cfg->is_latency)
+		output_latency(para->lat.hist, output_str[lcore_id]);
 }
 
 static inline void
@@ -183,28 +325,31 @@ vchan_data_populate(uint32_t dev_id, struct rte_dma_vchan_conf *qconf,
 	return 0;
 }
 
-/* Configuration of device. */
+/* Configuration of device, with one vchan per worker using it. */
 static void
-configure_dmadev_queue(uint32_t dev_id, struct test_configure *cfg, uint8_t sges_max)
+configure_dmadev_queue(uint32_t dev_id, struct test_configure *cfg, uint8_t sges_max,
+		uint16_t nb_vchans)
 {
-	uint16_t vchan = 0;
+	uint16_t vchan;
 	struct rte_dma_info info;
-	struct rte_dma_conf dev_config = { .nb_vchans = 1 };
+	struct rte_dma_conf dev_config = { .nb_vchans = nb_vchans };
 	struct rte_dma_vchan_conf qconf = { 0 };
 
 	if (vchan_data_populate(dev_id, &qconf, cfg) != 0)
 		rte_exit(EXIT_FAILURE, "Error with vchan data populate.\n");
 
 	if (rte_dma_configure(dev_id, &dev_config) != 0)
-		rte_exit(EXIT_FAILURE, "Error with dma configure.\n");
+		rte_exit(EXIT_FAILURE, "Error with dma configure of %u vchans.\n", nb_vchans);
 
-	if (rte_dma_vchan_setup(dev_id, vchan, &qconf) != 0)
-		rte_exit(EXIT_FAILURE, "Error with queue configuration.\n");
+	for (vchan = 0; vchan < nb_vchans; vchan++) {
+		if (rte_dma_vchan_setup(dev_id, vchan, &qconf) != 0)
+			rte_exit(EXIT_FAILURE, "Error with queue configuration.\n");
+	}
 
 	if (rte_dma_info_get(dev_id, &info) != 0)
 		rte_exit(EXIT_FAILURE, "Error with getting device info.\n");
 
-	if (info.nb_vchans != 1)
+	if (info.nb_vchans != nb_vchans)
 		rte_exit(EXIT_FAILURE, "Error, no configured queues reported on device id. %u\n",
 				dev_id);
 
@@ -212,44 +357,65 @@ configure_dmadev_queue(uint32_t dev_id, struct test_configure *cfg, uint8_t sges
 		rte_exit(EXIT_FAILURE, "Error with unsupported max_sges on device id %u.\n",
 				dev_id);
 
+	if (cfg->opcode == DMA_OP_FILL && !(info.dev_capa & RTE_DMA_CAPA_OPS_FILL))
+		rte_exit(EXIT_FAILURE, "Error with unsupported fill on device id %u.\n",
+				dev_id);
+
 	if (rte_dma_start(dev_id) != 0)
 		rte_exit(EXIT_FAILURE, "Error with dma start.\n");
 }
 
+/*
+ * Workers mapped to the same DMA device each get their own vchan,
+ * so N lcores can be run against M devices.
+ */
 static int
 config_dmadevs(struct test_configure *cfg)
 {
 	struct lcore_dma_map_t *ldm = &cfg->lcore_dma_map;
-	uint32_t nb_workers = ldm->cnt;
-	uint32_t i;
+	uint32_t nb_workers = cfg->nb_workers.cur;
+	uint32_t i, j;
 	int dev_id;
 	uint16_t nb_dmadevs = 0;
+	uint16_t nb_vchans;
 	uint8_t nb_sges = 0;
 	char *dma_name;
 
 	if (cfg->is_sg)
 		nb_sges = RTE_MAX(cfg->nb_src_sges, cfg->nb_dst_sges);
 
-	for (i = 0; i < ldm->cnt; i++) {
+	for (i = 0; i < nb_workers; i++) {
 		dma_name = ldm->dma_names[i];
 		dev_id = rte_dma_get_dev_id_by_name(dma_name);
 		if (dev_id < 0) {
 			fprintf(stderr, "Error: Fail to find DMA %s.\n", dma_name);
-			goto end;
+			printf("Not enough dmadevs for all workers (%u).\n", nb_workers);
+			return -1;
 		}
 
 		ldm->dma_ids[i] = dev_id;
-		configure_dmadev_queue(dev_id, cfg, nb_sges);
-		++nb_dmadevs;
+		ldm->vchan_ids[i] = 0;
+		for (j = 0; j < i; j++) {
+			if (ldm->dma_ids[j] == dev_id)
+				ldm->vchan_ids[i]++;
+		}
 	}
 
-end:
-	if (nb_dmadevs < nb_workers) {
-		printf("Not enough dmadevs (%u) for all workers (%u).\n", nb_dmadevs, nb_workers);
-		return -1;
+	for (i = 0; i < nb_workers; i++) {
+		if (ldm->vchan_ids[i] != 0)
+			continue;
+
+		nb_vchans = 0;
+		for (j = i; j < nb_workers; j++) {
+			if (ldm->dma_ids[j] == ldm->dma_ids[i])
+				nb_vchans++;
+		}
+
+		configure_dmadev_queue(ldm->dma_ids[i], cfg, nb_sges, nb_vchans);
+		++nb_dmadevs;
 	}
 
-	printf("Number of used dmadevs: %u.\n", nb_dmadevs);
+	printf("Number of used dmadevs: %u, vchans: %u.\n", nb_dmadevs, nb_workers);
 
 	return 0;
 }
@@ -263,17 +429,21 @@ error_exit(int dev_id)
 }
 
 static inline void
-do_dma_submit_and_poll(uint16_t dev_id, uint64_t *async_cnt,
-			volatile struct worker_info *worker_info)
+do_dma_submit_and_poll(struct lcore_params *para, uint64_t *async_cnt)
 {
-	int ret;
+	volatile struct worker_info *worker_info = &(para->worker_info);
+	uint16_t last_idx;
 	uint16_t nr_cpl;
+	int ret;
 
-	ret = rte_dma_submit(dev_id, 0);
+	ret = rte_dma_submit(para->dev_id, para->vchan_id);
 	if (ret < 0)
-		error_exit(dev_id);
+		error_exit(para->dev_id);
 
-	nr_cpl = rte_dma_completed(dev_id, 0, MAX_DMA_CPL_NB, NULL, NULL);
+	nr_cpl = rte_dma_completed(para->dev_id, para->vchan_id, MAX_DMA_CPL_NB,
+			&last_idx, NULL);
+	if (para->lat.enq_tsc != NULL && nr_cpl != 0 && worker_info->measure_flag)
+		lat_record(&para->lat, last_idx, nr_cpl);
 	*async_cnt -= nr_cpl;
 	worker_info->total_cpl += nr_cpl;
 }
@@ -284,9 +454,10 @@ do_dma_plain_mem_copy(void *p)
 	struct lcore_params *para = (struct lcore_params *)p;
 	volatile struct worker_info *worker_info = &(para->worker_info);
 	const uint16_t dev_id = para->dev_id;
+	const uint16_t vchan_id = para->vchan_id;
 	const uint32_t nr_buf = para->nr_buf;
 	const uint16_t kick_batch = para->kick_batch;
-	const uint32_t buf_size = para->buf_size;
+	const uint32_t *buf_sizes = para->buf_sizes;
 	struct rte_mbuf **srcs = para->srcs;
 	struct rte_mbuf **dsts = para->dsts;
 	uint16_t nr_cpl;
@@ -304,28 +475,85 @@ do_dma_plain_mem_copy(void *p)
 	while (1) {
 		for (i = 0; i < nr_buf; i++) {
 dma_copy:
-			ret = rte_dma_copy(dev_id, 0, rte_mbuf_data_iova(srcs[i]),
-				rte_mbuf_data_iova(dsts[i]), buf_size, 0);
+			ret = rte_dma_copy(dev_id, vchan_id, rte_mbuf_data_iova(srcs[i]),
+				rte_mbuf_data_iova(dsts[i]), buf_sizes[i], 0);
 			if (unlikely(ret < 0)) {
 				if (ret == -ENOSPC) {
-					do_dma_submit_and_poll(dev_id, &async_cnt, worker_info);
+					do_dma_submit_and_poll(para, &async_cnt);
 					goto dma_copy;
 				} else
 					error_exit(dev_id);
 			}
+			lat_stamp(&para->lat, ret);
 			async_cnt++;
 
 			if ((async_cnt % kick_batch) == 0)
-				do_dma_submit_and_poll(dev_id, &async_cnt, worker_info);
+				do_dma_submit_and_poll(para, &async_cnt);
 		}
 
 		if (worker_info->stop_flag)
 			break;
 	}
 
-	rte_dma_submit(dev_id, 0);
+	rte_dma_submit(dev_id, vchan_id);
 	while ((async_cnt > 0) && (poll_cnt++ < POLL_MAX)) {
-		nr_cpl = rte_dma_completed(dev_id, 0, MAX_DMA_CPL_NB, NULL, NULL);
+		nr_cpl = rte_dma_completed(dev_id, vchan_id, MAX_DMA_CPL_NB, NULL, NULL);
+		async_cnt -= nr_cpl;
+	}
+
+	return 0;
+}
+
+static inline int
+do_dma_mem_fill(void *p)
+{
+	struct lcore_params *para = (struct lcore_params *)p;
+	volatile struct worker_info *worker_info = &(para->worker_info);
+	const uint16_t dev_id = para->dev_id;
+	const uint16_t vchan_id = para->vchan_id;
+	const uint32_t nr_buf = para->nr_buf;
+	const uint16_t kick_batch = para->kick_batch;
+	const uint32_t *buf_sizes = para->buf_sizes;
+	const uint64_t pattern = para->pattern;
+	struct rte_mbuf **dsts = para->dsts;
+	uint16_t nr_cpl;
+	uint64_t async_cnt = 0;
+	uint32_t i;
+	uint32_t poll_cnt = 0;
+	int ret;
+
+	worker_info->stop_flag = false;
+	worker_info->ready_flag = true;
+
+	while (!worker_info->start_flag)
+		;
+
+	while (1) {
+		for (i = 0; i < nr_buf; i++) {
+dma_fill:
+			ret = rte_dma_fill(dev_id, vchan_id, pattern,
+				rte_mbuf_data_iova(dsts[i]), buf_sizes[i], 0);
+			if (unlikely(ret < 0)) {
+				if (ret == -ENOSPC) {
+					do_dma_submit_and_poll(para, &async_cnt);
+					goto dma_fill;
+				} else
+					error_exit(dev_id);
+			}
+			lat_stamp(&para->lat, ret);
+			async_cnt++;
+
+			if ((async_cnt % kick_batch) == 0)
+				do_dma_submit_and_poll(para, &async_cnt);
+		}
+
+		if (worker_info->stop_flag)
+			break;
+	}
+
+	rte_dma_submit(dev_id, vchan_id);
+	while ((async_cnt > 0) && (poll_cnt++ < POLL_MAX)) {
+		nr_cpl = rte_dma_completed(dev_id, vchan_id, MAX_DMA_CPL_NB, NULL, NULL);
 		async_cnt -= nr_cpl;
 	}
 
@@ -343,6 +571,7 @@ do_dma_sg_mem_copy(void *p)
 	const uint8_t nb_dst_sges = para->sge.nb_dsts;
 	const uint16_t kick_batch = para->kick_batch;
 	const uint16_t dev_id = para->dev_id;
+	const uint16_t vchan_id = para->vchan_id;
 	uint32_t nr_buf = para->nr_buf;
 	uint64_t async_cnt = 0;
 	uint32_t poll_cnt = 0;
@@ -361,30 +590,31 @@ do_dma_sg_mem_copy(void *p)
 		j = 0;
 		for (i = 0; i < nr_buf; i++) {
 dma_copy:
-			ret = rte_dma_copy_sg(dev_id, 0,
+			ret = rte_dma_copy_sg(dev_id, vchan_id,
 				&src_sges[i * nb_src_sges], &dst_sges[j * nb_dst_sges],
 				nb_src_sges, nb_dst_sges, 0);
 			if (unlikely(ret < 0)) {
 				if (ret == -ENOSPC) {
-					do_dma_submit_and_poll(dev_id, &async_cnt, worker_info);
+					do_dma_submit_and_poll(para, &async_cnt);
 					goto dma_copy;
 				} else
 					error_exit(dev_id);
 			}
+			lat_stamp(&para->lat, ret);
 			async_cnt++;
 			j++;
 
 			if ((async_cnt % kick_batch) == 0)
-				do_dma_submit_and_poll(dev_id, &async_cnt, worker_info);
+				do_dma_submit_and_poll(para, &async_cnt);
 		}
 
 		if (worker_info->stop_flag)
 			break;
 	}
 
-	rte_dma_submit(dev_id, 0);
+	rte_dma_submit(dev_id, vchan_id);
 	while ((async_cnt > 0) && (poll_cnt++ < POLL_MAX)) {
-		nr_cpl = rte_dma_completed(dev_id, 0, MAX_DMA_CPL_NB, NULL, NULL);
+		nr_cpl = rte_dma_completed(dev_id, vchan_id, MAX_DMA_CPL_NB, NULL, NULL);
 		async_cnt -= nr_cpl;
 	}
 
@@ -397,7 +627,7 @@ do_cpu_mem_copy(void *p)
 	struct lcore_params *para = (struct lcore_params *)p;
 	volatile struct worker_info *worker_info = &(para->worker_info);
 	const uint32_t nr_buf = para->nr_buf;
-	const uint32_t buf_size = para->buf_size;
+	const uint32_t *buf_sizes = para->buf_sizes;
 	struct rte_mbuf **srcs = para->srcs;
 	struct rte_mbuf **dsts = para->dsts;
 	uint32_t i;
@@ -414,7 +644,7 @@ do_cpu_mem_copy(void *p)
 			void *dst = rte_pktmbuf_mtod(srcs[i], void *);
 
 			/* copy buffer form src to dst */
-			rte_memcpy(dst, src, (size_t)buf_size);
+			rte_memcpy(dst, src, (size_t)buf_sizes[i]);
 			worker_info->total_cpl++;
 		}
 		if (worker_info->stop_flag)
@@ -572,11 +802,42 @@ setup_memory_env(struct test_configure *cfg,
 	return 0;
 }
 
+/* Size of each op, drawn from the distribution if one is configured. */
+static uint32_t *
+setup_buf_sizes(struct test_configure *cfg)
+{
+	struct buf_size_dist *dist = &cfg->buf_size_dist;
+	uint32_t nr_buf = cfg->nr_buf;
+	uint32_t *buf_sizes;
+	uint64_t weight;
+	uint32_t i;
+	uint16_t j;
+
+	buf_sizes = rte_malloc(NULL, nr_buf * sizeof(uint32_t), 0);
+	if (buf_sizes == NULL) {
+		printf("Error: buf_sizes malloc failed.\n");
+		return NULL;
+	}
+
+	for (i = 0; i < nr_buf; i++) {
+		if (!cfg->is_buf_size_dist) {
+			buf_sizes[i] = cfg->buf_size.cur;
+			continue;
+		}
+
+		weight = rte_rand_max(dist->total_weight);
+		for (j = 0; weight >= dist->weights[j]; j++)
+			weight -= dist->weights[j];
+		buf_sizes[i] = dist->sizes[j];
+	}
+
+	return buf_sizes;
+}
+
 static uint32_t
 align_buffer_count(struct test_configure *cfg, uint32_t *nr_sgsrc, uint32_t *nr_sgdst)
 {
-	struct lcore_dma_map_t *ldm = &cfg->lcore_dma_map;
-	uint16_t nb_workers = ldm->cnt;
+	uint16_t nb_workers = cfg->nb_workers.cur;
 	uint32_t nr_buf;
 
 	nr_buf = (cfg->mem_size.cur * 1024 * 1024) / (cfg->buf_size.cur * 2);
@@ -608,10 +869,12 @@ get_work_function(struct test_configure *cfg)
 	lcore_function_t *fn;
 
 	if (cfg->is_dma) {
-		if (!cfg->is_sg)
-			fn = do_dma_plain_mem_copy;
-		else
+		if (cfg->is_sg)
 			fn = do_dma_sg_mem_copy;
+		else if (cfg->opcode == DMA_OP_FILL)
+			fn = do_dma_mem_fill;
+		else
+			fn = do_dma_plain_mem_copy;
 	} else {
 		fn = do_cpu_mem_copy;
 	}
@@ -630,8 +893,14 @@ mem_copy_benchmark(struct test_configure *cfg)
 	struct lcore_dma_map_t *ldm = &cfg->lcore_dma_map;
 	unsigned int buf_size = cfg->buf_size.cur;
 	uint16_t kick_batch = cfg->kick_batch.cur;
-	uint16_t nb_workers = ldm->cnt;
+	uint16_t nb_workers = cfg->nb_workers.cur;
 	uint16_t test_secs = cfg->test_secs;
+	uint32_t *buf_sizes = NULL;
+	struct lat_hist *lat_total = NULL;
+	uint64_t pattern = rte_rand();
+	uint64_t size_sum;
+	uint32_t ring_size;
+	unsigned int socket_id;
 	float memory = 0;
 	uint32_t avg_cycles = 0;
 	uint32_t avg_cycles_total;
@@ -647,6 +916,10 @@ mem_copy_benchmark(struct test_configure *cfg)
 	if (setup_memory_env(cfg, &srcs, &dsts, &src_sges, &dst_sges) < 0)
 		goto out;
 
+	buf_sizes = setup_buf_sizes(cfg);
+	if (buf_sizes == NULL)
+		goto out;
+
 	if (cfg->is_dma)
 		if (config_dmadevs(cfg) < 0)
 			goto out;
@@ -657,30 +930,39 @@ mem_copy_benchmark(struct test_configure *cfg)
 		rte_mb();
 	}
 
-	printf("Start testing....\n");
-
 	for (i = 0; i < nb_workers; i++) {
 		lcore_id = ldm->lcores[i];
+		socket_id = rte_lcore_to_socket_id(lcore_id);
 		offset = nr_buf / nb_workers * i;
-		lcores[i] = rte_malloc(NULL, sizeof(struct lcore_params), 0);
+		lcores[i] = rte_zmalloc_socket(NULL, sizeof(struct lcore_params), 0, socket_id);
 		if (lcores[i] == NULL) {
 			printf("lcore parameters malloc failure for lcore %d\n", lcore_id);
-			break;
+			ret = -1;
+			goto out;
 		}
 		if (cfg->is_dma) {
 			lcores[i]->dma_name = ldm->dma_names[i];
 			lcores[i]->dev_id = ldm->dma_ids[i];
+			lcores[i]->vchan_id = ldm->vchan_ids[i];
 			lcores[i]->kick_batch = kick_batch;
+			lcores[i]->pattern = pattern;
 		}
 		lcores[i]->worker_id = i;
 		lcores[i]->nr_buf = (uint32_t)(nr_buf / nb_workers);
 		lcores[i]->buf_size = buf_size;
+		lcores[i]->buf_sizes = buf_sizes + offset;
 		lcores[i]->test_secs = test_secs;
 		lcores[i]->srcs = srcs + offset;
 		lcores[i]->dsts = dsts + offset;
 		lcores[i]->scenario_id = cfg->scenario_id;
 		lcores[i]->lcore_id = lcore_id;
 
+		size_sum = 0;
+		for (j = 0; j < lcores[i]->nr_buf; j++)
+			size_sum += lcores[i]->buf_sizes[j];
+		lcores[i]->avg_size = lcores[i]->nr_buf ?
+				size_sum / lcores[i]->nr_buf : buf_size;
+
 		if (cfg->is_sg) {
 			lcores[i]->sge.nb_srcs = cfg->nb_src_sges;
 			lcores[i]->sge.nb_dsts = cfg->nb_dst_sges;
@@ -688,10 +970,28 @@ mem_copy_benchmark(struct test_configure *cfg)
 			lcores[i]->sge.dsts = dst_sges + (nr_sgdst / nb_workers * i);
 		}
 
-		rte_eal_remote_launch(get_work_function(cfg), (void *)(lcores[i]),
-				lcore_id);
+		if (cfg->is_latency) {
+			/* the ring holds at most its size of ops in flight */
+			ring_size = rte_align32pow2(cfg->ring_size.cur);
+			lcores[i]->lat.mask = ring_size - 1;
+			lcores[i]->lat.enq_tsc = rte_zmalloc_socket(NULL,
+					ring_size * sizeof(uint64_t), RTE_CACHE_LINE_SIZE, socket_id);
+			lcores[i]->lat.hist = rte_zmalloc_socket(NULL, sizeof(struct lat_hist),
+					RTE_CACHE_LINE_SIZE, socket_id);
+			if (lcores[i]->lat.enq_tsc == NULL || lcores[i]->lat.hist == NULL) {
+				printf("latency buffers malloc failure for lcore %d\n", lcore_id);
+				ret = -1;
+				goto out;
+			}
+		}
 	}
 
+	printf("Start testing....\n");
+
+	for (i = 0; i < nb_workers; i++)
+		rte_eal_remote_launch(get_work_function(cfg), (void *)(lcores[i]),
+				lcores[i]->lcore_id);
+
 	while (1) {
 		bool ready = true;
 		for (i = 0; i < nb_workers; i++) {
@@ -708,24 +1008,43 @@ mem_copy_benchmark(struct test_configure *cfg)
 		lcores[i]->worker_info.start_flag = true;
 
 	usleep(TEST_WAIT_U_SECOND);
-	for (i = 0; i < nb_workers; i++)
+	for (i = 0; i < nb_workers; i++) {
 		lcores[i]->worker_info.test_cpl = lcores[i]->worker_info.total_cpl;
+		lcores[i]->worker_info.measure_flag = true;
+	}
 
 	usleep(test_secs * 1000 * 1000);
-	for (i = 0; i < nb_workers; i++)
+	for (i = 0; i < nb_workers; i++) {
+		lcores[i]->worker_info.measure_flag = false;
 		lcores[i]->worker_info.test_cpl = lcores[i]->worker_info.total_cpl -
 						lcores[i]->worker_info.test_cpl;
+	}
 
 	for (i = 0; i < nb_workers; i++)
 		lcores[i]->worker_info.stop_flag = true;
 
 	rte_eal_mp_wait_lcore();
 
-	if (cfg->transfer_dir == RTE_DMA_DIR_MEM_TO_MEM && !cfg->is_sg) {
+	if (cfg->transfer_dir == RTE_DMA_DIR_MEM_TO_MEM && cfg->is_dma &&
+			cfg->opcode == DMA_OP_FILL) {
+		const uint8_t *fills = (const uint8_t *)&pattern;
+		uint8_t *ptr;
+
+		for (i = 0; i < (nr_buf / nb_workers) * nb_workers; i++) {
+			ptr = rte_pktmbuf_mtod(dsts[i], uint8_t *);
+			for (j = 0; j < buf_sizes[i]; j++) {
+				if (ptr[j] != fills[j % 8]) {
+					printf("Fill validation fails for buffer number %d\n", i);
+					ret = -1;
+					goto out;
+				}
+			}
+		}
+	} else if (cfg->transfer_dir == RTE_DMA_DIR_MEM_TO_MEM && !cfg->is_sg) {
 		for (i = 0; i < (nr_buf / nb_workers) * nb_workers; i++) {
 			if (memcmp(rte_pktmbuf_mtod(srcs[i], void *),
 				   rte_pktmbuf_mtod(dsts[i], void *),
-				   cfg->buf_size.cur) != 0) {
+				   buf_sizes[i]) != 0) {
 				printf("Copy validation fails for buffer number %d\n", i);
 				ret = -1;
 				goto out;
@@ -775,21 +1094,34 @@ mem_copy_benchmark(struct test_configure *cfg)
 	bandwidth_total = 0;
 	avg_cycles_total = 0;
 	for (i = 0; i < nb_workers; i++) {
-		calc_result(buf_size, nr_buf, nb_workers, test_secs,
+		calc_result(buf_size, lcores[i]->avg_size, nr_buf, nb_workers, test_secs,
 			lcores[i]->worker_info.test_cpl,
 			&memory, &avg_cycles, &bandwidth, &mops);
-		output_result(cfg, lcores[i], kick_batch, avg_cycles, buf_size,
+		output_result(cfg, lcores[i], kick_batch, avg_cycles, lcores[i]->avg_size,
 			nr_buf / nb_workers, memory, bandwidth, mops);
 		mops_total += mops;
 		bandwidth_total += bandwidth;
 		avg_cycles_total += avg_cycles;
 	}
-	printf("\nAverage Cycles/op per worker: %.1lf, Total Bandwidth: %.3lf Gbps, Total MOps: %.3lf\n",
-		(avg_cycles_total * (float) 1.0) / nb_workers, bandwidth_total, mops_total);
+	printf("\nWorkers: %u, Average Cycles/op per worker: %.1lf, Total Bandwidth: %.3lf Gbps, Total MOps: %.3lf\n",
+		nb_workers, (avg_cycles_total * (float) 1.0) / nb_workers, bandwidth_total,
+		mops_total);
 	snprintf(output_str[MAX_WORKER_NB], MAX_OUTPUT_STR_LEN, CSV_TOTAL_LINE_FMT,
 			cfg->scenario_id, nr_buf, memory * nb_workers,
 			(avg_cycles_total * (float) 1.0) / nb_workers, bandwidth_total, mops_total);
 
+	if (cfg->is_latency) {
+		lat_total = rte_zmalloc(NULL, sizeof(struct lat_hist), 0);
+		if (lat_total == NULL) {
+			printf("Error: latency histogram malloc failed.\n");
+			ret = -1;
+			goto out;
+		}
+		for (i = 0; i < nb_workers; i++)
+			lat_hist_merge(lat_total, lcores[i]->lat.hist);
+		output_latency(lat_total, output_str[MAX_WORKER_NB]);
+	}
+
 out:
 
 	if (cfg->transfer_dir == RTE_DMA_DIR_DEV_TO_MEM)
@@ -830,14 +1162,24 @@ mem_copy_benchmark(struct test_configure *cfg)
 	rte_free(dst_sges);
 	dst_sges = NULL;
 
+	rte_free(buf_sizes);
+	rte_free(lat_total);
+
 	/* free the worker parameters */
 	for (i = 0; i < nb_workers; i++) {
+		if (lcores[i] != NULL) {
+			rte_free(lcores[i]->lat.enq_tsc);
+			rte_free(lcores[i]->lat.hist);
+		}
 		rte_free(lcores[i]);
 		lcores[i] = NULL;
 	}
 
 	if (cfg->is_dma) {
 		for (i = 0; i < nb_workers; i++) {
+			/* a device is shared by the workers of its vchans */
+			if (ldm->vchan_ids[i] != 0)
+				continue;
 			printf("Stopping dmadev %d\n", ldm->dma_ids[i]);
 			rte_dma_stop(ldm->dma_ids[i]);
 		}
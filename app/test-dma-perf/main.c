@@ -2,6 +2,7 @@
  * Copyright(c) 2023 Intel Corporation
  */
 
+#include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <getopt.h>
@@ -22,6 +23,7 @@
 #include "main.h"
 
 #define CSV_HDR_FMT "Case %u : %s,lcore,DMA,DMA ring size,kick batch size,buffer size(B),number of buffers,memory(MB),average cycle,bandwidth(Gbps),MOps\n"
+#define CSV_HDR_LAT_FMT "Case %u : %s,lcore,DMA,DMA ring size,kick batch size,buffer size(B),number of buffers,memory(MB),average cycle,bandwidth(Gbps),MOps,p50 latency(ns),p99 latency(ns),p99.9 latency(ns),max latency(ns)\n"
 
 #define MAX_EAL_PARAM_NB 100
 #define MAX_EAL_PARAM_LEN 1024
@@ -83,7 +85,8 @@ static void
 output_header(uint32_t case_id, struct test_configure *case_cfg)
 {
 	snprintf(output_str[0], MAX_OUTPUT_STR_LEN,
-			CSV_HDR_FMT, case_id, case_cfg->test_type_str);
+			case_cfg->is_latency ? CSV_HDR_LAT_FMT : CSV_HDR_FMT,
+			case_id, case_cfg->test_type_str);
 
 	output_csv(true);
 }
@@ -128,6 +131,7 @@ run_test(uint32_t case_id, struct test_configure *case_cfg)
 	struct test_configure_entry *buf_size = &case_cfg->buf_size;
 	struct test_configure_entry *ring_size = &case_cfg->ring_size;
 	struct test_configure_entry *kick_batch = &case_cfg->kick_batch;
+	struct test_configure_entry *nb_workers = &case_cfg->nb_workers;
 	struct test_configure_entry dummy = { 0 };
 	struct test_configure_entry *var_entry = &dummy;
 
@@ -153,6 +157,9 @@ run_test(uint32_t case_id, struct test_configure *case_cfg)
 	if (kick_batch->incr != 0)
 		var_entry = kick_batch;
 
+	if (nb_workers->incr != 0)
+		var_entry = nb_workers;
+
 	case_cfg->scenario_id = 0;
 
 	output_header(case_id, case_cfg);
@@ -331,6 +338,77 @@ parse_entry(const char *value, struct test_configure_entry *entry)
 	return args_nr;
 }
 
+/*
+ * Parse a buffer size distribution file: one "size[,weight]" entry per line,
+ * the weight defaulting to 1. Empty lines and lines starting with '#' are skipped.
+ */
+static int
+parse_buf_size_dist(const char *path, struct buf_size_dist *dist)
+{
+	unsigned long size, weight;
+	char line[256];
+	char *ptr, *end;
+	int ret = 0;
+	FILE *f;
+
+	f = fopen(path, "r");
+	if (f == NULL) {
+		printf("Open buffer size distribution file %s error.\n", path);
+		return -1;
+	}
+
+	memset(dist, 0, sizeof(struct buf_size_dist));
+
+	while (fgets(line, sizeof(line), f) != NULL) {
+		ptr = line;
+		while (isspace((unsigned char)*ptr))
+			ptr++;
+		if (*ptr == '\0' || *ptr == '#')
+			continue;
+
+		size = strtoul(ptr, &end, 0);
+		if (end == ptr || size == 0 || size > UINT32_MAX) {
+			printf("Invalid size in distribution entry: %s", line);
+			ret = -1;
+			break;
+		}
+
+		ptr = end;
+		while (isspace((unsigned char)*ptr) || *ptr == ',')
+			ptr++;
+		weight = 1;
+		if (*ptr != '\0') {
+			weight = strtoul(ptr, &end, 0);
+			if (end == ptr || weight == 0 || weight > UINT32_MAX) {
+				printf("Invalid weight in distribution entry: %s", line);
+				ret = -1;
+				break;
+			}
+		}
+
+		if (dist->nb >= MAX_BUF_SIZE_DIST_NB) {
+			printf("Error: The maximum number of distribution entries is %d.\n",
+				MAX_BUF_SIZE_DIST_NB);
+			ret = -1;
+			break;
+		}
+
+		dist->sizes[dist->nb] = size;
+		dist->weights[dist->nb] = weight;
+		dist->total_weight += weight;
+		dist->nb++;
+	}
+
+	fclose(f);
+
+	if (ret == 0 && dist->nb == 0) {
+		printf("No entry in buffer size distribution file %s.\n", path);
+		ret = -1;
+	}
+
+	return ret;
+}
+
 static int populate_pcie_config(const char *key, const char *value, void *test)
 {
 	struct test_configure *test_case = (struct test_configure *)test;
@@ -364,7 +442,10 @@ load_configs(const char *path)
 	const char *transfer_dir;
 	const char *lcore_dma;
 	const char *mem_size_str, *buf_size_str, *ring_size_str, *kick_batch_str,
-		*src_sges_str, *dst_sges_str;
+		*src_sges_str, *dst_sges_str, *nb_workers_str;
+	const char *buf_size_dist_str;
+	const char *dma_op;
+	const char *latency;
 	const char *skip;
 	struct rte_kvargs *kvlist;
 	const char *vchan_dev;
@@ -482,13 +563,44 @@ load_configs(const char *path)
 			nb_vp++;
 
 		buf_size_str = rte_cfgfile_get_entry(cfgfile, section_name, "buf_size");
-		args_nr = parse_entry(buf_size_str, &test_case->buf_size);
-		if (args_nr < 0) {
-			printf("parse error in case %d.\n", i + 1);
-			test_case->is_valid = false;
-			continue;
-		} else if (args_nr == 4)
-			nb_vp++;
+		buf_size_dist_str = rte_cfgfile_get_entry(cfgfile, section_name,
+							"buf_size_dist");
+		if (buf_size_dist_str != NULL) {
+			struct buf_size_dist *dist = &test_case->buf_size_dist;
+			uint32_t max_size = 0;
+			uint16_t j;
+
+			if (buf_size_str != NULL) {
+				printf("buf_size and buf_size_dist can not be both set in case %d.\n",
+					i + 1);
+				test_case->is_valid = false;
+				continue;
+			}
+
+			if (parse_buf_size_dist(buf_size_dist_str, dist) < 0) {
+				printf("parse buf_size_dist error in case %d.\n", i + 1);
+				test_case->is_valid = false;
+				continue;
+			}
+
+			/* Buffers are sized for the largest operation of the distribution. */
+			for (j = 0; j < dist->nb; j++)
+				max_size = RTE_MAX(max_size, dist->sizes[j]);
+			test_case->buf_size.cur = test_case->buf_size.first = max_size;
+			test_case->buf_size.last = 0;
+			test_case->buf_size.incr = 0;
+			test_case->buf_size.op = OP_NONE;
+			test_case->is_buf_size_dist = true;
+		} else {
+			args_nr = parse_entry(buf_size_str, &test_case->buf_size);
+			if (args_nr < 0) {
+				printf("parse error in case %d.\n", i + 1);
+				test_case->is_valid = false;
+				continue;
+			} else if (args_nr == 4)
+				nb_vp++;
+			test_case->is_buf_size_dist = false;
+		}
 
 		if (is_dma) {
 			ring_size_str = rte_cfgfile_get_entry(cfgfile, section_name,
@@ -534,6 +646,34 @@ load_configs(const char *path)
 				test_case->is_sg = false;
 			}
 
+			if (test_case->is_sg && test_case->is_buf_size_dist) {
+				printf("buf_size_dist is not supported with dma_src_sge and dma_dst_sge in case %d.\n",
+					i + 1);
+				test_case->is_valid = false;
+				continue;
+			}
+
+			dma_op = rte_cfgfile_get_entry(cfgfile, section_name, "dma_op");
+			if (dma_op == NULL || strcmp(dma_op, "copy") == 0) {
+				test_case->opcode = DMA_OP_COPY;
+			} else if (strcmp(dma_op, "fill") == 0) {
+				test_case->opcode = DMA_OP_FILL;
+			} else {
+				printf("Invalid dma_op %s in case %d.\n", dma_op, i + 1);
+				test_case->is_valid = false;
+				continue;
+			}
+
+			if (test_case->opcode == DMA_OP_FILL && test_case->is_sg) {
+				printf("dma_op fill can not be used with dma_src_sge and dma_dst_sge in case %d.\n",
+					i + 1);
+				test_case->is_valid = false;
+				continue;
+			}
+
+			latency = rte_cfgfile_get_entry(cfgfile, section_name, "latency");
+			test_case->is_latency = (latency != NULL && atoi(latency) == 1);
+
 			kick_batch_str = rte_cfgfile_get_entry(cfgfile, section_name, "kick_batch");
 			args_nr = parse_entry(kick_batch_str, &test_case->kick_batch);
 			if (args_nr < 0) {
@@ -560,6 +700,28 @@ load_configs(const char *path)
 			}
 		}
 
+		nb_workers_str = rte_cfgfile_get_entry(cfgfile, section_name, "nb_workers");
+		if (nb_workers_str != NULL) {
+			struct test_configure_entry *nb_workers = &test_case->nb_workers;
+
+			args_nr = parse_entry(nb_workers_str, nb_workers);
+			if (args_nr < 0 || nb_workers->first == 0 ||
+			    RTE_MAX(nb_workers->first, nb_workers->last) >
+					test_case->lcore_dma_map.cnt) {
+				printf("nb_workers should be between 1 and the number of mapped lcores in case %d.\n",
+					i + 1);
+				test_case->is_valid = false;
+				continue;
+			} else if (args_nr == 4)
+				nb_vp++;
+		} else {
+			test_case->nb_workers.cur = test_case->lcore_dma_map.cnt;
+			test_case->nb_workers.first = test_case->lcore_dma_map.cnt;
+			test_case->nb_workers.last = 0;
+			test_case->nb_workers.incr = 0;
+			test_case->nb_workers.op = OP_NONE;
+		}
+
 		if (nb_vp > 1) {
 			printf("Case %d error, each section can only have a single variable parameter.\n",
 					i + 1);
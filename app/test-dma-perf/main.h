@@ -15,8 +15,15 @@
 
 #define MAX_DMA_NB 128
 
+#define MAX_BUF_SIZE_DIST_NB 64
+
 extern char output_str[MAX_WORKER_NB + 1][MAX_OUTPUT_STR_LEN];
 
+enum {
+	DMA_OP_COPY = 0,
+	DMA_OP_FILL
+};
+
 typedef enum {
 	OP_NONE = 0,
 	OP_ADD,
@@ -35,9 +42,18 @@ struct lcore_dma_map_t {
 	uint32_t lcores[MAX_WORKER_NB];
 	char dma_names[MAX_WORKER_NB][RTE_DEV_NAME_MAX_LEN];
 	int16_t dma_ids[MAX_WORKER_NB];
+	uint16_t vchan_ids[MAX_WORKER_NB];
 	uint16_t cnt;
 };
 
+/* Sizes of the operations and their weights, read from a distribution file. */
+struct buf_size_dist {
+	uint32_t sizes[MAX_BUF_SIZE_DIST_NB];
+	uint32_t weights[MAX_BUF_SIZE_DIST_NB];
+	uint64_t total_weight;
+	uint16_t nb;
+};
+
 struct test_vchan_dev_config {
 	struct rte_dma_port_param port;
 	uintptr_t raddr;
@@ -54,11 +70,15 @@ struct test_configure {
 	uint16_t opcode;
 	bool is_dma;
 	bool is_sg;
+	bool is_latency;
+	bool is_buf_size_dist;
 	struct lcore_dma_map_t lcore_dma_map;
 	struct test_configure_entry mem_size;
 	struct test_configure_entry buf_size;
 	struct test_configure_entry ring_size;
 	struct test_configure_entry kick_batch;
+	struct test_configure_entry nb_workers;
+	struct buf_size_dist buf_size_dist;
 	uint8_t nb_src_sges;
 	uint8_t nb_dst_sges;
 	uint8_t cache_flush;
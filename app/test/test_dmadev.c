@@ -4,8 +4,14 @@
  */
 
 #include <inttypes.h>
+#ifndef RTE_EXEC_ENV_WINDOWS
+#include <poll.h>
+#include <unistd.h>
+#endif
 
 #include <rte_dmadev.h>
+#include <rte_hash_crc.h>
+#include <rte_malloc.h>
 #include <rte_mbuf.h>
 #include <rte_pause.h>
 #include <rte_cycles.h>
@@ -898,6 +904,334 @@ test_enqueue_fill(int16_t dev_id, uint16_t vchan)
 	return 0;
 }
 
+static int
+test_enqueue_crc32c(int16_t dev_id, uint16_t vchan)
+{
+	const unsigned int lengths[] = {8, 64, 1024, 50, 100, 89};
+	struct rte_mbuf *src;
+	char *src_data;
+	uint32_t crc[2], expected, seed;
+	unsigned int i, half;
+
+	src = rte_pktmbuf_alloc(pool);
+	if (src == NULL)
+		ERR_RETURN("Failed to allocate mbuf\n");
+	src_data = rte_pktmbuf_mtod(src, char *);
+
+	/* check value of the CRC32C (iSCSI) algorithm */
+	memcpy(src_data, "123456789", 9);
+	if (rte_dma_crc32c(dev_id, vchan, rte_pktmbuf_iova(src), 9, 0, &crc[0],
+			RTE_DMA_OP_FLAG_SUBMIT) < 0)
+		ERR_RETURN("Error with rte_dma_crc32c\n");
+	await_hw(dev_id, vchan);
+	if (rte_dma_completed(dev_id, vchan, 1, NULL, NULL) != 1)
+		ERR_RETURN("Error: crc32c operation failed\n");
+	if (crc[0] != 0xE3069283)
+		ERR_RETURN("Error with crc32c of \"123456789\": got %x, not e3069283\n",
+				crc[0]);
+
+	for (i = 0; i < COPY_LEN; i++)
+		src_data[i] = rte_rand() & 0xFF;
+
+	for (i = 0; i < RTE_DIM(lengths); i++) {
+		expected = ~rte_hash_crc(src_data, lengths[i], 0xFFFFFFFF);
+
+		/* CRC of the whole buffer, and of its second half chained to the first */
+		half = lengths[i] / 2;
+		seed = ~rte_hash_crc(src_data, half, 0xFFFFFFFF);
+		if (rte_dma_crc32c(dev_id, vchan, rte_pktmbuf_iova(src), lengths[i], 0,
+				&crc[0], 0) < 0 ||
+				rte_dma_crc32c(dev_id, vchan, rte_pktmbuf_iova_offset(src, half),
+				lengths[i] - half, seed, &crc[1], RTE_DMA_OP_FLAG_SUBMIT) < 0)
+			ERR_RETURN("Error with rte_dma_crc32c\n");
+		await_hw(dev_id, vchan);
+
+		if (rte_dma_completed(dev_id, vchan, 2, NULL, NULL) != 2)
+			ERR_RETURN("Error: crc32c operation failed (length: %u)\n", lengths[i]);
+		if (crc[0] != expected || crc[1] != expected)
+			ERR_RETURN("Error with crc32c (length = %u): got (%x, %x), not (%x)\n",
+					lengths[i], crc[0], crc[1], expected);
+	}
+
+	rte_pktmbuf_free(src);
+	return 0;
+}
+
+static int
+test_enqueue_compare(int16_t dev_id, uint16_t vchan)
+{
+	const unsigned int lengths[] = {8, 64, 1024, 50, 100, 89};
+	uint64_t pattern = 0xfedcba9876543210;
+	struct rte_mbuf *src1, *src2;
+	char *src1_data, *src2_data;
+	uint32_t result[4];
+	unsigned int i, j;
+
+	src1 = rte_pktmbuf_alloc(pool);
+	src2 = rte_pktmbuf_alloc(pool);
+	if (src1 == NULL || src2 == NULL)
+		ERR_RETURN("Failed to allocate mbufs\n");
+	src1_data = rte_pktmbuf_mtod(src1, char *);
+	src2_data = rte_pktmbuf_mtod(src2, char *);
+
+	for (i = 0; i < RTE_DIM(lengths); i++) {
+		for (j = 0; j < lengths[i]; j++) {
+			src1_data[j] = ((char *)&pattern)[j % 8];
+			src2_data[j] = src1_data[j];
+		}
+		/* the second buffer differs only on its last byte */
+		src2_data[lengths[i] - 1]++;
+
+		memset(result, 0xFF, sizeof(result));
+		if (rte_dma_compare(dev_id, vchan, rte_pktmbuf_iova(src1),
+				rte_pktmbuf_iova(src1), lengths[i], &result[0], 0) < 0 ||
+				rte_dma_compare(dev_id, vchan, rte_pktmbuf_iova(src1),
+				rte_pktmbuf_iova(src2), lengths[i], &result[1], 0) < 0 ||
+				rte_dma_compare_pattern(dev_id, vchan, pattern,
+				rte_pktmbuf_iova(src1), lengths[i], &result[2], 0) < 0 ||
+				rte_dma_compare_pattern(dev_id, vchan, pattern,
+				rte_pktmbuf_iova(src2), lengths[i], &result[3],
+				RTE_DMA_OP_FLAG_SUBMIT) < 0)
+			ERR_RETURN("Error with rte_dma_compare\n");
+		await_hw(dev_id, vchan);
+
+		if (rte_dma_completed(dev_id, vchan, 4, NULL, NULL) != 4)
+			ERR_RETURN("Error: compare operation failed (length: %u)\n", lengths[i]);
+		if (result[0] != 0 || result[1] != 1 || result[2] != 0 || result[3] != 1)
+			ERR_RETURN("Error with compare (length = %u): got (%u, %u, %u, %u)\n",
+					lengths[i], result[0], result[1], result[2], result[3]);
+	}
+
+	rte_pktmbuf_free(src1);
+	rte_pktmbuf_free(src2);
+	return 0;
+}
+
+static int
+test_enqueue_dualcast(int16_t dev_id, uint16_t vchan)
+{
+	/* both destinations at the same offset in a page, as some devices require */
+	const size_t page_sz = 4096;
+	struct rte_mbuf *src;
+	char *src_data, *dst;
+	unsigned int i;
+	int ret = -1;
+
+	src = rte_pktmbuf_alloc(pool);
+	dst = rte_zmalloc(NULL, 2 * page_sz, page_sz);
+	if (src == NULL || dst == NULL) {
+		print_err(__func__, __LINE__, "Failed to allocate buffers\n");
+		goto out;
+	}
+	src_data = rte_pktmbuf_mtod(src, char *);
+	for (i = 0; i < COPY_LEN; i++)
+		src_data[i] = rte_rand() & 0xFF;
+
+	if (rte_dma_dualcast(dev_id, vchan, rte_pktmbuf_iova(src),
+			rte_malloc_virt2iova(dst), rte_malloc_virt2iova(dst + page_sz),
+			COPY_LEN, RTE_DMA_OP_FLAG_SUBMIT) < 0) {
+		print_err(__func__, __LINE__, "Error with rte_dma_dualcast\n");
+		goto out;
+	}
+	await_hw(dev_id, vchan);
+
+	if (rte_dma_completed(dev_id, vchan, 1, NULL, NULL) != 1) {
+		print_err(__func__, __LINE__, "Error: dualcast operation failed\n");
+		goto out;
+	}
+	if (memcmp(src_data, dst, COPY_LEN) != 0 ||
+			memcmp(src_data, dst + page_sz, COPY_LEN) != 0) {
+		print_err(__func__, __LINE__, "Error with dualcast, data mismatch\n");
+		goto out;
+	}
+	ret = 0;
+
+out:
+	rte_pktmbuf_free(src);
+	rte_free(dst);
+	return ret;
+}
+
+static int
+test_enqueue_dif(int16_t dev_id, uint16_t vchan)
+{
+#define DIF_TEST_BLOCKS 4
+	const struct rte_dma_dif_conf conf = {
+		.block_size = 512,
+		.ref_tag = 0x12345678,
+		.app_tag = 0xabcd,
+		.app_tag_mask = 0xffff,
+	};
+	const uint32_t data_len = DIF_TEST_BLOCKS * conf.block_size;
+	const uint32_t pi_len = DIF_TEST_BLOCKS * (conf.block_size + RTE_DMA_DIF_SIZE);
+	char *data, *protected, *stripped;
+	uint32_t result[3];
+	unsigned int i;
+	int ret = -1;
+
+	data = rte_zmalloc(NULL, data_len, RTE_CACHE_LINE_SIZE);
+	protected = rte_zmalloc(NULL, pi_len, RTE_CACHE_LINE_SIZE);
+	stripped = rte_zmalloc(NULL, data_len, RTE_CACHE_LINE_SIZE);
+	if (data == NULL || protected == NULL || stripped == NULL) {
+		print_err(__func__, __LINE__, "Failed to allocate buffers\n");
+		goto out;
+	}
+	for (i = 0; i < data_len; i++)
+		data[i] = rte_rand() & 0xFF;
+
+	/* insert protection information, then strip it back */
+	if (rte_dma_dif(dev_id, vchan, RTE_DMA_DIF_OP_INSERT, rte_malloc_virt2iova(data),
+			rte_malloc_virt2iova(protected), data_len, &conf, NULL,
+			RTE_DMA_OP_FLAG_SUBMIT) < 0) {
+		print_err(__func__, __LINE__, "Error with rte_dma_dif insert\n");
+		goto out;
+	}
+	await_hw(dev_id, vchan);
+	if (rte_dma_completed(dev_id, vchan, 1, NULL, NULL) != 1) {
+		print_err(__func__, __LINE__, "Error: dif insert operation failed\n");
+		goto out;
+	}
+
+	memset(result, 0xFF, sizeof(result));
+	if (rte_dma_dif(dev_id, vchan, RTE_DMA_DIF_OP_STRIP, rte_malloc_virt2iova(protected),
+			rte_malloc_virt2iova(stripped), pi_len, &conf, &result[0],
+			RTE_DMA_OP_FLAG_SUBMIT) < 0) {
+		print_err(__func__, __LINE__, "Error with rte_dma_dif strip\n");
+		goto out;
+	}
+	await_hw(dev_id, vchan);
+	if (rte_dma_completed(dev_id, vchan, 1, NULL, NULL) != 1) {
+		print_err(__func__, __LINE__, "Error: dif strip operation failed\n");
+		goto out;
+	}
+	if (result[0] != 0 || memcmp(data, stripped, data_len) != 0) {
+		print_err(__func__, __LINE__, "Error with dif strip, result %x\n", result[0]);
+		goto out;
+	}
+
+	/* corrupt data of the last block, then its reference tag */
+	protected[pi_len - RTE_DMA_DIF_SIZE - 1]++;
+	if (rte_dma_dif(dev_id, vchan, RTE_DMA_DIF_OP_CHECK, rte_malloc_virt2iova(protected),
+			0, pi_len, &conf, &result[1], RTE_DMA_OP_FLAG_SUBMIT) < 0) {
+		print_err(__func__, __LINE__, "Error with rte_dma_dif check\n");
+		goto out;
+	}
+	await_hw(dev_id, vchan);
+	protected[pi_len - RTE_DMA_DIF_SIZE - 1]--;
+	protected[pi_len - 1]++;
+	if (rte_dma_dif(dev_id, vchan, RTE_DMA_DIF_OP_CHECK, rte_malloc_virt2iova(protected),
+			0, pi_len, &conf, &result[2], RTE_DMA_OP_FLAG_SUBMIT) < 0) {
+		print_err(__func__, __LINE__, "Error with rte_dma_dif check\n");
+		goto out;
+	}
+	await_hw(dev_id, vchan);
+	if (rte_dma_completed(dev_id, vchan, 2, NULL, NULL) != 2) {
+		print_err(__func__, __LINE__, "Error: dif check operation failed\n");
+		goto out;
+	}
+	if (result[1] != RTE_DMA_DIF_ERR_GUARD || result[2] != RTE_DMA_DIF_ERR_REF_TAG) {
+		print_err(__func__, __LINE__, "Error with dif check, results %x %x\n",
+				result[1], result[2]);
+		goto out;
+	}
+	ret = 0;
+
+out:
+	rte_free(data);
+	rte_free(protected);
+	rte_free(stripped);
+	return ret;
+}
+
+#ifndef RTE_EXEC_ENV_WINDOWS
+/* wait for the completion fd to be signalled, and clear it */
+static int
+await_intr(int fd)
+{
+	struct pollfd pfd = { .fd = fd, .events = POLLIN };
+	uint64_t val;
+
+	if (poll(&pfd, 1, 1000) != 1)
+		return -1;
+	if (read(fd, &val, sizeof(val)) != sizeof(val))
+		return -1;
+	return 0;
+}
+
+static int
+test_completion_intr(int16_t dev_id, uint16_t vchan)
+{
+	struct rte_mbuf *src, *dst;
+	int fd, i, ret = -1;
+
+	fd = rte_dma_intr_fd_get(dev_id, vchan);
+	if (fd < 0)
+		ERR_RETURN("Error getting completion fd: %d\n", fd);
+
+	src = rte_pktmbuf_alloc(pool);
+	dst = rte_pktmbuf_alloc(pool);
+	if (src == NULL || dst == NULL) {
+		print_err(__func__, __LINE__, "Failed to allocate mbufs\n");
+		goto out;
+	}
+
+	/* ops completing while armed signal the fd */
+	if (rte_dma_intr_enable(dev_id, vchan) != 0) {
+		print_err(__func__, __LINE__, "Error arming completion notification\n");
+		goto out;
+	}
+	for (i = 0; i < 2; i++) {
+		if (rte_dma_copy(dev_id, vchan, rte_pktmbuf_iova(src), rte_pktmbuf_iova(dst),
+				COPY_LEN, RTE_DMA_OP_FLAG_SUBMIT) != id_count++) {
+			print_err(__func__, __LINE__, "Error with rte_dma_copy\n");
+			goto out;
+		}
+		if (await_intr(fd) != 0) {
+			print_err(__func__, __LINE__, "No notification for copy %d\n", i);
+			goto out;
+		}
+		await_hw(dev_id, vchan);
+		if (rte_dma_completed(dev_id, vchan, 1, NULL, NULL) != 1) {
+			print_err(__func__, __LINE__, "Error with rte_dma_completed\n");
+			goto out;
+		}
+	}
+
+	/* arming must not miss an op which completed while disarmed */
+	if (rte_dma_intr_disable(dev_id, vchan) != 0) {
+		print_err(__func__, __LINE__, "Error disarming completion notification\n");
+		goto out;
+	}
+	if (rte_dma_copy(dev_id, vchan, rte_pktmbuf_iova(src), rte_pktmbuf_iova(dst),
+			COPY_LEN, RTE_DMA_OP_FLAG_SUBMIT) != id_count++) {
+		print_err(__func__, __LINE__, "Error with rte_dma_copy\n");
+		goto out;
+	}
+	await_hw(dev_id, vchan);
+	if (rte_dma_intr_enable(dev_id, vchan) != 0 || await_intr(fd) != 0) {
+		print_err(__func__, __LINE__, "No notification for op done before arming\n");
+		goto out;
+	}
+	if (rte_dma_completed(dev_id, vchan, 1, NULL, NULL) != 1) {
+		print_err(__func__, __LINE__, "Error with rte_dma_completed\n");
+		goto out;
+	}
+	ret = 0;
+
+out:
+	rte_dma_intr_disable(dev_id, vchan);
+	rte_pktmbuf_free(src);
+	rte_pktmbuf_free(dst);
+	return ret;
+}
+#else
+static int
+test_completion_intr(int16_t dev_id __rte_unused, uint16_t vchan __rte_unused)
+{
+	return 0;
+}
+#endif
+
 static int
 test_burst_capacity(int16_t dev_id, uint16_t vchan)
 {
@@ -1110,6 +1444,80 @@ test_dmadev_fill_setup(void)
 	return ret;
 }
 
+static int
+test_dmadev_crc32c_setup(void)
+{
+	int ret = TEST_SUCCESS;
+
+	if ((info.dev_capa & RTE_DMA_CAPA_OPS_CRC32C) == 0) {
+		RTE_LOG(ERR, USER1,
+			"DMA Dev %u: No device crc32c support, skipping crc32c tests\n",
+			test_dev_id);
+		ret = TEST_SKIPPED;
+	}
+
+	return ret;
+}
+
+static int
+test_dmadev_compare_setup(void)
+{
+	int ret = TEST_SUCCESS;
+
+	if ((info.dev_capa & RTE_DMA_CAPA_OPS_COMPARE) == 0) {
+		RTE_LOG(ERR, USER1,
+			"DMA Dev %u: No device compare support, skipping compare tests\n",
+			test_dev_id);
+		ret = TEST_SKIPPED;
+	}
+
+	return ret;
+}
+
+static int
+test_dmadev_dualcast_setup(void)
+{
+	int ret = TEST_SUCCESS;
+
+	if ((info.dev_capa & RTE_DMA_CAPA_OPS_DUALCAST) == 0) {
+		RTE_LOG(ERR, USER1,
+			"DMA Dev %u: No device dualcast support, skipping dualcast tests\n",
+			test_dev_id);
+		ret = TEST_SKIPPED;
+	}
+
+	return ret;
+}
+
+static int
+test_dmadev_dif_setup(void)
+{
+	int ret = TEST_SUCCESS;
+
+	if ((info.dev_capa & RTE_DMA_CAPA_OPS_DIF) == 0) {
+		RTE_LOG(ERR, USER1,
+			"DMA Dev %u: No device dif support, skipping dif tests\n", test_dev_id);
+		ret = TEST_SKIPPED;
+	}
+
+	return ret;
+}
+
+static int
+test_dmadev_intr_setup(void)
+{
+	int ret = TEST_SUCCESS;
+
+	if ((info.dev_capa & RTE_DMA_CAPA_INTR) == 0) {
+		RTE_LOG(ERR, USER1,
+			"DMA Dev %u: No device interrupt support, skipping interrupt tests\n",
+			test_dev_id);
+		ret = TEST_SKIPPED;
+	}
+
+	return ret;
+}
+
 static int
 test_dmadev_autofree_setup(void)
 {
@@ -1206,6 +1614,11 @@ test_dmadev_instance(int16_t dev_id)
 		  TEST_BURST,
 		  TEST_ERR,
 		  TEST_FILL,
+		  TEST_CRC32C,
+		  TEST_COMPARE,
+		  TEST_DUALCAST,
+		  TEST_DIF,
+		  TEST_INTR,
 		  TEST_M2D,
 		  TEST_END
 	};
@@ -1217,6 +1630,11 @@ test_dmadev_instance(int16_t dev_id)
 		{"burst_capacity", test_burst_capacity, 1},
 		{"error_handling", test_completion_handling, 1},
 		{"fill", test_enqueue_fill, 1},
+		{"crc32c", test_enqueue_crc32c, 1},
+		{"compare", test_enqueue_compare, 1},
+		{"dualcast", test_enqueue_dualcast, 1},
+		{"dif", test_enqueue_dif, 1},
+		{"intr", test_completion_intr, 1},
 		{"m2d_auto_free", test_m2d_auto_free, 128},
 	};
 
@@ -1243,6 +1661,21 @@ test_dmadev_instance(int16_t dev_id)
 			TEST_CASE_NAMED_WITH_DATA("fill",
 				test_dmadev_fill_setup, NULL,
 				runtest, &param[TEST_FILL]),
+			TEST_CASE_NAMED_WITH_DATA("crc32c",
+				test_dmadev_crc32c_setup, NULL,
+				runtest, &param[TEST_CRC32C]),
+			TEST_CASE_NAMED_WITH_DATA("compare",
+				test_dmadev_compare_setup, NULL,
+				runtest, &param[TEST_COMPARE]),
+			TEST_CASE_NAMED_WITH_DATA("dualcast",
+				test_dmadev_dualcast_setup, NULL,
+				runtest, &param[TEST_DUALCAST]),
+			TEST_CASE_NAMED_WITH_DATA("dif",
+				test_dmadev_dif_setup, NULL,
+				runtest, &param[TEST_DIF]),
+			TEST_CASE_NAMED_WITH_DATA("intr",
+				test_dmadev_intr_setup, NULL,
+				runtest, &param[TEST_INTR]),
 			TEST_CASE_NAMED_WITH_DATA("m2d_autofree",
 				test_dmadev_autofree_setup, NULL,
 				runtest, &param[TEST_M2D]),
@@ -1312,6 +1745,8 @@ test_dma(void)
 
 	/* attempt to create skeleton instance - ignore errors due to one being already present*/
 	rte_vdev_init(pmd, NULL);
+	/* and one with several workers, completing out of order internally */
+	rte_vdev_init("dma_skeleton_mt", "workers=4");
 
 	if (rte_dma_count_avail() == 0)
 		return TEST_SKIPPED;
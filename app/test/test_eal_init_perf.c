@@ -0,0 +1,155 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#include <stdio.h>
+
+#include "test.h"
+
+#ifndef RTE_EXEC_ENV_LINUX
+
+static int
+test_eal_init_perf(void)
+{
+	printf("eal_init_perf only supported on Linux, skipping test\n");
+	return TEST_SKIPPED;
+}
+
+#else
+
+#include <stdbool.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <rte_common.h>
+#include <rte_debug.h>
+#include <rte_eal.h>
+
+#include "process.h"
+
+/*
+ * Measure how long it takes a process to start up with increasing amounts of
+ * hugepage memory, with pages faulted in by the main thread only, and by
+ * several threads using --huge-prefault.
+ */
+
+#define BASE_MEM_MB 64
+#define MAX_MEM_MB 8192
+
+static double
+get_time_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+/* free hugepage memory of default size, in megabytes */
+static unsigned int
+get_free_huge_mb(void)
+{
+	unsigned long nb_free = 0, page_kb = 0;
+	char line[128];
+	FILE *f;
+
+	f = fopen("/proc/meminfo", "r");
+	if (f == NULL)
+		return 0;
+	while (fgets(line, sizeof(line), f) != NULL) {
+		sscanf(line, "HugePages_Free: %lu", &nb_free);
+		sscanf(line, "Hugepagesize: %lu kB", &page_kb);
+	}
+	fclose(f);
+
+	return nb_free * page_kb / 1024;
+}
+
+/* start a process with `mem_mb` megabytes, returns time taken or negative */
+static double
+time_init(unsigned int mem_mb, bool legacy, bool prefault)
+{
+	char prefix[64];
+	char mem[32];
+	const char *argv[9];
+	int argc = 0;
+	double start;
+
+	/*
+	 * Own prefix and no shared config, so that the process neither depends
+	 * on nor leaves anything behind for other processes. --in-memory cannot
+	 * be used, as it does not go together with --legacy-mem.
+	 */
+	snprintf(prefix, sizeof(prefix), "--file-prefix=eal_init_perf_%d",
+		(int)getpid());
+	snprintf(mem, sizeof(mem), "-m%u", mem_mb);
+
+	argv[argc++] = prgname;
+	argv[argc++] = prefix;
+	argv[argc++] = "--no-shconf";
+	argv[argc++] = "--huge-unlink";
+	argv[argc++] = "--no-pci";
+	argv[argc++] = mem;
+	if (legacy)
+		argv[argc++] = "--legacy-mem";
+	if (prefault)
+		argv[argc++] = "--huge-prefault";
+
+	start = get_time_ms();
+	if (process_dup(argv, argc, "test_eal_init_perf") != 0) {
+		printf("Error - process did not start with %u MB%s\n", mem_mb,
+			prefault ? " and --huge-prefault" : "");
+		return -1;
+	}
+	return get_time_ms() - start;
+}
+
+static int
+test_init_mode_perf(bool legacy)
+{
+	double base[2], ms[2];
+	unsigned int mem_mb, max_mb, i;
+
+	printf("\n%s memory mode:\n", legacy ? "Legacy" : "Dynamic");
+	for (i = 0; i < 2; i++) {
+		base[i] = time_init(BASE_MEM_MB, legacy, i != 0);
+		if (base[i] < 0)
+			return -1;
+	}
+
+	/* only try amounts of memory there are free hugepages for */
+	max_mb = RTE_MIN(get_free_huge_mb(), (unsigned int)MAX_MEM_MB);
+	printf("%10s %18s %18s\n", "Memory", "Serial, ms/GB", "Parallel, ms/GB");
+	for (mem_mb = 1024; mem_mb <= max_mb; mem_mb *= 2) {
+		for (i = 0; i < 2; i++) {
+			ms[i] = time_init(mem_mb, legacy, i != 0);
+			if (ms[i] < 0)
+				return -1;
+		}
+		printf("%7u MB %18.1f %18.1f\n", mem_mb,
+			(ms[0] - base[0]) * 1024 / mem_mb,
+			(ms[1] - base[1]) * 1024 / mem_mb);
+	}
+
+	return 0;
+}
+
+static int
+test_eal_init_perf(void)
+{
+	if (!rte_eal_has_hugepages()) {
+		printf("No hugepages, skipping test\n");
+		return TEST_SKIPPED;
+	}
+
+	if (test_init_mode_perf(false) < 0)
+		return -1;
+	if (test_init_mode_perf(true) < 0)
+		return -1;
+
+	return 0;
+}
+
+#endif /* RTE_EXEC_ENV_LINUX */
+
+REGISTER_PERF_TEST(eal_init_perf_autotest, test_eal_init_perf);
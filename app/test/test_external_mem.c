@@ -29,6 +29,7 @@ test_external_mem(void)
 #include <rte_eal_paging.h>
 #include <rte_errno.h>
 #include <rte_malloc.h>
+#include <rte_mem_xlat.h>
 #include <rte_ring.h>
 #include <rte_string_fns.h>
 
@@ -68,6 +69,11 @@ check_mem(void *addr, rte_iova_t *iova, size_t pgsz, int n_pages)
 			printf("%s():%i: IOVA mismatch\n", __func__, __LINE__);
 			return -1;
 		}
+		if (rte_mem_xlat_virt2iova(cur) != expected_iova) {
+			printf("%s():%i: Translation table mismatch\n",
+				__func__, __LINE__);
+			return -1;
+		}
 	}
 	return 0;
 }
@@ -532,6 +538,13 @@ test_extmem_basic(void *addr, size_t len, size_t pgsz, rte_iova_t *iova,
 		goto fail;
 	}
 
+	/* translation must be gone along with the memory */
+	if (rte_mem_xlat_virt2iova(addr) != RTE_BAD_IOVA) {
+		printf("%s():%i: Stale translation after unregister\n",
+			__func__, __LINE__);
+		goto fail;
+	}
+
 	return 0;
 fail:
 	/* even if something failed, attempt to clean up */
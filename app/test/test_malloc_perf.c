@@ -6,6 +6,8 @@
 #include <string.h>
 #include <rte_cycles.h>
 #include <rte_errno.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
 #include <rte_malloc.h>
 #include <rte_memzone.h>
 
@@ -147,6 +149,117 @@ memzone_free(void *addr)
 	rte_memzone_free((struct rte_memzone *)addr);
 }
 
+/*
+ * Multi-core scaling of small allocations
+ * =======================================
+ *
+ * Each worker lcore allocates a batch of small objects of mixed size, frees
+ * them, and repeats. The aggregate rate shows how well rte_malloc() scales
+ * with the number of lcores contending for the same heap. Run with and
+ * without --malloc-lcore-cache to compare.
+ */
+
+#define SCALING_BATCH 64
+#define SCALING_ITERS 20000
+
+struct scaling_result {
+	uint64_t tsc;
+	int ret;
+};
+
+static struct scaling_result scaling_results[RTE_MAX_LCORE];
+static RTE_ATOMIC(uint32_t) synchro;
+
+static int
+scaling_worker(void *arg)
+{
+	static const size_t SIZES[] = { 64, 128, 256, 512 };
+	struct scaling_result *res = arg;
+	void *ptrs[SCALING_BATCH];
+	uint64_t tsc;
+	size_t i, j;
+
+	rte_wait_until_equal_32((uint32_t *)(uintptr_t)&synchro, 1,
+			rte_memory_order_relaxed);
+
+	tsc = rte_rdtsc_precise();
+	for (i = 0; i < SCALING_ITERS; i++) {
+		for (j = 0; j < SCALING_BATCH; j++) {
+			ptrs[j] = rte_malloc(NULL, SIZES[j % RTE_DIM(SIZES)], 0);
+			if (ptrs[j] == NULL)
+				break;
+		}
+		res->ret = j == SCALING_BATCH ? 0 : -1;
+		while (j-- != 0)
+			rte_free(ptrs[j]);
+		if (res->ret < 0)
+			return -1;
+	}
+	res->tsc = rte_rdtsc_precise() - tsc;
+
+	return 0;
+}
+
+static int
+test_alloc_scaling_perf(void)
+{
+	unsigned int lcore_id, n_workers, n, i;
+	uint64_t max_tsc;
+	double mops;
+	int ret = 0;
+
+	n_workers = rte_lcore_count() - 1;
+	TEST_LOG(INFO, "Performance: rte_malloc/rte_free scaling\n");
+	if (n_workers == 0) {
+		TEST_LOG(INFO, "No worker lcores, skipping\n\n");
+		return 0;
+	}
+
+	TEST_LOG(INFO, "%8s%16s%20s\n", "Lcores", "Total (Mops/s)",
+			"Per lcore (Mops/s)");
+	for (n = 1;; n = RTE_MIN(n * 2, n_workers)) {
+		rte_atomic_store_explicit(&synchro, 0, rte_memory_order_relaxed);
+
+		i = 0;
+		RTE_LCORE_FOREACH_WORKER(lcore_id) {
+			if (i++ == n)
+				break;
+			memset(&scaling_results[lcore_id], 0,
+					sizeof(scaling_results[lcore_id]));
+			rte_eal_remote_launch(scaling_worker,
+					&scaling_results[lcore_id], lcore_id);
+		}
+
+		rte_atomic_store_explicit(&synchro, 1, rte_memory_order_relaxed);
+
+		max_tsc = 0;
+		i = 0;
+		RTE_LCORE_FOREACH_WORKER(lcore_id) {
+			if (i++ == n)
+				break;
+			if (rte_eal_wait_lcore(lcore_id) < 0) {
+				TEST_LOG(ERR, "Allocation failed on lcore %u\n",
+						lcore_id);
+				ret = -1;
+			}
+			max_tsc = RTE_MAX(max_tsc, scaling_results[lcore_id].tsc);
+		}
+		if (ret < 0 || max_tsc == 0)
+			break;
+
+		/* each allocation is paired with a free */
+		mops = (double)n * SCALING_ITERS * SCALING_BATCH * 2 /
+				tsc_to_us(max_tsc, 1);
+		TEST_LOG(INFO, "%8u%16.2f%20.2f\n", n, mops, mops / n);
+
+		if (n == n_workers)
+			break;
+	}
+
+	TEST_LOG(INFO, "\n");
+	return ret;
+}
+
 static int
 test_malloc_perf(void)
 {
@@ -168,6 +281,9 @@ test_malloc_perf(void)
 			NULL, memset_us_gb, rte_memzone_max_get() - 1) < 0)
 		return -1;
 
+	if (test_alloc_scaling_perf() < 0)
+		return -1;
+
 	return 0;
 }
 
@@ -0,0 +1,175 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#include "test.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef RTE_EXEC_ENV_WINDOWS
+static int
+test_mem_xlat_perf(void)
+{
+	printf("mem_xlat_perf not supported on Windows, skipping test\n");
+	return TEST_SKIPPED;
+}
+
+#else
+
+#include <sys/mman.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_errno.h>
+#include <rte_mem_xlat.h>
+#include <rte_memory.h>
+#include <rte_random.h>
+
+/*
+ * IOVA to VA lookup performance
+ * =============================
+ *
+ * Register external memory made of N 4K pages with discontiguous IOVA, so
+ * that every page ends up being a separate range, and compare the IOVA index
+ * lookup with a walk over all memory segments (which is what
+ * rte_mem_iova2virt() used to do) for random IOVAs.
+ */
+
+#define PGSZ RTE_PGSIZE_4K
+#define IOVA_BASE (UINT64_C(1) << 40)
+#define N_LOOKUPS 4096
+#define MAX_WALK_LOOKUPS 4096u
+
+struct walk_arg {
+	rte_iova_t iova;
+	void *virt;
+};
+
+static int
+find_virt(const struct rte_memseg_list *msl __rte_unused,
+		const struct rte_memseg *ms, void *arg)
+{
+	struct walk_arg *wa = arg;
+
+	if (wa->iova >= ms->iova && wa->iova < ms->iova + ms->len) {
+		wa->virt = RTE_PTR_ADD(ms->addr, wa->iova - ms->iova);
+		return 1;
+	}
+	return 0;
+}
+
+static void *
+walk_iova2virt(rte_iova_t iova)
+{
+	struct walk_arg wa = { .iova = iova, .virt = NULL };
+
+	rte_memseg_walk(find_virt, &wa);
+	return wa.virt;
+}
+
+static int
+test_iova2virt_perf(unsigned int n_pages)
+{
+	unsigned int i, n_walk;
+	size_t len = (size_t)n_pages * PGSZ;
+	rte_iova_t *iova, *lookups;
+	uint64_t idx_tsc, walk_tsc;
+	int ret = -1;
+	void *addr;
+
+	iova = malloc(n_pages * sizeof(*iova));
+	lookups = malloc(N_LOOKUPS * sizeof(*lookups));
+	if (iova == NULL || lookups == NULL) {
+		printf("Cannot allocate IOVA tables\n");
+		goto free_tables;
+	}
+
+	/* nothing is going to touch this memory, so don't reserve it */
+	addr = mmap(NULL, len, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (addr == MAP_FAILED) {
+		printf("Cannot reserve %zu bytes of VA space\n", len);
+		goto free_tables;
+	}
+
+	/* leave a hole after every page so that nothing gets merged */
+	for (i = 0; i < n_pages; i++)
+		iova[i] = IOVA_BASE + (rte_iova_t)i * 2 * PGSZ;
+	for (i = 0; i < N_LOOKUPS; i++)
+		lookups[i] = iova[rte_rand_max(n_pages)] + rte_rand_max(PGSZ);
+
+	if (rte_extmem_register(addr, len, iova, n_pages, PGSZ) != 0) {
+		printf("Cannot register external memory: %s\n",
+				rte_strerror(rte_errno));
+		goto unmap;
+	}
+
+	idx_tsc = rte_rdtsc_precise();
+	for (i = 0; i < N_LOOKUPS; i++)
+		if (rte_mem_xlat_iova2virt(lookups[i]) == NULL)
+			break;
+	idx_tsc = rte_rdtsc_precise() - idx_tsc;
+	if (i != N_LOOKUPS) {
+		printf("IOVA 0x%" PRIx64 " not found in index\n", lookups[i]);
+		goto unregister;
+	}
+
+	/* walking is slow, keep total run time in check */
+	n_walk = RTE_MIN(MAX_WALK_LOOKUPS, RTE_MAX(16u, (1u << 24) / n_pages));
+	walk_tsc = rte_rdtsc_precise();
+	for (i = 0; i < n_walk; i++)
+		if (walk_iova2virt(lookups[i]) == NULL)
+			break;
+	walk_tsc = rte_rdtsc_precise() - walk_tsc;
+	if (i != n_walk) {
+		printf("IOVA 0x%" PRIx64 " not found by walk\n", lookups[i]);
+		goto unregister;
+	}
+
+	/* both methods must agree */
+	for (i = 0; i < n_walk; i++) {
+		if (rte_mem_xlat_iova2virt(lookups[i]) !=
+				walk_iova2virt(lookups[i])) {
+			printf("Lookup mismatch for IOVA 0x%" PRIx64 "\n",
+					lookups[i]);
+			goto unregister;
+		}
+	}
+
+	printf("%10u %16.1f %16.1f %10.1fx\n", n_pages,
+			(double)idx_tsc / N_LOOKUPS,
+			(double)walk_tsc / n_walk,
+			((double)walk_tsc / n_walk) /
+			((double)idx_tsc / N_LOOKUPS));
+	ret = 0;
+
+unregister:
+	rte_extmem_unregister(addr, len);
+unmap:
+	munmap(addr, len);
+free_tables:
+	free(lookups);
+	free(iova);
+	return ret;
+}
+
+static int
+test_mem_xlat_perf(void)
+{
+	static const unsigned int n_pages[] = { 1 << 10, 1 << 16, 1 << 20 };
+	unsigned int i;
+
+	printf("%10s %16s %16s %11s\n", "Segments", "Index (cycles)",
+			"Walk (cycles)", "Speedup");
+	for (i = 0; i < RTE_DIM(n_pages); i++)
+		if (test_iova2virt_perf(n_pages[i]) < 0)
+			return TEST_FAILED;
+
+	return TEST_SUCCESS;
+}
+
+#endif /* !RTE_EXEC_ENV_WINDOWS */
+
+REGISTER_PERF_TEST(mem_xlat_perf_autotest, test_mem_xlat_perf);
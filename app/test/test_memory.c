@@ -4,9 +4,11 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <inttypes.h>
 
 #include <rte_eal.h>
 #include <rte_errno.h>
+#include <rte_mem_xlat.h>
 #include <rte_memory.h>
 #include <rte_common.h>
 #include <rte_memzone.h>
@@ -23,6 +25,8 @@
  * - Check that memory size is different than 0.
  *
  * - Try to read all memory; it should not segfault.
+ *
+ * - Check that the translation table agrees with the IOVA of all memsegs.
  */
 
 /*
@@ -75,6 +79,32 @@ check_seg_fds(const struct rte_memseg_list *msl, const struct rte_memseg *ms,
 	return 0;
 }
 
+static int
+check_xlat(const struct rte_memseg_list *msl __rte_unused,
+		const struct rte_memseg *ms, void *arg __rte_unused)
+{
+	const size_t offsets[] = { 0, 1, RTE_PGSIZE_4K, ms->len / 2, ms->len - 1 };
+	unsigned int i;
+
+	for (i = 0; i < RTE_DIM(offsets); i++) {
+		const void *addr = RTE_PTR_ADD(ms->addr, offsets[i]);
+		rte_iova_t expected, iova;
+
+		if (offsets[i] >= ms->len)
+			continue;
+		expected = ms->iova == RTE_BAD_IOVA ?
+				RTE_BAD_IOVA : ms->iova + offsets[i];
+		iova = rte_mem_xlat_virt2iova(addr);
+		if (iova != expected) {
+			printf("Translation mismatch for %p: got 0x%" PRIx64
+				", expected 0x%" PRIx64 "\n",
+				addr, iova, expected);
+			return -1;
+		}
+	}
+	return 0;
+}
+
 static int
 test_memory(void)
 {
@@ -107,6 +137,12 @@ test_memory(void)
 		return -1;
 	}
 
+	/* check address translation table */
+	if (rte_memseg_walk(check_xlat, NULL) != 0) {
+		printf("Error checking address translation table\n");
+		return -1;
+	}
+
 	return 0;
 }
 
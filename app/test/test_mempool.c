@@ -848,6 +848,7 @@ test_mempool(void)
 	struct rte_mempool *mp_stack_anon = NULL;
 	struct rte_mempool *mp_stack_mempool_iter = NULL;
 	struct rte_mempool *mp_stack = NULL;
+	struct rte_mempool *mp_numa = NULL;
 	struct rte_mempool *default_pool = NULL;
 	struct mp_data cb_arg = {
 		.ret = -1
@@ -944,6 +945,27 @@ test_mempool(void)
 	}
 	rte_mempool_obj_iter(mp_stack, my_obj_init, NULL);
 
+	/* create a mempool with the NUMA handler */
+	mp_numa = rte_mempool_create_empty("test_numa",
+		MEMPOOL_SIZE,
+		MEMPOOL_ELT_SIZE,
+		0, 0,
+		SOCKET_ID_ANY, 0);
+
+	if (mp_numa == NULL) {
+		printf("cannot allocate mp_numa mempool\n");
+		GOTO_ERR(ret, err);
+	}
+	if (rte_mempool_set_ops_byname(mp_numa, "numa", NULL) < 0) {
+		printf("cannot set numa handler\n");
+		GOTO_ERR(ret, err);
+	}
+	if (rte_mempool_populate_default(mp_numa) < 0) {
+		printf("cannot populate mp_numa mempool\n");
+		GOTO_ERR(ret, err);
+	}
+	rte_mempool_obj_iter(mp_numa, my_obj_init, NULL);
+
 	/* Create a mempool based on Default handler */
 	printf("Testing %s mempool handler\n", default_pool_ops);
 	default_pool = rte_mempool_create_empty("default_pool",
@@ -1011,6 +1033,13 @@ test_mempool(void)
 	if (test_mempool_basic(mp_stack, 1) < 0)
 		GOTO_ERR(ret, err);
 
+	/* test the NUMA handler, emptying all the shards */
+	if (test_mempool_basic(mp_numa, 1) < 0)
+		GOTO_ERR(ret, err);
+
+	if (test_mempool_basic_ex(mp_numa) < 0)
+		GOTO_ERR(ret, err);
+
 	if (test_mempool_basic(default_pool, 1) < 0)
 		GOTO_ERR(ret, err);
 
@@ -1038,6 +1067,7 @@ test_mempool(void)
 	rte_mempool_free(mp_stack_anon);
 	rte_mempool_free(mp_stack_mempool_iter);
 	rte_mempool_free(mp_stack);
+	rte_mempool_free(mp_numa);
 	rte_mempool_free(default_pool);
 
 	return ret;
@@ -0,0 +1,197 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_eal.h>
+#include <rte_memory.h>
+#include <rte_mempool.h>
+#include <rte_mempool_bucket.h>
+
+#include "test.h"
+
+/*
+ * Bucket mempool performance
+ * ==========================
+ *
+ *    Compare the bucket and ring mempool drivers for objects of storage
+ *    buffer sizes, from 4KB to 128KB, without cache so that the drivers
+ *    are measured:
+ *
+ *    - get and put of BURST objects,
+ *    - get of as many objects as a bucket holds, which the bucket driver
+ *      returns as one physically contiguous block, and put of them.
+ *
+ *    Buckets are 2MB when hugepages allow it, else of default size.
+ */
+
+#define BENCH_MEM_SIZE (64 << 20)
+#define BENCH_MIN_OBJS 256
+#define BENCH_MAX_OBJS 16384
+#define BENCH_ITERS 100000
+#define BURST 8
+
+static const unsigned int elt_sizes[] = { 4096, 16384, 65536, 131072 };
+
+static struct rte_mempool *
+bench_pool_create(const char *ops, unsigned int elt_size, unsigned int n,
+		  const struct rte_mempool_bucket_config *cfg)
+{
+	char name[RTE_MEMPOOL_NAMESIZE];
+	struct rte_mempool *mp;
+
+	snprintf(name, sizeof(name), "perf_%s_%u", ops, elt_size);
+	mp = rte_mempool_create_empty(name, n, elt_size, 0, 0,
+				      SOCKET_ID_ANY, 0);
+	if (mp == NULL)
+		return NULL;
+
+	if (rte_mempool_set_ops_byname(mp, ops, (void *)(uintptr_t)cfg) < 0 ||
+	    rte_mempool_populate_default(mp) != (int)n) {
+		rte_mempool_free(mp);
+		return NULL;
+	}
+
+	return mp;
+}
+
+/* get and put BURST objects, returns cycles per object */
+static int
+bench_burst(struct rte_mempool *mp, double *cycles)
+{
+	void *objs[BURST];
+	uint64_t start;
+	unsigned int i;
+
+	start = rte_rdtsc_precise();
+	for (i = 0; i < BENCH_ITERS; i++) {
+		if (rte_mempool_get_bulk(mp, objs, BURST) < 0)
+			return -1;
+		rte_mempool_put_bulk(mp, objs, BURST);
+	}
+	*cycles = (double)(rte_rdtsc_precise() - start) /
+		((double)BENCH_ITERS * BURST);
+
+	return 0;
+}
+
+/*
+ * get and put the objects of one bucket, as a contiguous block if the
+ * driver supports it, returns cycles per block
+ */
+static int
+bench_block(struct rte_mempool *mp, unsigned int block_size, int contig,
+	    void **objs, double *cycles)
+{
+	size_t stride = mp->header_size + mp->elt_size + mp->trailer_size;
+	unsigned int iters = BENCH_ITERS / 10;
+	uint64_t start;
+	unsigned int i, j;
+
+	start = rte_rdtsc_precise();
+	for (i = 0; i < iters; i++) {
+		if (contig) {
+			if (rte_mempool_get_contig_blocks(mp, objs, 1) < 0)
+				return -1;
+			for (j = 1; j < block_size; j++)
+				objs[j] = RTE_PTR_ADD(objs[0], j * stride);
+		} else if (rte_mempool_get_bulk(mp, objs, block_size) < 0) {
+			return -1;
+		}
+		rte_mempool_put_bulk(mp, objs, block_size);
+	}
+	*cycles = (double)(rte_rdtsc_precise() - start) / iters;
+
+	return 0;
+}
+
+static int
+bench_one_size(unsigned int elt_size,
+	       const struct rte_mempool_bucket_config *cfg)
+{
+	struct rte_mempool *ring_mp = NULL, *bucket_mp = NULL;
+	struct rte_mempool_info info;
+	double ring_burst, bucket_burst, ring_block, bucket_block;
+	void **objs = NULL;
+	unsigned int n;
+	int ret = -1;
+
+	n = RTE_MAX(RTE_MIN(BENCH_MEM_SIZE / elt_size,
+			    (unsigned int)BENCH_MAX_OBJS),
+		    (unsigned int)BENCH_MIN_OBJS);
+
+	ring_mp = bench_pool_create("ring_mp_mc", elt_size, n, NULL);
+	bucket_mp = bench_pool_create("bucket", elt_size, n, cfg);
+	if (ring_mp == NULL || bucket_mp == NULL) {
+		printf("elt_size=%u: cannot create mempools, skipped\n",
+		       elt_size);
+		ret = 0;
+		goto out;
+	}
+
+	if (rte_mempool_ops_get_info(bucket_mp, &info) < 0 ||
+	    info.contig_block_size == 0 || info.contig_block_size > n)
+		goto out;
+
+	objs = calloc(info.contig_block_size, sizeof(*objs));
+	if (objs == NULL)
+		goto out;
+
+	if (bench_burst(ring_mp, &ring_burst) < 0 ||
+	    bench_burst(bucket_mp, &bucket_burst) < 0 ||
+	    bench_block(ring_mp, info.contig_block_size, 0, objs,
+			&ring_block) < 0 ||
+	    bench_block(bucket_mp, info.contig_block_size, 1, objs,
+			&bucket_block) < 0) {
+		printf("elt_size=%u: mempool ran out of objects\n", elt_size);
+		goto out;
+	}
+
+	printf("elt_size=%u n=%u objs_per_bucket=%u "
+	       "burst_cycles_per_obj: ring=%.1f bucket=%.1f "
+	       "block_cycles: ring=%.1f bucket_contig=%.1f\n",
+	       elt_size, n, info.contig_block_size,
+	       ring_burst, bucket_burst, ring_block, bucket_block);
+
+	/* all the objects must be back */
+	if (!rte_mempool_full(ring_mp) || !rte_mempool_full(bucket_mp)) {
+		printf("elt_size=%u: objects were lost\n", elt_size);
+		goto out;
+	}
+
+	ret = 0;
+
+out:
+	free(objs);
+	rte_mempool_free(ring_mp);
+	rte_mempool_free(bucket_mp);
+	return ret;
+}
+
+static int
+test_mempool_bucket_perf(void)
+{
+	struct rte_mempool_bucket_config cfg;
+	unsigned int i;
+
+	memset(&cfg, 0, sizeof(cfg));
+	if (rte_eal_has_hugepages())
+		cfg.bucket_size = RTE_PGSIZE_2M;
+
+	printf("bucket_size=%zu (0 is default)\n", cfg.bucket_size);
+
+	for (i = 0; i < RTE_DIM(elt_sizes); i++) {
+		if (bench_one_size(elt_sizes[i], &cfg) < 0)
+			return TEST_FAILED;
+	}
+
+	return TEST_SUCCESS;
+}
+
+REGISTER_PERF_TEST(mempool_bucket_perf_autotest, test_mempool_bucket_perf);
@@ -23,6 +23,7 @@
 #include <rte_lcore.h>
 #include <rte_branch_prediction.h>
 #include <rte_mempool.h>
+#include <rte_ring.h>
 #include <rte_spinlock.h>
 #include <rte_malloc.h>
 #include <rte_mbuf_pool_ops.h>
@@ -63,6 +64,15 @@
  *      - 32
  *      - 128
  *      - 512
+ *
+ *    Then, objects are allocated on one core and freed on another during
+ *    TIME_S seconds, with a fixed size cache, with an adaptive cache, and
+ *    with an adaptive cache where the objects are put back into the cache
+ *    of the allocating core. The adaptive caches of both cores must grow.
+ *
+ *    Finally, on one core, objects are got into and put from a table
+ *    standing for the descriptors of a device ring, per burst of 32 to 512
+ *    objects, with the copying and with the zero-copy cache API.
  */
 
 #define N 65536
@@ -71,6 +81,13 @@
 #define MAX_KEEP 512
 #define MEMPOOL_SIZE ((rte_lcore_count()*(MAX_KEEP+RTE_MEMPOOL_CACHE_MAX_SIZE))-1)
 
+/* Cache size and bulk size of the pipeline test */
+#define PIPELINE_CACHE_SIZE 64
+#define PIPELINE_BULK 32
+
+/* Objects got and put per burst size of the zero-copy test */
+#define ZC_OBJS (1 << 26)
+
 /* Number of pointers fitting into one cache line. */
 #define CACHE_LINE_BURST (RTE_CACHE_LINE_SIZE / sizeof(uintptr_t))
 
@@ -107,6 +124,12 @@ struct mempool_test_stats {
 
 static struct mempool_test_stats stats[RTE_MAX_LCORE];
 
+/* objects sent from the allocating core to the freeing core */
+static struct rte_ring *pipeline_ring;
+static unsigned int pipeline_alloc_lcore;
+static int pipeline_return;
+static RTE_ATOMIC(uint32_t) pipeline_quit;
+
 /*
  * save the object number in the first 4 bytes of object data. All
  * other bytes are set to 0.
@@ -322,12 +345,195 @@ do_one_mempool_test(struct rte_mempool *mp, unsigned int cores)
 	return 0;
 }
 
+/* free the objects sent by the allocating core */
+static int
+pipeline_free_lcore(void *arg)
+{
+	struct rte_mempool *mp = arg;
+	void *obj_table[PIPELINE_BULK];
+	unsigned int n;
+
+	for (;;) {
+		n = rte_ring_sc_dequeue_burst(pipeline_ring, obj_table,
+					      PIPELINE_BULK, NULL);
+		if (n == 0) {
+			if (rte_atomic_load_explicit(&pipeline_quit,
+					rte_memory_order_acquire) &&
+			    rte_ring_empty(pipeline_ring))
+				break;
+			rte_pause();
+			continue;
+		}
+
+		if (pipeline_return)
+			rte_mempool_put_bulk_to_lcore(mp, obj_table, n,
+						      pipeline_alloc_lcore);
+		else
+			rte_mempool_put_bulk(mp, obj_table, n);
+	}
+
+	return 0;
+}
+
+/* allocate objects on the main core and free them on a worker core */
+static int
+pipeline_test(struct rte_mempool *mp, int return_to_origin)
+{
+	void *obj_table[PIPELINE_BULK];
+	struct rte_mempool_cache *alloc_cache, *free_cache;
+	uint64_t start_cycles, time_diff = 0, hz = rte_get_timer_hz();
+	uint64_t count = 0;
+	unsigned int lcore_id;
+	unsigned int i;
+	int adaptive = (mp->flags & RTE_MEMPOOL_F_ADAPTIVE_CACHE) != 0;
+	int ret = 0;
+
+	pipeline_alloc_lcore = rte_lcore_id();
+	pipeline_return = return_to_origin;
+	lcore_id = rte_get_next_lcore(-1, 1, 0);
+
+	printf("mempool_autotest pipeline cache=%u adaptive=%d "
+	       "return_to_origin=%d ", mp->cache_size, adaptive,
+	       return_to_origin);
+
+	if (rte_mempool_avail_count(mp) != MEMPOOL_SIZE) {
+		printf("mempool is not full\n");
+		return -1;
+	}
+
+	rte_atomic_store_explicit(&pipeline_quit, 0, rte_memory_order_relaxed);
+	if (rte_eal_remote_launch(pipeline_free_lcore, mp, lcore_id) < 0)
+		RET_ERR();
+
+	start_cycles = rte_get_timer_cycles();
+	while (time_diff / hz < TIME_S) {
+		for (i = 0; i < N / PIPELINE_BULK; i++) {
+			/* the pool may be held by the caches and the ring */
+			if (rte_mempool_get_bulk(mp, obj_table,
+						 PIPELINE_BULK) < 0)
+				continue;
+			while (rte_ring_sp_enqueue_bulk(pipeline_ring,
+					obj_table, PIPELINE_BULK, NULL) == 0)
+				rte_pause();
+			count += PIPELINE_BULK;
+		}
+		time_diff = rte_get_timer_cycles() - start_cycles;
+	}
+
+	rte_atomic_store_explicit(&pipeline_quit, 1, rte_memory_order_release);
+	if (rte_eal_wait_lcore(lcore_id) < 0)
+		RET_ERR();
+
+	alloc_cache = rte_mempool_default_cache(mp, pipeline_alloc_lcore);
+	free_cache = rte_mempool_default_cache(mp, lcore_id);
+	printf("rate_persec=%" PRIu64 " alloc_cache_size=%u "
+	       "free_cache_size=%u\n", count / TIME_S,
+	       alloc_cache->size, free_cache->size);
+
+	/* the allocating core always misses, the freeing one always flushes */
+	if (adaptive && !return_to_origin &&
+	    (alloc_cache->size <= mp->cache_size ||
+	     free_cache->size <= mp->cache_size)) {
+		printf("adaptive caches did not grow\n");
+		ret = -1;
+	}
+
+	/* no object may be lost in the caches of other cores */
+	if (rte_mempool_avail_count(mp) != MEMPOOL_SIZE) {
+		printf("mempool is not full\n");
+		ret = -1;
+	}
+
+	return ret;
+}
+
+/* get objects into a descriptor table and put them back, per burst */
+static int
+zc_burst_test(struct rte_mempool *mp, unsigned int burst, int zc,
+	      uint64_t *cycles)
+{
+	struct rte_mempool_cache *cache;
+	void *obj_table[MAX_KEEP];
+	void *desc[MAX_KEEP];
+	void **cache_objs;
+	uint64_t start;
+	unsigned int i, j;
+
+	cache = rte_mempool_default_cache(mp, rte_lcore_id());
+	if (cache == NULL)
+		RET_ERR();
+
+	start = rte_rdtsc_precise();
+	for (i = 0; i < ZC_OBJS / burst; i++) {
+		if (zc) {
+			cache_objs = rte_mempool_cache_zc_get_start(cache, mp,
+								    burst);
+			if (cache_objs == NULL)
+				RET_ERR();
+			for (j = 0; j < burst; j++)
+				desc[j] = cache_objs[j];
+			rte_mempool_cache_zc_get_finish(cache, mp, burst);
+
+			cache_objs = rte_mempool_cache_zc_put_start(cache, mp,
+								    burst);
+			if (cache_objs == NULL)
+				RET_ERR();
+			for (j = 0; j < burst; j++)
+				cache_objs[j] = desc[j];
+			rte_mempool_cache_zc_put_finish(cache, mp, burst);
+		} else {
+			if (rte_mempool_generic_get(mp, obj_table, burst,
+						    cache) < 0)
+				RET_ERR();
+			for (j = 0; j < burst; j++)
+				desc[j] = obj_table[j];
+
+			for (j = 0; j < burst; j++)
+				obj_table[j] = desc[j];
+			rte_mempool_generic_put(mp, obj_table, burst, cache);
+		}
+	}
+	*cycles = rte_rdtsc_precise() - start;
+
+	return 0;
+}
+
+/* compare the copying and the zero-copy cache API */
+static int
+zc_test(struct rte_mempool *mp)
+{
+	static const unsigned int bursts[] = { 32, 64, 128, 256, 512 };
+	uint64_t copy_cycles, zc_cycles;
+	unsigned int i;
+
+	for (i = 0; i < RTE_DIM(bursts); i++) {
+		if (zc_burst_test(mp, bursts[i], 0, &copy_cycles) < 0 ||
+		    zc_burst_test(mp, bursts[i], 1, &zc_cycles) < 0)
+			return -1;
+
+		printf("mempool_autotest cache=%u burst=%u "
+		       "cycles_per_obj: copy=%.2f zero_copy=%.2f\n",
+		       mp->cache_size, bursts[i],
+		       (double)copy_cycles / ZC_OBJS,
+		       (double)zc_cycles / ZC_OBJS);
+	}
+
+	if (rte_mempool_avail_count(mp) != MEMPOOL_SIZE) {
+		printf("mempool is not full\n");
+		return -1;
+	}
+
+	return 0;
+}
+
 static int
 test_mempool_perf(void)
 {
 	struct rte_mempool *mp_cache = NULL;
 	struct rte_mempool *mp_nocache = NULL;
 	struct rte_mempool *default_pool = NULL;
+	struct rte_mempool *mp_fixed = NULL;
+	struct rte_mempool *mp_adaptive = NULL;
 	const char *default_pool_ops;
 	int ret = -1;
 
@@ -426,6 +632,54 @@ test_mempool_perf(void)
 	if (do_one_mempool_test(mp_nocache, rte_lcore_count()) < 0)
 		goto err;
 
+	use_external_cache = 0;
+
+	printf("start zero-copy cache test\n");
+
+	if (zc_test(mp_cache) < 0)
+		goto err;
+
+	if (rte_lcore_count() < 2) {
+		printf("not enough lcores for pipeline test\n");
+		goto dump;
+	}
+
+	/* create mempools with fixed and adaptive caches of the same size */
+	mp_fixed = rte_mempool_create("perf_test_fixed", MEMPOOL_SIZE,
+				      MEMPOOL_ELT_SIZE, PIPELINE_CACHE_SIZE, 0,
+				      NULL, NULL,
+				      my_obj_init, NULL,
+				      SOCKET_ID_ANY, 0);
+	if (mp_fixed == NULL)
+		goto err;
+
+	mp_adaptive = rte_mempool_create("perf_test_adaptive", MEMPOOL_SIZE,
+					 MEMPOOL_ELT_SIZE, PIPELINE_CACHE_SIZE,
+					 0, NULL, NULL,
+					 my_obj_init, NULL,
+					 SOCKET_ID_ANY,
+					 RTE_MEMPOOL_F_ADAPTIVE_CACHE);
+	if (mp_adaptive == NULL)
+		goto err;
+
+	pipeline_ring = rte_ring_create("perf_test_pipeline", 512,
+					SOCKET_ID_ANY,
+					RING_F_SP_ENQ | RING_F_SC_DEQ);
+	if (pipeline_ring == NULL)
+		goto err;
+
+	printf("start pipeline test (fixed and adaptive cache)\n");
+
+	if (pipeline_test(mp_fixed, 0) < 0)
+		goto err;
+
+	if (pipeline_test(mp_adaptive, 0) < 0)
+		goto err;
+
+	if (pipeline_test(mp_adaptive, 1) < 0)
+		goto err;
+
+dump:
 	rte_mempool_list_dump(stdout);
 
 	ret = 0;
@@ -434,6 +688,10 @@ test_mempool_perf(void)
 	rte_mempool_free(mp_cache);
 	rte_mempool_free(mp_nocache);
 	rte_mempool_free(default_pool);
+	rte_mempool_free(mp_fixed);
+	rte_mempool_free(mp_adaptive);
+	rte_ring_free(pipeline_ring);
+	pipeline_ring = NULL;
 	return ret;
 }
 
@@ -0,0 +1,35 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+/* SEQ rings also store a sequence number per element */
+#define _st_ring_memsize(num)	\
+	rte_ring_get_memsize_elem_flags(sizeof(uintptr_t), num, RING_F_MPMC_SEQ)
+
+#include "test_ring_stress_impl.h"
+
+static inline uint32_t
+_st_ring_dequeue_bulk(struct rte_ring *r, void **obj, uint32_t n,
+	uint32_t *avail)
+{
+	return rte_ring_mc_seq_dequeue_bulk(r, obj, n, avail);
+}
+
+static inline uint32_t
+_st_ring_enqueue_bulk(struct rte_ring *r, void * const *obj, uint32_t n,
+	uint32_t *free)
+{
+	return rte_ring_mp_seq_enqueue_bulk(r, obj, n, free);
+}
+
+static int
+_st_ring_init(struct rte_ring *r, const char *name, uint32_t num)
+{
+	return rte_ring_init(r, name, num, RING_F_MPMC_SEQ);
+}
+
+const struct test test_ring_seq_stress = {
+	.name = "MT_SEQ",
+	.nb_case = RTE_DIM(tests),
+	.cases = tests,
+};
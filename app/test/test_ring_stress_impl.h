@@ -64,6 +64,11 @@ _st_ring_enqueue_bulk(struct rte_ring *r, void * const *obj, uint32_t n,
 static int
 _st_ring_init(struct rte_ring *r, const char *name, uint32_t num);
 
+/* memory needed by the ring, can be overridden before inclusion */
+#ifndef _st_ring_memsize
+#define _st_ring_memsize(num)	rte_ring_get_memsize(num)
+#endif
+
 
 static void
 lcore_stat_update(struct lcore_stat *ls, uint64_t call, uint64_t obj,
@@ -298,7 +303,7 @@ mt1_init(struct rte_ring **rng, void **data, uint32_t num)
 
 	/* alloc ring */
 	nr = 2 * num;
-	sz = rte_ring_get_memsize(nr);
+	sz = _st_ring_memsize(nr);
 	r = rte_zmalloc(NULL, sz, alignof(typeof(*r)));
 	if (r == NULL) {
 		printf("%s: alloc(%zu) for FIFO with %u elems failed",
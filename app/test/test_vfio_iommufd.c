@@ -0,0 +1,389 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#include <stdio.h>
+
+#include "test.h"
+
+#ifndef RTE_EXEC_ENV_LINUX
+
+static int
+test_vfio_iommufd(void)
+{
+	printf("vfio_iommufd not supported on this platform, skipping test\n");
+	return TEST_SKIPPED;
+}
+
+#else
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+
+#include <rte_common.h>
+#include <rte_eal.h>
+#include <rte_eal_paging.h>
+#include <rte_errno.h>
+#include <rte_malloc.h>
+#include <rte_memory.h>
+#include <rte_vfio.h>
+
+/*
+ * Check iommufd DMA mapping against the mock devices of the iommufd selftest
+ * (CONFIG_IOMMUFD_TEST), which let userspace look up what a hardware page
+ * table would contain:
+ *
+ * - Create an IOAS and attach two mock devices to it.
+ * - Map memory once and check it is visible in the page tables of both.
+ * - Unmap it and check it is gone from both.
+ * - Attach a mock device to the default IOAS and check DPDK memory is there.
+ * - Map external memory through the default container and check it lands
+ *   in the default IOAS.
+ */
+
+#define IOMMUFD_TEST_IOVA (1ULL << 28)
+#define IOMMUFD_TEST_LEN (4ULL << 20)
+#define IOMMUFD_TEST_NB_DEV 2
+
+/* selftest interface, from the kernel's drivers/iommu/iommufd/iommufd_test.h */
+#define IOMMU_TEST_CMD _IO(';', 0x80 + 32)
+/* from linux/iommufd.h, which older kernel headers lack */
+#define IOMMU_TEST_DESTROY _IO(';', 0x80)
+
+struct iommu_test_destroy {
+	uint32_t size;
+	uint32_t id;
+};
+
+enum {
+	IOMMU_TEST_OP_MOCK_DOMAIN = 2,
+	IOMMU_TEST_OP_MD_CHECK_MAP = 3,
+};
+
+struct iommu_test_cmd {
+	uint32_t size;
+	uint32_t op;
+	uint32_t id;
+	uint32_t __reserved;
+	union {
+		struct {
+			uint32_t out_stdev_id;
+			uint32_t out_hwpt_id;
+			uint32_t out_idev_id;
+		} mock_domain;
+		struct {
+			uint64_t iova;
+			uint64_t length;
+			uint64_t uptr;
+		} check_map;
+		/* kernel accepts larger commands as long as the tail is zero */
+		uint8_t pad[256];
+	};
+	uint32_t last;
+};
+
+struct mock_dev {
+	uint32_t stdev_id;
+	uint32_t hwpt_id;
+};
+
+static int
+mock_dev_create(int fd, uint32_t ioas_id, struct mock_dev *dev)
+{
+	struct iommu_test_cmd cmd;
+
+	memset(&cmd, 0, sizeof(cmd));
+	cmd.size = sizeof(cmd);
+	cmd.op = IOMMU_TEST_OP_MOCK_DOMAIN;
+	cmd.id = ioas_id;
+	if (ioctl(fd, IOMMU_TEST_CMD, &cmd))
+		return -errno;
+
+	dev->stdev_id = cmd.mock_domain.out_stdev_id;
+	dev->hwpt_id = cmd.mock_domain.out_hwpt_id;
+	return 0;
+}
+
+static int
+mock_dev_destroy(int fd, const struct mock_dev *dev)
+{
+	struct iommu_test_destroy destroy = {
+		.size = sizeof(destroy),
+		.id = dev->stdev_id,
+	};
+
+	return ioctl(fd, IOMMU_TEST_DESTROY, &destroy);
+}
+
+/* returns true if [iova, iova + len) maps to the pages at addr */
+static bool
+mock_dev_check_map(int fd, const struct mock_dev *dev, uint64_t iova,
+		uint64_t len, const void *addr)
+{
+	struct iommu_test_cmd cmd;
+
+	memset(&cmd, 0, sizeof(cmd));
+	cmd.size = sizeof(cmd);
+	cmd.op = IOMMU_TEST_OP_MD_CHECK_MAP;
+	cmd.id = dev->hwpt_id;
+	cmd.check_map.iova = iova;
+	cmd.check_map.length = len;
+	cmd.check_map.uptr = (uintptr_t)addr;
+
+	return ioctl(fd, IOMMU_TEST_CMD, &cmd) == 0;
+}
+
+static int
+test_ioas_shared(int fd)
+{
+	struct mock_dev devs[IOMMUFD_TEST_NB_DEV];
+	uint32_t ioas_id;
+	int nb_devs = 0;
+	void *buf;
+	int ret = -1;
+	int i;
+
+	buf = rte_malloc(NULL, IOMMUFD_TEST_LEN, IOMMUFD_TEST_LEN);
+	if (buf == NULL) {
+		printf("%s():%i: Cannot allocate memory\n", __func__, __LINE__);
+		return -1;
+	}
+	/* make sure pages are there before comparing them */
+	memset(buf, 0, IOMMUFD_TEST_LEN);
+
+	if (rte_vfio_iommufd_ioas_create(&ioas_id) < 0) {
+		printf("%s():%i: Cannot create IOAS\n", __func__, __LINE__);
+		goto free_buf;
+	}
+
+	for (i = 0; i < IOMMUFD_TEST_NB_DEV; i++) {
+		if (mock_dev_create(fd, ioas_id, &devs[i]) < 0) {
+			printf("%s():%i: Cannot attach mock device\n",
+				__func__, __LINE__);
+			goto destroy;
+		}
+		nb_devs++;
+	}
+
+	/* a single mapping must show up in all attached devices */
+	if (rte_vfio_iommufd_dma_map(ioas_id, (uintptr_t)buf,
+			IOMMUFD_TEST_IOVA, IOMMUFD_TEST_LEN) < 0) {
+		printf("%s():%i: Cannot map memory\n", __func__, __LINE__);
+		goto destroy;
+	}
+	for (i = 0; i < nb_devs; i++) {
+		if (!mock_dev_check_map(fd, &devs[i], IOMMUFD_TEST_IOVA,
+				IOMMUFD_TEST_LEN, buf)) {
+			printf("%s():%i: Memory not mapped in device %i\n",
+				__func__, __LINE__, i);
+			goto destroy;
+		}
+	}
+
+	/* same IOVA cannot be mapped twice */
+	if (rte_vfio_iommufd_dma_map(ioas_id, (uintptr_t)buf,
+			IOMMUFD_TEST_IOVA, IOMMUFD_TEST_LEN) == 0) {
+		printf("%s():%i: Overlapping mapping succeeded\n",
+			__func__, __LINE__);
+		goto destroy;
+	}
+
+	if (rte_vfio_iommufd_dma_unmap(ioas_id, IOMMUFD_TEST_IOVA,
+			IOMMUFD_TEST_LEN) < 0) {
+		printf("%s():%i: Cannot unmap memory\n", __func__, __LINE__);
+		goto destroy;
+	}
+	for (i = 0; i < nb_devs; i++) {
+		if (mock_dev_check_map(fd, &devs[i], IOMMUFD_TEST_IOVA,
+				IOMMUFD_TEST_LEN, buf)) {
+			printf("%s():%i: Memory still mapped in device %i\n",
+				__func__, __LINE__, i);
+			goto destroy;
+		}
+	}
+
+	ret = 0;
+destroy:
+	for (i = 0; i < nb_devs; i++)
+		mock_dev_destroy(fd, &devs[i]);
+	if (rte_vfio_iommufd_ioas_destroy(ioas_id) < 0) {
+		printf("%s():%i: Cannot destroy IOAS\n", __func__, __LINE__);
+		ret = -1;
+	}
+free_buf:
+	rte_free(buf);
+	return ret;
+}
+
+static int
+check_memseg(const struct rte_memseg_list *msl, const struct rte_memseg *ms,
+		void *arg)
+{
+	const struct mock_dev *dev = arg;
+	int fd = rte_vfio_iommufd_get_fd();
+
+	if (msl->external)
+		return 0;
+
+	if (!mock_dev_check_map(fd, dev, ms->iova, ms->len, ms->addr)) {
+		printf("%s():%i: Segment at %p not mapped\n",
+			__func__, __LINE__, ms->addr);
+		return -1;
+	}
+	return 0;
+}
+
+static int
+test_ioas_default(int fd)
+{
+	struct mock_dev dev;
+	uint32_t ioas_id;
+	int ret;
+
+	/* mock device pins pages by address, IOVA must be the address too */
+	if (rte_eal_iova_mode() != RTE_IOVA_VA) {
+		printf("IOVA as VA mode required, skipping default IOAS check\n");
+		return 0;
+	}
+
+	if (rte_vfio_iommufd_get_default_ioas(&ioas_id) < 0) {
+		printf("%s():%i: Cannot get default IOAS\n", __func__, __LINE__);
+		return -1;
+	}
+
+	if (rte_vfio_iommufd_ioas_destroy(ioas_id) == 0) {
+		printf("%s():%i: Default IOAS destroyed\n", __func__, __LINE__);
+		return -1;
+	}
+
+	if (mock_dev_create(fd, ioas_id, &dev) < 0) {
+		printf("%s():%i: Cannot attach mock device\n", __func__, __LINE__);
+		return -1;
+	}
+	ret = rte_memseg_walk(check_memseg, &dev);
+	mock_dev_destroy(fd, &dev);
+
+	return ret == 0 ? 0 : -1;
+}
+
+static int
+test_ioas_extmem(int fd)
+{
+	struct mock_dev dev;
+	uint32_t ioas_id;
+	uint64_t iova;
+	void *addr;
+	int ret = -1;
+
+	/* mock device pins pages by address, IOVA must be the address too */
+	if (rte_eal_iova_mode() != RTE_IOVA_VA) {
+		printf("IOVA as VA mode required, skipping external memory check\n");
+		return 0;
+	}
+
+	addr = mmap(NULL, IOMMUFD_TEST_LEN, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (addr == MAP_FAILED) {
+		printf("%s():%i: Cannot allocate memory\n", __func__, __LINE__);
+		return -1;
+	}
+	/* make sure pages are there before comparing them */
+	memset(addr, 0, IOMMUFD_TEST_LEN);
+	iova = (uintptr_t)addr;
+
+	if (rte_extmem_register(addr, IOMMUFD_TEST_LEN, NULL, 0,
+			rte_mem_page_size()) < 0) {
+		printf("%s():%i: Cannot register external memory\n",
+			__func__, __LINE__);
+		goto unmap;
+	}
+
+	if (rte_vfio_iommufd_get_default_ioas(&ioas_id) < 0) {
+		printf("%s():%i: Cannot get default IOAS\n", __func__, __LINE__);
+		goto unregister;
+	}
+	if (mock_dev_create(fd, ioas_id, &dev) < 0) {
+		printf("%s():%i: Cannot attach mock device\n", __func__, __LINE__);
+		goto unregister;
+	}
+
+	/* default container is the default IOAS in iommufd mode */
+	if (rte_vfio_container_dma_map(RTE_VFIO_DEFAULT_CONTAINER_FD,
+			(uintptr_t)addr, iova, IOMMUFD_TEST_LEN) < 0) {
+		printf("%s():%i: Cannot map external memory\n",
+			__func__, __LINE__);
+		goto destroy;
+	}
+	if (!mock_dev_check_map(fd, &dev, iova, IOMMUFD_TEST_LEN, addr)) {
+		printf("%s():%i: External memory not mapped\n",
+			__func__, __LINE__);
+		rte_vfio_container_dma_unmap(RTE_VFIO_DEFAULT_CONTAINER_FD,
+			(uintptr_t)addr, iova, IOMMUFD_TEST_LEN);
+		goto destroy;
+	}
+
+	if (rte_vfio_container_dma_unmap(RTE_VFIO_DEFAULT_CONTAINER_FD,
+			(uintptr_t)addr, iova, IOMMUFD_TEST_LEN) < 0) {
+		printf("%s():%i: Cannot unmap external memory\n",
+			__func__, __LINE__);
+		goto destroy;
+	}
+	if (mock_dev_check_map(fd, &dev, iova, IOMMUFD_TEST_LEN, addr)) {
+		printf("%s():%i: External memory still mapped\n",
+			__func__, __LINE__);
+		goto destroy;
+	}
+
+	ret = 0;
+destroy:
+	mock_dev_destroy(fd, &dev);
+unregister:
+	rte_extmem_unregister(addr, IOMMUFD_TEST_LEN);
+unmap:
+	munmap(addr, IOMMUFD_TEST_LEN);
+	return ret;
+}
+
+static int
+test_vfio_iommufd(void)
+{
+	struct iommu_test_cmd cmd;
+	int fd;
+
+	if (rte_eal_process_type() != RTE_PROC_PRIMARY) {
+		printf("Not a primary process, skipping test\n");
+		return TEST_SKIPPED;
+	}
+
+	fd = rte_vfio_iommufd_get_fd();
+	if (fd < 0) {
+		printf("iommufd not available, skipping test\n");
+		return TEST_SKIPPED;
+	}
+
+	/* an unknown op tells whether selftest support is built in */
+	memset(&cmd, 0, sizeof(cmd));
+	cmd.size = sizeof(cmd);
+	if (ioctl(fd, IOMMU_TEST_CMD, &cmd) < 0 && errno == ENOTTY) {
+		printf("iommufd selftest not available, skipping test\n");
+		return TEST_SKIPPED;
+	}
+
+	if (test_ioas_shared(fd) < 0)
+		return -1;
+	if (test_ioas_default(fd) < 0)
+		return -1;
+	if (test_ioas_extmem(fd) < 0)
+		return -1;
+
+	return 0;
+}
+
+#endif /* !RTE_EXEC_ENV_LINUX */
+
+REGISTER_FAST_TEST(vfio_iommufd_autotest, true, true, test_vfio_iommufd);
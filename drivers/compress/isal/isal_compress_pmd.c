@@ -1,11 +1,16 @@
 /* SPDX-License-Identifier: BSD-3-Clause
  * Copyright(c) 2018 Intel Corporation
  */
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+
 #include <isa-l.h>
 
 #include <bus_vdev_driver.h>
 #include <rte_common.h>
 #include <rte_cpuflags.h>
+#include <rte_kvargs.h>
 #include <rte_malloc.h>
 #include <rte_mbuf.h>
 #include <rte_compressdev_pmd.h>
@@ -19,6 +24,10 @@
 #define RTE_COMP_ISAL_LEVEL_THREE 3 /* Optimised for AVX512 & AVX2 only */
 #define CHKSUM_SZ_CRC 8
 #define CHKSUM_SZ_ADLER 4
+/* Largest op compressed with the Huffman tables of its batch */
+#define ISAL_BATCH_MAX_LEN (16 * 1024)
+/* Bytes of each op of a batch used to build the Huffman tables */
+#define ISAL_BATCH_SAMPLE_LEN (4 * 1024)
 
 #define STRINGIFY(s) #s
 #define ISAL_TOSTRING(maj, min, patch) \
@@ -232,7 +241,7 @@ isal_comp_set_priv_xform_parameters(struct isal_priv_xform *priv_xform,
 
 /* Compression using chained mbufs for input/output data */
 static int
-chained_mbuf_compression(struct rte_comp_op *op, struct isal_comp_qp *qp)
+chained_mbuf_compression(struct rte_comp_op *op, struct isal_zstream *stream)
 {
 	int ret;
 	uint32_t remaining_offset;
@@ -248,9 +257,9 @@ chained_mbuf_compression(struct rte_comp_op *op, struct isal_comp_qp *qp)
 		remaining_offset -= src->data_len;
 		src = src->next;
 	}
-	qp->stream->avail_in = RTE_MIN(src->data_len - remaining_offset,
+	stream->avail_in = RTE_MIN(src->data_len - remaining_offset,
 			op->src.length);
-	qp->stream->next_in = rte_pktmbuf_mtod_offset(src, uint8_t *,
+	stream->next_in = rte_pktmbuf_mtod_offset(src, uint8_t *,
 			remaining_offset);
 
 	remaining_offset = op->dst.offset;
@@ -258,25 +267,25 @@ chained_mbuf_compression(struct rte_comp_op *op, struct isal_comp_qp *qp)
 		remaining_offset -= dst->data_len;
 		dst = dst->next;
 	}
-	qp->stream->avail_out = dst->data_len - remaining_offset;
-	qp->stream->next_out = rte_pktmbuf_mtod_offset(dst, uint8_t *,
+	stream->avail_out = dst->data_len - remaining_offset;
+	stream->next_out = rte_pktmbuf_mtod_offset(dst, uint8_t *,
 			remaining_offset);
 
-	if (unlikely(!qp->stream->next_in || !qp->stream->next_out)) {
+	if (unlikely(!stream->next_in || !stream->next_out)) {
 		ISAL_PMD_LOG(ERR, "Invalid source or destination buffer\n");
 		op->status = RTE_COMP_OP_STATUS_INVALID_ARGS;
 		return -1;
 	}
 
-	while (qp->stream->internal_state.state != ZSTATE_END) {
+	while (stream->internal_state.state != ZSTATE_END) {
 		/* Last segment of data */
 		if (remaining_data <= src->data_len)
-			qp->stream->end_of_stream = 1;
+			stream->end_of_stream = 1;
 
 		/* Execute compression operation */
-		ret = isal_deflate(qp->stream);
+		ret = isal_deflate(stream);
 
-		remaining_data = op->src.length - qp->stream->total_in;
+		remaining_data = op->src.length - stream->total_in;
 
 		if (ret != COMP_OK) {
 			ISAL_PMD_LOG(ERR, "Compression operation failed\n");
@@ -284,13 +293,13 @@ chained_mbuf_compression(struct rte_comp_op *op, struct isal_comp_qp *qp)
 			return ret;
 		}
 
-		if (qp->stream->avail_in == 0 &&
-				qp->stream->total_in != op->src.length) {
+		if (stream->avail_in == 0 &&
+				stream->total_in != op->src.length) {
 			if (src->next != NULL) {
 				src = src->next;
-				qp->stream->next_in =
+				stream->next_in =
 						rte_pktmbuf_mtod(src, uint8_t *);
-				qp->stream->avail_in =
+				stream->avail_in =
 					RTE_MIN(remaining_data, src->data_len);
 			} else {
 				ISAL_PMD_LOG(ERR,
@@ -300,13 +309,13 @@ chained_mbuf_compression(struct rte_comp_op *op, struct isal_comp_qp *qp)
 			}
 		}
 
-		if (qp->stream->avail_out == 0 &&
-				qp->stream->internal_state.state != ZSTATE_END) {
+		if (stream->avail_out == 0 &&
+				stream->internal_state.state != ZSTATE_END) {
 			if (dst->next != NULL) {
 				dst = dst->next;
-				qp->stream->next_out =
+				stream->next_out =
 						rte_pktmbuf_mtod(dst, uint8_t *);
-				qp->stream->avail_out = dst->data_len;
+				stream->avail_out = dst->data_len;
 			} else {
 				ISAL_PMD_LOG(ERR,
 				"Not enough output buffer segments\n");
@@ -322,7 +331,8 @@ chained_mbuf_compression(struct rte_comp_op *op, struct isal_comp_qp *qp)
 
 /* Decompression using chained mbufs for input/output data */
 static int
-chained_mbuf_decompression(struct rte_comp_op *op, struct isal_comp_qp *qp)
+chained_mbuf_decompression(struct rte_comp_op *op,
+		struct inflate_state *state)
 {
 	int ret;
 	uint32_t consumed_data, src_remaining_offset, dst_remaining_offset;
@@ -338,9 +348,9 @@ chained_mbuf_decompression(struct rte_comp_op *op, struct isal_comp_qp *qp)
 		src_remaining_offset -= src->data_len;
 		src = src->next;
 	}
-	qp->state->avail_in = RTE_MIN(src->data_len - src_remaining_offset,
+	state->avail_in = RTE_MIN(src->data_len - src_remaining_offset,
 			op->src.length);
-	qp->state->next_in = rte_pktmbuf_mtod_offset(src, uint8_t *,
+	state->next_in = rte_pktmbuf_mtod_offset(src, uint8_t *,
 			src_remaining_offset);
 
 	dst_remaining_offset = op->dst.offset;
@@ -348,13 +358,13 @@ chained_mbuf_decompression(struct rte_comp_op *op, struct isal_comp_qp *qp)
 		dst_remaining_offset -= dst->data_len;
 		dst = dst->next;
 	}
-	qp->state->avail_out = dst->data_len - dst_remaining_offset;
-	qp->state->next_out = rte_pktmbuf_mtod_offset(dst, uint8_t *,
+	state->avail_out = dst->data_len - dst_remaining_offset;
+	state->next_out = rte_pktmbuf_mtod_offset(dst, uint8_t *,
 			dst_remaining_offset);
 
-	while (qp->state->block_state != ISAL_BLOCK_FINISH) {
+	while (state->block_state != ISAL_BLOCK_FINISH) {
 
-		ret = isal_inflate(qp->state);
+		ret = isal_inflate(state);
 
 		/* Check for first segment, offset needs to be accounted for */
 		if (remaining_data == op->src.length) {
@@ -362,16 +372,16 @@ chained_mbuf_decompression(struct rte_comp_op *op, struct isal_comp_qp *qp)
 		} else
 			consumed_data = src->data_len;
 
-		if (qp->state->avail_in == 0
+		if (state->avail_in == 0
 				&& op->consumed != op->src.length) {
 			op->consumed += consumed_data;
 			remaining_data -= consumed_data;
 
 			if (src->next != NULL) {
 				src = src->next;
-				qp->state->next_in =
+				state->next_in =
 						rte_pktmbuf_mtod(src, uint8_t *);
-				qp->state->avail_in =
+				state->avail_in =
 					RTE_MIN(remaining_data, src->data_len);
 			}
 		}
@@ -380,7 +390,7 @@ chained_mbuf_decompression(struct rte_comp_op *op, struct isal_comp_qp *qp)
 			ISAL_PMD_LOG(ERR, "Decompression operation ran "
 				"out of space, but can be recovered.\n%d bytes "
 				"consumed\t%d bytes produced\n",
-				consumed_data, qp->state->total_out);
+				consumed_data, state->total_out);
 				op->status =
 				RTE_COMP_OP_STATUS_OUT_OF_SPACE_RECOVERABLE;
 			return ret;
@@ -390,13 +400,13 @@ chained_mbuf_decompression(struct rte_comp_op *op, struct isal_comp_qp *qp)
 			return ret;
 		}
 
-		if (qp->state->avail_out == 0 &&
-				qp->state->block_state != ISAL_BLOCK_FINISH) {
+		if (state->avail_out == 0 &&
+				state->block_state != ISAL_BLOCK_FINISH) {
 			if (dst->next != NULL) {
 				dst = dst->next;
-				qp->state->next_out =
+				state->next_out =
 						rte_pktmbuf_mtod(dst, uint8_t *);
-				qp->state->avail_out = dst->data_len;
+				state->avail_out = dst->data_len;
 			} else {
 				ISAL_PMD_LOG(ERR,
 				"Not enough output buffer segments\n");
@@ -412,42 +422,48 @@ chained_mbuf_decompression(struct rte_comp_op *op, struct isal_comp_qp *qp)
 
 /* Stateless Compression Function */
 static int
-process_isal_deflate(struct rte_comp_op *op, struct isal_comp_qp *qp,
-		struct isal_priv_xform *priv_xform)
+process_isal_deflate(struct rte_comp_op *op, struct isal_zstream *stream,
+		struct isal_priv_xform *priv_xform,
+		struct isal_hufftables *hufftables)
 {
 	int ret = 0;
 	op->status = RTE_COMP_OP_STATUS_SUCCESS;
 
 	/* Required due to init clearing level_buf */
-	uint8_t *temp_level_buf = qp->stream->level_buf;
+	uint8_t *temp_level_buf = stream->level_buf;
 
 	/* Initialize compression stream */
-	isal_deflate_init(qp->stream);
+	isal_deflate_init(stream);
 
-	qp->stream->level_buf = temp_level_buf;
+	stream->level_buf = temp_level_buf;
 
 	/* Set Checksum flag */
-	qp->stream->gzip_flag = priv_xform->compress.chksum;
+	stream->gzip_flag = priv_xform->compress.chksum;
 
 	/* Stateless operation, input will be consumed in one go */
-	qp->stream->flush = NO_FLUSH;
+	stream->flush = NO_FLUSH;
 
 	/* set compression level & intermediate level buffer size */
-	qp->stream->level = priv_xform->compress.level;
-	qp->stream->level_buf_size = priv_xform->level_buffer_size;
+	stream->level = priv_xform->compress.level;
+	stream->level_buf_size = priv_xform->level_buffer_size;
 
 	/* Set op huffman code */
-	if (priv_xform->compress.deflate.huffman == RTE_COMP_HUFFMAN_FIXED)
-		isal_deflate_set_hufftables(qp->stream, NULL,
+	if (hufftables != NULL) {
+		/* Tables of the batch, the xform is at level 0 to use them */
+		isal_deflate_set_hufftables(stream, hufftables,
+				IGZIP_HUFFTABLE_CUSTOM);
+	} else if (priv_xform->compress.deflate.huffman ==
+			RTE_COMP_HUFFMAN_FIXED)
+		isal_deflate_set_hufftables(stream, NULL,
 				IGZIP_HUFFTABLE_STATIC);
 	else if (priv_xform->compress.deflate.huffman ==
 			RTE_COMP_HUFFMAN_DEFAULT)
-		isal_deflate_set_hufftables(qp->stream, NULL,
+		isal_deflate_set_hufftables(stream, NULL,
 			IGZIP_HUFFTABLE_DEFAULT);
 	/* Dynamically change the huffman code to suit the input data */
 	else if (priv_xform->compress.deflate.huffman ==
 			RTE_COMP_HUFFMAN_DYNAMIC)
-		isal_deflate_set_hufftables(qp->stream, NULL,
+		isal_deflate_set_hufftables(stream, NULL,
 				IGZIP_HUFFTABLE_DEFAULT);
 
 	if (op->m_src->pkt_len < (op->src.length + op->src.offset)) {
@@ -465,23 +481,23 @@ process_isal_deflate(struct rte_comp_op *op, struct isal_comp_qp *qp,
 
 	/* Chained mbufs */
 	if (op->m_src->nb_segs > 1 || op->m_dst->nb_segs > 1) {
-		ret = chained_mbuf_compression(op, qp);
+		ret = chained_mbuf_compression(op, stream);
 		if (ret < 0)
 			return ret;
 	} else {
 		/* Linear buffer */
-		qp->stream->end_of_stream = 1; /* All input consumed in one */
+		stream->end_of_stream = 1; /* All input consumed in one */
 		/* Point compression stream to input buffer */
-		qp->stream->avail_in = op->src.length;
-		qp->stream->next_in = rte_pktmbuf_mtod_offset(op->m_src,
+		stream->avail_in = op->src.length;
+		stream->next_in = rte_pktmbuf_mtod_offset(op->m_src,
 				uint8_t *, op->src.offset);
 
 		/*  Point compression stream to output buffer */
-		qp->stream->avail_out = op->m_dst->data_len - op->dst.offset;
-		qp->stream->next_out  = rte_pktmbuf_mtod_offset(op->m_dst,
+		stream->avail_out = op->m_dst->data_len - op->dst.offset;
+		stream->next_out  = rte_pktmbuf_mtod_offset(op->m_dst,
 				uint8_t *, op->dst.offset);
 
-		if (unlikely(!qp->stream->next_in || !qp->stream->next_out)) {
+		if (unlikely(!stream->next_in || !stream->next_out)) {
 			ISAL_PMD_LOG(ERR, "Invalid source or destination"
 					" buffers\n");
 			op->status = RTE_COMP_OP_STATUS_INVALID_ARGS;
@@ -489,7 +505,7 @@ process_isal_deflate(struct rte_comp_op *op, struct isal_comp_qp *qp,
 		}
 
 		/* Execute compression operation */
-		ret =  isal_deflate_stateless(qp->stream);
+		ret =  isal_deflate_stateless(stream);
 
 		/* Check that output buffer did not run out of space */
 		if (ret == STATELESS_OVERFLOW) {
@@ -499,7 +515,7 @@ process_isal_deflate(struct rte_comp_op *op, struct isal_comp_qp *qp,
 		}
 
 		/* Check that input buffer has been fully consumed */
-		if (qp->stream->avail_in != (uint32_t)0) {
+		if (stream->avail_in != (uint32_t)0) {
 			ISAL_PMD_LOG(ERR, "Input buffer could not be read"
 					" entirely\n");
 			op->status = RTE_COMP_OP_STATUS_ERROR;
@@ -513,15 +529,15 @@ process_isal_deflate(struct rte_comp_op *op, struct isal_comp_qp *qp,
 		}
 	}
 
-	op->consumed = qp->stream->total_in;
-	if (qp->stream->gzip_flag == IGZIP_DEFLATE) {
-		op->produced = qp->stream->total_out;
-	} else if (qp->stream->gzip_flag == IGZIP_ZLIB_NO_HDR) {
-		op->produced = qp->stream->total_out - CHKSUM_SZ_ADLER;
-		op->output_chksum = qp->stream->internal_state.crc + 1;
+	op->consumed = stream->total_in;
+	if (stream->gzip_flag == IGZIP_DEFLATE) {
+		op->produced = stream->total_out;
+	} else if (stream->gzip_flag == IGZIP_ZLIB_NO_HDR) {
+		op->produced = stream->total_out - CHKSUM_SZ_ADLER;
+		op->output_chksum = stream->internal_state.crc + 1;
 	} else {
-		op->produced = qp->stream->total_out - CHKSUM_SZ_CRC;
-		op->output_chksum = qp->stream->internal_state.crc;
+		op->produced = stream->total_out - CHKSUM_SZ_CRC;
+		op->output_chksum = stream->internal_state.crc;
 	}
 
 	return ret;
@@ -529,7 +545,7 @@ process_isal_deflate(struct rte_comp_op *op, struct isal_comp_qp *qp,
 
 /* Stateless Decompression Function */
 static int
-process_isal_inflate(struct rte_comp_op *op, struct isal_comp_qp *qp,
+process_isal_inflate(struct rte_comp_op *op, struct inflate_state *state,
 		struct isal_priv_xform *priv_xform)
 {
 	int ret = 0;
@@ -537,10 +553,10 @@ process_isal_inflate(struct rte_comp_op *op, struct isal_comp_qp *qp,
 	op->status = RTE_COMP_OP_STATUS_SUCCESS;
 
 	/* Initialize decompression state */
-	isal_inflate_init(qp->state);
+	isal_inflate_init(state);
 
 	/* Set Checksum flag */
-	qp->state->crc_flag = priv_xform->decompress.chksum;
+	state->crc_flag = priv_xform->decompress.chksum;
 
 	if (op->m_src->pkt_len < (op->src.length + op->src.offset)) {
 		ISAL_PMD_LOG(ERR, "Input mbuf(s) not big enough.\n");
@@ -557,22 +573,22 @@ process_isal_inflate(struct rte_comp_op *op, struct isal_comp_qp *qp,
 
 	/* Chained mbufs */
 	if (op->m_src->nb_segs > 1 || op->m_dst->nb_segs > 1) {
-		ret = chained_mbuf_decompression(op, qp);
+		ret = chained_mbuf_decompression(op, state);
 		if (ret !=  0)
 			return ret;
 	} else {
 		/* Linear buffer */
 		/* Point decompression state to input buffer */
-		qp->state->avail_in = op->src.length;
-		qp->state->next_in = rte_pktmbuf_mtod_offset(op->m_src,
+		state->avail_in = op->src.length;
+		state->next_in = rte_pktmbuf_mtod_offset(op->m_src,
 				uint8_t *, op->src.offset);
 
 		/* Point decompression state to output buffer */
-		qp->state->avail_out = op->m_dst->data_len - op->dst.offset;
-		qp->state->next_out  = rte_pktmbuf_mtod_offset(op->m_dst,
+		state->avail_out = op->m_dst->data_len - op->dst.offset;
+		state->next_out  = rte_pktmbuf_mtod_offset(op->m_dst,
 				uint8_t *, op->dst.offset);
 
-		if (unlikely(!qp->state->next_in || !qp->state->next_out)) {
+		if (unlikely(!state->next_in || !state->next_out)) {
 			ISAL_PMD_LOG(ERR, "Invalid source or destination"
 					" buffers\n");
 			op->status = RTE_COMP_OP_STATUS_INVALID_ARGS;
@@ -580,7 +596,7 @@ process_isal_inflate(struct rte_comp_op *op, struct isal_comp_qp *qp,
 		}
 
 		/* Execute decompression operation */
-		ret = isal_inflate_stateless(qp->state);
+		ret = isal_inflate_stateless(state);
 
 		if (ret == ISAL_OUT_OVERFLOW) {
 			ISAL_PMD_LOG(ERR, "Output buffer not big enough\n");
@@ -589,7 +605,7 @@ process_isal_inflate(struct rte_comp_op *op, struct isal_comp_qp *qp,
 		}
 
 		/* Check that input buffer has been fully consumed */
-		if (qp->state->avail_in != (uint32_t)0) {
+		if (state->avail_in != (uint32_t)0) {
 			ISAL_PMD_LOG(ERR, "Input buffer could not be read"
 					" entirely\n");
 			op->status = RTE_COMP_OP_STATUS_ERROR;
@@ -601,25 +617,25 @@ process_isal_inflate(struct rte_comp_op *op, struct isal_comp_qp *qp,
 			op->status = RTE_COMP_OP_STATUS_ERROR;
 			return ret;
 		}
-		op->consumed = op->src.length - qp->state->avail_in;
+		op->consumed = op->src.length - state->avail_in;
 	}
-	op->produced = qp->state->total_out;
-	op->output_chksum = qp->state->crc;
+	op->produced = state->total_out;
+	op->output_chksum = state->crc;
 
 	return ret;
 }
 
 /* Process compression/decompression operation */
 static int
-process_op(struct isal_comp_qp *qp, struct rte_comp_op *op,
-		struct isal_priv_xform *priv_xform)
+process_op(struct isal_zstream *stream, struct inflate_state *state,
+		struct rte_comp_op *op, struct isal_priv_xform *priv_xform)
 {
 	switch (priv_xform->type) {
 	case RTE_COMP_COMPRESS:
-		process_isal_deflate(op, qp, priv_xform);
+		process_isal_deflate(op, stream, priv_xform, NULL);
 		break;
 	case RTE_COMP_DECOMPRESS:
-		process_isal_inflate(op, qp, priv_xform);
+		process_isal_inflate(op, state, priv_xform);
 		break;
 	default:
 		ISAL_PMD_LOG(ERR, "Operation Not Supported\n");
@@ -628,29 +644,178 @@ process_op(struct isal_comp_qp *qp, struct rte_comp_op *op,
 	return 0;
 }
 
+int
+isal_comp_process_op(struct isal_zstream *stream, struct inflate_state *state,
+		struct rte_comp_op *op)
+{
+	int retval;
+
+	if (unlikely(op->op_type != RTE_COMP_OP_STATELESS)) {
+		op->status = RTE_COMP_OP_STATUS_INVALID_ARGS;
+		ISAL_PMD_LOG(ERR, "Stateful operation not Supported\n");
+		return -ENOTSUP;
+	}
+
+	retval = process_op(stream, state, op, op->private_xform);
+	if (unlikely(retval < 0))
+		return retval;
+	if (op->status != RTE_COMP_OP_STATUS_SUCCESS)
+		return -1;
+
+	return 0;
+}
+
+/*
+ * Check if an op can share the Huffman tables of a batch, higher ISA-L levels
+ * build their own tables for each block.
+ */
+static inline bool
+isal_batch_eligible(const struct rte_comp_op *op)
+{
+	const struct isal_priv_xform *priv_xform = op->private_xform;
+
+	return op->op_type == RTE_COMP_OP_STATELESS &&
+		priv_xform->type == RTE_COMP_COMPRESS &&
+		priv_xform->compress.deflate.huffman ==
+			RTE_COMP_HUFFMAN_DYNAMIC &&
+		priv_xform->compress.level == ISAL_BATCH_LEVEL &&
+		op->m_src->nb_segs == 1 && op->m_dst->nb_segs == 1 &&
+		op->src.length <= ISAL_BATCH_MAX_LEN &&
+		op->src.offset + op->src.length <= op->m_src->data_len;
+}
+
+/* Compress a batch of small ops with Huffman tables built for the batch */
+static uint16_t
+isal_comp_process_batch(struct isal_zstream *stream,
+		struct inflate_state *state, struct isal_comp_batch *batch,
+		struct rte_comp_op **ops, uint16_t nb_ops)
+{
+	struct isal_hufftables *hufftables = &batch->hufftables;
+	uint16_t i, nb_err = 0;
+
+	memset(&batch->histogram, 0, sizeof(batch->histogram));
+	for (i = 0; i < nb_ops; i++)
+		isal_update_histogram(rte_pktmbuf_mtod_offset(ops[i]->m_src,
+				uint8_t *, ops[i]->src.offset),
+				RTE_MIN(ops[i]->src.length,
+					(uint32_t)ISAL_BATCH_SAMPLE_LEN),
+				&batch->histogram);
+
+	/* Fall back to the tables chosen by each op */
+	if (isal_create_hufftables(hufftables, &batch->histogram) != 0)
+		hufftables = NULL;
+
+	for (i = 0; i < nb_ops; i++) {
+		if (hufftables == NULL) {
+			if (isal_comp_process_op(stream, state, ops[i]) < 0)
+				nb_err++;
+			continue;
+		}
+		process_isal_deflate(ops[i], stream, ops[i]->private_xform,
+				hufftables);
+		if (ops[i]->status != RTE_COMP_OP_STATUS_SUCCESS)
+			nb_err++;
+	}
+
+	return nb_err;
+}
+
+uint16_t
+isal_comp_process_burst(struct isal_zstream *stream,
+		struct inflate_state *state, struct isal_comp_batch *batch,
+		uint16_t batch_size, struct rte_comp_op **ops, uint16_t nb_ops)
+{
+	uint16_t i = 0, n, nb_err = 0;
+
+	while (i < nb_ops) {
+		n = 1;
+		/*
+		 * Group the following small dynamic Huffman ops using the
+		 * same private xform, so their output format is identical.
+		 */
+		if (batch != NULL && isal_batch_eligible(ops[i])) {
+			while (n < batch_size && i + n < nb_ops &&
+					ops[i + n]->private_xform ==
+						ops[i]->private_xform &&
+					isal_batch_eligible(ops[i + n]))
+				n++;
+		}
+
+		if (n > 1)
+			nb_err += isal_comp_process_batch(stream, state, batch,
+					&ops[i], n);
+		else if (isal_comp_process_op(stream, state, ops[i]) < 0)
+			nb_err++;
+		i += n;
+	}
+
+	return nb_err;
+}
+
+/* Enqueue burst, ops are handed to the helper threads in turn */
+static uint16_t
+isal_comp_pmd_enqueue_burst_async(void *queue_pair, struct rte_comp_op **ops,
+			uint16_t nb_ops)
+{
+	struct isal_comp_qp *qp = queue_pair;
+	struct isal_comp_worker *worker;
+	uint16_t num_enq = RTE_MIN(qp->num_free_elements, nb_ops);
+	uint16_t i;
+
+	/*
+	 * Op k of the queue pair always goes to worker (k % nb_workers), so
+	 * that the dequeue side can restore the submission order by reading
+	 * the workers in the same sequence.
+	 */
+	for (i = 0; i < num_enq; i++) {
+		worker = &qp->workers[qp->enq_worker];
+		if (rte_ring_sp_enqueue(worker->todo, ops[i]) != 0)
+			break;
+		if (++qp->enq_worker == qp->nb_workers)
+			qp->enq_worker = 0;
+	}
+
+	qp->num_free_elements -= i;
+	qp->qp_stats.enqueued_count += i;
+
+	return i;
+}
+
+/* Dequeue burst, ops are returned in the order they were enqueued */
+static uint16_t
+isal_comp_pmd_dequeue_burst_async(void *queue_pair, struct rte_comp_op **ops,
+		uint16_t nb_ops)
+{
+	struct isal_comp_qp *qp = queue_pair;
+	struct isal_comp_worker *worker;
+	uint16_t i;
+
+	for (i = 0; i < nb_ops; i++) {
+		worker = &qp->workers[qp->deq_worker];
+		/* The next op in order is not processed yet */
+		if (rte_ring_sc_dequeue(worker->done, (void **)&ops[i]) != 0)
+			break;
+		if (++qp->deq_worker == qp->nb_workers)
+			qp->deq_worker = 0;
+	}
+
+	qp->num_free_elements += i;
+	qp->qp_stats.dequeued_count += i;
+
+	return i;
+}
+
 /* Enqueue burst */
 static uint16_t
 isal_comp_pmd_enqueue_burst(void *queue_pair, struct rte_comp_op **ops,
 			uint16_t nb_ops)
 {
 	struct isal_comp_qp *qp = queue_pair;
-	uint16_t i;
 	int retval;
 	int16_t num_enq = RTE_MIN(qp->num_free_elements, nb_ops);
 
-	for (i = 0; i < num_enq; i++) {
-		if (unlikely(ops[i]->op_type != RTE_COMP_OP_STATELESS)) {
-			ops[i]->status = RTE_COMP_OP_STATUS_INVALID_ARGS;
-			ISAL_PMD_LOG(ERR, "Stateful operation not Supported\n");
-			qp->qp_stats.enqueue_err_count++;
-			continue;
-		}
-		retval = process_op(qp, ops[i], ops[i]->private_xform);
-		if (unlikely(retval < 0) ||
-				ops[i]->status != RTE_COMP_OP_STATUS_SUCCESS) {
-			qp->qp_stats.enqueue_err_count++;
-		}
-	}
+	qp->qp_stats.enqueue_err_count += isal_comp_process_burst(qp->stream,
+			qp->state, qp->batch, qp->batch_size, ops, num_enq);
 
 	retval = rte_ring_enqueue_burst(qp->processed_pkts, (void *)ops,
 			num_enq, NULL);
@@ -679,9 +844,11 @@ isal_comp_pmd_dequeue_burst(void *queue_pair, struct rte_comp_op **ops,
 /* Create ISA-L compression device */
 static int
 compdev_isal_create(const char *name, struct rte_vdev_device *vdev,
-		struct rte_compressdev_pmd_init_params *init_params)
+		struct rte_compressdev_pmd_init_params *init_params,
+		uint16_t nb_workers, uint16_t batch_size)
 {
 	struct rte_compressdev *dev;
+	struct isal_comp_private *internals;
 
 	dev = rte_compressdev_pmd_create(name, &vdev->device,
 			sizeof(struct isal_comp_private), init_params);
@@ -692,9 +859,20 @@ compdev_isal_create(const char *name, struct rte_vdev_device *vdev,
 
 	dev->dev_ops = isal_compress_pmd_ops;
 
+	internals = dev->data->dev_private;
+	internals->nb_workers = nb_workers;
+	internals->batch_size = batch_size;
+
 	/* register rx/tx burst functions for data path */
-	dev->dequeue_burst = isal_comp_pmd_dequeue_burst;
-	dev->enqueue_burst = isal_comp_pmd_enqueue_burst;
+	if (nb_workers != 0) {
+		dev->dequeue_burst = isal_comp_pmd_dequeue_burst_async;
+		dev->enqueue_burst = isal_comp_pmd_enqueue_burst_async;
+		ISAL_PMD_LOG(INFO, "%u helper threads per queue pair",
+				nb_workers);
+	} else {
+		dev->dequeue_burst = isal_comp_pmd_dequeue_burst;
+		dev->enqueue_burst = isal_comp_pmd_enqueue_burst;
+	}
 
 	ISAL_PMD_LOG(INFO, "\nISA-L library version used: "ISAL_VERSION_STRING);
 
@@ -719,6 +897,118 @@ compdev_isal_remove_dev(struct rte_vdev_device *vdev)
 	return rte_compressdev_pmd_destroy(compdev);
 }
 
+static const char * const compdev_isal_valid_params[] = {
+	RTE_COMPRESSDEV_PMD_NAME_ARG,
+	RTE_COMPRESSDEV_PMD_SOCKET_ID_ARG,
+	ISAL_ASYNC_WORKERS_ARG,
+	ISAL_BATCH_SIZE_ARG,
+	NULL
+};
+
+static int
+compdev_isal_parse_name_arg(const char *key __rte_unused,
+		const char *value, void *extra_args)
+{
+	struct rte_compressdev_pmd_init_params *params = extra_args;
+
+	if (strlen(value) >= RTE_COMPRESSDEV_NAME_MAX_LEN - 1)
+		return -EINVAL;
+
+	strlcpy(params->name, value, RTE_COMPRESSDEV_NAME_MAX_LEN);
+	return 0;
+}
+
+static int
+compdev_isal_parse_uint_arg(const char *key __rte_unused,
+		const char *value, void *extra_args)
+{
+	char *end;
+	unsigned long val;
+
+	errno = 0;
+	val = strtoul(value, &end, 10);
+	if (errno != 0 || *end != '\0' || val > INT_MAX)
+		return -EINVAL;
+
+	*(int *)extra_args = (int)val;
+	return 0;
+}
+
+/* socket ID may also be SOCKET_ID_ANY */
+static int
+compdev_isal_parse_socket_id_arg(const char *key __rte_unused,
+		const char *value, void *extra_args)
+{
+	char *end;
+	long val;
+
+	errno = 0;
+	val = strtol(value, &end, 10);
+	if (errno != 0 || *end != '\0' || val < SOCKET_ID_ANY || val > INT_MAX)
+		return -EINVAL;
+
+	*(int *)extra_args = (int)val;
+	return 0;
+}
+
+/* Parse the generic compressdev arguments and the ISA-L specific ones */
+static int
+compdev_isal_parse_args(struct rte_compressdev_pmd_init_params *params,
+		uint16_t *nb_workers, uint16_t *batch_size, const char *args)
+{
+	struct rte_kvargs *kvlist;
+	int workers = 0;
+	int batch = 0;
+	int ret;
+
+	if (args == NULL || args[0] == '\0')
+		return 0;
+
+	kvlist = rte_kvargs_parse(args, compdev_isal_valid_params);
+	if (kvlist == NULL)
+		return -EINVAL;
+
+	ret = rte_kvargs_process(kvlist, RTE_COMPRESSDEV_PMD_SOCKET_ID_ARG,
+			&compdev_isal_parse_socket_id_arg, &params->socket_id);
+	if (ret < 0)
+		goto free_kvlist;
+
+	ret = rte_kvargs_process(kvlist, RTE_COMPRESSDEV_PMD_NAME_ARG,
+			&compdev_isal_parse_name_arg, params);
+	if (ret < 0)
+		goto free_kvlist;
+
+	ret = rte_kvargs_process(kvlist, ISAL_ASYNC_WORKERS_ARG,
+			&compdev_isal_parse_uint_arg, &workers);
+	if (ret < 0)
+		goto free_kvlist;
+
+	if (workers > ISAL_ASYNC_WORKERS_MAX) {
+		ISAL_PMD_LOG(ERR, "At most %u helper threads per queue pair",
+				ISAL_ASYNC_WORKERS_MAX);
+		ret = -EINVAL;
+		goto free_kvlist;
+	}
+	*nb_workers = workers;
+
+	ret = rte_kvargs_process(kvlist, ISAL_BATCH_SIZE_ARG,
+			&compdev_isal_parse_uint_arg, &batch);
+	if (ret < 0)
+		goto free_kvlist;
+
+	if (batch > ISAL_BATCH_SIZE_MAX) {
+		ISAL_PMD_LOG(ERR, "At most %u ops per Huffman batch",
+				ISAL_BATCH_SIZE_MAX);
+		ret = -EINVAL;
+		goto free_kvlist;
+	}
+	*batch_size = batch;
+
+free_kvlist:
+	rte_kvargs_free(kvlist);
+	return ret;
+}
+
 /** Initialise ISA-L compression device */
 static int
 compdev_isal_probe(struct rte_vdev_device *dev)
@@ -728,6 +1018,8 @@ compdev_isal_probe(struct rte_vdev_device *dev)
 		rte_socket_id(),
 	};
 	const char *name, *args;
+	uint16_t nb_workers = 0;
+	uint16_t batch_size = 0;
 	int retval;
 
 	name = rte_vdev_device_name(dev);
@@ -736,14 +1028,16 @@ compdev_isal_probe(struct rte_vdev_device *dev)
 
 	args = rte_vdev_device_args(dev);
 
-	retval = rte_compressdev_pmd_parse_input_args(&init_params, args);
+	retval = compdev_isal_parse_args(&init_params, &nb_workers,
+			&batch_size, args);
 	if (retval) {
 		ISAL_PMD_LOG(ERR,
 			"Failed to parse initialisation arguments[%s]\n", args);
 		return -EINVAL;
 	}
 
-	return compdev_isal_create(name, dev, &init_params);
+	return compdev_isal_create(name, dev, &init_params, nb_workers,
+			batch_size);
 }
 
 static struct rte_vdev_driver compdev_isal_pmd_drv = {
@@ -753,5 +1047,7 @@ static struct rte_vdev_driver compdev_isal_pmd_drv = {
 
 RTE_PMD_REGISTER_VDEV(COMPDEV_NAME_ISAL_PMD, compdev_isal_pmd_drv);
 RTE_PMD_REGISTER_PARAM_STRING(COMPDEV_NAME_ISAL_PMD,
-	"socket_id=<int>");
+	"socket_id=<int> "
+	"async_workers=<int> "
+	"batch_size=<int>");
 RTE_LOG_REGISTER_DEFAULT(isal_logtype_driver, INFO);
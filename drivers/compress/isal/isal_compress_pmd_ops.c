@@ -6,10 +6,19 @@
 #include <rte_common.h>
 #include <rte_cpuflags.h>
 #include <rte_compressdev_pmd.h>
+#include <rte_cycles.h>
 #include <rte_malloc.h>
+#include <rte_pause.h>
 
 #include "isal_compress_pmd_private.h"
 
+/* Ops taken at once by a helper thread */
+#define ISAL_WORKER_BURST		32
+/* Empty polls before a helper thread starts sleeping */
+#define ISAL_WORKER_IDLE_SPINS		1024
+/* Sleep time of an idle helper thread */
+#define ISAL_WORKER_IDLE_SLEEP_US	10
+
 static const struct rte_compressdev_capabilities isal_pmd_capabilities[] = {
 	{
 		.algo = RTE_COMP_ALGO_DEFLATE,
@@ -116,7 +125,7 @@ static void
 isal_comp_pmd_stats_get(struct rte_compressdev *dev,
 		struct rte_compressdev_stats *stats)
 {
-	uint16_t qp_id;
+	uint16_t qp_id, i;
 
 	for (qp_id = 0; qp_id < dev->data->nb_queue_pairs; qp_id++) {
 		struct isal_comp_qp *qp = dev->data->queue_pairs[qp_id];
@@ -126,6 +135,11 @@ isal_comp_pmd_stats_get(struct rte_compressdev *dev,
 
 		stats->enqueue_err_count += qp->qp_stats.enqueue_err_count;
 		stats->dequeue_err_count += qp->qp_stats.dequeue_err_count;
+
+		for (i = 0; i < qp->nb_workers; i++)
+			stats->enqueue_err_count += rte_atomic_load_explicit(
+					&qp->workers[i].err_count,
+					rte_memory_order_relaxed);
 	}
 }
 
@@ -160,12 +174,212 @@ isal_comp_pmd_info_get(struct rte_compressdev *dev __rte_unused,
 static void
 isal_comp_pmd_stats_reset(struct rte_compressdev *dev)
 {
-	uint16_t qp_id;
+	uint16_t qp_id, i;
 
 	for (qp_id = 0; qp_id < dev->data->nb_queue_pairs; qp_id++) {
 		struct isal_comp_qp *qp = dev->data->queue_pairs[qp_id];
 		memset(&qp->qp_stats, 0, sizeof(qp->qp_stats));
+
+		for (i = 0; i < qp->nb_workers; i++)
+			rte_atomic_store_explicit(&qp->workers[i].err_count, 0,
+					rte_memory_order_relaxed);
+	}
+}
+
+/** Allocate compression stream and decompression state */
+static int
+isal_comp_pmd_ctx_alloc(struct isal_zstream **stream,
+		struct inflate_state **state, int socket_id)
+{
+	/* Initialize memory for compression stream structure */
+	*stream = rte_zmalloc_socket("Isa-l compression stream ",
+			sizeof(struct isal_zstream),  RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (*stream == NULL) {
+		ISAL_PMD_LOG(ERR, "Failed to allocate compression stream memory");
+		return -ENOMEM;
+	}
+	/* Initialize memory for compression level buffer */
+	(*stream)->level_buf = rte_zmalloc_socket("Isa-l compression lev_buf",
+			ISAL_DEF_LVL3_DEFAULT, RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if ((*stream)->level_buf == NULL) {
+		ISAL_PMD_LOG(ERR, "Failed to allocate compression level_buf memory");
+		return -ENOMEM;
+	}
+
+	/* Initialize memory for decompression state structure */
+	*state = rte_zmalloc_socket("Isa-l decompression state",
+			sizeof(struct inflate_state), RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (*state == NULL) {
+		ISAL_PMD_LOG(ERR, "Failed to allocate decompression state memory");
+		return -ENOMEM;
 	}
+
+	return 0;
+}
+
+/** Allocate Huffman tables shared by the ops of a batch */
+static struct isal_comp_batch *
+isal_comp_pmd_batch_alloc(uint16_t batch_size, int socket_id)
+{
+	struct isal_comp_batch *batch;
+
+	if (batch_size < 2)
+		return NULL;
+
+	batch = rte_zmalloc_socket("Isa-l compression batch",
+			sizeof(struct isal_comp_batch), RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (batch == NULL)
+		ISAL_PMD_LOG(ERR, "Failed to allocate Huffman batch memory,"
+				" ops are compressed one by one");
+
+	return batch;
+}
+
+/** Free compression stream and decompression state */
+static void
+isal_comp_pmd_ctx_free(struct isal_zstream *stream,
+		struct inflate_state *state)
+{
+	if (stream)
+		rte_free(stream->level_buf);
+	rte_free(stream);
+	rte_free(state);
+}
+
+/** Helper thread processing the ops of one share of a queue pair */
+static uint32_t
+isal_comp_pmd_worker_loop(void *arg)
+{
+	struct isal_comp_worker *worker = arg;
+	struct rte_comp_op *ops[ISAL_WORKER_BURST];
+	unsigned int idle = 0;
+	unsigned int nb_ops;
+	uint16_t nb_err;
+
+	while (rte_atomic_load_explicit(&worker->quit,
+			rte_memory_order_relaxed) == 0) {
+		nb_ops = rte_ring_sc_dequeue_burst(worker->todo, (void **)ops,
+				ISAL_WORKER_BURST, NULL);
+		if (nb_ops == 0) {
+			if (idle < ISAL_WORKER_IDLE_SPINS) {
+				idle++;
+				rte_pause();
+			} else {
+				rte_delay_us_sleep(ISAL_WORKER_IDLE_SLEEP_US);
+			}
+			continue;
+		}
+		idle = 0;
+
+		nb_err = isal_comp_process_burst(worker->stream, worker->state,
+				worker->batch, worker->batch_size, ops, nb_ops);
+		if (nb_err != 0)
+			rte_atomic_fetch_add_explicit(&worker->err_count,
+					nb_err, rte_memory_order_relaxed);
+
+		/*
+		 * Cannot fail: the queue pair never has more ops in flight
+		 * for a worker than its rings can hold.
+		 */
+		rte_ring_sp_enqueue_burst(worker->done, (void **)ops, nb_ops,
+				NULL);
+	}
+
+	return 0;
+}
+
+/** Stop the helper threads of a queue pair and free their resources */
+static void
+isal_comp_pmd_qp_workers_release(struct isal_comp_qp *qp)
+{
+	struct isal_comp_worker *worker;
+	uint16_t i;
+
+	if (qp->workers == NULL)
+		return;
+
+	for (i = 0; i < qp->nb_workers; i++) {
+		worker = &qp->workers[i];
+		if (worker->running) {
+			rte_atomic_store_explicit(&worker->quit, 1,
+					rte_memory_order_relaxed);
+			rte_thread_join(worker->tid, NULL);
+		}
+		rte_ring_free(worker->todo);
+		rte_ring_free(worker->done);
+		isal_comp_pmd_ctx_free(worker->stream, worker->state);
+		rte_free(worker->batch);
+	}
+
+	rte_free(qp->workers);
+	qp->workers = NULL;
+}
+
+/** Start the helper threads of a queue pair */
+static int
+isal_comp_pmd_qp_workers_setup(struct rte_compressdev *dev,
+		struct isal_comp_qp *qp, uint16_t nb_workers,
+		uint16_t batch_size, uint32_t max_inflight_ops, int socket_id)
+{
+	char name[RTE_RING_NAMESIZE];
+	struct isal_comp_worker *worker;
+	unsigned int ring_size;
+	uint16_t i;
+
+	qp->workers = rte_zmalloc_socket("Isa-l compression workers",
+			sizeof(*qp->workers) * nb_workers,
+			RTE_CACHE_LINE_SIZE, socket_id);
+	if (qp->workers == NULL) {
+		ISAL_PMD_LOG(ERR, "Failed to allocate helper thread memory");
+		return -ENOMEM;
+	}
+	qp->nb_workers = nb_workers;
+
+	/*
+	 * Ops are spread round-robin, so a worker never holds more than
+	 * its share of the in-flight ops of the queue pair.
+	 */
+	ring_size = RTE_MAX(1U, (max_inflight_ops + nb_workers - 1) / nb_workers);
+
+	for (i = 0; i < nb_workers; i++) {
+		worker = &qp->workers[i];
+
+		if (isal_comp_pmd_ctx_alloc(&worker->stream, &worker->state,
+				socket_id) < 0)
+			return -ENOMEM;
+		worker->batch = isal_comp_pmd_batch_alloc(batch_size,
+				socket_id);
+		worker->batch_size = RTE_MIN(batch_size, ISAL_WORKER_BURST);
+
+		snprintf(name, sizeof(name), "isal_%u_%u_w%u_todo",
+				dev->data->dev_id, qp->id, i);
+		worker->todo = rte_ring_create(name, ring_size, socket_id,
+				RING_F_SP_ENQ | RING_F_SC_DEQ | RING_F_EXACT_SZ);
+		snprintf(name, sizeof(name), "isal_%u_%u_w%u_done",
+				dev->data->dev_id, qp->id, i);
+		worker->done = rte_ring_create(name, ring_size, socket_id,
+				RING_F_SP_ENQ | RING_F_SC_DEQ | RING_F_EXACT_SZ);
+		if (worker->todo == NULL || worker->done == NULL) {
+			ISAL_PMD_LOG(ERR, "Failed to create helper thread rings");
+			return -ENOMEM;
+		}
+
+		snprintf(name, sizeof(name), "isal%u-%u-%u",
+				dev->data->dev_id, qp->id, i);
+		if (rte_thread_create_internal_control(&worker->tid, name,
+				isal_comp_pmd_worker_loop, worker) != 0) {
+			ISAL_PMD_LOG(ERR, "Failed to create helper thread %s",
+					name);
+			return -EAGAIN;
+		}
+		worker->running = true;
+	}
+
+	return 0;
 }
 
 /** Release queue pair */
@@ -177,12 +391,10 @@ isal_comp_pmd_qp_release(struct rte_compressdev *dev, uint16_t qp_id)
 	if (qp == NULL)
 		return -EINVAL;
 
-	if (qp->stream)
-		rte_free(qp->stream->level_buf);
-
-	rte_free(qp->state);
+	isal_comp_pmd_qp_workers_release(qp);
+	isal_comp_pmd_ctx_free(qp->stream, qp->state);
+	rte_free(qp->batch);
 	rte_ring_free(qp->processed_pkts);
-	rte_free(qp->stream);
 	rte_free(qp);
 	dev->data->queue_pairs[qp_id] = NULL;
 
@@ -236,6 +448,7 @@ static int
 isal_comp_pmd_qp_setup(struct rte_compressdev *dev, uint16_t qp_id,
 		uint32_t max_inflight_ops, int socket_id)
 {
+	struct isal_comp_private *internals = dev->data->dev_private;
 	struct isal_comp_qp *qp = NULL;
 	int retval;
 
@@ -251,30 +464,14 @@ isal_comp_pmd_qp_setup(struct rte_compressdev *dev, uint16_t qp_id,
 		return (-ENOMEM);
 	}
 
-	/* Initialize memory for compression stream structure */
-	qp->stream = rte_zmalloc_socket("Isa-l compression stream ",
-			sizeof(struct isal_zstream),  RTE_CACHE_LINE_SIZE,
-			socket_id);
-	if (qp->stream == NULL) {
-		ISAL_PMD_LOG(ERR, "Failed to allocate compression stream memory");
-		goto qp_setup_cleanup;
-	}
-	/* Initialize memory for compression level buffer */
-	qp->stream->level_buf = rte_zmalloc_socket("Isa-l compression lev_buf",
-			ISAL_DEF_LVL3_DEFAULT, RTE_CACHE_LINE_SIZE,
-			socket_id);
-	if (qp->stream->level_buf == NULL) {
-		ISAL_PMD_LOG(ERR, "Failed to allocate compression level_buf memory");
+	if (isal_comp_pmd_ctx_alloc(&qp->stream, &qp->state, socket_id) < 0)
 		goto qp_setup_cleanup;
-	}
 
-	/* Initialize memory for decompression state structure */
-	qp->state = rte_zmalloc_socket("Isa-l decompression state",
-			sizeof(struct inflate_state), RTE_CACHE_LINE_SIZE,
-			socket_id);
-	if (qp->state == NULL) {
-		ISAL_PMD_LOG(ERR, "Failed to allocate decompression state memory");
-		goto qp_setup_cleanup;
+	/* Helper threads have their own tables */
+	if (internals->nb_workers == 0) {
+		qp->batch = isal_comp_pmd_batch_alloc(internals->batch_size,
+				socket_id);
+		qp->batch_size = internals->batch_size;
 	}
 
 	qp->id = qp_id;
@@ -297,15 +494,22 @@ isal_comp_pmd_qp_setup(struct rte_compressdev *dev, uint16_t qp_id,
 
 	qp->num_free_elements = rte_ring_free_count(qp->processed_pkts);
 
+	if (internals->nb_workers != 0 &&
+			isal_comp_pmd_qp_workers_setup(dev, qp,
+				internals->nb_workers, internals->batch_size,
+				qp->num_free_elements, socket_id) < 0)
+		goto qp_setup_cleanup;
+
 	memset(&qp->qp_stats, 0, sizeof(qp->qp_stats));
 	return 0;
 
 qp_setup_cleanup:
-	if (qp->stream)
-		rte_free(qp->stream->level_buf);
-	rte_free(qp->stream);
-	rte_free(qp->state);
+	isal_comp_pmd_qp_workers_release(qp);
+	isal_comp_pmd_ctx_free(qp->stream, qp->state);
+	rte_free(qp->batch);
+	rte_ring_free(qp->processed_pkts);
 	rte_free(qp);
+	dev->data->queue_pairs[qp_id] = NULL;
 
 	return -1;
 }
@@ -337,6 +541,17 @@ isal_comp_pmd_priv_xform_create(struct rte_compressdev *dev,
 		rte_mempool_put(internals->priv_xform_mp, priv_xform);
 		return ret;
 	}
+
+	/* With batches, the default level is the one using their tables */
+	if (internals->batch_size > 1 && xform->type == RTE_COMP_COMPRESS &&
+			xform->compress.deflate.huffman ==
+				RTE_COMP_HUFFMAN_DYNAMIC &&
+			xform->compress.level == RTE_COMP_LEVEL_PMD_DEFAULT) {
+		struct isal_priv_xform *priv = *priv_xform;
+
+		priv->compress.level = ISAL_BATCH_LEVEL;
+		priv->level_buffer_size = ISAL_DEF_LVL0_DEFAULT;
+	}
 	return 0;
 }
 
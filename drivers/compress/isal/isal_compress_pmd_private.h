@@ -5,9 +5,21 @@
 #ifndef _ISAL_COMP_PMD_PRIVATE_H_
 #define _ISAL_COMP_PMD_PRIVATE_H_
 
+#include <rte_stdatomic.h>
+#include <rte_thread.h>
+
 #define COMPDEV_NAME_ISAL_PMD		compress_isal
 /**< ISA-L comp PMD device name */
 
+/* Device argument giving the number of helper threads per queue pair */
+#define ISAL_ASYNC_WORKERS_ARG		("async_workers")
+#define ISAL_ASYNC_WORKERS_MAX		16
+/* Device argument giving the most ops sharing one set of Huffman tables */
+#define ISAL_BATCH_SIZE_ARG		("batch_size")
+#define ISAL_BATCH_SIZE_MAX		64
+/* ISA-L level of the single pass encoder, the only one taking Huffman tables */
+#define ISAL_BATCH_LEVEL		0
+
 extern int isal_logtype_driver;
 #define ISAL_PMD_LOG(level, fmt, args...) \
 	rte_log(RTE_LOG_ ## level, isal_logtype_driver, "%s(): "fmt "\n", \
@@ -16,8 +28,44 @@ extern int isal_logtype_driver;
 /* private data structure for each ISA-L compression device */
 struct isal_comp_private {
 	struct rte_mempool *priv_xform_mp;
+	/* Helper threads per queue pair, 0 to process ops on enqueue */
+	uint16_t nb_workers;
+	/* Most ops compressed with one set of Huffman tables, 0 to disable */
+	uint16_t batch_size;
 };
 
+/** Huffman tables shared by a batch of small ops */
+struct isal_comp_batch {
+	/* Symbol counts of the batch */
+	struct isal_huff_histogram histogram;
+	/* Tables built from the histogram */
+	struct isal_hufftables hufftables;
+} __rte_cache_aligned;
+
+/** Helper thread processing a share of the ops of a queue pair */
+struct isal_comp_worker {
+	/* Ring of ops to process */
+	struct rte_ring *todo;
+	/* Ring of processed ops, in the order they were given */
+	struct rte_ring *done;
+	/* Compression stream information*/
+	struct isal_zstream *stream;
+	/* Decompression state information*/
+	struct inflate_state *state;
+	/* Huffman tables for batches, NULL if disabled */
+	struct isal_comp_batch *batch;
+	/* Most ops compressed with one set of Huffman tables */
+	uint16_t batch_size;
+	/* Number of ops which failed */
+	RTE_ATOMIC(uint64_t) err_count;
+	/* Set to stop the thread */
+	RTE_ATOMIC(uint32_t) quit;
+	/* Thread identifier */
+	rte_thread_t tid;
+	/* Thread was started */
+	bool running;
+} __rte_cache_aligned;
+
 /** ISA-L queue pair */
 struct isal_comp_qp {
 	/* Queue Pair Identifier */
@@ -34,6 +82,18 @@ struct isal_comp_qp {
 	struct inflate_state *state;
 	/* Number of free elements on ring */
 	uint16_t num_free_elements;
+	/* Number of helper threads, 0 if ops are processed on enqueue */
+	uint16_t nb_workers;
+	/* Worker given the next enqueued op */
+	uint16_t enq_worker;
+	/* Worker returning the next dequeued op */
+	uint16_t deq_worker;
+	/* Helper threads */
+	struct isal_comp_worker *workers;
+	/* Huffman tables for batches, NULL if disabled */
+	struct isal_comp_batch *batch;
+	/* Most ops compressed with one set of Huffman tables */
+	uint16_t batch_size;
 } __rte_cache_aligned;
 
 /** ISA-L private xform structure */
@@ -51,6 +111,21 @@ extern int
 isal_comp_set_priv_xform_parameters(struct isal_priv_xform *priv_xform,
 			const struct rte_comp_xform *xform);
 
+/** Process an op with the given compression and decompression state,
+ * returns a negative value if it did not complete successfully
+ */
+int
+isal_comp_process_op(struct isal_zstream *stream, struct inflate_state *state,
+		struct rte_comp_op *op);
+
+/** Process a burst of ops, sharing Huffman tables between small compression
+ * ops when batch is not NULL, returns the number of ops which failed
+ */
+uint16_t
+isal_comp_process_burst(struct isal_zstream *stream,
+		struct inflate_state *state, struct isal_comp_batch *batch,
+		uint16_t batch_size, struct rte_comp_op **ops, uint16_t nb_ops);
+
 /** device specific operations function pointer structure */
 extern struct rte_compressdev_ops *isal_compress_pmd_ops;
 
@@ -0,0 +1,693 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#include <string.h>
+
+#include <bus_vdev_driver.h>
+#include <rte_byteorder.h>
+#include <rte_common.h>
+#include <rte_malloc.h>
+
+#include "lz4_pmd_private.h"
+
+#define XXH_PRIME32_1 0x9E3779B1U
+#define XXH_PRIME32_2 0x85EBCA77U
+#define XXH_PRIME32_3 0xC2B2AE3DU
+#define XXH_PRIME32_4 0x27D4EB2FU
+#define XXH_PRIME32_5 0x165667B1U
+
+/** Position in a chain of mbufs */
+struct lz4_buf {
+	struct rte_mbuf *m;
+	uint8_t *data;
+	uint32_t len;
+	/**< Bytes left in the current segment, 0 once the chain is used up */
+};
+
+static inline uint32_t
+xxh32_rotl(uint32_t x, unsigned int r)
+{
+	return (x << r) | (x >> (32 - r));
+}
+
+static inline uint32_t
+xxh32_read(const uint8_t *p)
+{
+	uint32_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return rte_le_to_cpu_32(v);
+}
+
+static inline uint32_t
+xxh32_round(uint32_t acc, uint32_t input)
+{
+	acc += input * XXH_PRIME32_2;
+	acc = xxh32_rotl(acc, 13);
+	return acc * XXH_PRIME32_1;
+}
+
+static inline void
+xxh32_stripe(uint32_t v[4], const uint8_t *p)
+{
+	v[0] = xxh32_round(v[0], xxh32_read(p));
+	v[1] = xxh32_round(v[1], xxh32_read(p + 4));
+	v[2] = xxh32_round(v[2], xxh32_read(p + 8));
+	v[3] = xxh32_round(v[3], xxh32_read(p + 12));
+}
+
+static void
+lz4_xxh32_reset(struct lz4_xxh32_state *st, uint32_t seed)
+{
+	memset(st, 0, sizeof(*st));
+	st->seed = seed;
+	st->v[0] = seed + XXH_PRIME32_1 + XXH_PRIME32_2;
+	st->v[1] = seed + XXH_PRIME32_2;
+	st->v[2] = seed;
+	st->v[3] = seed - XXH_PRIME32_1;
+}
+
+static void
+lz4_xxh32_update(struct lz4_xxh32_state *st, const uint8_t *p, size_t len)
+{
+	const uint8_t *end = p + len;
+	size_t fill;
+
+	st->total_len += len;
+
+	if (st->memsize + len < sizeof(st->mem)) {
+		memcpy(st->mem + st->memsize, p, len);
+		st->memsize += len;
+		return;
+	}
+
+	if (st->memsize != 0) {
+		fill = sizeof(st->mem) - st->memsize;
+		memcpy(st->mem + st->memsize, p, fill);
+		xxh32_stripe(st->v, st->mem);
+		p += fill;
+		st->memsize = 0;
+	}
+
+	for (; p + sizeof(st->mem) <= end; p += sizeof(st->mem))
+		xxh32_stripe(st->v, p);
+
+	st->memsize = end - p;
+	memcpy(st->mem, p, st->memsize);
+}
+
+static uint32_t
+lz4_xxh32_digest(const struct lz4_xxh32_state *st)
+{
+	const uint8_t *p = st->mem;
+	const uint8_t *end = p + st->memsize;
+	uint32_t h;
+
+	if (st->total_len >= sizeof(st->mem))
+		h = xxh32_rotl(st->v[0], 1) + xxh32_rotl(st->v[1], 7) +
+			xxh32_rotl(st->v[2], 12) + xxh32_rotl(st->v[3], 18);
+	else
+		h = st->seed + XXH_PRIME32_5;
+
+	h += (uint32_t)st->total_len;
+
+	for (; p + 4 <= end; p += 4) {
+		h += xxh32_read(p) * XXH_PRIME32_3;
+		h = xxh32_rotl(h, 17) * XXH_PRIME32_4;
+	}
+	for (; p < end; p++) {
+		h += *p * XXH_PRIME32_5;
+		h = xxh32_rotl(h, 11) * XXH_PRIME32_1;
+	}
+
+	h ^= h >> 15;
+	h *= XXH_PRIME32_2;
+	h ^= h >> 13;
+	h *= XXH_PRIME32_3;
+	h ^= h >> 16;
+
+	return h;
+}
+
+/** Move n bytes forward, skipping to the next non-empty segment when
+ *  the current one is used up, returns false at the end of the chain
+ */
+static inline bool
+lz4_buf_advance(struct lz4_buf *b, uint32_t n)
+{
+	b->data += n;
+	b->len -= n;
+	while (b->len == 0) {
+		if (b->m->next == NULL)
+			return false;
+		b->m = b->m->next;
+		b->data = rte_pktmbuf_mtod(b->m, uint8_t *);
+		b->len = rte_pktmbuf_data_len(b->m);
+	}
+	return true;
+}
+
+static inline void
+lz4_buf_init(struct lz4_buf *b, struct rte_mbuf *m, uint32_t offset)
+{
+	b->m = m;
+	b->data = rte_pktmbuf_mtod_offset(m, uint8_t *, offset);
+	b->len = rte_pktmbuf_data_len(m) - offset;
+	lz4_buf_advance(b, 0);
+}
+
+/** Reset a stream after an op left it in the middle of a frame */
+static void
+lz4_stream_reset(struct lz4_stream *stream)
+{
+	stream->stage_len = 0;
+	stream->stage_off = 0;
+	stream->frame_open = 0;
+	if (stream->type == RTE_COMP_DECOMPRESS)
+		LZ4F_resetDecompressionContext(stream->dctx);
+}
+
+/** Copy the staged compressor output to the destination,
+ *  returns false if it does not all fit
+ */
+static bool
+lz4_stage_drain(struct lz4_stream *stream, struct lz4_buf *dst,
+		uint32_t *produced)
+{
+	size_t n;
+
+	while (stream->stage_len != 0) {
+		if (dst->len == 0)
+			return false;
+		n = RTE_MIN(stream->stage_len, (size_t)dst->len);
+		memcpy(dst->data, stream->stage + stream->stage_off, n);
+		stream->stage_off += n;
+		stream->stage_len -= n;
+		*produced += n;
+		lz4_buf_advance(dst, n);
+	}
+	stream->stage_off = 0;
+
+	return true;
+}
+
+/** Compressor output goes straight to the destination segment
+ *  when the worst case fits in it, else to the stage
+ */
+static inline uint8_t *
+lz4_out_target(struct lz4_stream *stream, struct lz4_buf *dst, size_t need)
+{
+	return dst->len >= need ? dst->data : stream->stage;
+}
+
+static inline bool
+lz4_out_commit(struct lz4_stream *stream, struct lz4_buf *dst,
+		uint8_t *target, size_t n, uint32_t *produced)
+{
+	if (target != stream->stage) {
+		*produced += n;
+		lz4_buf_advance(dst, n);
+		return true;
+	}
+
+	stream->stage_len = n;
+	stream->stage_off = 0;
+	return lz4_stage_drain(stream, dst, produced);
+}
+
+static void
+process_lz4_compress(struct rte_comp_op *op, struct lz4_stream *stream)
+{
+	bool stateful = (op->op_type == RTE_COMP_OP_STATEFUL);
+	struct lz4_xxh32_state xxh_op;
+	struct lz4_xxh32_state *xxh = stateful ? &stream->xxh : &xxh_op;
+	uint32_t remaining = op->src.length;
+	uint32_t consumed = 0, produced = 0;
+	LZ4F_preferences_t prefs;
+	struct lz4_buf src, dst;
+	uint8_t *target;
+	uint32_t chunk;
+	bool pending;
+	size_t ret;
+
+	/* only a stream can leave its frame open */
+	if (unlikely(op->flush_flag > RTE_COMP_FLUSH_FINAL ||
+			(!stateful && op->flush_flag < RTE_COMP_FLUSH_FULL))) {
+		op->status = RTE_COMP_OP_STATUS_INVALID_ARGS;
+		LZ4_PMD_ERR("Invalid flush value");
+		return;
+	}
+
+	lz4_buf_init(&src, op->m_src, op->src.offset);
+	lz4_buf_init(&dst, op->m_dst, op->dst.offset);
+
+	if (!stateful)
+		lz4_xxh32_reset(xxh, (uint32_t)op->input_chksum);
+
+	op->status = RTE_COMP_OP_STATUS_SUCCESS;
+
+	/* Output left over by the previous op of the stream goes first */
+	pending = (stream->stage_len != 0);
+	if (!lz4_stage_drain(stream, &dst, &produced))
+		goto out_of_space;
+
+	if (!stream->frame_open && (remaining != 0 || !pending)) {
+		prefs = stream->prefs;
+		if (stream->content_size)
+			prefs.frameInfo.contentSize = op->src.length;
+
+		target = lz4_out_target(stream, &dst, LZ4F_HEADER_SIZE_MAX);
+		ret = LZ4F_compressBegin(stream->cctx, target,
+				LZ4F_HEADER_SIZE_MAX, &prefs);
+		if (LZ4F_isError(ret))
+			goto error;
+		stream->frame_open = 1;
+		if (!lz4_out_commit(stream, &dst, target, ret, &produced))
+			goto out_of_space;
+	}
+
+	while (remaining != 0) {
+		if (unlikely(src.len == 0)) {
+			/* source chain shorter than the op length */
+			op->status = RTE_COMP_OP_STATUS_INVALID_ARGS;
+			LZ4_PMD_ERR("Source buffer shorter than op length");
+			lz4_stream_reset(stream);
+			return;
+		}
+
+		chunk = RTE_MIN(RTE_MIN(remaining, src.len),
+				(uint32_t)LZ4_PMD_CHUNK_SZ);
+		target = lz4_out_target(stream, &dst, stream->bound);
+		ret = LZ4F_compressUpdate(stream->cctx, target, stream->bound,
+				src.data, chunk, NULL);
+		if (LZ4F_isError(ret))
+			goto error;
+
+		if (stream->chksum == RTE_COMP_CHECKSUM_XXHASH32)
+			lz4_xxh32_update(xxh, src.data, chunk);
+		lz4_buf_advance(&src, chunk);
+		remaining -= chunk;
+		consumed += chunk;
+
+		if (!lz4_out_commit(stream, &dst, target, ret, &produced))
+			goto out_of_space;
+	}
+
+	if (stream->frame_open && op->flush_flag != RTE_COMP_FLUSH_NONE) {
+		target = lz4_out_target(stream, &dst, stream->bound);
+		if (op->flush_flag == RTE_COMP_FLUSH_SYNC) {
+			ret = LZ4F_flush(stream->cctx, target, stream->bound,
+					NULL);
+		} else {
+			/* a full flush starts a new, independent frame */
+			ret = LZ4F_compressEnd(stream->cctx, target,
+					stream->bound, NULL);
+			stream->frame_open = 0;
+		}
+		if (LZ4F_isError(ret))
+			goto error;
+		if (!lz4_out_commit(stream, &dst, target, ret, &produced))
+			goto out_of_space;
+	}
+
+	op->consumed += consumed;
+	op->produced += produced;
+	goto chksum;
+
+out_of_space:
+	if (!stateful) {
+		op->status = RTE_COMP_OP_STATUS_OUT_OF_SPACE_TERMINATED;
+		op->produced += produced;
+		lz4_stream_reset(stream);
+		return;
+	}
+	/* the stage keeps the output for the next op of the stream */
+	op->status = RTE_COMP_OP_STATUS_OUT_OF_SPACE_RECOVERABLE;
+	op->consumed += consumed;
+	op->produced += produced;
+
+chksum:
+	if (stream->chksum == RTE_COMP_CHECKSUM_XXHASH32)
+		op->output_chksum = lz4_xxh32_digest(xxh);
+	return;
+
+error:
+	op->status = RTE_COMP_OP_STATUS_ERROR;
+	LZ4_PMD_ERR("%s", LZ4F_getErrorName(ret));
+	lz4_stream_reset(stream);
+}
+
+static void
+process_lz4_decompress(struct rte_comp_op *op, struct lz4_stream *stream)
+{
+	bool stateful = (op->op_type == RTE_COMP_OP_STATEFUL);
+	struct lz4_xxh32_state xxh_op;
+	struct lz4_xxh32_state *xxh = stateful ? &stream->xxh : &xxh_op;
+	uint32_t remaining = op->src.length;
+	uint32_t consumed = 0, produced = 0;
+	struct lz4_buf src, dst;
+	size_t in_sz, out_sz;
+	bool dst_full = false;
+	size_t ret = 1;
+
+	lz4_buf_init(&src, op->m_src, op->src.offset);
+	lz4_buf_init(&dst, op->m_dst, op->dst.offset);
+
+	if (!stateful)
+		lz4_xxh32_reset(xxh, (uint32_t)op->input_chksum);
+
+	/** Ignoring flush value provided from application for decompression */
+	op->status = RTE_COMP_OP_STATUS_SUCCESS;
+
+	for (;;) {
+		if (dst.len == 0) {
+			dst_full = true;
+			break;
+		}
+		if (unlikely(remaining != 0 && src.len == 0)) {
+			op->status = RTE_COMP_OP_STATUS_INVALID_ARGS;
+			LZ4_PMD_ERR("Source buffer shorter than op length");
+			lz4_stream_reset(stream);
+			return;
+		}
+
+		in_sz = RTE_MIN(remaining, src.len);
+		out_sz = dst.len;
+		ret = LZ4F_decompress(stream->dctx, dst.data, &out_sz,
+				src.data, &in_sz, NULL);
+		if (LZ4F_isError(ret)) {
+			op->status = RTE_COMP_OP_STATUS_ERROR;
+			LZ4_PMD_ERR("%s", LZ4F_getErrorName(ret));
+			lz4_stream_reset(stream);
+			return;
+		}
+
+		if (stream->chksum == RTE_COMP_CHECKSUM_XXHASH32)
+			lz4_xxh32_update(xxh, dst.data, out_sz);
+		lz4_buf_advance(&src, in_sz);
+		lz4_buf_advance(&dst, out_sz);
+		remaining -= in_sz;
+		consumed += in_sz;
+		produced += out_sz;
+
+		/* frame fully decoded and no more input */
+		if (ret == 0 && remaining == 0)
+			break;
+		/* no progress, more input is needed */
+		if (in_sz == 0 && out_sz == 0)
+			break;
+	}
+
+	if (dst_full) {
+		if (!stateful) {
+			/* there is no more space for decompressed output */
+			op->status = RTE_COMP_OP_STATUS_OUT_OF_SPACE_TERMINATED;
+			op->produced += produced;
+			lz4_stream_reset(stream);
+			return;
+		}
+		op->status = RTE_COMP_OP_STATUS_OUT_OF_SPACE_RECOVERABLE;
+	} else if (ret != 0 && !stateful) {
+		/* a stateless op must hold whole frames */
+		op->status = RTE_COMP_OP_STATUS_ERROR;
+		LZ4_PMD_ERR("Truncated LZ4 frame");
+		lz4_stream_reset(stream);
+		return;
+	}
+
+	op->consumed += consumed;
+	op->produced += produced;
+	if (stream->chksum == RTE_COMP_CHECKSUM_XXHASH32)
+		op->output_chksum = lz4_xxh32_digest(xxh);
+}
+
+/** Process comp operation for mbuf */
+static inline int
+process_lz4_op(struct lz4_qp *qp, struct rte_comp_op *op)
+{
+	struct lz4_stream *stream;
+
+	if ((op->m_dst == NULL) ||
+			(op->src.offset > rte_pktmbuf_data_len(op->m_src)) ||
+			(op->dst.offset > rte_pktmbuf_data_len(op->m_dst))) {
+		op->status = RTE_COMP_OP_STATUS_INVALID_ARGS;
+		LZ4_PMD_ERR("Invalid source or destination buffers");
+	} else {
+		if (op->op_type == RTE_COMP_OP_STATEFUL)
+			stream = op->stream;
+		else
+			stream = op->private_xform;
+		stream->comp(op, stream);
+	}
+	/* whatever is out of op, put it into completion queue with
+	 * its status
+	 */
+	return rte_ring_enqueue(qp->processed_pkts, (void *)op);
+}
+
+/** Parse comp xform and set private xform/Stream parameters */
+int
+lz4_set_stream_parameters(const struct rte_comp_xform *xform,
+		struct lz4_stream *stream, bool stateful)
+{
+	enum rte_comp_checksum_type chksum;
+	uint8_t flags;
+	size_t err;
+	int level;
+
+	memset(stream, 0, sizeof(*stream));
+	stream->type = xform->type;
+
+	switch (xform->type) {
+	case RTE_COMP_COMPRESS:
+		if (xform->compress.algo != RTE_COMP_ALGO_LZ4) {
+			LZ4_PMD_ERR("Compression algorithm not supported");
+			return -1;
+		}
+		chksum = xform->compress.chksum;
+		flags = xform->compress.lz4.flags;
+		break;
+	case RTE_COMP_DECOMPRESS:
+		if (xform->decompress.algo != RTE_COMP_ALGO_LZ4) {
+			LZ4_PMD_ERR("Compression algorithm not supported");
+			return -1;
+		}
+		chksum = xform->decompress.chksum;
+		/* frame parameters are read from the frame header */
+		flags = 0;
+		break;
+	default:
+		return -1;
+	}
+
+	if (chksum != RTE_COMP_CHECKSUM_NONE &&
+			chksum != RTE_COMP_CHECKSUM_XXHASH32) {
+		LZ4_PMD_ERR("Checksum type not supported");
+		return -1;
+	}
+	stream->chksum = chksum;
+	lz4_xxh32_reset(&stream->xxh, 0);
+
+	if (flags & RTE_COMP_LZ4_FLAG_DICT_ID) {
+		LZ4_PMD_ERR("LZ4 dictionary ID not supported");
+		return -1;
+	}
+	if ((flags & RTE_COMP_LZ4_FLAG_CONTENT_SIZE) && stateful) {
+		LZ4_PMD_ERR("LZ4 content size not supported on a stream");
+		return -1;
+	}
+
+	if (xform->type == RTE_COMP_DECOMPRESS) {
+		err = LZ4F_createDecompressionContext(&stream->dctx,
+				LZ4F_VERSION);
+		if (LZ4F_isError(err)) {
+			LZ4_PMD_ERR("Decompression context init failed");
+			return -1;
+		}
+		stream->comp = process_lz4_decompress;
+		return 0;
+	}
+
+	/** Compression Level */
+	switch (xform->compress.level) {
+	case RTE_COMP_LEVEL_PMD_DEFAULT:
+	case RTE_COMP_LEVEL_MIN:
+		/* fast LZ4 */
+		level = 0;
+		break;
+	default:
+		level = xform->compress.level;
+		if (level < RTE_COMP_LEVEL_MIN || level > RTE_COMP_LEVEL_MAX) {
+			LZ4_PMD_ERR("Compression level %d not supported",
+					level);
+			return -1;
+		}
+		/* spread the higher levels over the LZ4-HC ones */
+		level = LZ4_PMD_HC_LEVEL_MIN +
+			(level - RTE_COMP_LEVEL_MIN - 1) *
+			(LZ4_PMD_HC_LEVEL_MAX - LZ4_PMD_HC_LEVEL_MIN) /
+			(RTE_COMP_LEVEL_MAX - RTE_COMP_LEVEL_MIN - 1);
+		break;
+	}
+
+	stream->prefs.compressionLevel = level;
+	stream->prefs.frameInfo.blockSizeID = LZ4F_max64KB;
+	stream->prefs.frameInfo.blockMode =
+		(flags & RTE_COMP_LZ4_FLAG_BLOCK_INDEPENDENCE) ?
+		LZ4F_blockIndependent : LZ4F_blockLinked;
+	stream->prefs.frameInfo.contentChecksumFlag =
+		(flags & RTE_COMP_LZ4_FLAG_CONTENT_CHECKSUM) ?
+		LZ4F_contentChecksumEnabled : LZ4F_noContentChecksum;
+	stream->prefs.frameInfo.blockChecksumFlag =
+		(flags & RTE_COMP_LZ4_FLAG_BLOCK_CHECKSUM) ?
+		LZ4F_blockChecksumEnabled : LZ4F_noBlockChecksum;
+	stream->content_size = !!(flags & RTE_COMP_LZ4_FLAG_CONTENT_SIZE);
+
+	err = LZ4F_createCompressionContext(&stream->cctx, LZ4F_VERSION);
+	if (LZ4F_isError(err)) {
+		LZ4_PMD_ERR("Compression context init failed");
+		return -1;
+	}
+
+	stream->bound = LZ4F_compressBound(LZ4_PMD_CHUNK_SZ, &stream->prefs);
+	stream->stage_sz = stream->bound;
+	stream->stage = rte_malloc(NULL, stream->stage_sz, 0);
+	if (stream->stage == NULL) {
+		LZ4_PMD_ERR("Cannot allocate compression output stage");
+		LZ4F_freeCompressionContext(stream->cctx);
+		stream->cctx = NULL;
+		return -1;
+	}
+	stream->comp = process_lz4_compress;
+
+	return 0;
+}
+
+void
+lz4_stream_free(struct lz4_stream *stream)
+{
+	if (stream->type == RTE_COMP_COMPRESS)
+		LZ4F_freeCompressionContext(stream->cctx);
+	else
+		LZ4F_freeDecompressionContext(stream->dctx);
+	rte_free(stream->stage);
+}
+
+static uint16_t
+lz4_pmd_enqueue_burst(void *queue_pair,
+			struct rte_comp_op **ops, uint16_t nb_ops)
+{
+	struct lz4_qp *qp = queue_pair;
+	int ret;
+	uint16_t i;
+	uint16_t enqd = 0;
+
+	for (i = 0; i < nb_ops; i++) {
+		ret = process_lz4_op(qp, ops[i]);
+		if (unlikely(ret < 0)) {
+			/* increment count if failed to push to completion
+			 * queue
+			 */
+			qp->qp_stats.enqueue_err_count++;
+		} else {
+			qp->qp_stats.enqueued_count++;
+			enqd++;
+		}
+	}
+	return enqd;
+}
+
+static uint16_t
+lz4_pmd_dequeue_burst(void *queue_pair,
+			struct rte_comp_op **ops, uint16_t nb_ops)
+{
+	struct lz4_qp *qp = queue_pair;
+
+	unsigned int nb_dequeued = 0;
+
+	nb_dequeued = rte_ring_dequeue_burst(qp->processed_pkts,
+			(void **)ops, nb_ops, NULL);
+	qp->qp_stats.dequeued_count += nb_dequeued;
+
+	return nb_dequeued;
+}
+
+static int
+lz4_create(const char *name,
+		struct rte_vdev_device *vdev,
+		struct rte_compressdev_pmd_init_params *init_params)
+{
+	struct rte_compressdev *dev;
+
+	dev = rte_compressdev_pmd_create(name, &vdev->device,
+			sizeof(struct lz4_private), init_params);
+	if (dev == NULL) {
+		LZ4_PMD_ERR("driver %s: create failed", init_params->name);
+		return -ENODEV;
+	}
+
+	dev->dev_ops = rte_lz4_pmd_ops;
+
+	/* register rx/tx burst functions for data path */
+	dev->dequeue_burst = lz4_pmd_dequeue_burst;
+	dev->enqueue_burst = lz4_pmd_enqueue_burst;
+
+	return 0;
+}
+
+static int
+lz4_probe(struct rte_vdev_device *vdev)
+{
+	struct rte_compressdev_pmd_init_params init_params = {
+		"",
+		rte_socket_id()
+	};
+	const char *name;
+	const char *input_args;
+	int retval;
+
+	name = rte_vdev_device_name(vdev);
+
+	if (name == NULL)
+		return -EINVAL;
+
+	input_args = rte_vdev_device_args(vdev);
+
+	retval = rte_compressdev_pmd_parse_input_args(&init_params, input_args);
+	if (retval < 0) {
+		LZ4_PMD_LOG(ERR,
+			"Failed to parse initialisation arguments[%s]",
+			input_args);
+		return -EINVAL;
+	}
+
+	return lz4_create(name, vdev, &init_params);
+}
+
+static int
+lz4_remove(struct rte_vdev_device *vdev)
+{
+	struct rte_compressdev *compressdev;
+	const char *name;
+
+	name = rte_vdev_device_name(vdev);
+	if (name == NULL)
+		return -EINVAL;
+
+	compressdev = rte_compressdev_pmd_get_named_dev(name);
+	if (compressdev == NULL)
+		return -ENODEV;
+
+	return rte_compressdev_pmd_destroy(compressdev);
+}
+
+static struct rte_vdev_driver lz4_pmd_drv = {
+	.probe = lz4_probe,
+	.remove = lz4_remove
+};
+
+RTE_PMD_REGISTER_VDEV(COMPRESSDEV_NAME_LZ4_PMD, lz4_pmd_drv);
+RTE_PMD_REGISTER_PARAM_STRING(COMPRESSDEV_NAME_LZ4_PMD,
+	"socket_id=<int>");
+RTE_LOG_REGISTER_DEFAULT(lz4_logtype_driver, INFO);
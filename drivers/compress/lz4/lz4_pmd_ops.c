@@ -0,0 +1,325 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#include <string.h>
+
+#include <dev_driver.h>
+#include <rte_common.h>
+#include <rte_malloc.h>
+
+#include "lz4_pmd_private.h"
+
+static const struct rte_compressdev_capabilities lz4_pmd_capabilities[] = {
+	{   /* LZ4 */
+		.algo = RTE_COMP_ALGO_LZ4,
+		.comp_feature_flags = (RTE_COMP_FF_STATEFUL_COMPRESSION |
+					RTE_COMP_FF_STATEFUL_DECOMPRESSION |
+					RTE_COMP_FF_OOP_SGL_IN_SGL_OUT |
+					RTE_COMP_FF_OOP_SGL_IN_LB_OUT |
+					RTE_COMP_FF_OOP_LB_IN_SGL_OUT |
+					RTE_COMP_FF_XXHASH32_CHECKSUM |
+					RTE_COMP_FF_LZ4_CONTENT_WITH_CHECKSUM |
+					RTE_COMP_FF_LZ4_CONTENT_SIZE |
+					RTE_COMP_FF_LZ4_BLOCK_INDEPENDENCE |
+					RTE_COMP_FF_LZ4_BLOCK_WITH_CHECKSUM),
+		/* LZ4 window is 64KB */
+		.window_size = {
+			.min = 16,
+			.max = 16,
+			.increment = 0
+		},
+	},
+
+	RTE_COMP_END_OF_CAPABILITIES_LIST()
+
+};
+
+/** Configure device */
+static int
+lz4_pmd_config(struct rte_compressdev *dev,
+		struct rte_compressdev_config *config)
+{
+	struct rte_mempool *mp;
+	char mp_name[RTE_MEMPOOL_NAMESIZE];
+	struct lz4_private *internals = dev->data->dev_private;
+
+	snprintf(mp_name, RTE_MEMPOOL_NAMESIZE,
+			"stream_mp_%u", dev->data->dev_id);
+	mp = internals->mp;
+	if (mp == NULL) {
+		mp = rte_mempool_create(mp_name,
+				config->max_nb_priv_xforms +
+				config->max_nb_streams,
+				sizeof(struct lz4_stream),
+				0, 0, NULL, NULL, NULL,
+				NULL, config->socket_id,
+				0);
+		if (mp == NULL) {
+			LZ4_PMD_ERR("Cannot create private xform pool on "
+			"socket %d\n", config->socket_id);
+			return -ENOMEM;
+		}
+		internals->mp = mp;
+	}
+	return 0;
+}
+
+/** Start device */
+static int
+lz4_pmd_start(__rte_unused struct rte_compressdev *dev)
+{
+	return 0;
+}
+
+/** Stop device */
+static void
+lz4_pmd_stop(__rte_unused struct rte_compressdev *dev)
+{
+}
+
+/** Close device */
+static int
+lz4_pmd_close(struct rte_compressdev *dev)
+{
+	struct lz4_private *internals = dev->data->dev_private;
+	rte_mempool_free(internals->mp);
+	internals->mp = NULL;
+	return 0;
+}
+
+/** Get device statistics */
+static void
+lz4_pmd_stats_get(struct rte_compressdev *dev,
+		struct rte_compressdev_stats *stats)
+{
+	int qp_id;
+
+	for (qp_id = 0; qp_id < dev->data->nb_queue_pairs; qp_id++) {
+		struct lz4_qp *qp = dev->data->queue_pairs[qp_id];
+
+		stats->enqueued_count += qp->qp_stats.enqueued_count;
+		stats->dequeued_count += qp->qp_stats.dequeued_count;
+
+		stats->enqueue_err_count += qp->qp_stats.enqueue_err_count;
+		stats->dequeue_err_count += qp->qp_stats.dequeue_err_count;
+	}
+}
+
+/** Reset device statistics */
+static void
+lz4_pmd_stats_reset(struct rte_compressdev *dev)
+{
+	int qp_id;
+
+	for (qp_id = 0; qp_id < dev->data->nb_queue_pairs; qp_id++) {
+		struct lz4_qp *qp = dev->data->queue_pairs[qp_id];
+
+		memset(&qp->qp_stats, 0, sizeof(qp->qp_stats));
+	}
+}
+
+/** Get device info */
+static void
+lz4_pmd_info_get(struct rte_compressdev *dev,
+		struct rte_compressdev_info *dev_info)
+{
+	if (dev_info != NULL) {
+		dev_info->driver_name = dev->device->name;
+		dev_info->feature_flags = dev->feature_flags;
+		dev_info->capabilities = lz4_pmd_capabilities;
+	}
+}
+
+/** Release queue pair */
+static int
+lz4_pmd_qp_release(struct rte_compressdev *dev, uint16_t qp_id)
+{
+	struct lz4_qp *qp = dev->data->queue_pairs[qp_id];
+
+	if (qp != NULL) {
+		rte_ring_free(qp->processed_pkts);
+		rte_free(qp);
+		dev->data->queue_pairs[qp_id] = NULL;
+	}
+	return 0;
+}
+
+/** set a unique name for the queue pair based on its name, dev_id and qp_id */
+static int
+lz4_pmd_qp_set_unique_name(struct rte_compressdev *dev,
+		struct lz4_qp *qp)
+{
+	unsigned int n = snprintf(qp->name, sizeof(qp->name),
+				"lz4_pmd_%u_qp_%u",
+				dev->data->dev_id, qp->id);
+
+	if (n >= sizeof(qp->name))
+		return -1;
+
+	return 0;
+}
+
+/** Create a ring to place process packets on */
+static struct rte_ring *
+lz4_pmd_qp_create_processed_pkts_ring(struct lz4_qp *qp,
+		unsigned int ring_size, int socket_id)
+{
+	struct rte_ring *r = qp->processed_pkts;
+
+	if (r) {
+		if (rte_ring_get_size(r) >= ring_size) {
+			LZ4_PMD_INFO("Reusing existing ring %s for processed"
+					" packets", qp->name);
+			return r;
+		}
+
+		LZ4_PMD_ERR("Unable to reuse existing ring %s for processed"
+				" packets", qp->name);
+		return NULL;
+	}
+
+	return rte_ring_create(qp->name, ring_size, socket_id,
+						RING_F_EXACT_SZ);
+}
+
+/** Setup a queue pair */
+static int
+lz4_pmd_qp_setup(struct rte_compressdev *dev, uint16_t qp_id,
+		uint32_t max_inflight_ops, int socket_id)
+{
+	struct lz4_qp *qp = NULL;
+
+	/* Free memory prior to re-allocation if needed. */
+	if (dev->data->queue_pairs[qp_id] != NULL)
+		lz4_pmd_qp_release(dev, qp_id);
+
+	/* Allocate the queue pair data structure. */
+	qp = rte_zmalloc_socket("LZ4 PMD Queue Pair", sizeof(*qp),
+					RTE_CACHE_LINE_SIZE, socket_id);
+	if (qp == NULL)
+		return (-ENOMEM);
+
+	qp->id = qp_id;
+	dev->data->queue_pairs[qp_id] = qp;
+
+	if (lz4_pmd_qp_set_unique_name(dev, qp))
+		goto qp_setup_cleanup;
+
+	qp->processed_pkts = lz4_pmd_qp_create_processed_pkts_ring(qp,
+			max_inflight_ops, socket_id);
+	if (qp->processed_pkts == NULL)
+		goto qp_setup_cleanup;
+
+	memset(&qp->qp_stats, 0, sizeof(qp->qp_stats));
+	return 0;
+
+qp_setup_cleanup:
+	if (qp) {
+		rte_free(qp);
+		qp = NULL;
+	}
+	return -1;
+}
+
+/** Configure stream or private xform */
+static int
+lz4_pmd_stream_alloc(struct rte_compressdev *dev,
+		const struct rte_comp_xform *xform,
+		void **zstream, bool stateful)
+{
+	int ret = 0;
+	struct lz4_stream *stream;
+	struct lz4_private *internals = dev->data->dev_private;
+
+	if (xform == NULL) {
+		LZ4_PMD_ERR("invalid xform struct");
+		return -EINVAL;
+	}
+
+	if (rte_mempool_get(internals->mp, zstream)) {
+		LZ4_PMD_ERR("Couldn't get object from session mempool");
+		return -ENOMEM;
+	}
+	stream = *((struct lz4_stream **)zstream);
+
+	ret = lz4_set_stream_parameters(xform, stream, stateful);
+
+	if (ret < 0) {
+		LZ4_PMD_ERR("failed configure session parameters");
+
+		memset(stream, 0, sizeof(struct lz4_stream));
+		/* Return session to mempool */
+		rte_mempool_put(internals->mp, stream);
+		return ret;
+	}
+
+	return 0;
+}
+
+/** Configure stream */
+static int
+lz4_pmd_stream_create(struct rte_compressdev *dev,
+		const struct rte_comp_xform *xform,
+		void **zstream)
+{
+	return lz4_pmd_stream_alloc(dev, xform, zstream, true);
+}
+
+/** Configure private xform */
+static int
+lz4_pmd_private_xform_create(struct rte_compressdev *dev,
+		const struct rte_comp_xform *xform,
+		void **private_xform)
+{
+	return lz4_pmd_stream_alloc(dev, xform, private_xform, false);
+}
+
+/** Clear the memory of stream so it doesn't leave key material behind */
+static int
+lz4_pmd_stream_free(__rte_unused struct rte_compressdev *dev,
+		void *zstream)
+{
+	struct lz4_stream *stream = (struct lz4_stream *)zstream;
+	if (!stream)
+		return -EINVAL;
+
+	lz4_stream_free(stream);
+	/* Zero out the whole structure */
+	memset(stream, 0, sizeof(struct lz4_stream));
+	struct rte_mempool *mp = rte_mempool_from_obj(stream);
+	rte_mempool_put(mp, stream);
+
+	return 0;
+}
+
+/** Clear the memory of stream so it doesn't leave key material behind */
+static int
+lz4_pmd_private_xform_free(struct rte_compressdev *dev,
+		void *private_xform)
+{
+	return lz4_pmd_stream_free(dev, private_xform);
+}
+
+struct rte_compressdev_ops lz4_pmd_ops = {
+		.dev_configure		= lz4_pmd_config,
+		.dev_start		= lz4_pmd_start,
+		.dev_stop		= lz4_pmd_stop,
+		.dev_close		= lz4_pmd_close,
+
+		.stats_get		= lz4_pmd_stats_get,
+		.stats_reset		= lz4_pmd_stats_reset,
+
+		.dev_infos_get		= lz4_pmd_info_get,
+
+		.queue_pair_setup	= lz4_pmd_qp_setup,
+		.queue_pair_release	= lz4_pmd_qp_release,
+
+		.private_xform_create	= lz4_pmd_private_xform_create,
+		.private_xform_free	= lz4_pmd_private_xform_free,
+
+		.stream_create	= lz4_pmd_stream_create,
+		.stream_free	= lz4_pmd_stream_free
+};
+
+struct rte_compressdev_ops *rte_lz4_pmd_ops = &lz4_pmd_ops;
@@ -0,0 +1,107 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#ifndef _LZ4_PMD_PRIVATE_H_
+#define _LZ4_PMD_PRIVATE_H_
+
+#include <stdbool.h>
+
+#include <lz4frame.h>
+#include <rte_compressdev.h>
+#include <rte_compressdev_pmd.h>
+
+#define COMPRESSDEV_NAME_LZ4_PMD	compress_lz4
+/**< LZ4 PMD device name */
+
+/* Largest input given to the compressor in a single call */
+#define LZ4_PMD_CHUNK_SZ		(64 * 1024)
+
+/* Range of LZ4-HC levels used above RTE_COMP_LEVEL_MIN */
+#define LZ4_PMD_HC_LEVEL_MIN		3
+#define LZ4_PMD_HC_LEVEL_MAX		12
+
+extern int lz4_logtype_driver;
+#define LZ4_PMD_LOG(level, fmt, args...) \
+	rte_log(RTE_LOG_ ## level, lz4_logtype_driver, "%s(): "fmt "\n", \
+			__func__, ##args)
+
+#define LZ4_PMD_INFO(fmt, args...) \
+	LZ4_PMD_LOG(INFO, fmt, ## args)
+#define LZ4_PMD_ERR(fmt, args...) \
+	LZ4_PMD_LOG(ERR, fmt, ## args)
+#define LZ4_PMD_WARN(fmt, args...) \
+	LZ4_PMD_LOG(WARNING, fmt, ## args)
+
+struct lz4_private {
+	struct rte_mempool *mp;
+};
+
+struct lz4_qp {
+	struct rte_ring *processed_pkts;
+	/**< Ring for placing process packets */
+	struct rte_compressdev_stats qp_stats;
+	/**< Queue pair statistics */
+	uint16_t id;
+	/**< Queue Pair Identifier */
+	char name[RTE_COMPRESSDEV_NAME_MAX_LEN];
+	/**< Unique Queue Pair Name */
+} __rte_cache_aligned;
+
+/** Streaming state of a xxHash-32 checksum */
+struct lz4_xxh32_state {
+	uint64_t total_len;
+	uint32_t v[4];
+	uint8_t mem[16];
+	uint32_t memsize;
+	uint32_t seed;
+};
+
+struct lz4_stream;
+
+/* Algorithm handler function prototype */
+typedef void (*comp_func_t)(struct rte_comp_op *op, struct lz4_stream *stream);
+
+/** LZ4 Stream structure, used for both private xforms and streams */
+struct lz4_stream {
+	union {
+		LZ4F_cctx *cctx;
+		/**< Compression context */
+		LZ4F_dctx *dctx;
+		/**< Decompression context */
+	};
+	comp_func_t comp;
+	/**< Operation (compression/decompression) */
+	enum rte_comp_xform_type type;
+	/**< Direction of the stream */
+	LZ4F_preferences_t prefs;
+	/**< Frame parameters and compression level */
+	enum rte_comp_checksum_type chksum;
+	/**< Checksum of the uncompressed data */
+	struct lz4_xxh32_state xxh;
+	/**< Running checksum of a stateful stream */
+	uint8_t frame_open;
+	/**< Frame header written, frame not ended yet */
+	uint8_t content_size;
+	/**< Frame header carries the size of the op source */
+	uint8_t *stage;
+	/**< Output of the compressor when it may not fit the destination */
+	size_t stage_sz;
+	size_t stage_len;
+	/**< Bytes of the stage not copied to the destination yet */
+	size_t stage_off;
+	size_t bound;
+	/**< Largest output of a compressor call on a chunk */
+} __rte_cache_aligned;
+
+int
+lz4_set_stream_parameters(const struct rte_comp_xform *xform,
+		struct lz4_stream *stream, bool stateful);
+
+void
+lz4_stream_free(struct lz4_stream *stream);
+
+/** Device specific operations function pointer structure */
+extern struct rte_compressdev_ops *rte_lz4_pmd_ops;
+
+#endif /* _LZ4_PMD_PRIVATE_H_ */
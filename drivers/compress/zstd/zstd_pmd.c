@@ -0,0 +1,602 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#include <string.h>
+
+#include <bus_vdev_driver.h>
+#include <rte_common.h>
+
+#include "zstd_pmd_private.h"
+
+/** Find the segment holding offset in a chain of mbufs,
+ *  returns the data at offset and sets the bytes left in the segment
+ */
+static inline uint8_t *
+zstd_mbuf_seek(struct rte_mbuf **m, uint32_t offset, size_t *len)
+{
+	while (offset >= rte_pktmbuf_data_len(*m) && (*m)->next != NULL) {
+		offset -= rte_pktmbuf_data_len(*m);
+		*m = (*m)->next;
+	}
+	*len = rte_pktmbuf_data_len(*m) - offset;
+	return rte_pktmbuf_mtod_offset(*m, uint8_t *, offset);
+}
+
+/** Move to the next non-empty segment of a chain of mbufs,
+ *  returns false at the end of the chain
+ */
+static inline bool
+zstd_mbuf_next(struct rte_mbuf **m, uint8_t **data, size_t *len)
+{
+	do {
+		*m = (*m)->next;
+		if (*m == NULL)
+			return false;
+	} while (rte_pktmbuf_data_len(*m) == 0);
+
+	*data = rte_pktmbuf_mtod(*m, uint8_t *);
+	*len = rte_pktmbuf_data_len(*m);
+	return true;
+}
+
+/** Prepare a compression context for a new frame of the stream */
+static int
+zstd_cctx_load(ZSTD_CCtx *cctx, const struct zstd_stream *stream)
+{
+	size_t ret;
+
+	ret = ZSTD_CCtx_reset(cctx, ZSTD_reset_session_and_parameters);
+	if (!ZSTD_isError(ret))
+		ret = ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel,
+				stream->level);
+	if (!ZSTD_isError(ret) && stream->window_log != 0)
+		ret = ZSTD_CCtx_setParameter(cctx, ZSTD_c_windowLog,
+				stream->window_log);
+	/* the dictionary is only referenced, it is digested already */
+	if (!ZSTD_isError(ret) && stream->cdict != NULL)
+		ret = ZSTD_CCtx_refCDict(cctx, stream->cdict);
+	if (ZSTD_isError(ret)) {
+		ZSTD_PMD_ERR("Cannot set compression parameters: %s",
+				ZSTD_getErrorName(ret));
+		return -1;
+	}
+
+	return 0;
+}
+
+/** Prepare a decompression context for a new frame of the stream */
+static int
+zstd_dctx_load(ZSTD_DCtx *dctx, const struct zstd_stream *stream)
+{
+	size_t ret;
+
+	ret = ZSTD_DCtx_reset(dctx, ZSTD_reset_session_and_parameters);
+	if (!ZSTD_isError(ret) && stream->window_log != 0)
+		ret = ZSTD_DCtx_setParameter(dctx, ZSTD_d_windowLogMax,
+				stream->window_log);
+	if (!ZSTD_isError(ret) && stream->ddict != NULL)
+		ret = ZSTD_DCtx_refDDict(dctx, stream->ddict);
+	if (ZSTD_isError(ret)) {
+		ZSTD_PMD_ERR("Cannot set decompression parameters: %s",
+				ZSTD_getErrorName(ret));
+		return -1;
+	}
+
+	return 0;
+}
+
+static void
+process_zstd_compress(struct rte_comp_op *op,
+		const struct zstd_stream *stream, void *ctx)
+{
+	ZSTD_CCtx *cctx = ctx;
+	struct rte_mbuf *mbuf_src = op->m_src;
+	struct rte_mbuf *mbuf_dst = op->m_dst;
+	bool stateful = op->op_type == RTE_COMP_OP_STATEFUL;
+	uint32_t remaining = op->src.length;
+	uint32_t consumed = 0, produced = 0;
+	ZSTD_EndDirective end, mode;
+	ZSTD_inBuffer in;
+	ZSTD_outBuffer out;
+	uint8_t *data;
+	size_t len, ret;
+
+	switch (op->flush_flag) {
+	case RTE_COMP_FLUSH_NONE:
+		end = ZSTD_e_continue;
+		break;
+	case RTE_COMP_FLUSH_SYNC:
+		end = ZSTD_e_flush;
+		break;
+	case RTE_COMP_FLUSH_FULL:
+	case RTE_COMP_FLUSH_FINAL:
+		end = ZSTD_e_end;
+		break;
+	default:
+		op->status = RTE_COMP_OP_STATUS_INVALID_ARGS;
+		ZSTD_PMD_ERR("Invalid flush value");
+		return;
+	}
+
+	if (!stateful) {
+		if (end != ZSTD_e_end) {
+			op->status = RTE_COMP_OP_STATUS_INVALID_ARGS;
+			ZSTD_PMD_ERR("Invalid flush value for a stateless op");
+			return;
+		}
+		/* the frame header carries the size of the whole input */
+		if (zstd_cctx_load(cctx, stream) < 0 ||
+				ZSTD_isError(ZSTD_CCtx_setPledgedSrcSize(cctx,
+						op->src.length))) {
+			op->status = RTE_COMP_OP_STATUS_ERROR;
+			return;
+		}
+	}
+
+	in.src = zstd_mbuf_seek(&mbuf_src, op->src.offset, &len);
+	in.size = RTE_MIN(len, remaining);
+	in.pos = 0;
+	out.dst = zstd_mbuf_seek(&mbuf_dst, op->dst.offset, &out.size);
+	out.pos = 0;
+
+	/* Initialize status to SUCCESS */
+	op->status = RTE_COMP_OP_STATUS_SUCCESS;
+
+	for (;;) {
+		/* only the segment holding the end of the input is flushed */
+		mode = (in.size == remaining) ? end : ZSTD_e_continue;
+		ret = ZSTD_compressStream2(cctx, &out, &in, mode);
+		if (unlikely(ZSTD_isError(ret))) {
+			ZSTD_PMD_ERR("Compression failed: %s",
+					ZSTD_getErrorName(ret));
+			op->status = RTE_COMP_OP_STATUS_ERROR;
+			break;
+		}
+
+		if (in.pos == in.size) {
+			/* all input given, done once flushed as requested */
+			if (in.size == remaining) {
+				if (mode == ZSTD_e_continue || ret == 0)
+					break;
+			} else {
+				consumed += in.size;
+				remaining -= in.size;
+				if (!zstd_mbuf_next(&mbuf_src, &data, &len)) {
+					op->status =
+						RTE_COMP_OP_STATUS_INVALID_ARGS;
+					break;
+				}
+				in.src = data;
+				in.size = RTE_MIN(len, remaining);
+				in.pos = 0;
+				continue;
+			}
+		}
+
+		if (out.pos == out.size) {
+			produced += out.pos;
+			out.pos = 0;
+			if (!zstd_mbuf_next(&mbuf_dst, &data, &out.size)) {
+				/* the context keeps what could not be written */
+				op->status = stateful ?
+				    RTE_COMP_OP_STATUS_OUT_OF_SPACE_RECOVERABLE :
+				    RTE_COMP_OP_STATUS_OUT_OF_SPACE_TERMINATED;
+				break;
+			}
+			out.dst = data;
+		}
+	}
+	consumed += in.pos;
+	produced += out.pos;
+
+	/* Update op stats */
+	switch (op->status) {
+	case RTE_COMP_OP_STATUS_SUCCESS:
+	case RTE_COMP_OP_STATUS_OUT_OF_SPACE_RECOVERABLE:
+		op->consumed += consumed;
+	/* Fall-through */
+	case RTE_COMP_OP_STATUS_OUT_OF_SPACE_TERMINATED:
+		op->produced += produced;
+		break;
+	default:
+		ZSTD_PMD_ERR("stats not updated for status:%d", op->status);
+		/* the stream cannot continue from an unknown point */
+		if (stateful)
+			ZSTD_CCtx_reset(cctx, ZSTD_reset_session_only);
+	}
+}
+
+static void
+process_zstd_decompress(struct rte_comp_op *op,
+		const struct zstd_stream *stream, void *ctx)
+{
+	ZSTD_DCtx *dctx = ctx;
+	struct rte_mbuf *mbuf_src = op->m_src;
+	struct rte_mbuf *mbuf_dst = op->m_dst;
+	bool stateful = op->op_type == RTE_COMP_OP_STATEFUL;
+	uint32_t remaining = op->src.length;
+	uint32_t consumed = 0, produced = 0;
+	ZSTD_inBuffer in;
+	ZSTD_outBuffer out;
+	uint8_t *data;
+	size_t len, ret;
+
+	if (!stateful && zstd_dctx_load(dctx, stream) < 0) {
+		op->status = RTE_COMP_OP_STATUS_ERROR;
+		return;
+	}
+
+	in.src = zstd_mbuf_seek(&mbuf_src, op->src.offset, &len);
+	in.size = RTE_MIN(len, remaining);
+	in.pos = 0;
+	out.dst = zstd_mbuf_seek(&mbuf_dst, op->dst.offset, &out.size);
+	out.pos = 0;
+
+	/* Ignoring flush value provided from application for decompression */
+	op->status = RTE_COMP_OP_STATUS_SUCCESS;
+
+	for (;;) {
+		ret = ZSTD_decompressStream(dctx, &out, &in);
+		if (unlikely(ZSTD_isError(ret))) {
+			ZSTD_PMD_ERR("Decompression failed: %s",
+					ZSTD_getErrorName(ret));
+			op->status = RTE_COMP_OP_STATUS_ERROR;
+			break;
+		}
+
+		/* a stateless op holds a single frame */
+		if (ret == 0 && !stateful)
+			break;
+
+		if (out.pos == out.size) {
+			if (ret == 0 && in.pos == in.size &&
+					in.size == remaining)
+				break;
+			/* the context may hold more output, keep flushing */
+			produced += out.pos;
+			out.pos = 0;
+			if (!zstd_mbuf_next(&mbuf_dst, &data, &out.size)) {
+				op->status = stateful ?
+				    RTE_COMP_OP_STATUS_OUT_OF_SPACE_RECOVERABLE :
+				    RTE_COMP_OP_STATUS_OUT_OF_SPACE_TERMINATED;
+				break;
+			}
+			out.dst = data;
+			continue;
+		}
+
+		if (in.pos == in.size) {
+			if (in.size == remaining) {
+				/* a stream waits for the rest of the frame */
+				if (!stateful) {
+					ZSTD_PMD_ERR("Truncated frame");
+					op->status = RTE_COMP_OP_STATUS_ERROR;
+				}
+				break;
+			}
+			consumed += in.size;
+			remaining -= in.size;
+			if (!zstd_mbuf_next(&mbuf_src, &data, &len)) {
+				op->status = RTE_COMP_OP_STATUS_INVALID_ARGS;
+				break;
+			}
+			in.src = data;
+			in.size = RTE_MIN(len, remaining);
+			in.pos = 0;
+		}
+	}
+	consumed += in.pos;
+	produced += out.pos;
+
+	/* Update op stats */
+	switch (op->status) {
+	case RTE_COMP_OP_STATUS_SUCCESS:
+	case RTE_COMP_OP_STATUS_OUT_OF_SPACE_RECOVERABLE:
+		op->consumed += consumed;
+	/* Fall-through */
+	case RTE_COMP_OP_STATUS_OUT_OF_SPACE_TERMINATED:
+		op->produced += produced;
+		break;
+	default:
+		ZSTD_PMD_ERR("stats not produced for status:%d", op->status);
+		if (stateful)
+			ZSTD_DCtx_reset(dctx, ZSTD_reset_session_only);
+	}
+}
+
+/** Process comp operation for mbuf */
+static inline int
+process_zstd_op(struct zstd_qp *qp, struct rte_comp_op *op)
+{
+	const struct zstd_stream *stream;
+	void *ctx;
+
+	if ((op->m_dst == NULL) ||
+			(op->src.offset > rte_pktmbuf_pkt_len(op->m_src)) ||
+			(op->src.length >
+			 rte_pktmbuf_pkt_len(op->m_src) - op->src.offset) ||
+			(op->dst.offset > rte_pktmbuf_pkt_len(op->m_dst))) {
+		op->status = RTE_COMP_OP_STATUS_INVALID_ARGS;
+		ZSTD_PMD_ERR("Invalid source or destination buffers");
+	} else {
+		if (op->op_type == RTE_COMP_OP_STATEFUL) {
+			stream = op->stream;
+			ctx = stream->cctx;
+		} else {
+			/* private xforms are shared, run in the qp context */
+			stream = op->private_xform;
+			if (stream->type == RTE_COMP_COMPRESS)
+				ctx = qp->cctx;
+			else
+				ctx = qp->dctx;
+		}
+		stream->comp(op, stream, ctx);
+	}
+	/* whatever is out of op, put it into completion queue with
+	 * its status
+	 */
+	return rte_ring_enqueue(qp->processed_pkts, (void *)op);
+}
+
+/** Check a window size against the bounds of a zstd parameter */
+static int
+zstd_window_check(int window_log, ZSTD_bounds bounds)
+{
+	if (window_log == 0)
+		return 0;
+	if (ZSTD_isError(bounds.error) || window_log < bounds.lowerBound ||
+			window_log > bounds.upperBound) {
+		ZSTD_PMD_ERR("Window size %d not supported", window_log);
+		return -1;
+	}
+	return 0;
+}
+
+/** Parse comp xform and set private xform/Stream parameters */
+int
+zstd_set_stream_parameters(const struct rte_comp_xform *xform,
+		struct zstd_stream *stream, bool stateful)
+{
+	const struct rte_comp_zstd_params *zstd;
+	int level;
+
+	memset(stream, 0, sizeof(*stream));
+	stream->type = xform->type;
+
+	switch (xform->type) {
+	case RTE_COMP_COMPRESS:
+		if (xform->compress.algo != RTE_COMP_ALGO_ZSTD) {
+			ZSTD_PMD_ERR("Compression algorithm not supported");
+			return -1;
+		}
+		if (xform->compress.chksum != RTE_COMP_CHECKSUM_NONE) {
+			ZSTD_PMD_ERR("Checksum type not supported");
+			return -1;
+		}
+		zstd = &xform->compress.zstd;
+		stream->window_log = xform->compress.window_size;
+		stream->comp = process_zstd_compress;
+		if (zstd_window_check(stream->window_log,
+				ZSTD_cParam_getBounds(ZSTD_c_windowLog)) < 0)
+			return -1;
+
+		/** Compression Level */
+		level = zstd->level;
+		if (level == 0) {
+			switch (xform->compress.level) {
+			case RTE_COMP_LEVEL_PMD_DEFAULT:
+				level = ZSTD_PMD_DEFAULT_LEVEL;
+				break;
+			default:
+				level = xform->compress.level;
+				if (level < RTE_COMP_LEVEL_MIN ||
+						level > RTE_COMP_LEVEL_MAX) {
+					ZSTD_PMD_ERR("Compression level %d not supported",
+							level);
+					return -1;
+				}
+				break;
+			}
+		} else if (level < ZSTD_minCLevel() ||
+				level > ZSTD_maxCLevel()) {
+			ZSTD_PMD_ERR("Zstandard level %d not supported", level);
+			return -1;
+		}
+		stream->level = level;
+
+		if (zstd->dict != NULL) {
+			stream->cdict = ZSTD_createCDict(zstd->dict,
+					zstd->dict_len, level);
+			if (stream->cdict == NULL) {
+				ZSTD_PMD_ERR("Cannot load compression dictionary");
+				return -1;
+			}
+		}
+
+		if (!stateful)
+			return 0;
+
+		stream->cctx = ZSTD_createCCtx();
+		if (stream->cctx == NULL ||
+				zstd_cctx_load(stream->cctx, stream) < 0) {
+			ZSTD_PMD_ERR("Compression context init failed");
+			zstd_stream_free(stream);
+			return -1;
+		}
+		break;
+
+	case RTE_COMP_DECOMPRESS:
+		if (xform->decompress.algo != RTE_COMP_ALGO_ZSTD) {
+			ZSTD_PMD_ERR("Compression algorithm not supported");
+			return -1;
+		}
+		if (xform->decompress.chksum != RTE_COMP_CHECKSUM_NONE) {
+			ZSTD_PMD_ERR("Checksum type not supported");
+			return -1;
+		}
+		zstd = &xform->decompress.zstd;
+		stream->window_log = xform->decompress.window_size;
+		stream->comp = process_zstd_decompress;
+		if (zstd_window_check(stream->window_log,
+				ZSTD_dParam_getBounds(ZSTD_d_windowLogMax)) < 0)
+			return -1;
+
+		if (zstd->dict != NULL) {
+			stream->ddict = ZSTD_createDDict(zstd->dict,
+					zstd->dict_len);
+			if (stream->ddict == NULL) {
+				ZSTD_PMD_ERR("Cannot load decompression dictionary");
+				return -1;
+			}
+		}
+
+		if (!stateful)
+			return 0;
+
+		stream->dctx = ZSTD_createDCtx();
+		if (stream->dctx == NULL ||
+				zstd_dctx_load(stream->dctx, stream) < 0) {
+			ZSTD_PMD_ERR("Decompression context init failed");
+			zstd_stream_free(stream);
+			return -1;
+		}
+		break;
+	default:
+		return -1;
+	}
+
+	return 0;
+}
+
+void
+zstd_stream_free(struct zstd_stream *stream)
+{
+	if (stream->type == RTE_COMP_COMPRESS) {
+		ZSTD_freeCCtx(stream->cctx);
+		ZSTD_freeCDict(stream->cdict);
+	} else {
+		ZSTD_freeDCtx(stream->dctx);
+		ZSTD_freeDDict(stream->ddict);
+	}
+	stream->cctx = NULL;
+	stream->cdict = NULL;
+}
+
+static uint16_t
+zstd_pmd_enqueue_burst(void *queue_pair,
+			struct rte_comp_op **ops, uint16_t nb_ops)
+{
+	struct zstd_qp *qp = queue_pair;
+	int ret;
+	uint16_t i;
+	uint16_t enqd = 0;
+
+	for (i = 0; i < nb_ops; i++) {
+		ret = process_zstd_op(qp, ops[i]);
+		if (unlikely(ret < 0)) {
+			/* increment count if failed to push to completion
+			 * queue
+			 */
+			qp->qp_stats.enqueue_err_count++;
+		} else {
+			qp->qp_stats.enqueued_count++;
+			enqd++;
+		}
+	}
+	return enqd;
+}
+
+static uint16_t
+zstd_pmd_dequeue_burst(void *queue_pair,
+			struct rte_comp_op **ops, uint16_t nb_ops)
+{
+	struct zstd_qp *qp = queue_pair;
+
+	unsigned int nb_dequeued = 0;
+
+	nb_dequeued = rte_ring_dequeue_burst(qp->processed_pkts,
+			(void **)ops, nb_ops, NULL);
+	qp->qp_stats.dequeued_count += nb_dequeued;
+
+	return nb_dequeued;
+}
+
+static int
+zstd_create(const char *name,
+		struct rte_vdev_device *vdev,
+		struct rte_compressdev_pmd_init_params *init_params)
+{
+	struct rte_compressdev *dev;
+
+	dev = rte_compressdev_pmd_create(name, &vdev->device,
+			sizeof(struct zstd_private), init_params);
+	if (dev == NULL) {
+		ZSTD_PMD_ERR("driver %s: create failed", init_params->name);
+		return -ENODEV;
+	}
+
+	dev->dev_ops = rte_zstd_pmd_ops;
+
+	/* register rx/tx burst functions for data path */
+	dev->dequeue_burst = zstd_pmd_dequeue_burst;
+	dev->enqueue_burst = zstd_pmd_enqueue_burst;
+
+	return 0;
+}
+
+static int
+zstd_probe(struct rte_vdev_device *vdev)
+{
+	struct rte_compressdev_pmd_init_params init_params = {
+		"",
+		rte_socket_id()
+	};
+	const char *name;
+	const char *input_args;
+	int retval;
+
+	name = rte_vdev_device_name(vdev);
+
+	if (name == NULL)
+		return -EINVAL;
+
+	input_args = rte_vdev_device_args(vdev);
+
+	retval = rte_compressdev_pmd_parse_input_args(&init_params, input_args);
+	if (retval < 0) {
+		ZSTD_PMD_LOG(ERR,
+			"Failed to parse initialisation arguments[%s]",
+			input_args);
+		return -EINVAL;
+	}
+
+	return zstd_create(name, vdev, &init_params);
+}
+
+static int
+zstd_remove(struct rte_vdev_device *vdev)
+{
+	struct rte_compressdev *compressdev;
+	const char *name;
+
+	name = rte_vdev_device_name(vdev);
+	if (name == NULL)
+		return -EINVAL;
+
+	compressdev = rte_compressdev_pmd_get_named_dev(name);
+	if (compressdev == NULL)
+		return -ENODEV;
+
+	return rte_compressdev_pmd_destroy(compressdev);
+}
+
+static struct rte_vdev_driver zstd_pmd_drv = {
+	.probe = zstd_probe,
+	.remove = zstd_remove
+};
+
+RTE_PMD_REGISTER_VDEV(COMPRESSDEV_NAME_ZSTD_PMD, zstd_pmd_drv);
+RTE_PMD_REGISTER_PARAM_STRING(COMPRESSDEV_NAME_ZSTD_PMD,
+	"socket_id=<int>");
+RTE_LOG_REGISTER_DEFAULT(zstd_logtype_driver, INFO);
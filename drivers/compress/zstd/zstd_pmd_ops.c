@@ -0,0 +1,329 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#include <string.h>
+
+#include <dev_driver.h>
+#include <rte_common.h>
+#include <rte_malloc.h>
+
+#include "zstd_pmd_private.h"
+
+static const struct rte_compressdev_capabilities zstd_pmd_capabilities[] = {
+	{   /* Zstandard */
+		.algo = RTE_COMP_ALGO_ZSTD,
+		.comp_feature_flags = (RTE_COMP_FF_STATEFUL_COMPRESSION |
+					RTE_COMP_FF_STATEFUL_DECOMPRESSION |
+					RTE_COMP_FF_OOP_SGL_IN_SGL_OUT |
+					RTE_COMP_FF_OOP_SGL_IN_LB_OUT |
+					RTE_COMP_FF_OOP_LB_IN_SGL_OUT |
+					RTE_COMP_FF_SHAREABLE_PRIV_XFORM |
+					RTE_COMP_FF_ZSTD_DICT),
+		/* up to the largest window decoded without extra setting */
+		.window_size = {
+			.min = 10,
+			.max = 27,
+			.increment = 1
+		},
+	},
+
+	RTE_COMP_END_OF_CAPABILITIES_LIST()
+
+};
+
+/** Configure device */
+static int
+zstd_pmd_config(struct rte_compressdev *dev,
+		struct rte_compressdev_config *config)
+{
+	struct rte_mempool *mp;
+	char mp_name[RTE_MEMPOOL_NAMESIZE];
+	struct zstd_private *internals = dev->data->dev_private;
+
+	snprintf(mp_name, RTE_MEMPOOL_NAMESIZE,
+			"stream_mp_%u", dev->data->dev_id);
+	mp = internals->mp;
+	if (mp == NULL) {
+		mp = rte_mempool_create(mp_name,
+				config->max_nb_priv_xforms +
+				config->max_nb_streams,
+				sizeof(struct zstd_stream),
+				0, 0, NULL, NULL, NULL,
+				NULL, config->socket_id,
+				0);
+		if (mp == NULL) {
+			ZSTD_PMD_ERR("Cannot create private xform pool on "
+			"socket %d\n", config->socket_id);
+			return -ENOMEM;
+		}
+		internals->mp = mp;
+	}
+	return 0;
+}
+
+/** Start device */
+static int
+zstd_pmd_start(__rte_unused struct rte_compressdev *dev)
+{
+	return 0;
+}
+
+/** Stop device */
+static void
+zstd_pmd_stop(__rte_unused struct rte_compressdev *dev)
+{
+}
+
+/** Close device */
+static int
+zstd_pmd_close(struct rte_compressdev *dev)
+{
+	struct zstd_private *internals = dev->data->dev_private;
+	rte_mempool_free(internals->mp);
+	internals->mp = NULL;
+	return 0;
+}
+
+/** Get device statistics */
+static void
+zstd_pmd_stats_get(struct rte_compressdev *dev,
+		struct rte_compressdev_stats *stats)
+{
+	int qp_id;
+
+	for (qp_id = 0; qp_id < dev->data->nb_queue_pairs; qp_id++) {
+		struct zstd_qp *qp = dev->data->queue_pairs[qp_id];
+
+		stats->enqueued_count += qp->qp_stats.enqueued_count;
+		stats->dequeued_count += qp->qp_stats.dequeued_count;
+
+		stats->enqueue_err_count += qp->qp_stats.enqueue_err_count;
+		stats->dequeue_err_count += qp->qp_stats.dequeue_err_count;
+	}
+}
+
+/** Reset device statistics */
+static void
+zstd_pmd_stats_reset(struct rte_compressdev *dev)
+{
+	int qp_id;
+
+	for (qp_id = 0; qp_id < dev->data->nb_queue_pairs; qp_id++) {
+		struct zstd_qp *qp = dev->data->queue_pairs[qp_id];
+
+		memset(&qp->qp_stats, 0, sizeof(qp->qp_stats));
+	}
+}
+
+/** Get device info */
+static void
+zstd_pmd_info_get(struct rte_compressdev *dev,
+		struct rte_compressdev_info *dev_info)
+{
+	if (dev_info != NULL) {
+		dev_info->driver_name = dev->device->name;
+		dev_info->feature_flags = dev->feature_flags;
+		dev_info->capabilities = zstd_pmd_capabilities;
+	}
+}
+
+/** Release queue pair */
+static int
+zstd_pmd_qp_release(struct rte_compressdev *dev, uint16_t qp_id)
+{
+	struct zstd_qp *qp = dev->data->queue_pairs[qp_id];
+
+	if (qp != NULL) {
+		rte_ring_free(qp->processed_pkts);
+		ZSTD_freeCCtx(qp->cctx);
+		ZSTD_freeDCtx(qp->dctx);
+		rte_free(qp);
+		dev->data->queue_pairs[qp_id] = NULL;
+	}
+	return 0;
+}
+
+/** set a unique name for the queue pair based on its name, dev_id and qp_id */
+static int
+zstd_pmd_qp_set_unique_name(struct rte_compressdev *dev,
+		struct zstd_qp *qp)
+{
+	unsigned int n = snprintf(qp->name, sizeof(qp->name),
+				"zstd_pmd_%u_qp_%u",
+				dev->data->dev_id, qp->id);
+
+	if (n >= sizeof(qp->name))
+		return -1;
+
+	return 0;
+}
+
+/** Create a ring to place process packets on */
+static struct rte_ring *
+zstd_pmd_qp_create_processed_pkts_ring(struct zstd_qp *qp,
+		unsigned int ring_size, int socket_id)
+{
+	struct rte_ring *r = qp->processed_pkts;
+
+	if (r) {
+		if (rte_ring_get_size(r) >= ring_size) {
+			ZSTD_PMD_INFO("Reusing existing ring %s for processed"
+					" packets", qp->name);
+			return r;
+		}
+
+		ZSTD_PMD_ERR("Unable to reuse existing ring %s for processed"
+				" packets", qp->name);
+		return NULL;
+	}
+
+	return rte_ring_create(qp->name, ring_size, socket_id,
+						RING_F_EXACT_SZ);
+}
+
+/** Setup a queue pair */
+static int
+zstd_pmd_qp_setup(struct rte_compressdev *dev, uint16_t qp_id,
+		uint32_t max_inflight_ops, int socket_id)
+{
+	struct zstd_qp *qp = NULL;
+
+	/* Free memory prior to re-allocation if needed. */
+	if (dev->data->queue_pairs[qp_id] != NULL)
+		zstd_pmd_qp_release(dev, qp_id);
+
+	/* Allocate the queue pair data structure. */
+	qp = rte_zmalloc_socket("ZSTD PMD Queue Pair", sizeof(*qp),
+					RTE_CACHE_LINE_SIZE, socket_id);
+	if (qp == NULL)
+		return (-ENOMEM);
+
+	qp->id = qp_id;
+	dev->data->queue_pairs[qp_id] = qp;
+
+	if (zstd_pmd_qp_set_unique_name(dev, qp))
+		goto qp_setup_cleanup;
+
+	qp->processed_pkts = zstd_pmd_qp_create_processed_pkts_ring(qp,
+			max_inflight_ops, socket_id);
+	if (qp->processed_pkts == NULL)
+		goto qp_setup_cleanup;
+
+	/* Contexts of the stateless operations, shared by all private xforms */
+	qp->cctx = ZSTD_createCCtx();
+	qp->dctx = ZSTD_createDCtx();
+	if (qp->cctx == NULL || qp->dctx == NULL) {
+		ZSTD_PMD_ERR("Cannot create contexts of queue pair %u", qp_id);
+		goto qp_setup_cleanup;
+	}
+
+	memset(&qp->qp_stats, 0, sizeof(qp->qp_stats));
+	return 0;
+
+qp_setup_cleanup:
+	zstd_pmd_qp_release(dev, qp_id);
+	return -1;
+}
+
+/** Configure stream or private xform */
+static int
+zstd_pmd_stream_alloc(struct rte_compressdev *dev,
+		const struct rte_comp_xform *xform,
+		void **zstream, bool stateful)
+{
+	int ret = 0;
+	struct zstd_stream *stream;
+	struct zstd_private *internals = dev->data->dev_private;
+
+	if (xform == NULL) {
+		ZSTD_PMD_ERR("invalid xform struct");
+		return -EINVAL;
+	}
+
+	if (rte_mempool_get(internals->mp, zstream)) {
+		ZSTD_PMD_ERR("Couldn't get object from session mempool");
+		return -ENOMEM;
+	}
+	stream = *((struct zstd_stream **)zstream);
+
+	ret = zstd_set_stream_parameters(xform, stream, stateful);
+
+	if (ret < 0) {
+		ZSTD_PMD_ERR("failed configure session parameters");
+
+		memset(stream, 0, sizeof(struct zstd_stream));
+		/* Return session to mempool */
+		rte_mempool_put(internals->mp, stream);
+		return ret;
+	}
+
+	return 0;
+}
+
+/** Configure stream */
+static int
+zstd_pmd_stream_create(struct rte_compressdev *dev,
+		const struct rte_comp_xform *xform,
+		void **zstream)
+{
+	return zstd_pmd_stream_alloc(dev, xform, zstream, true);
+}
+
+/** Configure private xform */
+static int
+zstd_pmd_private_xform_create(struct rte_compressdev *dev,
+		const struct rte_comp_xform *xform,
+		void **private_xform)
+{
+	return zstd_pmd_stream_alloc(dev, xform, private_xform, false);
+}
+
+/** Clear the memory of stream so it doesn't leave key material behind */
+static int
+zstd_pmd_stream_free(__rte_unused struct rte_compressdev *dev,
+		void *zstream)
+{
+	struct zstd_stream *stream = (struct zstd_stream *)zstream;
+	if (!stream)
+		return -EINVAL;
+
+	zstd_stream_free(stream);
+	/* Zero out the whole structure */
+	memset(stream, 0, sizeof(struct zstd_stream));
+	struct rte_mempool *mp = rte_mempool_from_obj(stream);
+	rte_mempool_put(mp, stream);
+
+	return 0;
+}
+
+/** Clear the memory of stream so it doesn't leave key material behind */
+static int
+zstd_pmd_private_xform_free(struct rte_compressdev *dev,
+		void *private_xform)
+{
+	return zstd_pmd_stream_free(dev, private_xform);
+}
+
+struct rte_compressdev_ops zstd_pmd_ops = {
+		.dev_configure		= zstd_pmd_config,
+		.dev_start		= zstd_pmd_start,
+		.dev_stop		= zstd_pmd_stop,
+		.dev_close		= zstd_pmd_close,
+
+		.stats_get		= zstd_pmd_stats_get,
+		.stats_reset		= zstd_pmd_stats_reset,
+
+		.dev_infos_get		= zstd_pmd_info_get,
+
+		.queue_pair_setup	= zstd_pmd_qp_setup,
+		.queue_pair_release	= zstd_pmd_qp_release,
+
+		.private_xform_create	= zstd_pmd_private_xform_create,
+		.private_xform_free	= zstd_pmd_private_xform_free,
+
+		.stream_create	= zstd_pmd_stream_create,
+		.stream_free	= zstd_pmd_stream_free
+};
+
+struct rte_compressdev_ops *rte_zstd_pmd_ops = &zstd_pmd_ops;
@@ -0,0 +1,97 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#ifndef _ZSTD_PMD_PRIVATE_H_
+#define _ZSTD_PMD_PRIVATE_H_
+
+#include <stdbool.h>
+
+#include <zstd.h>
+#include <rte_compressdev.h>
+#include <rte_compressdev_pmd.h>
+
+#define COMPRESSDEV_NAME_ZSTD_PMD	compress_zstd
+/**< ZSTD PMD device name */
+
+/* Level used for RTE_COMP_LEVEL_PMD_DEFAULT, as the zstd command line */
+#define ZSTD_PMD_DEFAULT_LEVEL		3
+
+extern int zstd_logtype_driver;
+#define ZSTD_PMD_LOG(level, fmt, args...) \
+	rte_log(RTE_LOG_ ## level, zstd_logtype_driver, "%s(): "fmt "\n", \
+			__func__, ##args)
+
+#define ZSTD_PMD_INFO(fmt, args...) \
+	ZSTD_PMD_LOG(INFO, fmt, ## args)
+#define ZSTD_PMD_ERR(fmt, args...) \
+	ZSTD_PMD_LOG(ERR, fmt, ## args)
+#define ZSTD_PMD_WARN(fmt, args...) \
+	ZSTD_PMD_LOG(WARNING, fmt, ## args)
+
+struct zstd_private {
+	struct rte_mempool *mp;
+};
+
+struct zstd_qp {
+	struct rte_ring *processed_pkts;
+	/**< Ring for placing process packets */
+	struct rte_compressdev_stats qp_stats;
+	/**< Queue pair statistics */
+	ZSTD_CCtx *cctx;
+	/**< Compression context of the stateless operations */
+	ZSTD_DCtx *dctx;
+	/**< Decompression context of the stateless operations */
+	uint16_t id;
+	/**< Queue Pair Identifier */
+	char name[RTE_COMPRESSDEV_NAME_MAX_LEN];
+	/**< Unique Queue Pair Name */
+} __rte_cache_aligned;
+
+struct zstd_stream;
+
+/* Algorithm handler function prototype */
+typedef void (*comp_func_t)(struct rte_comp_op *op,
+		const struct zstd_stream *stream, void *ctx);
+
+/**
+ * ZSTD Stream structure, used for both private xforms and streams.
+ *
+ * A private xform only holds read-only parameters, the stateless
+ * operations run in the context of the queue pair, so it can be
+ * shared by any number of operations in flight.
+ */
+struct zstd_stream {
+	union {
+		ZSTD_CCtx *cctx;
+		/**< Compression context of a stream */
+		ZSTD_DCtx *dctx;
+		/**< Decompression context of a stream */
+	};
+	union {
+		ZSTD_CDict *cdict;
+		/**< Digested compression dictionary, NULL if none */
+		ZSTD_DDict *ddict;
+		/**< Digested decompression dictionary, NULL if none */
+	};
+	comp_func_t comp;
+	/**< Operation (compression/decompression) */
+	enum rte_comp_xform_type type;
+	/**< Direction of the stream */
+	int level;
+	/**< Zstandard compression level */
+	int window_log;
+	/**< Base two log of the window size, 0 for the library default */
+} __rte_cache_aligned;
+
+int
+zstd_set_stream_parameters(const struct rte_comp_xform *xform,
+		struct zstd_stream *stream, bool stateful);
+
+void
+zstd_stream_free(struct zstd_stream *stream);
+
+/** Device specific operations function pointer structure */
+extern struct rte_compressdev_ops *rte_zstd_pmd_ops;
+
+#endif /* _ZSTD_PMD_PRIVATE_H_ */
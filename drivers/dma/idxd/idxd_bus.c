@@ -94,6 +94,7 @@ idxd_dev_close(struct rte_dma_dev *dev)
 {
 	struct idxd_dmadev *idxd = dev->data->dev_private;
 	munmap(idxd->portal, 0x1000);
+	idxd_vchans_free(idxd);
 	return 0;
 }
 
@@ -218,6 +219,7 @@ static int
 idxd_probe_dsa(struct rte_dsa_device *dev)
 {
 	struct idxd_dmadev idxd = {0};
+	char mode[16];
 	int ret = 0;
 
 	IDXD_PMD_INFO("Probing device %s on numa node %d",
@@ -228,6 +230,11 @@ idxd_probe_dsa(struct rte_dsa_device *dev)
 	if (read_wq_int(dev, "max_batch_size", &ret) < 0)
 		return -1;
 	idxd.max_batch_size = ret;
+	/* the kernel only enables shared WQs when the CPU has ENQCMD */
+	if (read_wq_string(dev, "mode", mode, sizeof(mode)) == 0 &&
+			strncmp(mode, "shared", 6) == 0)
+		idxd.shared_wq = 1;
+	idxd.intr_fd = -1;
 	idxd.qid = dev->addr.wq_id;
 	idxd.u.bus.dsa_id = dev->addr.device_id;
 	idxd.sva_support = 1;
@@ -2,11 +2,13 @@
  * Copyright 2021 Intel Corporation
  */
 
+#include <inttypes.h>
 #include <x86intrin.h>
 
 #include <rte_malloc.h>
 #include <rte_common.h>
 #include <rte_log.h>
+#include <rte_pause.h>
 #include <rte_prefetch.h>
 
 #include "idxd_internal.h"
@@ -24,9 +26,16 @@
 
 __use_avx2
 static __rte_always_inline rte_iova_t
-__desc_idx_to_iova(struct idxd_dmadev *idxd, uint16_t n)
+__desc_idx_to_iova(struct idxd_vchan *vc, uint16_t n)
 {
-	return idxd->desc_iova + (n * sizeof(struct idxd_hw_desc));
+	return vc->desc_iova + (n * sizeof(struct idxd_hw_desc));
+}
+
+__use_avx2
+static __rte_always_inline struct idxd_vchan *
+__get_vchan(void *dev_private, uint16_t qid)
+{
+	return &((struct idxd_dmadev *)dev_private)->vchans[qid];
 }
 
 __use_avx2
@@ -39,95 +48,169 @@ __idxd_movdir64b(volatile void *dst, const struct idxd_hw_desc *src)
 			: "memory");
 }
 
+/* returns non-zero if the shared WQ did not accept the descriptor */
 __use_avx2
-static __rte_always_inline void
-__submit(struct idxd_dmadev *idxd)
+static __rte_always_inline uint8_t
+__idxd_enqcmd(volatile void *dst, const struct idxd_hw_desc *src)
 {
-	rte_prefetch1(&idxd->batch_comp_ring[idxd->batch_idx_read]);
+	uint8_t retry;
 
-	if (idxd->batch_size == 0)
-		return;
+	asm volatile (".byte 0xf2, 0x0f, 0x38, 0xf8, 0x02\n\t"
+			"setz %0"
+			: "=r" (retry)
+			: "a" (dst), "d" (src)
+			: "memory", "cc");
+	return retry;
+}
+
+__use_avx2
+static __rte_always_inline int
+__idxd_write_portal(struct idxd_vchan *vc, const struct idxd_hw_desc *desc)
+{
+	unsigned int i;
+
+	_mm_sfence(); /* fence before writing desc to device */
+	if (!vc->shared_wq) {
+		__idxd_movdir64b(vc->portal, desc);
+		return 0;
+	}
+
+	/* a shared WQ refuses descriptors while full, so retry a bounded number
+	 * of times and leave the batch pending for a later submit otherwise.
+	 */
+	for (i = 0; i < IDXD_ENQCMD_MAX_RETRIES; i++) {
+		if (__idxd_enqcmd(vc->portal, desc) == 0)
+			return 0;
+		rte_pause();
+	}
+	vc->enq_busy++;
+	return -EBUSY;
+}
+
+__use_avx2
+static __rte_always_inline int
+__submit(struct idxd_vchan *vc)
+{
+	rte_prefetch1(&vc->batch_comp_ring[vc->batch_idx_read]);
+
+	if (vc->batch_size == 0)
+		return 0;
 
 	/* write completion to batch comp ring */
-	rte_iova_t comp_addr = idxd->batch_iova +
-			(idxd->batch_idx_write * sizeof(struct idxd_completion));
+	rte_iova_t comp_addr = vc->batch_iova +
+			(vc->batch_idx_write * sizeof(struct idxd_completion));
 
-	if (idxd->batch_size == 1) {
+	if (vc->batch_size == 1) {
 		/* submit batch directly */
-		struct idxd_hw_desc desc =
-				idxd->desc_ring[idxd->batch_start & idxd->desc_ring_mask];
+		const uint16_t idx = vc->batch_start & vc->desc_ring_mask;
+		struct idxd_hw_desc desc = vc->desc_ring[idx];
 		desc.completion = comp_addr;
-		desc.op_flags |= IDXD_FLAG_REQUEST_COMPLETION;
-		_mm_sfence(); /* fence before writing desc to device */
-		__idxd_movdir64b(idxd->portal, &desc);
+		desc.op_flags |= IDXD_FLAG_REQUEST_COMPLETION | vc->intr_flags;
+		desc.intr_handle = vc->intr_handle;
+		if (__idxd_write_portal(vc, &desc) < 0)
+			return -EBUSY;
+		/* the op result now lands in the batch completion. Not before
+		 * the write succeeds: a busy WQ leaves the op pending, and it
+		 * may go out later in a batch, with its own completion.
+		 */
+		if (vc->nb_results != 0 && vc->results[idx].dst != NULL)
+			vc->results[idx].comp = &vc->batch_comp_ring[vc->batch_idx_write];
 	} else {
 		const struct idxd_hw_desc batch_desc = {
 				.op_flags = (idxd_op_batch << IDXD_CMD_OP_SHIFT) |
 				IDXD_FLAG_COMPLETION_ADDR_VALID |
-				IDXD_FLAG_REQUEST_COMPLETION,
-				.desc_addr = __desc_idx_to_iova(idxd,
-						idxd->batch_start & idxd->desc_ring_mask),
+				IDXD_FLAG_REQUEST_COMPLETION | vc->intr_flags,
+				.desc_addr = __desc_idx_to_iova(vc,
+						vc->batch_start & vc->desc_ring_mask),
 				.completion = comp_addr,
-				.size = idxd->batch_size,
+				.size = vc->batch_size,
+				.intr_handle = vc->intr_handle,
 		};
-		_mm_sfence(); /* fence before writing desc to device */
-		__idxd_movdir64b(idxd->portal, &batch_desc);
+		if (__idxd_write_portal(vc, &batch_desc) < 0)
+			return -EBUSY;
 	}
 
-	if (++idxd->batch_idx_write > idxd->max_batches)
-		idxd->batch_idx_write = 0;
+	if (++vc->batch_idx_write > vc->max_batches)
+		vc->batch_idx_write = 0;
 
-	idxd->stats.submitted += idxd->batch_size;
+	vc->stats.submitted += vc->batch_size;
 
-	idxd->batch_start += idxd->batch_size;
-	idxd->batch_size = 0;
-	idxd->batch_idx_ring[idxd->batch_idx_write] = idxd->batch_start;
-	_mm256_store_si256((void *)&idxd->batch_comp_ring[idxd->batch_idx_write],
+	vc->batch_start += vc->batch_size;
+	vc->batch_size = 0;
+	vc->batch_idx_ring[vc->batch_idx_write] = vc->batch_start;
+	_mm256_store_si256((void *)&vc->batch_comp_ring[vc->batch_idx_write],
 			_mm256_setzero_si256());
+	return 0;
 }
 
 __use_avx2
 static __rte_always_inline int
-__idxd_write_desc(struct idxd_dmadev *idxd,
+__idxd_write_desc(struct idxd_vchan *vc,
 		const uint32_t op_flags,
 		const rte_iova_t src,
 		const rte_iova_t dst,
 		const uint32_t size,
+		const uint64_t op_specific0,
+		const uint64_t op_specific1,
+		const uint64_t op_specific2,
+		uint32_t *result,
+		const enum idxd_result_type result_type,
 		const uint32_t flags)
 {
-	uint16_t mask = idxd->desc_ring_mask;
-	uint16_t job_id = idxd->batch_start + idxd->batch_size;
+	uint16_t mask = vc->desc_ring_mask;
+	uint16_t job_id = vc->batch_start + vc->batch_size;
 	/* we never wrap batches, so we only mask the start and allow start+size to overflow */
-	uint16_t write_idx = (idxd->batch_start & mask) + idxd->batch_size;
+	uint16_t write_idx = (vc->batch_start & mask) + vc->batch_size;
 
 	/* first check batch ring space then desc ring space */
-	if ((idxd->batch_idx_read == 0 && idxd->batch_idx_write == idxd->max_batches) ||
-			idxd->batch_idx_write + 1 == idxd->batch_idx_read)
+	if ((vc->batch_idx_read == 0 && vc->batch_idx_write == vc->max_batches) ||
+			vc->batch_idx_write + 1 == vc->batch_idx_read)
 		return -ENOSPC;
-	if (((write_idx + 1) & mask) == (idxd->ids_returned & mask))
+	if (((write_idx + 1) & mask) == (vc->ids_returned & mask))
 		return -ENOSPC;
 
+	/* ops returning a result need their completion record written back */
+	uint32_t comp_flags = IDXD_FLAG_COMPLETION_ADDR_VALID;
+	if (result != NULL) {
+		struct idxd_op_result *r = &vc->results[job_id & mask];
+
+		r->dst = result;
+		r->comp = (const void *)&vc->desc_ring[write_idx & mask];
+		r->type = result_type;
+		vc->nb_results++;
+		comp_flags |= IDXD_FLAG_REQUEST_COMPLETION;
+	}
+
 	/* write desc. Note: descriptors don't wrap, but the completion address does */
-	const uint64_t op_flags64 = (uint64_t)(op_flags | IDXD_FLAG_COMPLETION_ADDR_VALID) << 32;
-	const uint64_t comp_addr = __desc_idx_to_iova(idxd, write_idx & mask);
-	_mm256_store_si256((void *)&idxd->desc_ring[write_idx],
+	const uint64_t op_flags64 = (uint64_t)(op_flags | comp_flags) << 32;
+	const uint64_t comp_addr = __desc_idx_to_iova(vc, write_idx & mask);
+	_mm256_store_si256((void *)&vc->desc_ring[write_idx],
 			_mm256_set_epi64x(dst, src, comp_addr, op_flags64));
-	_mm256_store_si256((void *)&idxd->desc_ring[write_idx].size,
-			_mm256_set_epi64x(0, 0, 0, size));
+	_mm256_store_si256((void *)&vc->desc_ring[write_idx].size,
+			_mm256_set_epi64x(op_specific2, op_specific1, op_specific0, size));
 
-	idxd->batch_size++;
+	vc->batch_size++;
 
-	rte_prefetch0_write(&idxd->desc_ring[write_idx + 1]);
+	rte_prefetch0_write(&vc->desc_ring[write_idx + 1]);
 
-	if (flags & RTE_DMA_OP_FLAG_SUBMIT)
-		__submit(idxd);
+	/* nothing retries a submit refused by a busy shared WQ, so fail the
+	 * enqueue, leaving the earlier ops pending for the next submit
+	 */
+	if ((flags & RTE_DMA_OP_FLAG_SUBMIT) && __submit(vc) < 0) {
+		vc->batch_size--;
+		if (result != NULL) {
+			vc->results[job_id & mask].dst = NULL;
+			vc->nb_results--;
+		}
+		return -EBUSY;
+	}
 
 	return job_id;
 }
 
 __use_avx2
 int
-idxd_enqueue_copy(void *dev_private, uint16_t qid __rte_unused, rte_iova_t src,
+idxd_enqueue_copy(void *dev_private, uint16_t qid, rte_iova_t src,
 		rte_iova_t dst, unsigned int length, uint64_t flags)
 {
 	/* we can take advantage of the fact that the fence flag in dmadev and DSA are the same,
@@ -136,27 +219,135 @@ idxd_enqueue_copy(void *dev_private, uint16_t qid __rte_unused, rte_iova_t src,
 	RTE_BUILD_BUG_ON(RTE_DMA_OP_FLAG_FENCE != IDXD_FLAG_FENCE);
 	uint32_t memmove = (idxd_op_memmove << IDXD_CMD_OP_SHIFT) |
 			IDXD_FLAG_CACHE_CONTROL | (flags & IDXD_FLAG_FENCE);
-	return __idxd_write_desc(dev_private, memmove, src, dst, length,
-			flags);
+	return __idxd_write_desc(__get_vchan(dev_private, qid), memmove, src, dst, length,
+			0, 0, 0, NULL, IDXD_RESULT_NONE, flags);
 }
 
 __use_avx2
 int
-idxd_enqueue_fill(void *dev_private, uint16_t qid __rte_unused, uint64_t pattern,
+idxd_enqueue_fill(void *dev_private, uint16_t qid, uint64_t pattern,
 		rte_iova_t dst, unsigned int length, uint64_t flags)
 {
 	uint32_t fill = (idxd_op_fill << IDXD_CMD_OP_SHIFT) |
 			IDXD_FLAG_CACHE_CONTROL | (flags & IDXD_FLAG_FENCE);
-	return __idxd_write_desc(dev_private, fill, pattern, dst, length,
-			flags);
+	return __idxd_write_desc(__get_vchan(dev_private, qid), fill, pattern, dst, length,
+			0, 0, 0, NULL, IDXD_RESULT_NONE, flags);
 }
 
 __use_avx2
 int
-idxd_submit(void *dev_private, uint16_t qid __rte_unused)
+idxd_enqueue_crc32c(void *dev_private, uint16_t qid, rte_iova_t src,
+		uint32_t length, uint32_t seed, uint32_t *crc, uint64_t flags)
 {
-	__submit(dev_private);
-	return 0;
+	uint32_t crcgen = (idxd_op_crcgen << IDXD_CMD_OP_SHIFT) | (flags & IDXD_FLAG_FENCE);
+	/* hardware neither inverts the seed nor the result, unlike the API */
+	return __idxd_write_desc(__get_vchan(dev_private, qid), crcgen, src, 0, length,
+			~seed, 0, 0, crc, IDXD_RESULT_CRC, flags);
+}
+
+__use_avx2
+int
+idxd_enqueue_compare(void *dev_private, uint16_t qid, rte_iova_t src1,
+		rte_iova_t src2, uint32_t length, uint32_t *result, uint64_t flags)
+{
+	uint32_t compare = (idxd_op_compare << IDXD_CMD_OP_SHIFT) | (flags & IDXD_FLAG_FENCE);
+	return __idxd_write_desc(__get_vchan(dev_private, qid), compare, src1, src2, length,
+			0, 0, 0, result, IDXD_RESULT_COMPARE, flags);
+}
+
+__use_avx2
+int
+idxd_enqueue_compare_pattern(void *dev_private, uint16_t qid,
+		uint64_t pattern, rte_iova_t src, uint32_t length, uint32_t *result,
+		uint64_t flags)
+{
+	uint32_t compval = (idxd_op_compval << IDXD_CMD_OP_SHIFT) | (flags & IDXD_FLAG_FENCE);
+	return __idxd_write_desc(__get_vchan(dev_private, qid), compval, src, pattern, length,
+			0, 0, 0, result, IDXD_RESULT_COMPARE, flags);
+}
+
+__use_avx2
+int
+idxd_enqueue_dualcast(void *dev_private, uint16_t qid, rte_iova_t src,
+		rte_iova_t dst1, rte_iova_t dst2, uint32_t length, uint64_t flags)
+{
+	uint32_t dualcast = (idxd_op_dualcast << IDXD_CMD_OP_SHIFT) |
+			IDXD_FLAG_CACHE_CONTROL | (flags & IDXD_FLAG_FENCE);
+
+	if ((dst1 & IDXD_DUALCAST_ADDR_MASK) != (dst2 & IDXD_DUALCAST_ADDR_MASK))
+		return -EINVAL;
+	return __idxd_write_desc(__get_vchan(dev_private, qid), dualcast, src, dst1, length,
+			dst2, 0, 0, NULL, IDXD_RESULT_NONE, flags);
+}
+
+__use_avx2
+int
+idxd_enqueue_dif(void *dev_private, uint16_t qid, enum rte_dma_dif_op op,
+		rte_iova_t src, rte_iova_t dst, uint32_t length,
+		const struct rte_dma_dif_conf *conf, uint32_t *result, uint64_t flags)
+{
+	struct idxd_hw_desc desc = {0};
+	uint32_t dif_op;
+	uint8_t dif_flags, src_dst_flags = 0;
+
+	switch (conf->block_size) {
+	case 512:
+		dif_flags = IDXD_DIF_BLK_SZ_512;
+		break;
+	case 520:
+		dif_flags = IDXD_DIF_BLK_SZ_520;
+		break;
+	case 4096:
+		dif_flags = IDXD_DIF_BLK_SZ_4096;
+		break;
+	case 4104:
+		dif_flags = IDXD_DIF_BLK_SZ_4104;
+		break;
+	default:
+		return -EINVAL;
+	}
+	if (conf->flags & RTE_DMA_DIF_F_NO_REF_CHECK)
+		dif_flags |= IDXD_DIF_REF_TAG_CHECK_DISABLE;
+	if (conf->flags & RTE_DMA_DIF_F_REF_FIXED)
+		src_dst_flags |= IDXD_DIF_REF_TAG_FIXED;
+
+	switch (op) {
+	case RTE_DMA_DIF_OP_INSERT:
+		dif_op = idxd_op_dif_ins;
+		desc.dif_ins.dst_dif_flags = src_dst_flags;
+		desc.dif_ins.dif_flags = dif_flags;
+		desc.dif_ins.ref_tag = conf->ref_tag;
+		desc.dif_ins.app_tag = conf->app_tag;
+		break;
+	case RTE_DMA_DIF_OP_CHECK:
+		dst = 0;
+		/* fall-through */
+	case RTE_DMA_DIF_OP_STRIP:
+		dif_op = op == RTE_DMA_DIF_OP_CHECK ? idxd_op_dif_check : idxd_op_dif_strp;
+		if (conf->flags & RTE_DMA_DIF_F_NO_GUARD_CHECK)
+			src_dst_flags |= IDXD_DIF_GUARD_CHECK_DISABLE;
+		desc.dif_chk.src_dif_flags = src_dst_flags;
+		desc.dif_chk.dif_flags = dif_flags;
+		desc.dif_chk.ref_tag = conf->ref_tag;
+		/* hardware ignores the application tag bits set in its mask */
+		desc.dif_chk.app_tag_mask = ~conf->app_tag_mask;
+		desc.dif_chk.app_tag = conf->app_tag;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	dif_op = (dif_op << IDXD_CMD_OP_SHIFT) | (flags & IDXD_FLAG_FENCE);
+	return __idxd_write_desc(__get_vchan(dev_private, qid), dif_op, src, dst, length,
+			desc.op_specific[0], desc.op_specific[1], desc.op_specific[2],
+			result, IDXD_RESULT_DIF, flags);
+}
+
+__use_avx2
+int
+idxd_submit(void *dev_private, uint16_t qid)
+{
+	return __submit(__get_vchan(dev_private, qid));
 }
 
 __use_avx2
@@ -168,6 +359,8 @@ get_comp_status(struct idxd_completion *c)
 	/* successful descriptors are not written back normally */
 	case IDXD_COMP_STATUS_INCOMPLETE:
 	case IDXD_COMP_STATUS_SUCCESS:
+	/* DIF tag mismatches are returned as the result of the op */
+	case IDXD_COMP_STATUS_DIF_ERROR:
 		return RTE_DMA_STATUS_SUCCESSFUL;
 	case IDXD_COMP_STATUS_PAGE_FAULT:
 		return RTE_DMA_STATUS_PAGE_FAULT;
@@ -184,13 +377,13 @@ get_comp_status(struct idxd_completion *c)
 
 __use_avx2
 int
-idxd_vchan_status(const struct rte_dma_dev *dev, uint16_t vchan __rte_unused,
+idxd_vchan_status(const struct rte_dma_dev *dev, uint16_t vchan,
 		enum rte_dma_vchan_status *status)
 {
-	struct idxd_dmadev *idxd = dev->fp_obj->dev_private;
-	uint16_t last_batch_write = idxd->batch_idx_write == 0 ? idxd->max_batches :
-			idxd->batch_idx_write - 1;
-	uint8_t bstatus = (idxd->batch_comp_ring[last_batch_write].status != 0);
+	struct idxd_vchan *vc = __get_vchan(dev->fp_obj->dev_private, vchan);
+	uint16_t last_batch_write = vc->batch_idx_write == 0 ? vc->max_batches :
+			vc->batch_idx_write - 1;
+	uint8_t bstatus = (vc->batch_comp_ring[last_batch_write].status != 0);
 
 	/* An IDXD device will always be either active or idle.
 	 * RTE_DMA_VCHAN_HALTED_ERROR is therefore not supported by IDXD.
@@ -200,9 +393,164 @@ idxd_vchan_status(const struct rte_dma_dev *dev, uint16_t vchan __rte_unused,
 	return 0;
 }
 
+__use_avx2
+int
+idxd_intr_enable(struct rte_dma_dev *dev, uint16_t vchan)
+{
+	struct idxd_dmadev *idxd = dev->fp_obj->dev_private;
+	struct idxd_vchan *vc = __get_vchan(idxd, vchan);
+
+	if (idxd->intr_fd < 0)
+		return -ENOTSUP;
+
+	vc->intr_flags = IDXD_FLAG_REQUEST_COMPLETION_INTR;
+	if (vc->batch_idx_read == vc->batch_idx_write)
+		return 0;
+
+	/* Batches submitted while disarmed raise no interrupt, so follow them
+	 * with a drain descriptor, which completes once they are all complete.
+	 * Only one drain at a time fits in the reserved WQ slot, and one still
+	 * pending will wake the application up to arm again anyway.
+	 */
+	if (vc->drain_pending &&
+			((volatile struct idxd_completion *)&vc->drain_comp)->status == 0)
+		return 0;
+
+	const struct idxd_hw_desc drain = {
+			.op_flags = (idxd_op_drain << IDXD_CMD_OP_SHIFT) |
+				IDXD_FLAG_COMPLETION_ADDR_VALID |
+				IDXD_FLAG_REQUEST_COMPLETION |
+				IDXD_FLAG_REQUEST_COMPLETION_INTR,
+			.completion = vc->drain_iova,
+			.intr_handle = vc->intr_handle,
+	};
+	vc->drain_comp.status = 0;
+	/* a shared WQ keeps no slot for the drain and may refuse it, leaving
+	 * the batches in flight without interrupt, so the caller has to poll
+	 */
+	if (__idxd_write_portal(vc, &drain) < 0) {
+		vc->drain_pending = 0;
+		return -EBUSY;
+	}
+	vc->drain_pending = 1;
+	return 0;
+}
+
+int
+idxd_intr_disable(struct rte_dma_dev *dev, uint16_t vchan)
+{
+	struct idxd_dmadev *idxd = dev->fp_obj->dev_private;
+
+	if (idxd->intr_fd < 0)
+		return -ENOTSUP;
+	idxd->vchans[vchan].intr_flags = 0;
+	return 0;
+}
+
+int
+idxd_intr_fd_get(const struct rte_dma_dev *dev, uint16_t vchan __rte_unused)
+{
+	const struct idxd_dmadev *idxd = dev->fp_obj->dev_private;
+
+	/* all vchans share the interrupt of the WQ */
+	if (idxd->intr_fd < 0)
+		return -ENOTSUP;
+	return idxd->intr_fd;
+}
+
+__use_avx2
+static __rte_always_inline void
+__write_result(struct idxd_vchan *vc, uint16_t id, bool successful)
+{
+	struct idxd_op_result *r = &vc->results[id & vc->desc_ring_mask];
+	uint32_t val = 0;
+
+	if (r->dst == NULL)
+		return;
+
+	/* results of failed ops are dropped */
+	if (successful) {
+		switch (r->type) {
+		case IDXD_RESULT_CRC:
+			val = ~r->comp->crc_val;
+			break;
+		case IDXD_RESULT_COMPARE:
+			val = (r->comp->result == IDXD_COMP_RESULT_MISMATCH);
+			break;
+		case IDXD_RESULT_DIF:
+			if (r->comp->result & IDXD_DIF_STATUS_GUARD)
+				val |= RTE_DMA_DIF_ERR_GUARD;
+			if (r->comp->result & IDXD_DIF_STATUS_APP_TAG)
+				val |= RTE_DMA_DIF_ERR_APP_TAG;
+			if (r->comp->result & IDXD_DIF_STATUS_REF_TAG)
+				val |= RTE_DMA_DIF_ERR_REF_TAG;
+			break;
+		default:
+			break;
+		}
+		*r->dst = val;
+	}
+
+	r->dst = NULL;
+	vc->nb_results--;
+}
+
+/* status of a descriptor which did not complete successfully */
+static __rte_always_inline bool
+desc_failed(uint8_t status)
+{
+	return status > IDXD_COMP_STATUS_SUCCESS &&
+		status != IDXD_COMP_STATUS_DIF_ERROR;
+}
+
+/*
+ * A batch fails if one of its descriptors is not successful, but DIF errors
+ * are results, so check whether all its descriptors actually succeeded.
+ */
+__use_avx2
+static __rte_always_inline bool
+batch_dif_only(struct idxd_vchan *vc, uint8_t bstatus)
+{
+	uint16_t next_batch, b_start, b_end, i;
+
+	next_batch = vc->batch_idx_read + 1;
+	if (next_batch > vc->max_batches)
+		next_batch = 0;
+	b_start = vc->batch_idx_ring[vc->batch_idx_read];
+	b_end = vc->batch_idx_ring[next_batch];
+
+	/* not a batch, the status is the one of the descriptor */
+	if ((uint16_t)(b_end - b_start) == 1)
+		return bstatus == IDXD_COMP_STATUS_DIF_ERROR;
+
+	if (vc->batch_comp_ring[vc->batch_idx_read].completed_size !=
+			(uint16_t)(b_end - b_start))
+		return false;
+	for (i = b_start; i != b_end; i++) {
+		struct idxd_completion *c = (void *)&vc->desc_ring[i & vc->desc_ring_mask];
+		if (desc_failed(c->status))
+			return false;
+	}
+	return true;
+}
+
+/* copy results of successful ops from start to end (excluded) */
+__use_avx2
+static __rte_always_inline void
+write_results(struct idxd_vchan *vc, uint16_t start, uint16_t end)
+{
+	uint16_t id;
+
+	if (vc->nb_results == 0)
+		return;
+
+	for (id = start; id != end; id++)
+		__write_result(vc, id, true);
+}
+
 __use_avx2
 static __rte_always_inline int
-batch_ok(struct idxd_dmadev *idxd, uint16_t max_ops, enum rte_dma_status_code *status)
+batch_ok(struct idxd_vchan *vc, uint16_t max_ops, enum rte_dma_status_code *status)
 {
 	uint16_t ret;
 	uint8_t bstatus;
@@ -211,29 +559,33 @@ batch_ok(struct idxd_dmadev *idxd, uint16_t max_ops, enum rte_dma_status_code *s
 		return 0;
 
 	/* first check if there are any unreturned handles from last time */
-	if (idxd->ids_avail != idxd->ids_returned) {
-		ret = RTE_MIN((uint16_t)(idxd->ids_avail - idxd->ids_returned), max_ops);
-		idxd->ids_returned += ret;
+	if (vc->ids_avail != vc->ids_returned) {
+		ret = RTE_MIN((uint16_t)(vc->ids_avail - vc->ids_returned), max_ops);
+		vc->ids_returned += ret;
 		if (status)
 			memset(status, RTE_DMA_STATUS_SUCCESSFUL, ret * sizeof(*status));
 		return ret;
 	}
 
-	if (idxd->batch_idx_read == idxd->batch_idx_write)
+	if (vc->batch_idx_read == vc->batch_idx_write)
 		return 0;
 
-	bstatus = idxd->batch_comp_ring[idxd->batch_idx_read].status;
+	bstatus = vc->batch_comp_ring[vc->batch_idx_read].status;
 	/* now check if next batch is complete and successful */
-	if (bstatus == IDXD_COMP_STATUS_SUCCESS) {
+	if (bstatus == IDXD_COMP_STATUS_SUCCESS ||
+			(bstatus != IDXD_COMP_STATUS_INCOMPLETE &&
+			batch_dif_only(vc, bstatus))) {
 		/* since the batch idx ring stores the start of each batch, pre-increment to lookup
 		 * start of next batch.
 		 */
-		if (++idxd->batch_idx_read > idxd->max_batches)
-			idxd->batch_idx_read = 0;
-		idxd->ids_avail = idxd->batch_idx_ring[idxd->batch_idx_read];
-
-		ret = RTE_MIN((uint16_t)(idxd->ids_avail - idxd->ids_returned), max_ops);
-		idxd->ids_returned += ret;
+		if (++vc->batch_idx_read > vc->max_batches)
+			vc->batch_idx_read = 0;
+		vc->ids_avail = vc->batch_idx_ring[vc->batch_idx_read];
+		/* completion records are valid until the batch slot is reused */
+		write_results(vc, vc->ids_returned, vc->ids_avail);
+
+		ret = RTE_MIN((uint16_t)(vc->ids_avail - vc->ids_returned), max_ops);
+		vc->ids_returned += ret;
 		if (status)
 			memset(status, RTE_DMA_STATUS_SUCCESSFUL, ret * sizeof(*status));
 		return ret;
@@ -247,12 +599,12 @@ batch_ok(struct idxd_dmadev *idxd, uint16_t max_ops, enum rte_dma_status_code *s
 
 __use_avx2
 static inline uint16_t
-batch_completed(struct idxd_dmadev *idxd, uint16_t max_ops, bool *has_error)
+batch_completed(struct idxd_vchan *vc, uint16_t max_ops, bool *has_error)
 {
 	uint16_t i;
 	uint16_t b_start, b_end, next_batch;
 
-	int ret = batch_ok(idxd, max_ops, NULL);
+	int ret = batch_ok(vc, max_ops, NULL);
 	if (ret >= 0)
 		return ret;
 
@@ -263,11 +615,11 @@ batch_completed(struct idxd_dmadev *idxd, uint16_t max_ops, bool *has_error)
 	 * Subsequent calls here will always return zero packets, and the error must be cleared by
 	 * calling the completed_status() function.
 	 */
-	next_batch = (idxd->batch_idx_read + 1);
-	if (next_batch > idxd->max_batches)
+	next_batch = (vc->batch_idx_read + 1);
+	if (next_batch > vc->max_batches)
 		next_batch = 0;
-	b_start = idxd->batch_idx_ring[idxd->batch_idx_read];
-	b_end = idxd->batch_idx_ring[next_batch];
+	b_start = vc->batch_idx_ring[vc->batch_idx_read];
+	b_end = vc->batch_idx_ring[next_batch];
 
 	if (b_end - b_start == 1) { /* not a batch */
 		*has_error = true;
@@ -275,23 +627,24 @@ batch_completed(struct idxd_dmadev *idxd, uint16_t max_ops, bool *has_error)
 	}
 
 	for (i = b_start; i < b_end; i++) {
-		struct idxd_completion *c = (void *)&idxd->desc_ring[i & idxd->desc_ring_mask];
-		if (c->status > IDXD_COMP_STATUS_SUCCESS) /* ignore incomplete(0) and success(1) */
+		struct idxd_completion *c = (void *)&vc->desc_ring[i & vc->desc_ring_mask];
+		if (desc_failed(c->status)) /* ignore incomplete(0), success(1) and DIF */
 			break;
 	}
-	ret = RTE_MIN((uint16_t)(i - idxd->ids_returned), max_ops);
+	ret = RTE_MIN((uint16_t)(i - vc->ids_returned), max_ops);
 	if (ret < max_ops)
 		*has_error = true; /* we got up to the point of error */
-	idxd->ids_avail = idxd->ids_returned += ret;
+	write_results(vc, vc->ids_returned, vc->ids_returned + ret);
+	vc->ids_avail = vc->ids_returned += ret;
 
 	/* to ensure we can call twice and just return 0, set start of batch to where we finished */
-	idxd->batch_comp_ring[idxd->batch_idx_read].completed_size -= ret;
-	idxd->batch_idx_ring[idxd->batch_idx_read] += ret;
-	if (idxd->batch_idx_ring[next_batch] - idxd->batch_idx_ring[idxd->batch_idx_read] == 1) {
+	vc->batch_comp_ring[vc->batch_idx_read].completed_size -= ret;
+	vc->batch_idx_ring[vc->batch_idx_read] += ret;
+	if (vc->batch_idx_ring[next_batch] - vc->batch_idx_ring[vc->batch_idx_read] == 1) {
 		/* copy over the descriptor status to the batch ring as if no batch */
-		uint16_t d_idx = idxd->batch_idx_ring[idxd->batch_idx_read] & idxd->desc_ring_mask;
-		struct idxd_completion *desc_comp = (void *)&idxd->desc_ring[d_idx];
-		idxd->batch_comp_ring[idxd->batch_idx_read].status = desc_comp->status;
+		uint16_t d_idx = vc->batch_idx_ring[vc->batch_idx_read] & vc->desc_ring_mask;
+		struct idxd_completion *desc_comp = (void *)&vc->desc_ring[d_idx];
+		vc->batch_comp_ring[vc->batch_idx_read].status = desc_comp->status;
 	}
 
 	return ret;
@@ -299,30 +652,32 @@ batch_completed(struct idxd_dmadev *idxd, uint16_t max_ops, bool *has_error)
 
 __use_avx2
 static uint16_t
-batch_completed_status(struct idxd_dmadev *idxd, uint16_t max_ops, enum rte_dma_status_code *status)
+batch_completed_status(struct idxd_vchan *vc, uint16_t max_ops, enum rte_dma_status_code *status)
 {
 	uint16_t next_batch;
 
-	int ret = batch_ok(idxd, max_ops, status);
+	int ret = batch_ok(vc, max_ops, status);
 	if (ret >= 0)
 		return ret;
 
 	/* ERROR case, not successful, not incomplete */
 	/* Get the batch size, and special case size 1.
 	 */
-	next_batch = (idxd->batch_idx_read + 1);
-	if (next_batch > idxd->max_batches)
+	next_batch = (vc->batch_idx_read + 1);
+	if (next_batch > vc->max_batches)
 		next_batch = 0;
-	const uint16_t b_start = idxd->batch_idx_ring[idxd->batch_idx_read];
-	const uint16_t b_end = idxd->batch_idx_ring[next_batch];
+	const uint16_t b_start = vc->batch_idx_ring[vc->batch_idx_read];
+	const uint16_t b_end = vc->batch_idx_ring[next_batch];
 	const uint16_t b_len = b_end - b_start;
 	if (b_len == 1) {/* not a batch */
-		*status = get_comp_status(&idxd->batch_comp_ring[idxd->batch_idx_read]);
+		*status = get_comp_status(&vc->batch_comp_ring[vc->batch_idx_read]);
 		if (status != RTE_DMA_STATUS_SUCCESSFUL)
-			idxd->stats.errors++;
-		idxd->ids_avail++;
-		idxd->ids_returned++;
-		idxd->batch_idx_read = next_batch;
+			vc->stats.errors++;
+		if (vc->nb_results != 0)
+			__write_result(vc, b_start, *status == RTE_DMA_STATUS_SUCCESSFUL);
+		vc->ids_avail++;
+		vc->ids_returned++;
+		vc->batch_idx_read = next_batch;
 		return 1;
 	}
 
@@ -336,38 +691,41 @@ batch_completed_status(struct idxd_dmadev *idxd, uint16_t max_ops, enum rte_dma_
 	 *   - if bcount is to be exactly 1, update the batch descriptor as it will be treated as
 	 *     non-batch next time.
 	 */
-	const uint16_t bcount = idxd->batch_comp_ring[idxd->batch_idx_read].completed_size;
+	const uint16_t bcount = vc->batch_comp_ring[vc->batch_idx_read].completed_size;
 	for (ret = 0; ret < b_len && ret < max_ops; ret++) {
 		struct idxd_completion *c = (void *)
-				&idxd->desc_ring[(b_start + ret) & idxd->desc_ring_mask];
+				&vc->desc_ring[(b_start + ret) & vc->desc_ring_mask];
 		status[ret] = (ret < bcount) ? get_comp_status(c) : RTE_DMA_STATUS_NOT_ATTEMPTED;
 		if (status[ret] != RTE_DMA_STATUS_SUCCESSFUL)
-			idxd->stats.errors++;
+			vc->stats.errors++;
+		if (vc->nb_results != 0)
+			__write_result(vc, b_start + ret,
+					status[ret] == RTE_DMA_STATUS_SUCCESSFUL);
 	}
-	idxd->ids_avail = idxd->ids_returned += ret;
+	vc->ids_avail = vc->ids_returned += ret;
 
 	/* everything fit */
 	if (ret == b_len) {
-		idxd->batch_idx_read = next_batch;
+		vc->batch_idx_read = next_batch;
 		return ret;
 	}
 
 	/* set up for next time, update existing batch descriptor & start idx at batch_idx_read */
-	idxd->batch_idx_ring[idxd->batch_idx_read] += ret;
+	vc->batch_idx_ring[vc->batch_idx_read] += ret;
 	if (ret > bcount) {
 		/* we have only incomplete ones - set batch completed size to 0 */
-		struct idxd_completion *comp = &idxd->batch_comp_ring[idxd->batch_idx_read];
+		struct idxd_completion *comp = &vc->batch_comp_ring[vc->batch_idx_read];
 		comp->completed_size = 0;
 		/* if there is only one descriptor left, job skipped so set flag appropriately */
 		if (b_len - ret == 1)
 			comp->status = IDXD_COMP_STATUS_SKIPPED;
 	} else {
-		struct idxd_completion *comp = &idxd->batch_comp_ring[idxd->batch_idx_read];
+		struct idxd_completion *comp = &vc->batch_comp_ring[vc->batch_idx_read];
 		comp->completed_size -= ret;
 		/* if there is only one descriptor left, copy status info straight to desc */
 		if (comp->completed_size == 1) {
 			struct idxd_completion *c = (void *)
-					&idxd->desc_ring[(b_start + ret) & idxd->desc_ring_mask];
+					&vc->desc_ring[(b_start + ret) & vc->desc_ring_mask];
 			comp->status = c->status;
 			/* individual descs can be ok without writeback, but not batches */
 			if (comp->status == IDXD_COMP_STATUS_INCOMPLETE)
@@ -377,8 +735,8 @@ batch_completed_status(struct idxd_dmadev *idxd, uint16_t max_ops, enum rte_dma_
 			uint16_t i;
 			for (i = b_start + ret; i < b_end; i++) {
 				struct idxd_completion *c = (void *)
-						&idxd->desc_ring[i & idxd->desc_ring_mask];
-				if (c->status > IDXD_COMP_STATUS_SUCCESS)
+						&vc->desc_ring[i & vc->desc_ring_mask];
+				if (desc_failed(c->status))
 					break;
 			}
 			if (i == b_end) /* no errors */
@@ -391,88 +749,115 @@ batch_completed_status(struct idxd_dmadev *idxd, uint16_t max_ops, enum rte_dma_
 
 __use_avx2
 uint16_t
-idxd_completed(void *dev_private, uint16_t qid __rte_unused, uint16_t max_ops,
+idxd_completed(void *dev_private, uint16_t qid, uint16_t max_ops,
 		uint16_t *last_idx, bool *has_error)
 {
-	struct idxd_dmadev *idxd = dev_private;
+	struct idxd_vchan *vc = __get_vchan(dev_private, qid);
 	uint16_t batch, ret = 0;
 
 	do {
-		batch = batch_completed(idxd, max_ops - ret, has_error);
+		batch = batch_completed(vc, max_ops - ret, has_error);
 		ret += batch;
 	} while (batch > 0 && *has_error == false);
 
-	idxd->stats.completed += ret;
-	*last_idx = idxd->ids_returned - 1;
+	vc->stats.completed += ret;
+	*last_idx = vc->ids_returned - 1;
 	return ret;
 }
 
 __use_avx2
 uint16_t
-idxd_completed_status(void *dev_private, uint16_t qid __rte_unused, uint16_t max_ops,
+idxd_completed_status(void *dev_private, uint16_t qid, uint16_t max_ops,
 		uint16_t *last_idx, enum rte_dma_status_code *status)
 {
-	struct idxd_dmadev *idxd = dev_private;
+	struct idxd_vchan *vc = __get_vchan(dev_private, qid);
 	uint16_t batch, ret = 0;
 
 	do {
-		batch = batch_completed_status(idxd, max_ops - ret, &status[ret]);
+		batch = batch_completed_status(vc, max_ops - ret, &status[ret]);
 		ret += batch;
 	} while (batch > 0);
 
-	idxd->stats.completed += ret;
-	*last_idx = idxd->ids_returned - 1;
+	vc->stats.completed += ret;
+	*last_idx = vc->ids_returned - 1;
 	return ret;
 }
 
-int
-idxd_dump(const struct rte_dma_dev *dev, FILE *f)
+static void
+idxd_vchan_dump(const struct idxd_vchan *vc, uint16_t vchan, FILE *f)
 {
-	struct idxd_dmadev *idxd = dev->fp_obj->dev_private;
 	unsigned int i;
 
-	fprintf(f, "== IDXD Private Data ==\n");
-	fprintf(f, "  Portal: %p\n", idxd->portal);
+	fprintf(f, "  Vchan %u:\n", vchan);
 	fprintf(f, "  Config: { ring_size: %u }\n",
-			idxd->qcfg.nb_desc);
+			vc->qcfg.nb_desc);
 	fprintf(f, "  Batch ring (sz = %u, max_batches = %u):\n\t",
-			idxd->max_batches + 1, idxd->max_batches);
-	for (i = 0; i <= idxd->max_batches; i++) {
-		fprintf(f, " %u ", idxd->batch_idx_ring[i]);
-		if (i == idxd->batch_idx_read && i == idxd->batch_idx_write)
+			vc->max_batches + 1, vc->max_batches);
+	for (i = 0; i <= vc->max_batches; i++) {
+		fprintf(f, " %u ", vc->batch_idx_ring[i]);
+		if (i == vc->batch_idx_read && i == vc->batch_idx_write)
 			fprintf(f, "[rd ptr, wr ptr] ");
-		else if (i == idxd->batch_idx_read)
+		else if (i == vc->batch_idx_read)
 			fprintf(f, "[rd ptr] ");
-		else if (i == idxd->batch_idx_write)
+		else if (i == vc->batch_idx_write)
 			fprintf(f, "[wr ptr] ");
-		if (i == idxd->max_batches)
+		if (i == vc->max_batches)
 			fprintf(f, "\n");
 	}
 
-	fprintf(f, "  Curr batch: start = %u, size = %u\n", idxd->batch_start, idxd->batch_size);
-	fprintf(f, "  IDS: avail = %u, returned: %u\n", idxd->ids_avail, idxd->ids_returned);
+	fprintf(f, "  Curr batch: start = %u, size = %u\n", vc->batch_start, vc->batch_size);
+	fprintf(f, "  IDS: avail = %u, returned: %u\n", vc->ids_avail, vc->ids_returned);
+	if (vc->shared_wq)
+		fprintf(f, "  Submissions refused by busy WQ: %"PRIu64"\n", vc->enq_busy);
+}
+
+int
+idxd_dump(const struct rte_dma_dev *dev, FILE *f)
+{
+	struct idxd_dmadev *idxd = dev->fp_obj->dev_private;
+	uint16_t i;
+
+	fprintf(f, "== IDXD Private Data ==\n");
+	fprintf(f, "  Portal: %p (%s WQ)\n", idxd->portal,
+			idxd->shared_wq ? "shared" : "dedicated");
+	fprintf(f, "  Vchans: %u\n", idxd->nb_vchans);
+	for (i = 0; i < idxd->nb_vchans; i++)
+		if (idxd->vchans[i].batch_idx_ring != NULL)
+			idxd_vchan_dump(&idxd->vchans[i], i, f);
 	return 0;
 }
 
 int
-idxd_stats_get(const struct rte_dma_dev *dev, uint16_t vchan __rte_unused,
+idxd_stats_get(const struct rte_dma_dev *dev, uint16_t vchan,
 		struct rte_dma_stats *stats, uint32_t stats_sz)
 {
 	struct idxd_dmadev *idxd = dev->fp_obj->dev_private;
 	if (stats_sz < sizeof(*stats))
 		return -EINVAL;
-	*stats = idxd->stats;
+	*stats = idxd->vchans[vchan].stats;
 	return 0;
 }
 
 int
-idxd_stats_reset(struct rte_dma_dev *dev, uint16_t vchan __rte_unused)
+idxd_stats_reset(struct rte_dma_dev *dev, uint16_t vchan)
 {
 	struct idxd_dmadev *idxd = dev->fp_obj->dev_private;
-	idxd->stats = (struct rte_dma_stats){0};
+	idxd->vchans[vchan].stats = (struct rte_dma_stats){0};
 	return 0;
 }
 
+/* a dedicated WQ has its slots split between the vchans, a shared one does not */
+static uint16_t
+idxd_max_vchans(const struct idxd_dmadev *idxd)
+{
+	if (idxd->shared_wq)
+		return IDXD_MAX_VCHANS;
+	/* with interrupts, each vchan keeps a slot for a drain descriptor */
+	if (idxd->intr_fd >= 0)
+		return RTE_MIN(IDXD_MAX_VCHANS, idxd->max_batches / 2);
+	return RTE_MIN(IDXD_MAX_VCHANS, idxd->max_batches);
+}
+
 int
 idxd_info_get(const struct rte_dma_dev *dev, struct rte_dma_info *info, uint32_t size)
 {
@@ -483,85 +868,138 @@ idxd_info_get(const struct rte_dma_dev *dev, struct rte_dma_info *info, uint32_t
 
 	*info = (struct rte_dma_info) {
 			.dev_capa = RTE_DMA_CAPA_MEM_TO_MEM | RTE_DMA_CAPA_HANDLES_ERRORS |
-				RTE_DMA_CAPA_OPS_COPY | RTE_DMA_CAPA_OPS_FILL,
-			.max_vchans = 1,
+				RTE_DMA_CAPA_OPS_COPY | RTE_DMA_CAPA_OPS_FILL |
+				RTE_DMA_CAPA_OPS_CRC32C | RTE_DMA_CAPA_OPS_COMPARE |
+				RTE_DMA_CAPA_OPS_DUALCAST | RTE_DMA_CAPA_OPS_DIF,
+			.max_vchans = idxd_max_vchans(idxd),
 			.max_desc = 4096,
 			.min_desc = 64,
 	};
 	if (idxd->sva_support)
 		info->dev_capa |= RTE_DMA_CAPA_SVA;
+	if (idxd->intr_fd >= 0)
+		info->dev_capa |= RTE_DMA_CAPA_INTR;
 	return 0;
 }
 
 uint16_t
-idxd_burst_capacity(const void *dev_private, uint16_t vchan __rte_unused)
+idxd_burst_capacity(const void *dev_private, uint16_t vchan)
 {
-	const struct idxd_dmadev *idxd = dev_private;
-	uint16_t write_idx = idxd->batch_start + idxd->batch_size;
+	const struct idxd_vchan *vc = &((const struct idxd_dmadev *)dev_private)->vchans[vchan];
+	uint16_t write_idx = vc->batch_start + vc->batch_size;
 	uint16_t used_space;
 
 	/* Check for space in the batch ring */
-	if ((idxd->batch_idx_read == 0 && idxd->batch_idx_write == idxd->max_batches) ||
-			idxd->batch_idx_write + 1 == idxd->batch_idx_read)
+	if ((vc->batch_idx_read == 0 && vc->batch_idx_write == vc->max_batches) ||
+			vc->batch_idx_write + 1 == vc->batch_idx_read)
 		return 0;
 
 	/* Subtract and mask to get in correct range */
-	used_space = (write_idx - idxd->ids_returned) & idxd->desc_ring_mask;
+	used_space = (write_idx - vc->ids_returned) & vc->desc_ring_mask;
 
-	const int ret = RTE_MIN((idxd->desc_ring_mask - used_space),
-			(idxd->max_batch_size - idxd->batch_size));
+	const int ret = RTE_MIN((vc->desc_ring_mask - used_space),
+			(vc->max_batch_size - vc->batch_size));
 	return ret < 0 ? 0 : (uint16_t)ret;
 }
 
+static void
+idxd_vchan_free(struct idxd_vchan *vc)
+{
+	rte_free(vc->batch_comp_ring);
+	rte_free(vc->desc_ring);
+	rte_free(vc->results);
+	*vc = (struct idxd_vchan){0};
+}
+
+void
+idxd_vchans_free(struct idxd_dmadev *idxd)
+{
+	uint16_t i;
+
+	for (i = 0; i < RTE_DIM(idxd->vchans); i++)
+		idxd_vchan_free(&idxd->vchans[i]);
+}
+
 int
-idxd_configure(struct rte_dma_dev *dev __rte_unused, const struct rte_dma_conf *dev_conf,
+idxd_configure(struct rte_dma_dev *dev, const struct rte_dma_conf *dev_conf,
 		uint32_t conf_sz)
 {
+	struct idxd_dmadev *idxd = dev->fp_obj->dev_private;
+
 	if (sizeof(struct rte_dma_conf) != conf_sz)
 		return -EINVAL;
 
-	if (dev_conf->nb_vchans != 1)
+	if (dev_conf->nb_vchans == 0 || dev_conf->nb_vchans > idxd_max_vchans(idxd))
 		return -EINVAL;
+
+	/* the share of WQ slots of each vchan changes, so all must be set up again */
+	idxd_vchans_free(idxd);
+	idxd->nb_vchans = dev_conf->nb_vchans;
 	return 0;
 }
 
 int
-idxd_vchan_setup(struct rte_dma_dev *dev, uint16_t vchan __rte_unused,
+idxd_vchan_setup(struct rte_dma_dev *dev, uint16_t vchan,
 		const struct rte_dma_vchan_conf *qconf, uint32_t qconf_sz)
 {
 	struct idxd_dmadev *idxd = dev->fp_obj->dev_private;
+	struct idxd_vchan *vc = &idxd->vchans[vchan];
 	uint16_t max_desc = qconf->nb_desc;
 
 	if (sizeof(struct rte_dma_vchan_conf) != qconf_sz)
 		return -EINVAL;
 
-	idxd->qcfg = *qconf;
+	/* in case we are reconfiguring a vchan, free any existing memory */
+	idxd_vchan_free(vc);
+
+	vc->qcfg = *qconf;
+	vc->portal = idxd->portal;
+	vc->shared_wq = idxd->shared_wq;
+	vc->max_batch_size = idxd->max_batch_size;
+	/* the device arbitrates between submitters of a shared WQ, but nothing
+	 * stops vchans from overflowing a dedicated WQ unless each keeps to its share
+	 */
+	vc->max_batches = idxd->shared_wq ? idxd->max_batches :
+			idxd->max_batches / idxd->nb_vchans;
+	if (!idxd->shared_wq && idxd->intr_fd >= 0)
+		vc->max_batches--;
+	vc->intr_handle = idxd->intr_handle;
+	vc->drain_iova = rte_mem_virt2iova(&vc->drain_comp);
 
 	if (!rte_is_power_of_2(max_desc))
 		max_desc = rte_align32pow2(max_desc);
-	IDXD_PMD_DEBUG("DMA dev %u using %u descriptors", dev->data->dev_id, max_desc);
-	idxd->desc_ring_mask = max_desc - 1;
-	idxd->qcfg.nb_desc = max_desc;
-
-	/* in case we are reconfiguring a device, free any existing memory */
-	rte_free(idxd->desc_ring);
+	IDXD_PMD_DEBUG("DMA dev %u vchan %u using %u descriptors, %u batches",
+			dev->data->dev_id, vchan, max_desc, vc->max_batches);
+	vc->desc_ring_mask = max_desc - 1;
+	vc->qcfg.nb_desc = max_desc;
 
 	/* allocate the descriptor ring at 2x size as batches can't wrap */
-	idxd->desc_ring = rte_zmalloc(NULL, sizeof(*idxd->desc_ring) * max_desc * 2, 0);
-	if (idxd->desc_ring == NULL)
-		return -ENOMEM;
-	idxd->desc_iova = rte_mem_virt2iova(idxd->desc_ring);
-
-	idxd->batch_idx_read = 0;
-	idxd->batch_idx_write = 0;
-	idxd->batch_start = 0;
-	idxd->batch_size = 0;
-	idxd->ids_returned = 0;
-	idxd->ids_avail = 0;
-
-	memset(idxd->batch_comp_ring, 0, sizeof(*idxd->batch_comp_ring) *
-			(idxd->max_batches + 1));
+	vc->desc_ring = rte_zmalloc(NULL, sizeof(*vc->desc_ring) * max_desc * 2, 0);
+	if (vc->desc_ring == NULL)
+		goto nomem;
+	vc->desc_iova = rte_mem_virt2iova(vc->desc_ring);
+
+	vc->results = rte_zmalloc(NULL, sizeof(*vc->results) * max_desc, 0);
+	if (vc->results == NULL)
+		goto nomem;
+
+	/* allocate batch index ring and completion ring.
+	 * The +1 is because we can never fully use
+	 * the ring, otherwise read == write means both full and empty.
+	 */
+	vc->batch_comp_ring = rte_zmalloc_socket(NULL, (sizeof(vc->batch_idx_ring[0]) +
+			sizeof(vc->batch_comp_ring[0])) * (vc->max_batches + 1),
+			sizeof(vc->batch_comp_ring[0]), dev->device->numa_node);
+	if (vc->batch_comp_ring == NULL)
+		goto nomem;
+	vc->batch_idx_ring = (void *)&vc->batch_comp_ring[vc->max_batches + 1];
+	vc->batch_iova = rte_mem_virt2iova(vc->batch_comp_ring);
 	return 0;
+
+nomem:
+	IDXD_PMD_ERR("Unable to reserve memory for vchan %u", vchan);
+	idxd_vchan_free(vc);
+	return -ENOMEM;
 }
 
 int
@@ -575,7 +1013,11 @@ idxd_dmadev_create(const char *name, struct rte_device *dev,
 
 	RTE_BUILD_BUG_ON(sizeof(struct idxd_hw_desc) != 64);
 	RTE_BUILD_BUG_ON(offsetof(struct idxd_hw_desc, size) != 32);
+	RTE_BUILD_BUG_ON(offsetof(struct idxd_hw_desc, op_specific) != 40);
+	RTE_BUILD_BUG_ON(offsetof(struct idxd_hw_desc, dif_chk.ref_tag) != 48);
+	RTE_BUILD_BUG_ON(offsetof(struct idxd_hw_desc, dif_ins.ref_tag) != 56);
 	RTE_BUILD_BUG_ON(sizeof(struct idxd_completion) != 32);
+	RTE_BUILD_BUG_ON(offsetof(struct idxd_completion, crc_val) != 16);
 
 	if (!name) {
 		IDXD_PMD_ERR("Invalid name of the device!");
@@ -600,6 +1042,12 @@ idxd_dmadev_create(const char *name, struct rte_device *dev,
 	dmadev->fp_obj->completed_status = idxd_completed_status;
 	dmadev->fp_obj->burst_capacity = idxd_burst_capacity;
 	dmadev->fp_obj->dev_private = dmadev->data->dev_private;
+	dmadev->fp_ext_obj->crc32c = idxd_enqueue_crc32c;
+	dmadev->fp_ext_obj->compare = idxd_enqueue_compare;
+	dmadev->fp_ext_obj->compare_pattern = idxd_enqueue_compare_pattern;
+	dmadev->fp_ext_obj->dualcast = idxd_enqueue_dualcast;
+	dmadev->fp_ext_obj->dif = idxd_enqueue_dif;
+	dmadev->fp_ext_obj->dev_private = dmadev->data->dev_private;
 
 	if (rte_eal_process_type() != RTE_PROC_PRIMARY)
 		return 0;
@@ -608,21 +1056,6 @@ idxd_dmadev_create(const char *name, struct rte_device *dev,
 	*idxd = *base_idxd; /* copy over the main fields already passed in */
 	idxd->dmadev = dmadev;
 
-	/* allocate batch index ring and completion ring.
-	 * The +1 is because we can never fully use
-	 * the ring, otherwise read == write means both full and empty.
-	 */
-	idxd->batch_comp_ring = rte_zmalloc_socket(NULL, (sizeof(idxd->batch_idx_ring[0]) +
-			sizeof(idxd->batch_comp_ring[0]))	* (idxd->max_batches + 1),
-			sizeof(idxd->batch_comp_ring[0]), dev->numa_node);
-	if (idxd->batch_comp_ring == NULL) {
-		IDXD_PMD_ERR("Unable to reserve memory for batch data\n");
-		ret = -ENOMEM;
-		goto cleanup;
-	}
-	idxd->batch_idx_ring = (void *)&idxd->batch_comp_ring[idxd->max_batches+1];
-	idxd->batch_iova = rte_mem_virt2iova(idxd->batch_comp_ring);
-
 	idxd->dmadev->state = RTE_DMA_DEV_READY;
 
 	return 0;
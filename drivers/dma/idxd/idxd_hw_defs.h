@@ -14,12 +14,20 @@ enum rte_idxd_ops {
 	idxd_op_batch,
 	idxd_op_drain,
 	idxd_op_memmove,
-	idxd_op_fill
+	idxd_op_fill,
+	idxd_op_compare,
+	idxd_op_compval,
+	idxd_op_dualcast = 0x09,
+	idxd_op_crcgen = 0x10,
+	idxd_op_dif_check = 0x12,
+	idxd_op_dif_ins,
+	idxd_op_dif_strp,
 };
 
 #define IDXD_FLAG_FENCE                 (1 << 0)
 #define IDXD_FLAG_COMPLETION_ADDR_VALID (1 << 2)
 #define IDXD_FLAG_REQUEST_COMPLETION    (1 << 3)
+#define IDXD_FLAG_REQUEST_COMPLETION_INTR (1 << 4)
 #define IDXD_FLAG_CACHE_CONTROL         (1 << 8)
 
 /**
@@ -40,14 +48,51 @@ struct idxd_hw_desc {
 	uint32_t size;    /* length of data for op, or batch size */
 
 	uint16_t intr_handle; /* completion interrupt handle */
+	uint16_t reserved;
 
-	/* remaining 26 bytes are reserved */
-	uint16_t reserved[13];
+	/* remaining 24 bytes are operation specific */
+	union {
+		rte_iova_t dst2;       /* second destination for dualcast */
+		uint32_t crc_seed;     /* seed for CRC generation */
+		struct {               /* DIF check and strip */
+			uint8_t src_dif_flags;
+			uint8_t rsvd0;
+			uint8_t dif_flags;
+			uint8_t rsvd1[5];
+			uint32_t ref_tag;
+			uint16_t app_tag_mask;
+			uint16_t app_tag;
+		} dif_chk;
+		struct {               /* DIF insert */
+			uint8_t rsvd0;
+			uint8_t dst_dif_flags;
+			uint8_t dif_flags;
+			uint8_t rsvd1[13];
+			uint32_t ref_tag;
+			uint16_t app_tag_mask;
+			uint16_t app_tag;
+		} dif_ins;
+		uint64_t op_specific[3];
+	};
 } __rte_aligned(64);
 
+/* source and destination DIF flags */
+#define IDXD_DIF_REF_TAG_FIXED          (1 << 6)
+#define IDXD_DIF_GUARD_CHECK_DISABLE    (1 << 7)
+/* DIF flags, block size in the low bits */
+#define IDXD_DIF_BLK_SZ_512             0
+#define IDXD_DIF_BLK_SZ_520             1
+#define IDXD_DIF_BLK_SZ_4096            2
+#define IDXD_DIF_BLK_SZ_4104            3
+#define IDXD_DIF_REF_TAG_CHECK_DISABLE  (1 << 2)
+
+/* dualcast destinations must share the same offset in a 4k page */
+#define IDXD_DUALCAST_ADDR_MASK         0xFFF
+
 #define IDXD_COMP_STATUS_INCOMPLETE        0
 #define IDXD_COMP_STATUS_SUCCESS           1
 #define IDXD_COMP_STATUS_PAGE_FAULT     0X03
+#define IDXD_COMP_STATUS_DIF_ERROR      0x09 /* tag mismatch, bits in result */
 #define IDXD_COMP_STATUS_INVALID_OPCODE 0x10
 #define IDXD_COMP_STATUS_INVALID_SIZE   0x13
 #define IDXD_COMP_STATUS_SKIPPED        0xFF /* not official IDXD error, needed as placeholder */
@@ -62,9 +107,19 @@ struct idxd_completion {
 	uint32_t completed_size; /* data length, or descriptors for batch */
 
 	rte_iova_t fault_address;
-	uint32_t invalid_flags;
+	union {
+		uint32_t invalid_flags;
+		uint32_t crc_val; /* result of CRC generation */
+	};
 } __rte_aligned(32);
 
+/* completion result of compare ops */
+#define IDXD_COMP_RESULT_MISMATCH       1
+/* completion result of DIF ops, one bit per tag mismatching */
+#define IDXD_DIF_STATUS_GUARD           (1 << 0)
+#define IDXD_DIF_STATUS_APP_TAG         (1 << 1)
+#define IDXD_DIF_STATUS_REF_TAG         (1 << 2)
+
 /*** Definitions for Intel(R) Data Streaming Accelerator  ***/
 
 #define IDXD_CMD_SHIFT 20
@@ -40,7 +40,27 @@ struct idxd_pci_common {
 	volatile void *portals;
 };
 
-struct idxd_dmadev {
+enum idxd_result_type {
+	IDXD_RESULT_NONE = 0,
+	IDXD_RESULT_CRC,
+	IDXD_RESULT_COMPARE,
+	IDXD_RESULT_DIF,
+};
+
+/* where to copy the result of an op, taken from its completion record */
+struct idxd_op_result {
+	uint32_t *dst;
+	const struct idxd_completion *comp;
+	uint8_t type;
+};
+
+/* vchans of a device share its WQ portal */
+#define IDXD_MAX_VCHANS 16
+
+/* attempts at submitting to a full shared WQ before giving up */
+#define IDXD_ENQCMD_MAX_RETRIES 64
+
+struct idxd_vchan {
 	struct idxd_hw_desc *desc_ring;
 
 	/* counters to track the batches */
@@ -56,19 +76,46 @@ struct idxd_dmadev {
 	unsigned short batch_size;
 
 	void *portal; /* address to write the batch descriptor */
+	uint8_t shared_wq; /* submit with ENQCMD rather than MOVDIR64B */
+
+	/* completion interrupt, requested for batches while armed */
+	uint32_t intr_flags;
+	uint16_t intr_handle;
+	uint8_t drain_pending; /* drain desc submitted, using the reserved WQ slot */
+	struct idxd_completion drain_comp;
+	rte_iova_t drain_iova;
 
 	struct idxd_completion *batch_comp_ring;
 	unsigned short *batch_idx_ring; /* store where each batch ends */
 
+	struct idxd_op_result *results; /* indexed by job id, like desc ring */
+	unsigned short nb_results; /* ops whose results are not copied yet */
+
 	struct rte_dma_stats stats;
+	uint64_t enq_busy; /* submissions refused by a full shared WQ */
 
 	rte_iova_t batch_iova; /* base address of the batch comp ring */
 	rte_iova_t desc_iova; /* base address of desc ring, needed for completions */
 
 	unsigned short max_batch_size;
 
-	struct rte_dma_dev *dmadev;
 	struct rte_dma_vchan_conf qcfg;
+} __rte_cache_aligned;
+
+struct idxd_dmadev {
+	struct idxd_vchan vchans[IDXD_MAX_VCHANS];
+	uint16_t nb_vchans;
+
+	void *portal; /* address to write descriptors, for all vchans */
+	uint8_t shared_wq; /* WQ accepts descriptors from several submitters */
+
+	unsigned short max_batches; /* slots in the WQ */
+	unsigned short max_batch_size;
+
+	int intr_fd; /* eventfd of the WQ completion interrupt, -1 if none */
+	uint16_t intr_handle; /* MSI-X vector of the WQ completion interrupt */
+
+	struct rte_dma_dev *dmadev;
 	uint8_t sva_support;
 	uint8_t qid;
 
@@ -88,16 +135,29 @@ int idxd_configure(struct rte_dma_dev *dev, const struct rte_dma_conf *dev_conf,
 		uint32_t conf_sz);
 int idxd_vchan_setup(struct rte_dma_dev *dev, uint16_t vchan,
 		const struct rte_dma_vchan_conf *qconf, uint32_t qconf_sz);
+void idxd_vchans_free(struct idxd_dmadev *idxd);
 int idxd_info_get(const struct rte_dma_dev *dev, struct rte_dma_info *dev_info,
 		uint32_t size);
 int idxd_enqueue_copy(void *dev_private, uint16_t qid, rte_iova_t src,
 		rte_iova_t dst, unsigned int length, uint64_t flags);
 int idxd_enqueue_fill(void *dev_private, uint16_t qid, uint64_t pattern,
 		rte_iova_t dst, unsigned int length, uint64_t flags);
+int idxd_enqueue_crc32c(void *dev_private, uint16_t qid, rte_iova_t src,
+		uint32_t length, uint32_t seed, uint32_t *crc, uint64_t flags);
+int idxd_enqueue_compare(void *dev_private, uint16_t qid, rte_iova_t src1,
+		rte_iova_t src2, uint32_t length, uint32_t *result, uint64_t flags);
+int idxd_enqueue_compare_pattern(void *dev_private, uint16_t qid,
+		uint64_t pattern, rte_iova_t src, uint32_t length, uint32_t *result,
+		uint64_t flags);
+int idxd_enqueue_dualcast(void *dev_private, uint16_t qid, rte_iova_t src,
+		rte_iova_t dst1, rte_iova_t dst2, uint32_t length, uint64_t flags);
+int idxd_enqueue_dif(void *dev_private, uint16_t qid, enum rte_dma_dif_op op,
+		rte_iova_t src, rte_iova_t dst, uint32_t length,
+		const struct rte_dma_dif_conf *conf, uint32_t *result, uint64_t flags);
 int idxd_submit(void *dev_private, uint16_t qid);
 uint16_t idxd_completed(void *dev_private, uint16_t qid, uint16_t max_ops,
 		uint16_t *last_idx, bool *has_error);
-uint16_t idxd_completed_status(void *dev_private, uint16_t qid __rte_unused,
+uint16_t idxd_completed_status(void *dev_private, uint16_t qid,
 		uint16_t max_ops, uint16_t *last_idx,
 		enum rte_dma_status_code *status);
 int idxd_stats_get(const struct rte_dma_dev *dev, uint16_t vchan,
@@ -106,5 +166,8 @@ int idxd_stats_reset(struct rte_dma_dev *dev, uint16_t vchan);
 int idxd_vchan_status(const struct rte_dma_dev *dev, uint16_t vchan,
 		enum rte_dma_vchan_status *status);
 uint16_t idxd_burst_capacity(const void *dev_private, uint16_t vchan);
+int idxd_intr_fd_get(const struct rte_dma_dev *dev, uint16_t vchan);
+int idxd_intr_enable(struct rte_dma_dev *dev, uint16_t vchan);
+int idxd_intr_disable(struct rte_dma_dev *dev, uint16_t vchan);
 
 #endif /* _IDXD_INTERNAL_H_ */
@@ -88,15 +88,18 @@ idxd_pci_dev_start(struct rte_dma_dev *dev)
 {
 	struct idxd_dmadev *idxd = dev->fp_obj->dev_private;
 	uint8_t err_code;
+	uint16_t i;
 
 	if (idxd_is_wq_enabled(idxd)) {
 		IDXD_PMD_WARN("WQ %d already enabled", idxd->qid);
 		return 0;
 	}
 
-	if (idxd->desc_ring == NULL) {
-		IDXD_PMD_ERR("WQ %d has not been fully configured", idxd->qid);
-		return -EINVAL;
+	for (i = 0; i < idxd->nb_vchans; i++) {
+		if (idxd->vchans[i].desc_ring == NULL) {
+			IDXD_PMD_ERR("WQ %d has not been fully configured", idxd->qid);
+			return -EINVAL;
+		}
 	}
 
 	err_code = idxd_pci_dev_command(idxd, idxd_enable_wq);
@@ -129,8 +132,7 @@ idxd_pci_dev_close(struct rte_dma_dev *dev)
 
 	/* free device memory */
 	IDXD_PMD_DEBUG("Freeing device driver memory");
-	rte_free(idxd->batch_comp_ring);
-	rte_free(idxd->desc_ring);
+	idxd_vchans_free(idxd);
 
 	/* if this is the last WQ on the device, disable the device and free
 	 * the PCI struct
@@ -145,6 +147,12 @@ idxd_pci_dev_close(struct rte_dma_dev *dev)
 			return err_code;
 		}
 		IDXD_PMD_DEBUG("IDXD device disabled OK");
+		if (idxd->intr_fd >= 0) {
+			struct rte_pci_device *pci_dev = RTE_DEV_TO_PCI(dev->device);
+
+			rte_intr_disable(pci_dev->intr_handle);
+			rte_intr_efd_disable(pci_dev->intr_handle);
+		}
 		rte_free(idxd->u.pci);
 	}
 
@@ -162,6 +170,9 @@ static const struct rte_dma_dev_ops idxd_pci_ops = {
 	.dev_start = idxd_pci_dev_start,
 	.dev_stop = idxd_pci_dev_stop,
 	.vchan_status = idxd_vchan_status,
+	.intr_fd_get = idxd_intr_fd_get,
+	.intr_enable = idxd_intr_enable,
+	.intr_disable = idxd_intr_disable,
 };
 
 /* each portal uses 4 x 4k pages */
@@ -304,12 +315,35 @@ init_pci_device(struct rte_pci_device *dev, struct idxd_dmadev *idxd,
 	return err_code;
 }
 
+/* Completion interrupts of WQ n go to MSI-X vector n + 1, vector 0 being
+ * for device errors. This needs VFIO to route the vectors to eventfds.
+ * Returns the number of WQs with an interrupt.
+ */
+static int
+idxd_pci_intr_init(struct rte_pci_device *dev, uint8_t nb_wqs)
+{
+	if (rte_intr_type_get(dev->intr_handle) != RTE_INTR_HANDLE_VFIO_MSIX)
+		return 0;
+
+	if (rte_intr_efd_enable(dev->intr_handle, nb_wqs) != 0) {
+		IDXD_PMD_WARN("Cannot create completion eventfds, interrupts disabled");
+		return 0;
+	}
+	if (rte_intr_enable(dev->intr_handle) != 0) {
+		IDXD_PMD_WARN("Cannot enable MSI-X, interrupts disabled");
+		rte_intr_efd_disable(dev->intr_handle);
+		return 0;
+	}
+
+	return rte_intr_nb_efd_get(dev->intr_handle);
+}
+
 static int
 idxd_dmadev_probe_pci(struct rte_pci_driver *drv, struct rte_pci_device *dev)
 {
 	struct idxd_dmadev idxd = {0};
 	uint8_t nb_wqs;
-	int qid, ret = 0;
+	int qid, nb_intr, ret = 0;
 	char name[PCI_PRI_STR_SIZE];
 	unsigned int max_queues = 0;
 
@@ -369,6 +403,7 @@ idxd_dmadev_probe_pci(struct rte_pci_driver *drv, struct rte_pci_device *dev)
 		return -EINVAL;
 	}
 	nb_wqs = (uint8_t)ret;
+	nb_intr = idxd_pci_intr_init(dev, nb_wqs);
 
 	/* set up one device for each queue */
 	for (qid = 0; qid < nb_wqs; qid++) {
@@ -377,6 +412,9 @@ idxd_dmadev_probe_pci(struct rte_pci_driver *drv, struct rte_pci_device *dev)
 		/* add the queue number to each device name */
 		snprintf(qname, sizeof(qname), "%s-q%d", name, qid);
 		idxd.qid = qid;
+		idxd.intr_fd = qid < nb_intr ?
+				rte_intr_efds_index_get(dev->intr_handle, qid) : -1;
+		idxd.intr_handle = RTE_INTR_VEC_RXTX_OFFSET + qid;
 		idxd.portal = RTE_PTR_ADD(idxd.u.pci->portals,
 				qid * IDXD_PORTAL_SIZE);
 		if (idxd_is_wq_enabled(&idxd))
@@ -2,19 +2,29 @@
  * Copyright(c) 2021-2024 HiSilicon Limited
  */
 
+#include <errno.h>
 #include <inttypes.h>
 #include <stdlib.h>
 
 #include <pthread.h>
+#ifndef RTE_EXEC_ENV_WINDOWS
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
 
 #include <bus_vdev_driver.h>
+#include <rte_cpuflags.h>
 #include <rte_cycles.h>
 #include <rte_eal.h>
+#include <rte_byteorder.h>
+#include <rte_hash_crc.h>
 #include <rte_kvargs.h>
 #include <rte_lcore.h>
 #include <rte_log.h>
 #include <rte_malloc.h>
 #include <rte_memcpy.h>
+#include <rte_pause.h>
+#include <rte_vect.h>
 
 #include <rte_dmadev_pmd.h>
 
@@ -39,8 +49,15 @@ skeldma_info_get(const struct rte_dma_dev *dev, struct rte_dma_info *dev_info,
 			     RTE_DMA_CAPA_SVA |
 			     RTE_DMA_CAPA_OPS_COPY |
 			     RTE_DMA_CAPA_OPS_COPY_SG |
-			     RTE_DMA_CAPA_OPS_FILL;
-	dev_info->max_vchans = 1;
+			     RTE_DMA_CAPA_OPS_FILL |
+			     RTE_DMA_CAPA_OPS_CRC32C |
+			     RTE_DMA_CAPA_OPS_COMPARE |
+			     RTE_DMA_CAPA_OPS_DUALCAST |
+			     RTE_DMA_CAPA_OPS_DIF;
+#ifndef RTE_EXEC_ENV_WINDOWS
+	dev_info->dev_capa |= RTE_DMA_CAPA_INTR;
+#endif
+	dev_info->max_vchans = SKELDMA_MAX_VCHANS;
 	dev_info->max_desc = SKELDMA_MAX_DESC;
 	dev_info->min_desc = SKELDMA_MIN_DESC;
 	dev_info->max_sges = SKELDMA_MAX_SGES;
@@ -48,13 +65,22 @@ skeldma_info_get(const struct rte_dma_dev *dev, struct rte_dma_info *dev_info,
 	return 0;
 }
 
+static void vchan_release(struct skeldma_hw *hw, uint16_t vchan);
+
 static int
 skeldma_configure(struct rte_dma_dev *dev, const struct rte_dma_conf *conf,
 		  uint32_t conf_sz)
 {
-	RTE_SET_USED(dev);
-	RTE_SET_USED(conf);
+	struct skeldma_hw *hw = dev->data->dev_private;
+	uint16_t i;
+
 	RTE_SET_USED(conf_sz);
+
+	/* Release the vchans which are no more used. */
+	for (i = conf->nb_vchans; i < SKELDMA_MAX_VCHANS; i++)
+		vchan_release(hw, i);
+	hw->nb_vchans = conf->nb_vchans;
+
 	return 0;
 }
 
@@ -112,50 +138,349 @@ do_fill(struct skeldma_desc *desc)
 		dst[i] = fills[i % 8];
 }
 
+static inline void
+do_crc32c(struct skeldma_desc *desc)
+{
+	*desc->crc32c.crc = ~rte_hash_crc(desc->crc32c.src, desc->crc32c.len,
+					  ~desc->crc32c.seed);
+}
+
+static inline void
+do_compare_pattern(struct skeldma_desc *desc)
+{
+	uint8_t *fills = (uint8_t *)&desc->compare_pattern.pattern;
+	uint8_t *src = (uint8_t *)desc->compare_pattern.src;
+	uint32_t i;
+
+	for (i = 0; i < desc->compare_pattern.len; i++) {
+		if (src[i] != fills[i % 8]) {
+			*desc->compare_pattern.result = 1;
+			return;
+		}
+	}
+	*desc->compare_pattern.result = 0;
+}
+
+/* T10 DIF guard tag: CRC16 with polynomial 0x8BB7, no reflection */
+static uint16_t
+dif_crc16(const uint8_t *buf, uint32_t len)
+{
+	uint16_t crc = 0;
+	uint32_t i;
+	int b;
+
+	for (i = 0; i < len; i++) {
+		crc ^= (uint16_t)buf[i] << 8;
+		for (b = 0; b < 8; b++)
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x8BB7 : crc << 1;
+	}
+
+	return crc;
+}
+
+struct skeldma_dif_pi {
+	rte_be16_t guard;
+	rte_be16_t app_tag;
+	rte_be32_t ref_tag;
+} __rte_packed;
+
+static inline uint32_t
+dif_check_block(const uint8_t *data, const struct rte_dma_dif_conf *conf,
+		uint32_t ref_tag)
+{
+	const struct skeldma_dif_pi *pi = (const void *)(data + conf->block_size);
+	uint32_t err = 0;
+
+	if (!(conf->flags & RTE_DMA_DIF_F_NO_GUARD_CHECK) &&
+	    rte_be_to_cpu_16(pi->guard) != dif_crc16(data, conf->block_size))
+		err |= RTE_DMA_DIF_ERR_GUARD;
+	if ((rte_be_to_cpu_16(pi->app_tag) ^ conf->app_tag) & conf->app_tag_mask)
+		err |= RTE_DMA_DIF_ERR_APP_TAG;
+	if (!(conf->flags & RTE_DMA_DIF_F_NO_REF_CHECK) &&
+	    rte_be_to_cpu_32(pi->ref_tag) != ref_tag)
+		err |= RTE_DMA_DIF_ERR_REF_TAG;
+
+	return err;
+}
+
+static inline void
+do_dif(struct skeldma_desc *desc)
+{
+	const struct rte_dma_dif_conf *conf = &desc->dif.conf;
+	uint32_t blk_sz = conf->block_size;
+	uint32_t ref_tag = conf->ref_tag;
+	uint8_t *src = desc->dif.src;
+	uint8_t *dst = desc->dif.dst;
+	struct skeldma_dif_pi *pi;
+	uint32_t err = 0;
+	uint32_t off;
+
+	if (desc->dif.op == RTE_DMA_DIF_OP_INSERT) {
+		for (off = 0; off + blk_sz <= desc->dif.len; off += blk_sz) {
+			rte_memcpy(dst, src + off, blk_sz);
+			pi = (void *)(dst + blk_sz);
+			pi->guard = rte_cpu_to_be_16(dif_crc16(src + off, blk_sz));
+			pi->app_tag = rte_cpu_to_be_16(conf->app_tag);
+			pi->ref_tag = rte_cpu_to_be_32(ref_tag);
+			dst += blk_sz + RTE_DMA_DIF_SIZE;
+			if (!(conf->flags & RTE_DMA_DIF_F_REF_FIXED))
+				ref_tag++;
+		}
+	} else {
+		/* stop on the first block in error, like hardware does */
+		for (off = 0; off + blk_sz + RTE_DMA_DIF_SIZE <= desc->dif.len;
+		     off += blk_sz + RTE_DMA_DIF_SIZE) {
+			err = dif_check_block(src + off, conf, ref_tag);
+			if (err != 0)
+				break;
+			if (desc->dif.op == RTE_DMA_DIF_OP_STRIP) {
+				rte_memcpy(dst, src + off, blk_sz);
+				dst += blk_sz;
+			}
+			if (!(conf->flags & RTE_DMA_DIF_F_REF_FIXED))
+				ref_tag++;
+		}
+	}
+
+	if (desc->dif.result != NULL)
+		*desc->dif.result = err;
+}
+
+static inline void
+do_copy(struct skeldma_hw *hw, struct skeldma_desc *desc)
+{
+	if (desc->copy.len >= SKELDMA_NT_COPY_MIN && hw->copy_nt != NULL)
+		hw->copy_nt(desc->copy.dst, desc->copy.src, desc->copy.len);
+	else
+		rte_memcpy(desc->copy.dst, desc->copy.src, desc->copy.len);
+}
+
+static inline void
+do_desc(struct skeldma_hw *hw, struct skeldma_desc *desc)
+{
+	switch (desc->op) {
+	case SKELDMA_OP_COPY:
+		do_copy(hw, desc);
+		break;
+	case SKELDMA_OP_COPY_SG:
+		do_copy_sg(desc);
+		break;
+	case SKELDMA_OP_FILL:
+		do_fill(desc);
+		break;
+	case SKELDMA_OP_CRC32C:
+		do_crc32c(desc);
+		break;
+	case SKELDMA_OP_COMPARE:
+		*desc->compare.result = memcmp(desc->compare.src1,
+				desc->compare.src2, desc->compare.len) != 0;
+		break;
+	case SKELDMA_OP_COMPARE_PATTERN:
+		do_compare_pattern(desc);
+		break;
+	case SKELDMA_OP_DUALCAST:
+		rte_memcpy(desc->dualcast.dst1, desc->dualcast.src,
+			   desc->dualcast.len);
+		rte_memcpy(desc->dualcast.dst2, desc->dualcast.src,
+			   desc->dualcast.len);
+		break;
+	case SKELDMA_OP_DIF:
+		do_dif(desc);
+		break;
+	}
+}
+
+#ifndef RTE_EXEC_ENV_WINDOWS
+static int
+vchan_intr_init(struct skeldma_vchan *vc)
+{
+	vc->intr_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	return vc->intr_fd < 0 ? -errno : 0;
+}
+
+static void
+vchan_intr_fini(struct skeldma_vchan *vc)
+{
+	if (vc->intr_fd >= 0)
+		close(vc->intr_fd);
+}
+
+static void
+vchan_notify(struct skeldma_vchan *vc)
+{
+	uint64_t val = 1;
+
+	/* Fails only if the counter would overflow, it is readable anyway. */
+	if (write(vc->intr_fd, &val, sizeof(val)) < 0)
+		SKELDMA_LOG(DEBUG, "Write to completion fd fail!");
+}
+#else
+static int
+vchan_intr_init(struct skeldma_vchan *vc)
+{
+	vc->intr_fd = -1;
+	return 0;
+}
+
+static void
+vchan_intr_fini(struct skeldma_vchan *vc)
+{
+	RTE_SET_USED(vc);
+}
+
+static void
+vchan_notify(struct skeldma_vchan *vc)
+{
+	RTE_SET_USED(vc);
+}
+#endif
+
+/*
+ * Move the done index over the descriptors flagged done in ring order,
+ * returns true if it moved.
+ */
+static bool
+vchan_done_advance(struct skeldma_vchan *vc)
+{
+	uint64_t done, pos, submitted;
+
+	/* Pairs with the flagging of the other workers, so that at least
+	 * one of two workers finishing concurrently sees both bursts done.
+	 */
+	rte_atomic_thread_fence(rte_memory_order_seq_cst);
+
+	done = rte_atomic_load_explicit(&vc->done, rte_memory_order_relaxed);
+	do {
+		/* Descriptors from submitted on may hold flags of the
+		 * previous lap.
+		 */
+		submitted = rte_atomic_load_explicit(&vc->submitted,
+				rte_memory_order_acquire);
+		pos = done;
+		while (pos != submitted &&
+		       rte_atomic_load_explicit(&vc->desc[pos & vc->mask].done,
+				rte_memory_order_acquire))
+			pos++;
+		if (pos == done)
+			return false;
+	} while (!rte_atomic_compare_exchange_weak_explicit(&vc->done,
+			&done, pos, rte_memory_order_seq_cst,
+			rte_memory_order_relaxed));
+
+	return true;
+}
+
+/* Take a burst of submitted descriptors of a vchan and process them. */
+static uint16_t
+vchan_work(struct skeldma_hw *hw, struct skeldma_vchan *vc)
+{
+	struct skeldma_desc *desc;
+	uint64_t claimed, avail;
+	uint16_t nb, i;
+
+	claimed = rte_atomic_load_explicit(&vc->claimed, rte_memory_order_relaxed);
+	do {
+		avail = rte_atomic_load_explicit(&vc->submitted,
+				rte_memory_order_acquire) - claimed;
+		if (avail == 0)
+			return 0;
+		nb = RTE_MIN(avail, (uint64_t)SKELDMA_WORKER_BURST);
+		/* A fenced descriptor starts a new burst. */
+		for (i = 1; i < nb; i++) {
+			if (vc->desc[(claimed + i) & vc->mask].fence) {
+				nb = i;
+				break;
+			}
+		}
+	} while (!rte_atomic_compare_exchange_weak_explicit(&vc->claimed,
+			&claimed, claimed + nb, rte_memory_order_relaxed,
+			rte_memory_order_relaxed));
+
+	/* Previous descriptors were all taken, possibly by other workers,
+	 * wait for all of them to be done, in ring order.
+	 */
+	if (vc->desc[claimed & vc->mask].fence) {
+		while (rte_atomic_load_explicit(&vc->done,
+				rte_memory_order_acquire) < claimed) {
+			if (hw->exit_flag)
+				return 0;
+			rte_pause();
+		}
+	}
+
+	for (i = 0; i < nb; i++) {
+		desc = &vc->desc[(claimed + i) & vc->mask];
+		do_desc(hw, desc);
+		rte_atomic_store_explicit(&desc->done, 1,
+				rte_memory_order_release);
+	}
+	/* Sequentially consistent with the arming in skeldma_intr_enable(),
+	 * so that either the application sees these descriptors done, or the
+	 * worker moving the done index over them sees the vchan armed.
+	 */
+	if (vchan_done_advance(vc) &&
+	    rte_atomic_load_explicit(&vc->intr_armed, rte_memory_order_seq_cst))
+		vchan_notify(vc);
+
+	return nb;
+}
+
 static uint32_t
 cpuwork_thread(void *param)
 {
 #define SLEEP_THRESHOLD		10000
 #define SLEEP_US_VAL		10
 
-	struct rte_dma_dev *dev = param;
-	struct skeldma_hw *hw = dev->data->dev_private;
-	struct skeldma_desc *desc = NULL;
-	int ret;
+	struct skeldma_worker *worker = param;
+	struct skeldma_hw *hw = worker->dev->data->dev_private;
+	uint16_t nb_vchans = hw->nb_vchans;
+	uint16_t i, vchan, nb;
 
 	while (!hw->exit_flag) {
-		ret = rte_ring_dequeue(hw->desc_running, (void **)&desc);
-		if (ret) {
-			hw->zero_req_count++;
-			if (hw->zero_req_count == 0)
-				hw->zero_req_count = SLEEP_THRESHOLD;
-			if (hw->zero_req_count >= SLEEP_THRESHOLD)
+		/* Workers start from different vchans to spread the load. */
+		nb = 0;
+		for (i = 0; i < nb_vchans; i++) {
+			vchan = (worker->id + i) % nb_vchans;
+			nb += vchan_work(hw, hw->vchans[vchan]);
+		}
+		if (nb == 0) {
+			worker->zero_req_count++;
+			if (worker->zero_req_count == 0)
+				worker->zero_req_count = SLEEP_THRESHOLD;
+			if (worker->zero_req_count >= SLEEP_THRESHOLD)
 				rte_delay_us_sleep(SLEEP_US_VAL);
 			continue;
 		}
-		hw->zero_req_count = 0;
-
-		if (desc->op == SKELDMA_OP_COPY)
-			rte_memcpy(desc->copy.dst, desc->copy.src, desc->copy.len);
-		else if (desc->op == SKELDMA_OP_COPY_SG)
-			do_copy_sg(desc);
-		else if (desc->op == SKELDMA_OP_FILL)
-			do_fill(desc);
-
-		__atomic_fetch_add(&hw->completed_count, 1, __ATOMIC_RELEASE);
-		(void)rte_ring_enqueue(hw->desc_completed, (void *)desc);
+		worker->zero_req_count = 0;
 	}
 
 	return 0;
 }
 
 static void
-fflush_ring(struct skeldma_hw *hw, struct rte_ring *ring)
+vchan_reset(struct skeldma_vchan *vc)
 {
-	struct skeldma_desc *desc = NULL;
-	while (rte_ring_count(ring) > 0) {
-		(void)rte_ring_dequeue(ring, (void **)&desc);
-		(void)rte_ring_enqueue(hw->desc_empty, (void *)desc);
+	vc->head = 0;
+	vc->tail = 0;
+	vc->submitted_count = 0;
+	vc->completed_count = 0;
+	rte_atomic_store_explicit(&vc->submitted, 0, rte_memory_order_relaxed);
+	rte_atomic_store_explicit(&vc->claimed, 0, rte_memory_order_relaxed);
+	rte_atomic_store_explicit(&vc->done, 0, rte_memory_order_relaxed);
+	rte_atomic_store_explicit(&vc->intr_armed, 0, rte_memory_order_relaxed);
+}
+
+static void
+workers_stop(struct skeldma_hw *hw, uint16_t nb_workers)
+{
+	uint16_t i;
+
+	hw->exit_flag = true;
+	rte_delay_ms(1);
+
+	for (i = 0; i < nb_workers; i++) {
+		(void)pthread_cancel((pthread_t)hw->workers[i].thread.opaque_id);
+		rte_thread_join(hw->workers[i].thread, NULL);
 	}
 }
 
@@ -164,43 +489,52 @@ skeldma_start(struct rte_dma_dev *dev)
 {
 	struct skeldma_hw *hw = dev->data->dev_private;
 	char name[RTE_THREAD_INTERNAL_NAME_SIZE];
+	struct skeldma_worker *worker;
 	rte_cpuset_t cpuset;
+	uint16_t i;
 	int ret;
 
-	if (hw->desc_mem == NULL) {
-		SKELDMA_LOG(ERR, "Vchan was not setup, start fail!");
-		return -EINVAL;
+	for (i = 0; i < hw->nb_vchans; i++) {
+		if (hw->vchans[i] == NULL) {
+			SKELDMA_LOG(ERR, "Vchan %u was not setup, start fail!", i);
+			return -EINVAL;
+		}
 	}
 
 	/* Reset the dmadev to a known state, include:
-	 * 1) fflush pending/running/completed ring to empty ring.
-	 * 2) init ring idx to zero.
-	 * 3) init running statistics.
-	 * 4) mark cpuwork task exit_flag to false.
+	 * 1) init ring idx and running statistics of vchans to zero.
+	 * 2) mark cpuwork task exit_flag to false.
 	 */
-	fflush_ring(hw, hw->desc_pending);
-	fflush_ring(hw, hw->desc_running);
-	fflush_ring(hw, hw->desc_completed);
-	hw->ridx = 0;
-	hw->last_ridx = hw->ridx - 1;
-	hw->submitted_count = 0;
-	hw->zero_req_count = 0;
-	hw->completed_count = 0;
+	for (i = 0; i < hw->nb_vchans; i++)
+		vchan_reset(hw->vchans[i]);
 	hw->exit_flag = false;
 
 	rte_mb();
 
-	snprintf(name, sizeof(name), "dma-skel%d", dev->data->dev_id);
-	ret = rte_thread_create_internal_control(&hw->thread, name,
-			cpuwork_thread, dev);
-	if (ret) {
-		SKELDMA_LOG(ERR, "Start cpuwork thread fail!");
-		return -EINVAL;
+	for (i = 0; i < hw->nb_workers; i++) {
+		worker = &hw->workers[i];
+		worker->dev = dev;
+		worker->id = i;
+		worker->zero_req_count = 0;
+		if (hw->nb_workers == 1)
+			snprintf(name, sizeof(name), "dma-skel%d",
+				 dev->data->dev_id);
+		else
+			snprintf(name, sizeof(name), "dma-sk%d-%u",
+				 dev->data->dev_id, i);
+		ret = rte_thread_create_internal_control(&worker->thread, name,
+				cpuwork_thread, worker);
+		if (ret) {
+			SKELDMA_LOG(ERR, "Start cpuwork thread fail!");
+			workers_stop(hw, i);
+			return -EINVAL;
+		}
 	}
 
 	if (hw->lcore_id != -1) {
 		cpuset = rte_lcore_cpuset(hw->lcore_id);
-		ret = rte_thread_set_affinity_by_id(hw->thread, &cpuset);
+		ret = rte_thread_set_affinity_by_id(hw->workers[0].thread,
+						    &cpuset);
 		if (ret)
 			SKELDMA_LOG(WARNING,
 				"Set thread affinity lcore = %d fail!",
@@ -215,95 +549,65 @@ skeldma_stop(struct rte_dma_dev *dev)
 {
 	struct skeldma_hw *hw = dev->data->dev_private;
 
-	hw->exit_flag = true;
-	rte_delay_ms(1);
-
-	(void)pthread_cancel((pthread_t)hw->thread.opaque_id);
-	rte_thread_join(hw->thread, NULL);
+	workers_stop(hw, hw->nb_workers);
 
 	return 0;
 }
 
 static int
-vchan_setup(struct skeldma_hw *hw, int16_t dev_id, uint16_t nb_desc)
+vchan_setup(struct skeldma_hw *hw, uint16_t vchan, uint16_t nb_desc)
 {
-	char name[RTE_RING_NAMESIZE];
+	struct skeldma_vchan *vc;
 	struct skeldma_desc *desc;
-	struct rte_ring *empty;
-	struct rte_ring *pending;
-	struct rte_ring *running;
-	struct rte_ring *completed;
-	uint16_t i;
+	int ret;
 
+	vc = rte_zmalloc_socket(NULL, sizeof(*vc), RTE_CACHE_LINE_SIZE,
+				hw->socket_id);
 	desc = rte_zmalloc_socket(NULL, nb_desc * sizeof(struct skeldma_desc),
 				  RTE_CACHE_LINE_SIZE, hw->socket_id);
-	if (desc == NULL) {
+	if (vc == NULL || desc == NULL) {
 		SKELDMA_LOG(ERR, "Malloc dma skeleton desc fail!");
+		rte_free(vc);
+		rte_free(desc);
 		return -ENOMEM;
 	}
 
-	snprintf(name, RTE_RING_NAMESIZE, "dma_skel_desc_empty_%d", dev_id);
-	empty = rte_ring_create(name, nb_desc, hw->socket_id,
-				RING_F_SP_ENQ | RING_F_SC_DEQ);
-	snprintf(name, RTE_RING_NAMESIZE, "dma_skel_desc_pend_%d", dev_id);
-	pending = rte_ring_create(name, nb_desc, hw->socket_id,
-				  RING_F_SP_ENQ | RING_F_SC_DEQ);
-	snprintf(name, RTE_RING_NAMESIZE, "dma_skel_desc_run_%d", dev_id);
-	running = rte_ring_create(name, nb_desc, hw->socket_id,
-				  RING_F_SP_ENQ | RING_F_SC_DEQ);
-	snprintf(name, RTE_RING_NAMESIZE, "dma_skel_desc_comp_%d", dev_id);
-	completed = rte_ring_create(name, nb_desc, hw->socket_id,
-				    RING_F_SP_ENQ | RING_F_SC_DEQ);
-	if (empty == NULL || pending == NULL || running == NULL ||
-	    completed == NULL) {
-		SKELDMA_LOG(ERR, "Create dma skeleton desc ring fail!");
-		rte_ring_free(empty);
-		rte_ring_free(pending);
-		rte_ring_free(running);
-		rte_ring_free(completed);
+	ret = vchan_intr_init(vc);
+	if (ret != 0) {
+		SKELDMA_LOG(ERR, "Create dma skeleton completion fd fail!");
+		rte_free(vc);
 		rte_free(desc);
-		return -ENOMEM;
+		return ret;
 	}
 
-	/* The real usable ring size is *count-1* instead of *count* to
-	 * differentiate a free ring from an empty ring.
-	 * @see rte_ring_create
-	 */
-	for (i = 0; i < nb_desc - 1; i++)
-		(void)rte_ring_enqueue(empty, (void *)(desc + i));
-
-	hw->desc_mem = desc;
-	hw->desc_empty = empty;
-	hw->desc_pending = pending;
-	hw->desc_running = running;
-	hw->desc_completed = completed;
+	vc->desc = desc;
+	vc->nb_desc = nb_desc;
+	vc->mask = nb_desc - 1;
+	hw->vchans[vchan] = vc;
 
 	return 0;
 }
 
 static void
-vchan_release(struct skeldma_hw *hw)
+vchan_release(struct skeldma_hw *hw, uint16_t vchan)
 {
-	if (hw->desc_mem == NULL)
+	if (hw->vchans[vchan] == NULL)
 		return;
 
-	rte_free(hw->desc_mem);
-	hw->desc_mem = NULL;
-	rte_ring_free(hw->desc_empty);
-	hw->desc_empty = NULL;
-	rte_ring_free(hw->desc_pending);
-	hw->desc_pending = NULL;
-	rte_ring_free(hw->desc_running);
-	hw->desc_running = NULL;
-	rte_ring_free(hw->desc_completed);
-	hw->desc_completed = NULL;
+	vchan_intr_fini(hw->vchans[vchan]);
+	rte_free(hw->vchans[vchan]->desc);
+	rte_free(hw->vchans[vchan]);
+	hw->vchans[vchan] = NULL;
 }
 
 static int
 skeldma_close(struct rte_dma_dev *dev)
 {
+	uint16_t i;
+
 	/* The device already stopped */
-	vchan_release(dev->data->dev_private);
+	for (i = 0; i < SKELDMA_MAX_VCHANS; i++)
+		vchan_release(dev->data->dev_private, i);
 	return 0;
 }
 
@@ -314,7 +618,6 @@ skeldma_vchan_setup(struct rte_dma_dev *dev, uint16_t vchan,
 {
 	struct skeldma_hw *hw = dev->data->dev_private;
 
-	RTE_SET_USED(vchan);
 	RTE_SET_USED(conf_sz);
 
 	if (!rte_is_power_of_2(conf->nb_desc)) {
@@ -322,8 +625,8 @@ skeldma_vchan_setup(struct rte_dma_dev *dev, uint16_t vchan,
 		return -EINVAL;
 	}
 
-	vchan_release(hw);
-	return vchan_setup(hw, dev->data->dev_id, conf->nb_desc);
+	vchan_release(hw, vchan);
+	return vchan_setup(hw, vchan, conf->nb_desc);
 }
 
 static int
@@ -331,28 +634,42 @@ skeldma_vchan_status(const struct rte_dma_dev *dev,
 		uint16_t vchan, enum rte_dma_vchan_status *status)
 {
 	struct skeldma_hw *hw = dev->data->dev_private;
-
-	RTE_SET_USED(vchan);
+	struct skeldma_vchan *vc = hw->vchans[vchan];
 
 	*status = RTE_DMA_VCHAN_IDLE;
-	if (hw->submitted_count != __atomic_load_n(&hw->completed_count, __ATOMIC_ACQUIRE)
-			|| hw->zero_req_count == 0)
+	if (vc != NULL &&
+	    rte_atomic_load_explicit(&vc->submitted, rte_memory_order_relaxed) !=
+	    rte_atomic_load_explicit(&vc->done, rte_memory_order_acquire))
 		*status = RTE_DMA_VCHAN_ACTIVE;
 	return 0;
 }
 
+static void
+vchan_stats_add(const struct skeldma_vchan *vc, struct rte_dma_stats *stats)
+{
+	stats->submitted += vc->submitted_count;
+	stats->completed += vc->completed_count;
+}
+
 static int
 skeldma_stats_get(const struct rte_dma_dev *dev, uint16_t vchan,
 		  struct rte_dma_stats *stats, uint32_t stats_sz)
 {
 	struct skeldma_hw *hw = dev->data->dev_private;
+	uint16_t i;
 
-	RTE_SET_USED(vchan);
 	RTE_SET_USED(stats_sz);
 
-	stats->submitted = hw->submitted_count;
-	stats->completed = hw->completed_count;
-	stats->errors = 0;
+	*stats = (struct rte_dma_stats){0};
+	if (vchan != RTE_DMA_ALL_VCHAN) {
+		if (hw->vchans[vchan] != NULL)
+			vchan_stats_add(hw->vchans[vchan], stats);
+		return 0;
+	}
+	for (i = 0; i < hw->nb_vchans; i++) {
+		if (hw->vchans[i] != NULL)
+			vchan_stats_add(hw->vchans[i], stats);
+	}
 
 	return 0;
 }
@@ -361,59 +678,142 @@ static int
 skeldma_stats_reset(struct rte_dma_dev *dev, uint16_t vchan)
 {
 	struct skeldma_hw *hw = dev->data->dev_private;
+	uint16_t i;
 
-	RTE_SET_USED(vchan);
+	for (i = 0; i < hw->nb_vchans; i++) {
+		if (hw->vchans[i] == NULL ||
+		    (vchan != RTE_DMA_ALL_VCHAN && vchan != i))
+			continue;
+		hw->vchans[i]->submitted_count = 0;
+		hw->vchans[i]->completed_count = 0;
+	}
+
+	return 0;
+}
+
+static int
+skeldma_intr_fd_get(const struct rte_dma_dev *dev, uint16_t vchan)
+{
+	struct skeldma_hw *hw = dev->data->dev_private;
+	struct skeldma_vchan *vc = hw->vchans[vchan];
+
+	if (vc == NULL)
+		return -EINVAL;
+	if (vc->intr_fd < 0)
+		return -ENOTSUP;
+	return vc->intr_fd;
+}
+
+static int
+skeldma_intr_enable(struct rte_dma_dev *dev, uint16_t vchan)
+{
+	struct skeldma_hw *hw = dev->data->dev_private;
+	struct skeldma_vchan *vc = hw->vchans[vchan];
+
+	if (vc == NULL)
+		return -EINVAL;
+	if (vc->intr_fd < 0)
+		return -ENOTSUP;
 
-	hw->submitted_count = 0;
-	hw->completed_count = 0;
+	/* Descriptors done before arming are not signalled by the workers. */
+	rte_atomic_store_explicit(&vc->intr_armed, 1, rte_memory_order_seq_cst);
+	if (rte_atomic_load_explicit(&vc->done, rte_memory_order_seq_cst) != vc->tail)
+		vchan_notify(vc);
 
 	return 0;
 }
 
 static int
-skeldma_dump(const struct rte_dma_dev *dev, FILE *f)
+skeldma_intr_disable(struct rte_dma_dev *dev, uint16_t vchan)
 {
-#define GET_RING_COUNT(ring)	((ring) ? (rte_ring_count(ring)) : 0)
+	struct skeldma_hw *hw = dev->data->dev_private;
+	struct skeldma_vchan *vc = hw->vchans[vchan];
+
+	if (vc == NULL)
+		return -EINVAL;
+	if (vc->intr_fd < 0)
+		return -ENOTSUP;
+
+	rte_atomic_store_explicit(&vc->intr_armed, 0, rte_memory_order_relaxed);
+
+	return 0;
+}
 
+static int
+skeldma_dump(const struct rte_dma_dev *dev, FILE *f)
+{
 	struct skeldma_hw *hw = dev->data->dev_private;
+	struct skeldma_vchan *vc;
+	uint16_t i;
 
 	(void)fprintf(f,
 		"    lcore_id: %d\n"
 		"    socket_id: %d\n"
-		"    desc_empty_ring_count: %u\n"
-		"    desc_pending_ring_count: %u\n"
-		"    desc_running_ring_count: %u\n"
-		"    desc_completed_ring_count: %u\n",
-		hw->lcore_id, hw->socket_id,
-		GET_RING_COUNT(hw->desc_empty),
-		GET_RING_COUNT(hw->desc_pending),
-		GET_RING_COUNT(hw->desc_running),
-		GET_RING_COUNT(hw->desc_completed));
-	(void)fprintf(f,
-		"    next_ring_idx: %u\n"
-		"    last_ring_idx: %u\n"
-		"    submitted_count: %" PRIu64 "\n"
-		"    completed_count: %" PRIu64 "\n",
-		hw->ridx, hw->last_ridx,
-		hw->submitted_count, hw->completed_count);
+		"    nb_workers: %u\n"
+		"    nt_copy: %s\n",
+		hw->lcore_id, hw->socket_id, hw->nb_workers,
+		hw->copy_nt != NULL ? "on" : "off");
+
+	for (i = 0; i < hw->nb_vchans; i++) {
+		vc = hw->vchans[i];
+		if (vc == NULL)
+			continue;
+		(void)fprintf(f,
+			"    vchan %u:\n"
+			"      nb_desc: %u\n"
+			"      head: %" PRIu64 "\n"
+			"      submitted: %" PRIu64 "\n"
+			"      claimed: %" PRIu64 "\n"
+			"      done: %" PRIu64 "\n"
+			"      tail: %" PRIu64 "\n"
+			"      submitted_count: %" PRIu64 "\n"
+			"      completed_count: %" PRIu64 "\n",
+			i, vc->nb_desc, vc->head,
+			rte_atomic_load_explicit(&vc->submitted, rte_memory_order_relaxed),
+			rte_atomic_load_explicit(&vc->claimed, rte_memory_order_relaxed),
+			rte_atomic_load_explicit(&vc->done, rte_memory_order_relaxed),
+			vc->tail, vc->submitted_count, vc->completed_count);
+	}
 
 	return 0;
 }
 
+/* Get the descriptor at head, NULL if the ring is full. */
+static inline struct skeldma_desc *
+desc_get(struct skeldma_vchan *vc, enum skeldma_op op, uint64_t flags)
+{
+	struct skeldma_desc *desc;
+
+	/* Keep one descriptor unused, as the previous ring based design. */
+	if (vc->head - vc->tail >= vc->mask)
+		return NULL;
+
+	desc = &vc->desc[vc->head & vc->mask];
+	desc->op = op;
+	desc->fence = !!(flags & RTE_DMA_OP_FLAG_FENCE);
+	rte_atomic_store_explicit(&desc->done, 0, rte_memory_order_relaxed);
+
+	return desc;
+}
+
 static inline void
-submit(struct skeldma_hw *hw, struct skeldma_desc *desc)
+submit(struct skeldma_vchan *vc)
 {
-	uint16_t count = rte_ring_count(hw->desc_pending);
-	struct skeldma_desc *pend_desc = NULL;
+	rte_atomic_store_explicit(&vc->submitted, vc->head,
+				  rte_memory_order_release);
+}
 
-	while (count > 0) {
-		(void)rte_ring_dequeue(hw->desc_pending, (void **)&pend_desc);
-		(void)rte_ring_enqueue(hw->desc_running, (void *)pend_desc);
-		count--;
-	}
+/* Enqueue the descriptor at head, return its ring idx. */
+static inline int
+desc_put(struct skeldma_vchan *vc, uint64_t flags)
+{
+	uint16_t ridx = vc->head++;
 
-	if (desc)
-		(void)rte_ring_enqueue(hw->desc_running, (void *)desc);
+	if (flags & RTE_DMA_OP_FLAG_SUBMIT)
+		submit(vc);
+	vc->submitted_count++;
+
+	return ridx;
 }
 
 static int
@@ -422,27 +822,17 @@ skeldma_copy(void *dev_private, uint16_t vchan,
 	     uint32_t length, uint64_t flags)
 {
 	struct skeldma_hw *hw = dev_private;
+	struct skeldma_vchan *vc = hw->vchans[vchan];
 	struct skeldma_desc *desc;
-	int ret;
-
-	RTE_SET_USED(vchan);
-	RTE_SET_USED(flags);
 
-	ret = rte_ring_dequeue(hw->desc_empty, (void **)&desc);
-	if (ret)
+	desc = desc_get(vc, SKELDMA_OP_COPY, flags);
+	if (desc == NULL)
 		return -ENOSPC;
-	desc->op = SKELDMA_OP_COPY;
-	desc->ridx = hw->ridx;
 	desc->copy.src = (void *)(uintptr_t)src;
 	desc->copy.dst = (void *)(uintptr_t)dst;
 	desc->copy.len = length;
-	if (flags & RTE_DMA_OP_FLAG_SUBMIT)
-		submit(hw, desc);
-	else
-		(void)rte_ring_enqueue(hw->desc_pending, (void *)desc);
-	hw->submitted_count++;
 
-	return hw->ridx++;
+	return desc_put(vc, flags);
 }
 
 static int
@@ -453,27 +843,18 @@ skeldma_copy_sg(void *dev_private, uint16_t vchan,
 		uint64_t flags)
 {
 	struct skeldma_hw *hw = dev_private;
+	struct skeldma_vchan *vc = hw->vchans[vchan];
 	struct skeldma_desc *desc;
-	int ret;
-
-	RTE_SET_USED(vchan);
 
-	ret = rte_ring_dequeue(hw->desc_empty, (void **)&desc);
-	if (ret)
+	desc = desc_get(vc, SKELDMA_OP_COPY_SG, flags);
+	if (desc == NULL)
 		return -ENOSPC;
-	desc->op = SKELDMA_OP_COPY_SG;
-	desc->ridx = hw->ridx;
 	memcpy(desc->copy_sg.src, src, sizeof(*src) * nb_src);
 	memcpy(desc->copy_sg.dst, dst, sizeof(*dst) * nb_dst);
 	desc->copy_sg.nb_src = nb_src;
 	desc->copy_sg.nb_dst = nb_dst;
-	if (flags & RTE_DMA_OP_FLAG_SUBMIT)
-		submit(hw, desc);
-	else
-		(void)rte_ring_enqueue(hw->desc_pending, (void *)desc);
-	hw->submitted_count++;
 
-	return hw->ridx++;
+	return desc_put(vc, flags);
 }
 
 static int
@@ -482,64 +863,159 @@ skeldma_fill(void *dev_private, uint16_t vchan,
 	     uint32_t length, uint64_t flags)
 {
 	struct skeldma_hw *hw = dev_private;
+	struct skeldma_vchan *vc = hw->vchans[vchan];
 	struct skeldma_desc *desc;
-	int ret;
-
-	RTE_SET_USED(vchan);
 
-	ret = rte_ring_dequeue(hw->desc_empty, (void **)&desc);
-	if (ret)
+	desc = desc_get(vc, SKELDMA_OP_FILL, flags);
+	if (desc == NULL)
 		return -ENOSPC;
-	desc->op = SKELDMA_OP_FILL;
-	desc->ridx = hw->ridx;
 	desc->fill.dst = (void *)(uintptr_t)dst;
 	desc->fill.len = length;
 	desc->fill.pattern = pattern;
-	if (flags & RTE_DMA_OP_FLAG_SUBMIT)
-		submit(hw, desc);
-	else
-		(void)rte_ring_enqueue(hw->desc_pending, (void *)desc);
-	hw->submitted_count++;
 
-	return hw->ridx++;
+	return desc_put(vc, flags);
+}
+
+static int
+skeldma_crc32c(void *dev_private, uint16_t vchan,
+	       rte_iova_t src, uint32_t length,
+	       uint32_t seed, uint32_t *crc, uint64_t flags)
+{
+	struct skeldma_hw *hw = dev_private;
+	struct skeldma_vchan *vc = hw->vchans[vchan];
+	struct skeldma_desc *desc;
+
+	desc = desc_get(vc, SKELDMA_OP_CRC32C, flags);
+	if (desc == NULL)
+		return -ENOSPC;
+	desc->crc32c.src = (void *)(uintptr_t)src;
+	desc->crc32c.len = length;
+	desc->crc32c.seed = seed;
+	desc->crc32c.crc = crc;
+
+	return desc_put(vc, flags);
+}
+
+static int
+skeldma_compare(void *dev_private, uint16_t vchan,
+		rte_iova_t src1, rte_iova_t src2,
+		uint32_t length, uint32_t *result, uint64_t flags)
+{
+	struct skeldma_hw *hw = dev_private;
+	struct skeldma_vchan *vc = hw->vchans[vchan];
+	struct skeldma_desc *desc;
+
+	desc = desc_get(vc, SKELDMA_OP_COMPARE, flags);
+	if (desc == NULL)
+		return -ENOSPC;
+	desc->compare.src1 = (void *)(uintptr_t)src1;
+	desc->compare.src2 = (void *)(uintptr_t)src2;
+	desc->compare.len = length;
+	desc->compare.result = result;
+
+	return desc_put(vc, flags);
+}
+
+static int
+skeldma_compare_pattern(void *dev_private, uint16_t vchan,
+			uint64_t pattern, rte_iova_t src,
+			uint32_t length, uint32_t *result, uint64_t flags)
+{
+	struct skeldma_hw *hw = dev_private;
+	struct skeldma_vchan *vc = hw->vchans[vchan];
+	struct skeldma_desc *desc;
+
+	desc = desc_get(vc, SKELDMA_OP_COMPARE_PATTERN, flags);
+	if (desc == NULL)
+		return -ENOSPC;
+	desc->compare_pattern.src = (void *)(uintptr_t)src;
+	desc->compare_pattern.len = length;
+	desc->compare_pattern.pattern = pattern;
+	desc->compare_pattern.result = result;
+
+	return desc_put(vc, flags);
+}
+
+static int
+skeldma_dualcast(void *dev_private, uint16_t vchan,
+		 rte_iova_t src, rte_iova_t dst1, rte_iova_t dst2,
+		 uint32_t length, uint64_t flags)
+{
+	struct skeldma_hw *hw = dev_private;
+	struct skeldma_vchan *vc = hw->vchans[vchan];
+	struct skeldma_desc *desc;
+
+	desc = desc_get(vc, SKELDMA_OP_DUALCAST, flags);
+	if (desc == NULL)
+		return -ENOSPC;
+	desc->dualcast.src = (void *)(uintptr_t)src;
+	desc->dualcast.dst1 = (void *)(uintptr_t)dst1;
+	desc->dualcast.dst2 = (void *)(uintptr_t)dst2;
+	desc->dualcast.len = length;
+
+	return desc_put(vc, flags);
+}
+
+static int
+skeldma_dif(void *dev_private, uint16_t vchan,
+	    enum rte_dma_dif_op op, rte_iova_t src, rte_iova_t dst,
+	    uint32_t length, const struct rte_dma_dif_conf *conf,
+	    uint32_t *result, uint64_t flags)
+{
+	struct skeldma_hw *hw = dev_private;
+	struct skeldma_vchan *vc = hw->vchans[vchan];
+	struct skeldma_desc *desc;
+
+	if (conf->block_size == 0 || op > RTE_DMA_DIF_OP_CHECK)
+		return -EINVAL;
+
+	desc = desc_get(vc, SKELDMA_OP_DIF, flags);
+	if (desc == NULL)
+		return -ENOSPC;
+	desc->dif.op = op;
+	desc->dif.src = (void *)(uintptr_t)src;
+	desc->dif.dst = (void *)(uintptr_t)dst;
+	desc->dif.len = length;
+	desc->dif.conf = *conf;
+	desc->dif.result = result;
+
+	return desc_put(vc, flags);
 }
 
 static int
 skeldma_submit(void *dev_private, uint16_t vchan)
 {
 	struct skeldma_hw *hw = dev_private;
-	RTE_SET_USED(vchan);
-	submit(hw, NULL);
+	submit(hw->vchans[vchan]);
 	return 0;
 }
 
+/* Return the number of done descriptors from tail, in ring order. */
+static inline uint16_t
+vchan_completed(struct skeldma_vchan *vc, uint16_t nb_cpls, uint16_t *last_idx)
+{
+	uint16_t count;
+
+	count = RTE_MIN(rte_atomic_load_explicit(&vc->done,
+			rte_memory_order_acquire) - vc->tail, (uint64_t)nb_cpls);
+
+	vc->tail += count;
+	vc->completed_count += count;
+	*last_idx = vc->tail - 1;
+
+	return count;
+}
+
 static uint16_t
 skeldma_completed(void *dev_private,
 		  uint16_t vchan, const uint16_t nb_cpls,
 		  uint16_t *last_idx, bool *has_error)
 {
 	struct skeldma_hw *hw = dev_private;
-	struct skeldma_desc *desc = NULL;
-	uint16_t index = 0;
-	uint16_t count;
 
-	RTE_SET_USED(vchan);
 	RTE_SET_USED(has_error);
 
-	count = RTE_MIN(nb_cpls, rte_ring_count(hw->desc_completed));
-	while (index < count) {
-		(void)rte_ring_dequeue(hw->desc_completed, (void **)&desc);
-		if (index == count - 1) {
-			hw->last_ridx = desc->ridx;
-			*last_idx = desc->ridx;
-		}
-		index++;
-		(void)rte_ring_enqueue(hw->desc_empty, (void *)desc);
-	}
-	if (unlikely(count == 0))
-		*last_idx = hw->last_ridx;
-
-	return count;
+	return vchan_completed(hw->vchans[vchan], nb_cpls, last_idx);
 }
 
 static uint16_t
@@ -548,24 +1024,11 @@ skeldma_completed_status(void *dev_private,
 			 uint16_t *last_idx, enum rte_dma_status_code *status)
 {
 	struct skeldma_hw *hw = dev_private;
-	struct skeldma_desc *desc = NULL;
-	uint16_t index = 0;
-	uint16_t count;
+	uint16_t count, i;
 
-	RTE_SET_USED(vchan);
-
-	count = RTE_MIN(nb_cpls, rte_ring_count(hw->desc_completed));
-	while (index < count) {
-		(void)rte_ring_dequeue(hw->desc_completed, (void **)&desc);
-		if (index == count - 1) {
-			hw->last_ridx = desc->ridx;
-			*last_idx = desc->ridx;
-		}
-		status[index++] = RTE_DMA_STATUS_SUCCESSFUL;
-		(void)rte_ring_enqueue(hw->desc_empty, (void *)desc);
-	}
-	if (unlikely(count == 0))
-		*last_idx = hw->last_ridx;
+	count = vchan_completed(hw->vchans[vchan], nb_cpls, last_idx);
+	for (i = 0; i < count; i++)
+		status[i] = RTE_DMA_STATUS_SUCCESSFUL;
 
 	return count;
 }
@@ -574,9 +1037,9 @@ static uint16_t
 skeldma_burst_capacity(const void *dev_private, uint16_t vchan)
 {
 	const struct skeldma_hw *hw = dev_private;
+	const struct skeldma_vchan *vc = hw->vchans[vchan];
 
-	RTE_SET_USED(vchan);
-	return rte_ring_count(hw->desc_empty);
+	return vc->mask - (vc->head - vc->tail);
 }
 
 static const struct rte_dma_dev_ops skeldma_ops = {
@@ -593,10 +1056,31 @@ static const struct rte_dma_dev_ops skeldma_ops = {
 	.stats_reset      = skeldma_stats_reset,
 
 	.dev_dump         = skeldma_dump,
+
+	.intr_fd_get      = skeldma_intr_fd_get,
+	.intr_enable      = skeldma_intr_enable,
+	.intr_disable     = skeldma_intr_disable,
 };
 
+static skeldma_copy_t
+skeldma_get_copy_nt(void)
+{
+#ifdef CC_AVX512_SUPPORT
+	if (rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_512 &&
+	    rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) == 1)
+		return skeldma_copy_nt_avx512;
+#endif
+#ifdef CC_AVX2_SUPPORT
+	if (rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_256 &&
+	    rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2) == 1)
+		return skeldma_copy_nt_avx2;
+#endif
+	return NULL;
+}
+
 static int
-skeldma_create(const char *name, struct rte_vdev_device *vdev, int lcore_id)
+skeldma_create(const char *name, struct rte_vdev_device *vdev, int lcore_id,
+	       uint16_t nb_workers)
 {
 	struct rte_dma_dev *dev;
 	struct skeldma_hw *hw;
@@ -620,10 +1104,18 @@ skeldma_create(const char *name, struct rte_vdev_device *vdev, int lcore_id)
 	dev->fp_obj->completed = skeldma_completed;
 	dev->fp_obj->completed_status = skeldma_completed_status;
 	dev->fp_obj->burst_capacity = skeldma_burst_capacity;
+	dev->fp_ext_obj->dev_private = dev->data->dev_private;
+	dev->fp_ext_obj->crc32c = skeldma_crc32c;
+	dev->fp_ext_obj->compare = skeldma_compare;
+	dev->fp_ext_obj->compare_pattern = skeldma_compare_pattern;
+	dev->fp_ext_obj->dualcast = skeldma_dualcast;
+	dev->fp_ext_obj->dif = skeldma_dif;
 
 	hw = dev->data->dev_private;
 	hw->lcore_id = lcore_id;
 	hw->socket_id = socket_id;
+	hw->nb_workers = nb_workers;
+	hw->copy_nt = skeldma_get_copy_nt();
 
 	dev->state = RTE_DMA_DEV_READY;
 
@@ -653,11 +1145,30 @@ skeldma_parse_lcore(const char *key __rte_unused,
 	return 0;
 }
 
+static int
+skeldma_parse_workers(const char *key __rte_unused,
+		      const char *value,
+		      void *opaque)
+{
+	int nb_workers;
+
+	if (value == NULL || opaque == NULL)
+		return -EINVAL;
+
+	nb_workers = atoi(value);
+	if (nb_workers > 0 && nb_workers <= SKELDMA_MAX_WORKERS)
+		*(uint16_t *)opaque = nb_workers;
+
+	return 0;
+}
+
 static void
-skeldma_parse_vdev_args(struct rte_vdev_device *vdev, int *lcore_id)
+skeldma_parse_vdev_args(struct rte_vdev_device *vdev, int *lcore_id,
+			uint16_t *nb_workers)
 {
 	static const char *const args[] = {
 		SKELDMA_ARG_LCORE,
+		SKELDMA_ARG_WORKERS,
 		NULL
 	};
 
@@ -675,6 +1186,9 @@ skeldma_parse_vdev_args(struct rte_vdev_device *vdev, int *lcore_id)
 	(void)rte_kvargs_process(kvlist, SKELDMA_ARG_LCORE,
 				 skeldma_parse_lcore, lcore_id);
 	SKELDMA_LOG(INFO, "Parse lcore_id = %d", *lcore_id);
+	(void)rte_kvargs_process(kvlist, SKELDMA_ARG_WORKERS,
+				 skeldma_parse_workers, nb_workers);
+	SKELDMA_LOG(INFO, "Parse workers = %u", *nb_workers);
 
 	rte_kvargs_free(kvlist);
 }
@@ -682,6 +1196,7 @@ skeldma_parse_vdev_args(struct rte_vdev_device *vdev, int *lcore_id)
 static int
 skeldma_probe(struct rte_vdev_device *vdev)
 {
+	uint16_t nb_workers = 1;
 	const char *name;
 	int lcore_id = -1;
 	int ret;
@@ -695,12 +1210,12 @@ skeldma_probe(struct rte_vdev_device *vdev)
 		return -EINVAL;
 	}
 
-	skeldma_parse_vdev_args(vdev, &lcore_id);
+	skeldma_parse_vdev_args(vdev, &lcore_id, &nb_workers);
 
-	ret = skeldma_create(name, vdev, lcore_id);
+	ret = skeldma_create(name, vdev, lcore_id, nb_workers);
 	if (ret >= 0)
-		SKELDMA_LOG(INFO, "Create %s dmadev with lcore-id %d",
-			name, lcore_id);
+		SKELDMA_LOG(INFO, "Create %s dmadev with lcore-id %d and %u workers",
+			name, lcore_id, nb_workers);
 
 	return ret < 0 ? ret : 0;
 }
@@ -730,4 +1245,5 @@ static struct rte_vdev_driver skeldma_pmd_drv = {
 
 RTE_PMD_REGISTER_VDEV(dma_skeleton, skeldma_pmd_drv);
 RTE_PMD_REGISTER_PARAM_STRING(dma_skeleton,
-		SKELDMA_ARG_LCORE "=<uint16> ");
+		SKELDMA_ARG_LCORE "=<uint16> "
+		SKELDMA_ARG_WORKERS "=<uint16> ");
@@ -6,23 +6,35 @@
 #define SKELETON_DMADEV_H
 
 #include <rte_dmadev.h>
-#include <rte_ring.h>
+#include <rte_stdatomic.h>
 #include <rte_thread.h>
 
 #define SKELDMA_ARG_LCORE	"lcore"
+#define SKELDMA_ARG_WORKERS	"workers"
 
 #define SKELDMA_MAX_SGES	4
+#define SKELDMA_MAX_VCHANS	8
+#define SKELDMA_MAX_WORKERS	16
+/* Max descriptors a worker takes at once */
+#define SKELDMA_WORKER_BURST	32
+/* Copies from this length bypass the caches with non-temporal stores */
+#define SKELDMA_NT_COPY_MIN	(64 * 1024)
 
 enum skeldma_op {
 	SKELDMA_OP_COPY,
 	SKELDMA_OP_COPY_SG,
 	SKELDMA_OP_FILL,
+	SKELDMA_OP_CRC32C,
+	SKELDMA_OP_COMPARE,
+	SKELDMA_OP_COMPARE_PATTERN,
+	SKELDMA_OP_DUALCAST,
+	SKELDMA_OP_DIF,
 };
 
 struct skeldma_desc {
 	enum skeldma_op op;
-	uint16_t ridx; /* ring idx */
-
+	bool fence; /* wait for all previous descriptors to be done */
+	RTE_ATOMIC(uint32_t) done;
 	union {
 		struct {
 			void *src;
@@ -40,48 +52,101 @@ struct skeldma_desc {
 			uint32_t len;
 			uint64_t pattern;
 		} fill;
+		struct {
+			void *src;
+			uint32_t len;
+			uint32_t seed;
+			uint32_t *crc;
+		} crc32c;
+		struct {
+			void *src1;
+			void *src2;
+			uint32_t len;
+			uint32_t *result;
+		} compare;
+		struct {
+			void *src;
+			uint32_t len;
+			uint64_t pattern;
+			uint32_t *result;
+		} compare_pattern;
+		struct {
+			void *src;
+			void *dst1;
+			void *dst2;
+			uint32_t len;
+		} dualcast;
+		struct {
+			enum rte_dma_dif_op op;
+			void *src;
+			void *dst;
+			uint32_t len;
+			struct rte_dma_dif_conf conf;
+			uint32_t *result;
+		} dif;
 	};
 };
 
+/*
+ * Descriptors of a vchan are used in ring order, tracked by free running
+ * counters:
+ *  - the application fills descriptors at head,
+ *  - submitting makes descriptors up to head visible to workers,
+ *  - workers take bursts of submitted descriptors, and flag each one done,
+ *  - the done index moves over the descriptors flagged done, in order,
+ *  - the application returns done descriptors from tail, up to done.
+ *
+ *  tail <= done <= claimed <= submitted <= head < tail + nb_desc
+ */
+struct skeldma_vchan {
+	struct skeldma_desc *desc;
+	uint16_t nb_desc;
+	uint16_t mask;
+	int intr_fd; /* eventfd signalling completions, -1 if none */
+
+	/* Cache delimiter for dataplane API's operation data */
+	char cache1 __rte_cache_aligned;
+	uint64_t head;
+	uint64_t tail;
+	uint64_t submitted_count;
+	uint64_t completed_count;
+
+	/* Cache delimiter for data shared with workers */
+	RTE_ATOMIC(uint64_t) submitted __rte_cache_aligned;
+	RTE_ATOMIC(uint64_t) claimed __rte_cache_aligned;
+	RTE_ATOMIC(uint64_t) done __rte_cache_aligned; /* all done before this */
+	RTE_ATOMIC(uint32_t) intr_armed; /* signal intr_fd when done grows */
+};
+
+typedef void (*skeldma_copy_t)(void *dst, const void *src, size_t len);
+
+struct skeldma_worker {
+	struct rte_dma_dev *dev;
+	rte_thread_t thread;
+	uint32_t zero_req_count;
+	uint16_t id;
+};
+
 struct skeldma_hw {
-	int lcore_id; /* cpuwork task affinity core */
+	int lcore_id; /* cpuwork task affinity core of first worker */
 	int socket_id;
-	rte_thread_t thread; /* cpuwork task thread */
+	uint16_t nb_workers;
 	volatile int exit_flag; /* cpuwork task exit flag */
 
-	struct skeldma_desc *desc_mem;
-
-	/* Descriptor ring state machine:
-	 *
-	 *  -----------     enqueue without submit     -----------
-	 *  |  empty  |------------------------------->| pending |
-	 *  -----------\                               -----------
-	 *       ^      \------------                       |
-	 *       |                  |                       |submit doorbell
-	 *       |                  |                       |
-	 *       |                  |enqueue with submit    |
-	 *       |get completed     |------------------|    |
-	 *       |                                     |    |
-	 *       |                                     v    v
-	 *  -----------     cpuwork thread working     -----------
-	 *  |completed|<-------------------------------| running |
-	 *  -----------                                -----------
-	 */
-	struct rte_ring *desc_empty;
-	struct rte_ring *desc_pending;
-	struct rte_ring *desc_running;
-	struct rte_ring *desc_completed;
+	/* large copy function, NULL if no non-temporal copy is available */
+	skeldma_copy_t copy_nt;
 
-	/* Cache delimiter for dataplane API's operation data */
-	char cache1 __rte_cache_aligned;
-	uint16_t ridx;  /* ring idx */
-	uint16_t last_ridx;
-	uint64_t submitted_count;
+	uint16_t nb_vchans;
+	struct skeldma_vchan *vchans[SKELDMA_MAX_VCHANS];
 
-	/* Cache delimiter for cpuwork thread's operation data */
-	char cache2 __rte_cache_aligned;
-	volatile uint32_t zero_req_count;
-	uint64_t completed_count;
+	struct skeldma_worker workers[SKELDMA_MAX_WORKERS];
 };
 
+#ifdef CC_AVX2_SUPPORT
+void skeldma_copy_nt_avx2(void *dst, const void *src, size_t len);
+#endif
+#ifdef CC_AVX512_SUPPORT
+void skeldma_copy_nt_avx512(void *dst, const void *src, size_t len);
+#endif
+
 #endif /* SKELETON_DMADEV_H */
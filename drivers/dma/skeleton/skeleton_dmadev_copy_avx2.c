@@ -0,0 +1,43 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 HiSilicon Limited
+ */
+
+#include <x86intrin.h>
+
+#include <rte_memcpy.h>
+
+#include "skeleton_dmadev.h"
+
+/* Copy with non-temporal stores, not to evict the data of other cores from
+ * the caches. The destination is aligned first, as streaming stores require.
+ */
+void
+skeldma_copy_nt_avx2(void *dst, const void *src, size_t len)
+{
+	const uint8_t *s = src;
+	uint8_t *d = dst;
+	size_t head;
+
+	head = RTE_PTR_ALIGN_CEIL(d, 32) - d;
+	if (head > len)
+		head = len;
+	rte_memcpy(d, s, head);
+	d += head;
+	s += head;
+	len -= head;
+
+	for (; len >= 128; len -= 128, d += 128, s += 128) {
+		__m256i y0 = _mm256_loadu_si256((const __m256i *)s);
+		__m256i y1 = _mm256_loadu_si256((const __m256i *)(s + 32));
+		__m256i y2 = _mm256_loadu_si256((const __m256i *)(s + 64));
+		__m256i y3 = _mm256_loadu_si256((const __m256i *)(s + 96));
+		_mm256_stream_si256((__m256i *)d, y0);
+		_mm256_stream_si256((__m256i *)(d + 32), y1);
+		_mm256_stream_si256((__m256i *)(d + 64), y2);
+		_mm256_stream_si256((__m256i *)(d + 96), y3);
+	}
+	rte_memcpy(d, s, len);
+
+	/* order streaming stores before the completion is reported */
+	_mm_sfence();
+}
@@ -0,0 +1,43 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 HiSilicon Limited
+ */
+
+#include <x86intrin.h>
+
+#include <rte_memcpy.h>
+
+#include "skeleton_dmadev.h"
+
+/* Copy with non-temporal stores, not to evict the data of other cores from
+ * the caches. The destination is aligned first, as streaming stores require.
+ */
+void
+skeldma_copy_nt_avx512(void *dst, const void *src, size_t len)
+{
+	const uint8_t *s = src;
+	uint8_t *d = dst;
+	size_t head;
+
+	head = RTE_PTR_ALIGN_CEIL(d, 64) - d;
+	if (head > len)
+		head = len;
+	rte_memcpy(d, s, head);
+	d += head;
+	s += head;
+	len -= head;
+
+	for (; len >= 256; len -= 256, d += 256, s += 256) {
+		__m512i z0 = _mm512_loadu_si512(s);
+		__m512i z1 = _mm512_loadu_si512(s + 64);
+		__m512i z2 = _mm512_loadu_si512(s + 128);
+		__m512i z3 = _mm512_loadu_si512(s + 192);
+		_mm512_stream_si512((void *)d, z0);
+		_mm512_stream_si512((void *)(d + 64), z1);
+		_mm512_stream_si512((void *)(d + 128), z2);
+		_mm512_stream_si512((void *)(d + 192), z3);
+	}
+	rte_memcpy(d, s, len);
+
+	/* order streaming stores before the completion is reported */
+	_mm_sfence();
+}
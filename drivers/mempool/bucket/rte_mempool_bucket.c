@@ -16,6 +16,8 @@
 #include <rte_mempool.h>
 #include <rte_malloc.h>
 
+#include "rte_mempool_bucket.h"
+
 /*
  * The general idea of the bucket mempool driver is as follows.
  * We keep track of physically contiguous groups (buckets) of objects
@@ -24,12 +26,22 @@
  * Until the bucket is full, no objects from it are eligible for allocation.
  * If a request is made to dequeue a multiply of bucket size, it is
  * satisfied by returning the whole buckets, instead of separate objects.
+ *
+ * Buckets are aligned on their size, a power of two, so the header of the
+ * bucket of an object is found by masking the object address. They may be
+ * as large as a hugepage, e.g. 2MB or 1GB, to hold large objects.
  */
 
+/* Largest bucket size */
+#define BUCKET_MAX_SIZE (UINT32_C(1) << 30)
+/* Objects a bucket of default size holds at least, if pages are large enough */
+#define BUCKET_MIN_OBJS 8
+/* Objects of a new bucket moved at once to the orphan ring */
+#define BUCKET_ORPHAN_BURST 64
 
 struct bucket_header {
 	unsigned int lcore_id;
-	uint8_t fill_cnt;
+	uint32_t fill_cnt;
 };
 
 struct bucket_stack {
@@ -175,11 +187,30 @@ bucket_fill_obj_table(const struct bucket_data *bd, void **pstart,
 	return obj_table;
 }
 
+static int
+bucket_enqueue_orphans(struct bucket_data *bd, uint8_t *objptr,
+		       unsigned int n)
+{
+	void *orphans[BUCKET_ORPHAN_BURST];
+	unsigned int i, burst;
+
+	while (n > 0) {
+		burst = RTE_MIN(n, (unsigned int)BUCKET_ORPHAN_BURST);
+		for (i = 0; i < burst; i++, objptr += bd->total_elt_size)
+			orphans[i] = objptr;
+		if (rte_ring_enqueue_bulk(bd->shared_orphan_ring, orphans,
+					  burst, NULL) != burst)
+			return -ENOBUFS;
+		n -= burst;
+	}
+
+	return 0;
+}
+
 static int
 bucket_dequeue_orphans(struct bucket_data *bd, void **obj_table,
 		       unsigned int n_orphans)
 {
-	unsigned int i;
 	int rc;
 	uint8_t *objptr;
 
@@ -204,15 +235,12 @@ bucket_dequeue_orphans(struct bucket_data *bd, void **obj_table,
 		hdr->fill_cnt = 0;
 		bucket_fill_obj_table(bd, (void **)&objptr, obj_table,
 				      n_orphans);
-		for (i = n_orphans; i < bd->obj_per_bucket; i++,
-			     objptr += bd->total_elt_size) {
-			rc = rte_ring_enqueue(bd->shared_orphan_ring,
-					      objptr);
-			if (rc != 0) {
-				RTE_ASSERT(0);
-				rte_errno = -rc;
-				return rc;
-			}
+		rc = bucket_enqueue_orphans(bd, objptr,
+					    bd->obj_per_bucket - n_orphans);
+		if (rc != 0) {
+			RTE_ASSERT(0);
+			rte_errno = -rc;
+			return rc;
 		}
 	}
 
@@ -451,6 +479,41 @@ bucket_uninit_per_lcore(unsigned int lcore_id, void *arg)
 	bd->buckets[lcore_id] = NULL;
 }
 
+/*
+ * Use the configured bucket size, or the smallest power of two from the
+ * build time size which holds enough objects, within a page.
+ */
+static int
+bucket_select_size(const struct rte_mempool *mp, size_t pg_sz,
+		   unsigned int bucket_header_size,
+		   unsigned int total_elt_size, unsigned int *bucket_mem_size)
+{
+	const struct rte_mempool_bucket_config *cfg = mp->pool_config;
+	size_t size;
+
+	if (cfg != NULL && cfg->bucket_size != 0) {
+		size = cfg->bucket_size;
+		if (size > BUCKET_MAX_SIZE || !rte_is_power_of_2(size) ||
+		    (pg_sz != 0 && size > pg_sz))
+			return -EINVAL;
+	} else {
+		size = RTE_DRIVER_MEMPOOL_BUCKET_SIZE_KB * 1024;
+		while (size < bucket_header_size +
+				(size_t)BUCKET_MIN_OBJS * total_elt_size &&
+		       size < BUCKET_MAX_SIZE)
+			size *= 2;
+		/* No page size when objects need not be IOVA-contiguous */
+		if (pg_sz != 0)
+			size = RTE_MIN(size, pg_sz);
+	}
+
+	if (size < bucket_header_size + total_elt_size)
+		return -EINVAL;
+
+	*bucket_mem_size = size;
+	return 0;
+}
+
 static int
 bucket_alloc(struct rte_mempool *mp)
 {
@@ -479,8 +542,10 @@ bucket_alloc(struct rte_mempool *mp)
 	RTE_BUILD_BUG_ON(sizeof(struct bucket_header) > RTE_CACHE_LINE_SIZE);
 	bd->header_size = mp->header_size + bucket_header_size;
 	bd->total_elt_size = mp->header_size + mp->elt_size + mp->trailer_size;
-	bd->bucket_mem_size = RTE_MIN(pg_sz,
-			(size_t)(RTE_DRIVER_MEMPOOL_BUCKET_SIZE_KB * 1024));
+	rc = bucket_select_size(mp, pg_sz, bucket_header_size,
+				bd->total_elt_size, &bd->bucket_mem_size);
+	if (rc < 0)
+		goto invalid_bucket_size;
 	bd->obj_per_bucket = (bd->bucket_mem_size - bucket_header_size) /
 		bd->total_elt_size;
 	bd->bucket_page_mask = ~(rte_align64pow2(bd->bucket_mem_size) - 1);
@@ -539,6 +604,7 @@ bucket_alloc(struct rte_mempool *mp)
 invalid_shared_orphan_ring:
 	rte_lcore_callback_unregister(bd->lcore_callback_handle);
 no_mem_for_stacks:
+invalid_bucket_size:
 	rte_free(bd);
 no_mem_for_data:
 	rte_errno = -rc;
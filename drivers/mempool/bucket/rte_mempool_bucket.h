@@ -0,0 +1,43 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#ifndef RTE_MEMPOOL_BUCKET_H
+#define RTE_MEMPOOL_BUCKET_H
+
+/**
+ * @file
+ *
+ * Configuration of the bucket mempool driver.
+ *
+ * A pointer to this structure may be given as *pool_config* to
+ * rte_mempool_set_ops_byname() when selecting the "bucket" ops.
+ */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Configuration of a bucket mempool.
+ */
+struct rte_mempool_bucket_config {
+	/**
+	 * Size in bytes of a bucket, i.e. of a physically contiguous block
+	 * of objects, including a cache line of header. It must be a power
+	 * of two and not exceed the page size of the mempool memory,
+	 * e.g. 2MB or 1GB with hugepages of that size.
+	 * Zero selects the smallest power of two at least
+	 * RTE_DRIVER_MEMPOOL_BUCKET_SIZE_KB which holds 8 objects,
+	 * or one page if smaller.
+	 */
+	size_t bucket_size;
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTE_MEMPOOL_BUCKET_H */
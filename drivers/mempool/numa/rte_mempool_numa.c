@@ -0,0 +1,349 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_errno.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_memory.h>
+#include <rte_mempool.h>
+#include <rte_ring.h>
+
+/* Objects sorted at once on enqueue */
+#define NUMA_SORT_BURST 64
+
+/* Memory chunk whose objects belong to a shard */
+struct numa_range {
+	uintptr_t start;
+	uintptr_t end;
+	unsigned int shard;
+};
+
+struct numa_pool {
+	/* One ring of free objects per NUMA node, allocated on that node */
+	struct rte_ring *shards[RTE_MAX_NUMA_NODES];
+	unsigned int nb_shards;
+	/* Shard of each socket, the default shard for unknown sockets */
+	uint8_t shard_of_socket[RTE_MAX_NUMA_NODES];
+	unsigned int default_shard;
+	/* Memory chunks of the pool, sorted by address */
+	struct numa_range *ranges;
+	unsigned int nb_ranges;
+	unsigned int max_ranges;
+	/* Number of shards with objects, a single one needs no sorting */
+	unsigned int nb_used;
+	uint8_t used[RTE_MAX_NUMA_NODES];
+	/* Flags of the rings */
+	uint32_t rg_flags;
+};
+
+static inline unsigned int
+numa_socket_shard(const struct numa_pool *pool, int socket_id)
+{
+	if (socket_id < 0 || socket_id >= RTE_MAX_NUMA_NODES)
+		return pool->default_shard;
+	return pool->shard_of_socket[socket_id];
+}
+
+static inline unsigned int
+numa_obj_shard(const struct numa_pool *pool, const void *obj)
+{
+	uintptr_t addr = (uintptr_t)obj;
+	unsigned int lo = 0, hi = pool->nb_ranges;
+	unsigned int mid;
+
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (addr < pool->ranges[mid].start)
+			hi = mid;
+		else if (addr >= pool->ranges[mid].end)
+			lo = mid + 1;
+		else
+			return pool->ranges[mid].shard;
+	}
+
+	return pool->default_shard;
+}
+
+static inline int
+numa_ring_enqueue(const struct numa_pool *pool, unsigned int shard,
+		void * const *obj_table, unsigned int n)
+{
+	struct rte_ring *r = pool->shards[shard];
+
+	if (pool->rg_flags & RING_F_SP_ENQ)
+		return rte_ring_sp_enqueue_bulk(r, obj_table, n, NULL) == 0 ?
+			-ENOBUFS : 0;
+	return rte_ring_mp_enqueue_bulk(r, obj_table, n, NULL) == 0 ?
+		-ENOBUFS : 0;
+}
+
+static inline unsigned int
+numa_ring_dequeue(const struct numa_pool *pool, unsigned int shard,
+		void **obj_table, unsigned int n)
+{
+	struct rte_ring *r = pool->shards[shard];
+
+	if (pool->rg_flags & RING_F_SC_DEQ)
+		return rte_ring_sc_dequeue_burst(r, obj_table, n, NULL);
+	return rte_ring_mc_dequeue_burst(r, obj_table, n, NULL);
+}
+
+/* Put objects back into the shard of the node their memory is on */
+static int
+numa_enqueue(struct rte_mempool *mp, void * const *obj_table, unsigned int n)
+{
+	const struct numa_pool *pool = mp->pool_data;
+	void *sorted[NUMA_SORT_BURST];
+	uint8_t obj_shard[NUMA_SORT_BURST];
+	unsigned int count[RTE_MAX_NUMA_NODES + 1];
+	unsigned int i, j, burst, shard;
+	int ret = 0;
+
+	if (unlikely(n == 0))
+		return 0;
+
+	/* all objects are in the same shard, that of the first one */
+	if (pool->nb_used <= 1)
+		return numa_ring_enqueue(pool,
+				numa_obj_shard(pool, obj_table[0]), obj_table, n);
+
+	for (i = 0; i < n; i += burst) {
+		burst = RTE_MIN(n - i, (unsigned int)NUMA_SORT_BURST);
+
+		/* Counting sort of the burst by shard */
+		memset(count, 0, sizeof(count[0]) * (pool->nb_shards + 1));
+		for (j = 0; j < burst; j++) {
+			obj_shard[j] = numa_obj_shard(pool, obj_table[i + j]);
+			count[obj_shard[j] + 1]++;
+		}
+		for (shard = 1; shard <= pool->nb_shards; shard++)
+			count[shard] += count[shard - 1];
+		for (j = 0; j < burst; j++)
+			sorted[count[obj_shard[j]]++] = obj_table[i + j];
+
+		/* count[shard] is now the end of the objects of the shard */
+		for (shard = 0, j = 0; shard < pool->nb_shards; shard++) {
+			if (count[shard] != j &&
+			    numa_ring_enqueue(pool, shard, &sorted[j],
+					count[shard] - j) < 0)
+				ret = -ENOBUFS;
+			j = count[shard];
+		}
+	}
+
+	return ret;
+}
+
+/*
+ * Take objects from the shard of the calling lcore, and from the other
+ * shards only if it does not have enough of them.
+ */
+static int
+numa_dequeue(struct rte_mempool *mp, void **obj_table, unsigned int n)
+{
+	const struct numa_pool *pool = mp->pool_data;
+	unsigned int local = numa_socket_shard(pool, (int)rte_socket_id());
+	unsigned int shard, got;
+
+	got = numa_ring_dequeue(pool, local, obj_table, n);
+	if (likely(got == n))
+		return 0;
+
+	for (shard = 0; shard < pool->nb_shards && got < n; shard++) {
+		if (shard != local)
+			got += numa_ring_dequeue(pool, shard, obj_table + got,
+					n - got);
+	}
+	if (got == n)
+		return 0;
+
+	/* Dequeues are all or nothing, give back what was taken */
+	if (got != 0)
+		numa_enqueue(mp, obj_table, got);
+
+	return -ENOBUFS;
+}
+
+static unsigned int
+numa_get_count(const struct rte_mempool *mp)
+{
+	const struct numa_pool *pool = mp->pool_data;
+	unsigned int shard, count = 0;
+
+	for (shard = 0; shard < pool->nb_shards; shard++)
+		count += rte_ring_count(pool->shards[shard]);
+
+	return count;
+}
+
+static void
+numa_free(struct rte_mempool *mp)
+{
+	struct numa_pool *pool = mp->pool_data;
+	unsigned int shard;
+
+	if (pool == NULL)
+		return;
+
+	for (shard = 0; shard < pool->nb_shards; shard++)
+		rte_free(pool->shards[shard]);
+	rte_free(pool->ranges);
+	rte_free(pool);
+	mp->pool_data = NULL;
+}
+
+static int
+numa_alloc(struct rte_mempool *mp)
+{
+	struct numa_pool *pool;
+	unsigned int shard, count;
+	ssize_t ring_size;
+	int socket_id;
+	int ret;
+
+	pool = rte_zmalloc_socket("mempool_numa", sizeof(*pool),
+			RTE_CACHE_LINE_SIZE, mp->socket_id);
+	if (pool == NULL) {
+		rte_errno = ENOMEM;
+		return -rte_errno;
+	}
+	mp->pool_data = pool;
+
+	if (mp->flags & RTE_MEMPOOL_F_SP_PUT)
+		pool->rg_flags |= RING_F_SP_ENQ;
+	if (mp->flags & RTE_MEMPOOL_F_SC_GET)
+		pool->rg_flags |= RING_F_SC_DEQ;
+
+	/* Any shard may end up holding all the objects of the pool */
+	count = rte_align32pow2(mp->size + 1);
+	ring_size = rte_ring_get_memsize(count);
+	if (ring_size < 0) {
+		ret = ring_size;
+		goto fail;
+	}
+
+	pool->nb_shards = RTE_MIN(rte_socket_count(),
+			(unsigned int)RTE_MAX_NUMA_NODES);
+	if (pool->nb_shards == 0)
+		pool->nb_shards = 1;
+
+	for (shard = 0; shard < pool->nb_shards; shard++) {
+		socket_id = rte_socket_id_by_idx(shard);
+		if (socket_id < 0 || socket_id >= RTE_MAX_NUMA_NODES)
+			socket_id = SOCKET_ID_ANY;
+		else
+			pool->shard_of_socket[socket_id] = shard;
+
+		pool->shards[shard] = rte_zmalloc_socket("mempool_numa_ring",
+				ring_size, RTE_CACHE_LINE_SIZE, socket_id);
+		if (pool->shards[shard] == NULL) {
+			ret = -ENOMEM;
+			goto fail;
+		}
+
+		ret = rte_ring_init(pool->shards[shard], mp->name, count,
+				pool->rg_flags);
+		if (ret < 0)
+			goto fail;
+
+		if (socket_id == mp->socket_id)
+			pool->default_shard = shard;
+	}
+
+	/* Sockets with no lcore map to the shard of the pool */
+	for (socket_id = 0; socket_id < RTE_MAX_NUMA_NODES; socket_id++) {
+		if (rte_socket_id_by_idx(pool->shard_of_socket[socket_id]) !=
+				socket_id)
+			pool->shard_of_socket[socket_id] = pool->default_shard;
+	}
+
+	return 0;
+
+fail:
+	numa_free(mp);
+	rte_errno = -ret;
+	return ret;
+}
+
+/* Record the shard of a memory chunk before its objects are enqueued */
+static int
+numa_add_range(struct rte_mempool *mp, void *vaddr, size_t len)
+{
+	struct numa_pool *pool = mp->pool_data;
+	const struct rte_memseg_list *msl;
+	struct numa_range *ranges;
+	uintptr_t start = (uintptr_t)vaddr;
+	unsigned int shard, pos;
+
+	msl = rte_mem_virt2memseg_list(vaddr);
+	shard = numa_socket_shard(pool,
+			msl != NULL ? msl->socket_id : mp->socket_id);
+
+	/* Chunks of a virtually contiguous area come in address order */
+	for (pos = 0; pos < pool->nb_ranges; pos++) {
+		if (pool->ranges[pos].end == start &&
+		    pool->ranges[pos].shard == shard &&
+		    (pos + 1 == pool->nb_ranges ||
+		     pool->ranges[pos + 1].start >= start + len)) {
+			pool->ranges[pos].end = start + len;
+			goto out;
+		}
+		if (pool->ranges[pos].start > start)
+			break;
+	}
+
+	if (pool->nb_ranges == pool->max_ranges) {
+		ranges = rte_realloc(pool->ranges, sizeof(*ranges) *
+				RTE_MAX(2 * pool->max_ranges, 8U), 0);
+		if (ranges == NULL)
+			return -ENOMEM;
+		pool->ranges = ranges;
+		pool->max_ranges = RTE_MAX(2 * pool->max_ranges, 8U);
+	}
+
+	memmove(&pool->ranges[pos + 1], &pool->ranges[pos],
+		sizeof(*pool->ranges) * (pool->nb_ranges - pos));
+	pool->ranges[pos].start = start;
+	pool->ranges[pos].end = start + len;
+	pool->ranges[pos].shard = shard;
+	pool->nb_ranges++;
+
+out:
+	if (!pool->used[shard]) {
+		pool->used[shard] = 1;
+		pool->nb_used++;
+	}
+	return 0;
+}
+
+static int
+numa_populate(struct rte_mempool *mp, unsigned int max_objs,
+		void *vaddr, rte_iova_t iova, size_t len,
+		rte_mempool_populate_obj_cb_t *obj_cb, void *obj_cb_arg)
+{
+	int ret;
+
+	ret = numa_add_range(mp, vaddr, len);
+	if (ret < 0)
+		return ret;
+
+	return rte_mempool_op_populate_default(mp, max_objs, vaddr, iova, len,
+			obj_cb, obj_cb_arg);
+}
+
+static const struct rte_mempool_ops ops_numa = {
+	.name = "numa",
+	.alloc = numa_alloc,
+	.free = numa_free,
+	.enqueue = numa_enqueue,
+	.dequeue = numa_dequeue,
+	.get_count = numa_get_count,
+	.populate = numa_populate,
+};
+
+RTE_MEMPOOL_REGISTER_OPS(ops_numa);
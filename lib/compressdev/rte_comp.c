@@ -51,6 +51,8 @@ rte_comp_get_feature_name(uint64_t flag)
 		return "LZ4_BLOCK_INDEPENDENCE";
 	case RTE_COMP_FF_LZ4_BLOCK_WITH_CHECKSUM:
 		return "LZ4_BLOCK_WITH_CHECKSUM";
+	case RTE_COMP_FF_ZSTD_DICT:
+		return "ZSTD_DICT";
 	default:
 		return NULL;
 	}
@@ -77,6 +77,8 @@ extern "C" {
 /**< LZ4 block independent is supported */
 #define RTE_COMP_FF_LZ4_BLOCK_WITH_CHECKSUM	(1ULL << 20)
 /**< LZ4 block with checksum is supported */
+#define RTE_COMP_FF_ZSTD_DICT			(1ULL << 21)
+/**< Zstandard pre-trained dictionaries are supported */
 
 /** Status of comp operation */
 enum rte_comp_op_status {
@@ -123,6 +125,10 @@ enum rte_comp_algorithm {
 	/**< LZ4 compression algorithm
 	 * https://github.com/lz4/lz4
 	 */
+	RTE_COMP_ALGO_ZSTD,
+	/**< Zstandard compression algorithm
+	 * https://tools.ietf.org/html/rfc8878
+	 */
 };
 
 /** Compression Hash Algorithms */
@@ -281,6 +287,25 @@ struct rte_comp_lz4_params {
 	 */
 };
 
+/** Parameters specific to the Zstandard algorithm */
+struct rte_comp_zstd_params {
+	int level;
+	/**< Native Zstandard compression level, from ZSTD_minCLevel()
+	 * to ZSTD_maxCLevel(). When not 0, it is used instead of the
+	 * generic compression level. Ignored for decompression.
+	 */
+	const void *dict;
+	/**< Pre-trained dictionary, as produced by "zstd --train",
+	 * or NULL to not use any. The same dictionary must be given for
+	 * compression and decompression. The content is only read while
+	 * the private xform or stream is created, and is digested once
+	 * for all the operations using it.
+	 * Requires RTE_COMP_FF_ZSTD_DICT.
+	 */
+	uint32_t dict_len;
+	/**< Length of the dictionary in bytes */
+};
+
 /** Setup Data for compression */
 struct rte_comp_compress_xform {
 	enum rte_comp_algorithm algo;
@@ -304,6 +329,11 @@ struct rte_comp_compress_xform {
 	/**< Hash algorithm to be used with compress operation. Hash is always
 	 * done on plaintext.
 	 */
+	struct rte_comp_zstd_params zstd;
+	/**< Parameters specific to the Zstandard algorithm.
+	 * Kept out of the algorithm specific union to preserve the layout
+	 * of the other fields.
+	 */
 };
 
 /**
@@ -327,6 +357,11 @@ struct rte_comp_decompress_xform {
 	/**< Hash algorithm to be used with decompress operation. Hash is always
 	 * done on plaintext.
 	 */
+	struct rte_comp_zstd_params zstd;
+	/**< Parameters specific to the Zstandard algorithm.
+	 * Kept out of the algorithm specific union to preserve the layout
+	 * of the other fields.
+	 */
 };
 
 /**
@@ -22,6 +22,7 @@
 static int16_t dma_devices_max;
 
 struct rte_dma_fp_object *rte_dma_fp_objs;
+struct rte_dma_fp_ext_object *rte_dma_fp_ext_objs;
 static struct rte_dma_dev *rte_dma_devices;
 static struct {
 	/* Hold the dev_max information of the primary process. This field is
@@ -124,12 +125,13 @@ dma_find_by_name(const char *name)
 }
 
 static void dma_fp_object_dummy(struct rte_dma_fp_object *obj);
+static void dma_fp_ext_object_dummy(struct rte_dma_fp_ext_object *obj);
 
 static int
 dma_fp_data_prepare(void)
 {
-	size_t size;
-	void *ptr;
+	size_t size, ext_size;
+	void *ptr, *ext_ptr;
 	int i;
 
 	if (rte_dma_fp_objs != NULL)
@@ -148,10 +150,23 @@ dma_fp_data_prepare(void)
 		return -ENOMEM;
 	memset(ptr, 0, size);
 
+	ext_size = dma_devices_max * sizeof(struct rte_dma_fp_ext_object) +
+		RTE_CACHE_LINE_SIZE;
+	ext_ptr = malloc(ext_size);
+	if (ext_ptr == NULL) {
+		free(ptr);
+		return -ENOMEM;
+	}
+	memset(ext_ptr, 0, ext_size);
+
 	rte_dma_fp_objs = RTE_PTR_ALIGN(ptr, RTE_CACHE_LINE_SIZE);
 	for (i = 0; i < dma_devices_max; i++)
 		dma_fp_object_dummy(&rte_dma_fp_objs[i]);
 
+	rte_dma_fp_ext_objs = RTE_PTR_ALIGN(ext_ptr, RTE_CACHE_LINE_SIZE);
+	for (i = 0; i < dma_devices_max; i++)
+		dma_fp_ext_object_dummy(&rte_dma_fp_ext_objs[i]);
+
 	return 0;
 }
 
@@ -322,6 +337,8 @@ dma_allocate(const char *name, int numa_node, size_t private_data_size)
 	if (dev) {
 		dev->fp_obj = &rte_dma_fp_objs[dev->data->dev_id];
 		dma_fp_object_dummy(dev->fp_obj);
+		dev->fp_ext_obj = &rte_dma_fp_ext_objs[dev->data->dev_id];
+		dma_fp_ext_object_dummy(dev->fp_ext_obj);
 	}
 
 	return dev;
@@ -336,6 +353,7 @@ dma_release(struct rte_dma_dev *dev)
 	}
 
 	dma_fp_object_dummy(dev->fp_obj);
+	dma_fp_ext_object_dummy(dev->fp_ext_obj);
 	memset(dev, 0, sizeof(struct rte_dma_dev));
 }
 
@@ -745,6 +763,60 @@ rte_dma_vchan_status(int16_t dev_id, uint16_t vchan, enum rte_dma_vchan_status *
 	return (*dev->dev_ops->vchan_status)(dev, vchan, status);
 }
 
+int
+rte_dma_intr_fd_get(int16_t dev_id, uint16_t vchan)
+{
+	struct rte_dma_dev *dev = &rte_dma_devices[dev_id];
+
+	if (!rte_dma_is_valid(dev_id))
+		return -EINVAL;
+
+	if (vchan >= dev->data->dev_conf.nb_vchans) {
+		RTE_DMA_LOG(ERR, "Device %d vchan %u out of range", dev_id, vchan);
+		return -EINVAL;
+	}
+
+	if (*dev->dev_ops->intr_fd_get == NULL)
+		return -ENOTSUP;
+	return (*dev->dev_ops->intr_fd_get)(dev, vchan);
+}
+
+int
+rte_dma_intr_enable(int16_t dev_id, uint16_t vchan)
+{
+	struct rte_dma_dev *dev = &rte_dma_devices[dev_id];
+
+	if (!rte_dma_is_valid(dev_id))
+		return -EINVAL;
+
+	if (vchan >= dev->data->dev_conf.nb_vchans) {
+		RTE_DMA_LOG(ERR, "Device %d vchan %u out of range", dev_id, vchan);
+		return -EINVAL;
+	}
+
+	if (*dev->dev_ops->intr_enable == NULL)
+		return -ENOTSUP;
+	return (*dev->dev_ops->intr_enable)(dev, vchan);
+}
+
+int
+rte_dma_intr_disable(int16_t dev_id, uint16_t vchan)
+{
+	struct rte_dma_dev *dev = &rte_dma_devices[dev_id];
+
+	if (!rte_dma_is_valid(dev_id))
+		return -EINVAL;
+
+	if (vchan >= dev->data->dev_conf.nb_vchans) {
+		RTE_DMA_LOG(ERR, "Device %d vchan %u out of range", dev_id, vchan);
+		return -EINVAL;
+	}
+
+	if (*dev->dev_ops->intr_disable == NULL)
+		return -ENOTSUP;
+	return (*dev->dev_ops->intr_disable)(dev, vchan);
+}
+
 static const char *
 dma_capability_name(uint64_t capability)
 {
@@ -760,9 +832,14 @@ dma_capability_name(uint64_t capability)
 		{ RTE_DMA_CAPA_SILENT,      "silent"  },
 		{ RTE_DMA_CAPA_HANDLES_ERRORS, "handles_errors" },
 		{ RTE_DMA_CAPA_M2D_AUTO_FREE,  "m2d_auto_free"  },
+		{ RTE_DMA_CAPA_INTR,        "intr"    },
 		{ RTE_DMA_CAPA_OPS_COPY,    "copy"    },
 		{ RTE_DMA_CAPA_OPS_COPY_SG, "copy_sg" },
 		{ RTE_DMA_CAPA_OPS_FILL,    "fill"    },
+		{ RTE_DMA_CAPA_OPS_CRC32C,  "crc32c"  },
+		{ RTE_DMA_CAPA_OPS_COMPARE, "compare" },
+		{ RTE_DMA_CAPA_OPS_DUALCAST, "dualcast" },
+		{ RTE_DMA_CAPA_OPS_DIF,     "dif"     },
 	};
 
 	const char *name = "unknown";
@@ -854,6 +931,61 @@ dummy_fill(__rte_unused void *dev_private, __rte_unused uint16_t vchan,
 	return -EINVAL;
 }
 
+static int
+dummy_crc32c(__rte_unused void *dev_private, __rte_unused uint16_t vchan,
+	     __rte_unused rte_iova_t src, __rte_unused uint32_t length,
+	     __rte_unused uint32_t seed, __rte_unused uint32_t *crc,
+	     __rte_unused uint64_t flags)
+{
+	RTE_DMA_LOG(ERR, "crc32c is not configured or not supported.");
+	return -EINVAL;
+}
+
+static int
+dummy_compare(__rte_unused void *dev_private, __rte_unused uint16_t vchan,
+	      __rte_unused rte_iova_t src1, __rte_unused rte_iova_t src2,
+	      __rte_unused uint32_t length, __rte_unused uint32_t *result,
+	      __rte_unused uint64_t flags)
+{
+	RTE_DMA_LOG(ERR, "compare is not configured or not supported.");
+	return -EINVAL;
+}
+
+static int
+dummy_compare_pattern(__rte_unused void *dev_private,
+		      __rte_unused uint16_t vchan,
+		      __rte_unused uint64_t pattern,
+		      __rte_unused rte_iova_t src,
+		      __rte_unused uint32_t length,
+		      __rte_unused uint32_t *result,
+		      __rte_unused uint64_t flags)
+{
+	RTE_DMA_LOG(ERR,
+		    "compare_pattern is not configured or not supported.");
+	return -EINVAL;
+}
+
+static int
+dummy_dualcast(__rte_unused void *dev_private, __rte_unused uint16_t vchan,
+	       __rte_unused rte_iova_t src, __rte_unused rte_iova_t dst1,
+	       __rte_unused rte_iova_t dst2, __rte_unused uint32_t length,
+	       __rte_unused uint64_t flags)
+{
+	RTE_DMA_LOG(ERR, "dualcast is not configured or not supported.");
+	return -EINVAL;
+}
+
+static int
+dummy_dif(__rte_unused void *dev_private, __rte_unused uint16_t vchan,
+	  __rte_unused enum rte_dma_dif_op op, __rte_unused rte_iova_t src,
+	  __rte_unused rte_iova_t dst, __rte_unused uint32_t length,
+	  __rte_unused const struct rte_dma_dif_conf *conf,
+	  __rte_unused uint32_t *result, __rte_unused uint64_t flags)
+{
+	RTE_DMA_LOG(ERR, "dif is not configured or not supported.");
+	return -EINVAL;
+}
+
 static int
 dummy_submit(__rte_unused void *dev_private, __rte_unused uint16_t vchan)
 {
@@ -903,6 +1035,17 @@ dma_fp_object_dummy(struct rte_dma_fp_object *obj)
 	obj->burst_capacity   = dummy_burst_capacity;
 }
 
+static void
+dma_fp_ext_object_dummy(struct rte_dma_fp_ext_object *obj)
+{
+	obj->dev_private      = NULL;
+	obj->crc32c           = dummy_crc32c;
+	obj->compare          = dummy_compare;
+	obj->compare_pattern  = dummy_compare_pattern;
+	obj->dualcast         = dummy_dualcast;
+	obj->dif              = dummy_dif;
+}
+
 static int
 dmadev_handle_dev_list(const char *cmd __rte_unused,
 		const char *params __rte_unused,
@@ -965,9 +1108,14 @@ dmadev_handle_dev_info(const char *cmd __rte_unused,
 	ADD_CAPA(dma_caps, dev_capa, RTE_DMA_CAPA_SILENT);
 	ADD_CAPA(dma_caps, dev_capa, RTE_DMA_CAPA_HANDLES_ERRORS);
 	ADD_CAPA(dma_caps, dev_capa, RTE_DMA_CAPA_M2D_AUTO_FREE);
+	ADD_CAPA(dma_caps, dev_capa, RTE_DMA_CAPA_INTR);
 	ADD_CAPA(dma_caps, dev_capa, RTE_DMA_CAPA_OPS_COPY);
 	ADD_CAPA(dma_caps, dev_capa, RTE_DMA_CAPA_OPS_COPY_SG);
 	ADD_CAPA(dma_caps, dev_capa, RTE_DMA_CAPA_OPS_FILL);
+	ADD_CAPA(dma_caps, dev_capa, RTE_DMA_CAPA_OPS_CRC32C);
+	ADD_CAPA(dma_caps, dev_capa, RTE_DMA_CAPA_OPS_COMPARE);
+	ADD_CAPA(dma_caps, dev_capa, RTE_DMA_CAPA_OPS_DUALCAST);
+	ADD_CAPA(dma_caps, dev_capa, RTE_DMA_CAPA_OPS_DIF);
 	rte_tel_data_add_dict_container(d, "capabilities", dma_caps, 0);
 
 	return 0;
@@ -70,6 +70,11 @@
  *     - rte_dma_copy()
  *     - rte_dma_copy_sg()
  *     - rte_dma_fill()
+ *     - rte_dma_crc32c()
+ *     - rte_dma_compare()
+ *     - rte_dma_compare_pattern()
+ *     - rte_dma_dualcast()
+ *     - rte_dma_dif()
  *     - rte_dma_submit()
  *
  * These APIs could work with different virtual DMA channels which have
@@ -148,6 +153,7 @@
 
 #include <rte_bitops.h>
 #include <rte_common.h>
+#include <rte_compat.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -258,6 +264,12 @@ int16_t rte_dma_next_dev(int16_t start_dev_id);
  * rte_dma_vchan_setup() will fail.
  */
 #define RTE_DMA_CAPA_M2D_AUTO_FREE      RTE_BIT64(7)
+/** Support completion notification through a file descriptor,
+ * so that the application may sleep rather than poll for completions.
+ *
+ * @see rte_dma_intr_fd_get()
+ */
+#define RTE_DMA_CAPA_INTR               RTE_BIT64(8)
 
 /** Support copy operation.
  * This capability start with index of 32, so that it could leave gap between
@@ -268,6 +280,14 @@ int16_t rte_dma_next_dev(int16_t start_dev_id);
 #define RTE_DMA_CAPA_OPS_COPY_SG	RTE_BIT64(33)
 /** Support fill operation. */
 #define RTE_DMA_CAPA_OPS_FILL		RTE_BIT64(34)
+/** Support CRC32C generation operation. */
+#define RTE_DMA_CAPA_OPS_CRC32C		RTE_BIT64(35)
+/** Support memory compare and compare pattern operations. */
+#define RTE_DMA_CAPA_OPS_COMPARE	RTE_BIT64(36)
+/** Support dualcast operation. */
+#define RTE_DMA_CAPA_OPS_DUALCAST	RTE_BIT64(37)
+/** Support T10 DIF insert, strip and check operations. */
+#define RTE_DMA_CAPA_OPS_DIF		RTE_BIT64(38)
 /**@}*/
 
 /**
@@ -685,6 +705,82 @@ enum rte_dma_vchan_status {
 int
 rte_dma_vchan_status(int16_t dev_id, uint16_t vchan, enum rte_dma_vchan_status *status);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the file descriptor signalling completions on a virtual DMA channel.
+ *
+ * The descriptor is an eventfd, which becomes readable when operations
+ * complete while the notification is armed by rte_dma_intr_enable().
+ * It is valid from the vchan setup until the device is closed or configured
+ * again, and may be added to an epoll set.
+ * The application reads it to clear the notification before gathering the
+ * completions with rte_dma_completed() or rte_dma_completed_status().
+ *
+ * Several vchans of a device may share the same descriptor.
+ *
+ * @param dev_id
+ *   The identifier of the device.
+ * @param vchan
+ *   The identifier of virtual DMA channel.
+ *
+ * @return
+ *   - >=0: the file descriptor.
+ *   - -ENOTSUP: the device does not support completion notification.
+ *   - other negative value on failure.
+ *
+ * @see RTE_DMA_CAPA_INTR
+ */
+__rte_experimental
+int rte_dma_intr_fd_get(int16_t dev_id, uint16_t vchan);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Arm the completion notification of a virtual DMA channel.
+ *
+ * Once armed, the file descriptor returned by rte_dma_intr_fd_get() becomes
+ * readable when an operation completes, including the operations enqueued
+ * before arming and not yet complete.
+ * If completed operations are not yet gathered, it may become readable
+ * immediately. Spurious notifications are possible, so the application should
+ * not rely on finding completions after each one.
+ *
+ * The usual pattern is to arm the notification when polling finds no
+ * completion, poll once more to close the race with the device, then sleep
+ * on the descriptor and disarm the notification once woken up.
+ *
+ * @param dev_id
+ *   The identifier of the device.
+ * @param vchan
+ *   The identifier of virtual DMA channel.
+ *
+ * @return
+ *   0 on success. Otherwise negative value is returned.
+ */
+__rte_experimental
+int rte_dma_intr_enable(int16_t dev_id, uint16_t vchan);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Disarm the completion notification of a virtual DMA channel,
+ * for the application to go back to polling.
+ *
+ * @param dev_id
+ *   The identifier of the device.
+ * @param vchan
+ *   The identifier of virtual DMA channel.
+ *
+ * @return
+ *   0 on success. Otherwise negative value is returned.
+ */
+__rte_experimental
+int rte_dma_intr_disable(int16_t dev_id, uint16_t vchan);
+
 /**
  * Dump DMA device info.
  *
@@ -772,6 +868,68 @@ struct rte_dma_sge {
 	uint32_t length; /**< The DMA operation length. */
 };
 
+/**
+ * T10 DIF operation types.
+ *
+ * @see rte_dma_dif
+ */
+enum rte_dma_dif_op {
+	/** Compute and append protection information to each data block. */
+	RTE_DMA_DIF_OP_INSERT,
+	/** Check protection information and remove it from each data block. */
+	RTE_DMA_DIF_OP_STRIP,
+	/** Check protection information of each data block. */
+	RTE_DMA_DIF_OP_CHECK,
+};
+
+/**@{@name DIF flags
+ * @see struct rte_dma_dif_conf::flags
+ */
+/** Do not check guard tag. */
+#define RTE_DMA_DIF_F_NO_GUARD_CHECK	RTE_BIT32(0)
+/** Do not check reference tag. */
+#define RTE_DMA_DIF_F_NO_REF_CHECK	RTE_BIT32(1)
+/** Use the same reference tag for all blocks, instead of incrementing it. */
+#define RTE_DMA_DIF_F_REF_FIXED		RTE_BIT32(2)
+/**@}*/
+
+/**@{@name DIF errors
+ * Result of a DIF strip or check operation.
+ * @see rte_dma_dif
+ */
+/** Guard tag mismatch. */
+#define RTE_DMA_DIF_ERR_GUARD		RTE_BIT32(0)
+/** Application tag mismatch. */
+#define RTE_DMA_DIF_ERR_APP_TAG		RTE_BIT32(1)
+/** Reference tag mismatch. */
+#define RTE_DMA_DIF_ERR_REF_TAG		RTE_BIT32(2)
+/**@}*/
+
+/** Size of the protection information appended to each data block. */
+#define RTE_DMA_DIF_SIZE 8
+
+/**
+ * T10 DIF parameters.
+ *
+ * Protection information made of a 16-bit CRC of the block data (guard tag),
+ * a 16-bit application tag and a 32-bit reference tag, all big endian,
+ * follows each data block.
+ *
+ * @see rte_dma_dif
+ */
+struct rte_dma_dif_conf {
+	/** Size of data blocks, protection information excluded. */
+	uint32_t block_size;
+	/** Reference tag of the first block. */
+	uint32_t ref_tag;
+	/** Application tag. */
+	uint16_t app_tag;
+	/** Bits of the application tag which are checked. */
+	uint16_t app_tag_mask;
+	/** Flags (RTE_DMA_DIF_F_*). */
+	uint32_t flags;
+};
+
 #include "rte_dmadev_core.h"
 #include "rte_dmadev_trace_fp.h"
 
@@ -953,6 +1111,309 @@ rte_dma_fill(int16_t dev_id, uint16_t vchan, uint64_t pattern,
 	return ret;
 }
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enqueue a CRC32C generation operation onto the virtual DMA channel.
+ *
+ * This queues up an operation computing the CRC32C (Castagnoli) of a buffer,
+ * if the 'flags' parameter contains RTE_DMA_OP_FLAG_SUBMIT then trigger
+ * doorbell to begin this operation, otherwise do not trigger doorbell.
+ *
+ * The CRC is computed as by iSCSI, with inverted seed and result, so that
+ * passing the CRC of a buffer as seed gives the CRC of the concatenation of
+ * that buffer with the next one.
+ *
+ * @param dev_id
+ *   The identifier of the device.
+ * @param vchan
+ *   The identifier of virtual DMA channel.
+ * @param src
+ *   The address of the source buffer.
+ * @param length
+ *   The length of the source buffer.
+ * @param seed
+ *   CRC of previous data, 0 if none.
+ * @param[out] crc
+ *   Where to store the CRC. It is written by the time the operation is
+ *   reported successfully completed by rte_dma_completed() or
+ *   rte_dma_completed_status().
+ * @param flags
+ *   An flags for this operation.
+ *   @see RTE_DMA_OP_FLAG_*
+ *
+ * @return
+ *   - 0..UINT16_MAX: index of enqueued job.
+ *   - -ENOSPC: if no space left to enqueue.
+ *   - other values < 0 on failure.
+ */
+__rte_experimental
+static inline int
+rte_dma_crc32c(int16_t dev_id, uint16_t vchan, rte_iova_t src,
+	       uint32_t length, uint32_t seed, uint32_t *crc, uint64_t flags)
+{
+	struct rte_dma_fp_ext_object *obj = &rte_dma_fp_ext_objs[dev_id];
+	int ret;
+
+#ifdef RTE_DMADEV_DEBUG
+	if (!rte_dma_is_valid(dev_id) || length == 0 || crc == NULL)
+		return -EINVAL;
+	if (*obj->crc32c == NULL)
+		return -ENOTSUP;
+#endif
+
+	ret = (*obj->crc32c)(obj->dev_private, vchan, src, length, seed, crc,
+			     flags);
+	rte_dma_trace_crc32c(dev_id, vchan, src, length, seed, flags, ret);
+
+	return ret;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enqueue a memory compare operation onto the virtual DMA channel.
+ *
+ * This queues up an operation comparing two buffers, if the 'flags'
+ * parameter contains RTE_DMA_OP_FLAG_SUBMIT then trigger doorbell to begin
+ * this operation, otherwise do not trigger doorbell.
+ *
+ * Buffers being different is not an operation failure.
+ *
+ * @param dev_id
+ *   The identifier of the device.
+ * @param vchan
+ *   The identifier of virtual DMA channel.
+ * @param src1
+ *   The address of the first buffer.
+ * @param src2
+ *   The address of the second buffer.
+ * @param length
+ *   The length of the buffers.
+ * @param[out] result
+ *   Where to store the result, 0 if buffers are equal, 1 otherwise.
+ *   It is written by the time the operation is reported successfully
+ *   completed by rte_dma_completed() or rte_dma_completed_status().
+ * @param flags
+ *   An flags for this operation.
+ *   @see RTE_DMA_OP_FLAG_*
+ *
+ * @return
+ *   - 0..UINT16_MAX: index of enqueued job.
+ *   - -ENOSPC: if no space left to enqueue.
+ *   - other values < 0 on failure.
+ */
+__rte_experimental
+static inline int
+rte_dma_compare(int16_t dev_id, uint16_t vchan, rte_iova_t src1,
+		rte_iova_t src2, uint32_t length, uint32_t *result,
+		uint64_t flags)
+{
+	struct rte_dma_fp_ext_object *obj = &rte_dma_fp_ext_objs[dev_id];
+	int ret;
+
+#ifdef RTE_DMADEV_DEBUG
+	if (!rte_dma_is_valid(dev_id) || length == 0 || result == NULL)
+		return -EINVAL;
+	if (*obj->compare == NULL)
+		return -ENOTSUP;
+#endif
+
+	ret = (*obj->compare)(obj->dev_private, vchan, src1, src2, length,
+			      result, flags);
+	rte_dma_trace_compare(dev_id, vchan, src1, src2, length, flags, ret);
+
+	return ret;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enqueue a compare pattern operation onto the virtual DMA channel.
+ *
+ * This queues up an operation checking that a buffer is filled with a
+ * pattern, if the 'flags' parameter contains RTE_DMA_OP_FLAG_SUBMIT then
+ * trigger doorbell to begin this operation, otherwise do not trigger doorbell.
+ *
+ * Buffer not matching the pattern is not an operation failure.
+ *
+ * @param dev_id
+ *   The identifier of the device.
+ * @param vchan
+ *   The identifier of virtual DMA channel.
+ * @param pattern
+ *   The pattern the buffer is expected to be filled with, as by rte_dma_fill().
+ * @param src
+ *   The address of the buffer.
+ * @param length
+ *   The length of the buffer.
+ * @param[out] result
+ *   Where to store the result, 0 if the buffer matches, 1 otherwise.
+ *   It is written by the time the operation is reported successfully
+ *   completed by rte_dma_completed() or rte_dma_completed_status().
+ * @param flags
+ *   An flags for this operation.
+ *   @see RTE_DMA_OP_FLAG_*
+ *
+ * @return
+ *   - 0..UINT16_MAX: index of enqueued job.
+ *   - -ENOSPC: if no space left to enqueue.
+ *   - other values < 0 on failure.
+ */
+__rte_experimental
+static inline int
+rte_dma_compare_pattern(int16_t dev_id, uint16_t vchan, uint64_t pattern,
+			rte_iova_t src, uint32_t length, uint32_t *result,
+			uint64_t flags)
+{
+	struct rte_dma_fp_ext_object *obj = &rte_dma_fp_ext_objs[dev_id];
+	int ret;
+
+#ifdef RTE_DMADEV_DEBUG
+	if (!rte_dma_is_valid(dev_id) || length == 0 || result == NULL)
+		return -EINVAL;
+	if (*obj->compare_pattern == NULL)
+		return -ENOTSUP;
+#endif
+
+	ret = (*obj->compare_pattern)(obj->dev_private, vchan, pattern, src,
+				      length, result, flags);
+	rte_dma_trace_compare_pattern(dev_id, vchan, pattern, src, length,
+				      flags, ret);
+
+	return ret;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enqueue a dualcast operation onto the virtual DMA channel.
+ *
+ * This queues up an operation copying a buffer to two destinations at once,
+ * if the 'flags' parameter contains RTE_DMA_OP_FLAG_SUBMIT then trigger
+ * doorbell to begin this operation, otherwise do not trigger doorbell.
+ *
+ * @note Some devices require both destinations to have the same offset within
+ * a 4 KB page.
+ *
+ * @param dev_id
+ *   The identifier of the device.
+ * @param vchan
+ *   The identifier of virtual DMA channel.
+ * @param src
+ *   The address of the source buffer.
+ * @param dst1
+ *   The address of the first destination buffer.
+ * @param dst2
+ *   The address of the second destination buffer.
+ * @param length
+ *   The length of the data to be copied.
+ * @param flags
+ *   An flags for this operation.
+ *   @see RTE_DMA_OP_FLAG_*
+ *
+ * @return
+ *   - 0..UINT16_MAX: index of enqueued job.
+ *   - -ENOSPC: if no space left to enqueue.
+ *   - other values < 0 on failure.
+ */
+__rte_experimental
+static inline int
+rte_dma_dualcast(int16_t dev_id, uint16_t vchan, rte_iova_t src,
+		 rte_iova_t dst1, rte_iova_t dst2, uint32_t length,
+		 uint64_t flags)
+{
+	struct rte_dma_fp_ext_object *obj = &rte_dma_fp_ext_objs[dev_id];
+	int ret;
+
+#ifdef RTE_DMADEV_DEBUG
+	if (!rte_dma_is_valid(dev_id) || length == 0)
+		return -EINVAL;
+	if (*obj->dualcast == NULL)
+		return -ENOTSUP;
+#endif
+
+	ret = (*obj->dualcast)(obj->dev_private, vchan, src, dst1, dst2,
+			       length, flags);
+	rte_dma_trace_dualcast(dev_id, vchan, src, dst1, dst2, length, flags,
+			       ret);
+
+	return ret;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enqueue a T10 DIF operation onto the virtual DMA channel.
+ *
+ * This queues up an operation inserting, stripping or checking protection
+ * information of data blocks, if the 'flags' parameter contains
+ * RTE_DMA_OP_FLAG_SUBMIT then trigger doorbell to begin this operation,
+ * otherwise do not trigger doorbell.
+ *
+ * Protection information not matching is not an operation failure.
+ *
+ * @param dev_id
+ *   The identifier of the device.
+ * @param vchan
+ *   The identifier of virtual DMA channel.
+ * @param op
+ *   The operation type.
+ * @param src
+ *   The address of the source buffer.
+ * @param dst
+ *   The address of the destination buffer, unused by RTE_DMA_DIF_OP_CHECK.
+ * @param length
+ *   The length of the source buffer, a multiple of the block size for insert
+ *   operations, or of the block size plus RTE_DMA_DIF_SIZE for strip and check
+ *   operations.
+ * @param conf
+ *   The DIF parameters, which can be reused as soon as this function returns.
+ * @param[out] result
+ *   Where to store the result of strip and check operations,
+ *   0 if all blocks are correct, or RTE_DMA_DIF_ERR_* flags of the first
+ *   incorrect block. It can be NULL for insert operations.
+ *   It is written by the time the operation is reported successfully
+ *   completed by rte_dma_completed() or rte_dma_completed_status().
+ * @param flags
+ *   An flags for this operation.
+ *   @see RTE_DMA_OP_FLAG_*
+ *
+ * @return
+ *   - 0..UINT16_MAX: index of enqueued job.
+ *   - -ENOSPC: if no space left to enqueue.
+ *   - other values < 0 on failure.
+ */
+__rte_experimental
+static inline int
+rte_dma_dif(int16_t dev_id, uint16_t vchan, enum rte_dma_dif_op op,
+	    rte_iova_t src, rte_iova_t dst, uint32_t length,
+	    const struct rte_dma_dif_conf *conf, uint32_t *result,
+	    uint64_t flags)
+{
+	struct rte_dma_fp_ext_object *obj = &rte_dma_fp_ext_objs[dev_id];
+	int ret;
+
+#ifdef RTE_DMADEV_DEBUG
+	if (!rte_dma_is_valid(dev_id) || length == 0 || conf == NULL ||
+	    (op != RTE_DMA_DIF_OP_INSERT && result == NULL))
+		return -EINVAL;
+	if (*obj->dif == NULL)
+		return -ENOTSUP;
+#endif
+
+	ret = (*obj->dif)(obj->dev_private, vchan, op, src, dst, length, conf,
+			  result, flags);
+	rte_dma_trace_dif(dev_id, vchan, op, src, dst, length, flags, ret);
+
+	return ret;
+}
+
 /**
  * Trigger hardware to begin performing enqueued operations.
  *
@@ -34,6 +34,36 @@ typedef int (*rte_dma_fill_t)(void *dev_private, uint16_t vchan,
 			      uint64_t pattern, rte_iova_t dst,
 			      uint32_t length, uint64_t flags);
 
+/** @internal Used to enqueue a CRC32C generation operation. */
+typedef int (*rte_dma_crc32c_t)(void *dev_private, uint16_t vchan,
+				rte_iova_t src, uint32_t length,
+				uint32_t seed, uint32_t *crc, uint64_t flags);
+
+/** @internal Used to enqueue a memory compare operation. */
+typedef int (*rte_dma_compare_t)(void *dev_private, uint16_t vchan,
+				 rte_iova_t src1, rte_iova_t src2,
+				 uint32_t length, uint32_t *result,
+				 uint64_t flags);
+
+/** @internal Used to enqueue a compare pattern operation. */
+typedef int (*rte_dma_compare_pattern_t)(void *dev_private, uint16_t vchan,
+					 uint64_t pattern, rte_iova_t src,
+					 uint32_t length, uint32_t *result,
+					 uint64_t flags);
+
+/** @internal Used to enqueue a dualcast operation. */
+typedef int (*rte_dma_dualcast_t)(void *dev_private, uint16_t vchan,
+				  rte_iova_t src, rte_iova_t dst1,
+				  rte_iova_t dst2, uint32_t length,
+				  uint64_t flags);
+
+/** @internal Used to enqueue a T10 DIF operation. */
+typedef int (*rte_dma_dif_t)(void *dev_private, uint16_t vchan,
+			     enum rte_dma_dif_op op, rte_iova_t src,
+			     rte_iova_t dst, uint32_t length,
+			     const struct rte_dma_dif_conf *conf,
+			     uint32_t *result, uint64_t flags);
+
 /** @internal Used to trigger hardware to begin working. */
 typedef int (*rte_dma_submit_t)(void *dev_private, uint16_t vchan);
 
@@ -77,4 +107,24 @@ struct __rte_cache_aligned rte_dma_fp_object {
 
 extern struct rte_dma_fp_object *rte_dma_fp_objs;
 
+/**
+ * @internal
+ * Fast-path dmadev data transformation functions, in a separate flat array
+ * so that adding them does not change the size of rte_dma_fp_object.
+ * One entry per dmadev.
+ */
+struct __rte_cache_aligned rte_dma_fp_ext_object {
+	/** PMD-specific private data. The driver should copy
+	 * rte_dma_dev.data->dev_private to this field during initialization.
+	 */
+	void *dev_private;
+	rte_dma_crc32c_t           crc32c;
+	rte_dma_compare_t          compare;
+	rte_dma_compare_pattern_t  compare_pattern;
+	rte_dma_dualcast_t         dualcast;
+	rte_dma_dif_t              dif;
+};
+
+extern struct rte_dma_fp_ext_object *rte_dma_fp_ext_objs;
+
 #endif /* RTE_DMADEV_CORE_H */
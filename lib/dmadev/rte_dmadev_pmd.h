@@ -64,6 +64,15 @@ typedef int (*rte_dma_vchan_status_t)(const struct rte_dma_dev *dev, uint16_t vc
 /** @internal Used to dump internal information. */
 typedef int (*rte_dma_dump_t)(const struct rte_dma_dev *dev, FILE *f);
 
+/** @internal Used to get the completion notification fd of a virtual DMA channel. */
+typedef int (*rte_dma_intr_fd_get_t)(const struct rte_dma_dev *dev, uint16_t vchan);
+
+/** @internal Used to arm the completion notification of a virtual DMA channel. */
+typedef int (*rte_dma_intr_enable_t)(struct rte_dma_dev *dev, uint16_t vchan);
+
+/** @internal Used to disarm the completion notification of a virtual DMA channel. */
+typedef int (*rte_dma_intr_disable_t)(struct rte_dma_dev *dev, uint16_t vchan);
+
 /**
  * DMA device operations function pointer table.
  *
@@ -83,6 +92,10 @@ struct rte_dma_dev_ops {
 
 	rte_dma_vchan_status_t     vchan_status;
 	rte_dma_dump_t             dev_dump;
+
+	rte_dma_intr_fd_get_t      intr_fd_get;
+	rte_dma_intr_enable_t      intr_enable;
+	rte_dma_intr_disable_t     intr_disable;
 };
 
 /**
@@ -131,7 +144,9 @@ struct __rte_cache_aligned rte_dma_dev {
 	/** Functions implemented by PMD. */
 	const struct rte_dma_dev_ops *dev_ops;
 	enum rte_dma_dev_state state; /**< Flag indicating the device state. */
-	uint64_t reserved[2]; /**< Reserved for future fields. */
+	/** Fast-path data transformation functions and related data. */
+	struct rte_dma_fp_ext_object *fp_ext_obj;
+	uint64_t reserved[1]; /**< Reserved for future fields. */
 };
 
 /**
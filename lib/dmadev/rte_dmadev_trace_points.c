@@ -45,6 +45,21 @@ RTE_TRACE_POINT_REGISTER(rte_dma_trace_copy_sg,
 RTE_TRACE_POINT_REGISTER(rte_dma_trace_fill,
 	lib.dmadev.fill)
 
+RTE_TRACE_POINT_REGISTER(rte_dma_trace_crc32c,
+	lib.dmadev.crc32c)
+
+RTE_TRACE_POINT_REGISTER(rte_dma_trace_compare,
+	lib.dmadev.compare)
+
+RTE_TRACE_POINT_REGISTER(rte_dma_trace_compare_pattern,
+	lib.dmadev.compare_pattern)
+
+RTE_TRACE_POINT_REGISTER(rte_dma_trace_dualcast,
+	lib.dmadev.dualcast)
+
+RTE_TRACE_POINT_REGISTER(rte_dma_trace_dif,
+	lib.dmadev.dif)
+
 RTE_TRACE_POINT_REGISTER(rte_dma_trace_submit,
 	lib.dmadev.submit)
 
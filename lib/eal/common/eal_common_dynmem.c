@@ -321,6 +321,7 @@ eal_dynmem_hugepage_init(void)
 				}
 
 				/* mark preallocated pages as unfreeable */
+				eal_memalloc_mark_alloc(pages, cur_pages);
 				for (i = 0; i < cur_pages; i++) {
 					struct rte_memseg *ms = pages[i];
 					ms->flags |=
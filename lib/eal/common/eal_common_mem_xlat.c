@@ -0,0 +1,668 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_errno.h>
+#include <rte_fbarray.h>
+#include <rte_log.h>
+#include <rte_mem_xlat.h>
+#include <rte_memory.h>
+#include <rte_seqcount.h>
+#include <rte_spinlock.h>
+#include <rte_stdatomic.h>
+
+#include "eal_memalloc.h"
+#include "eal_private.h"
+
+#define XLAT_MEM_EVENT_CLB_NAME "eal_mem_xlat_clb"
+
+#define XLAT_L1_SIZE RTE_BIT64(RTE_MEM_XLAT_L1_SHIFT)
+#define XLAT_L2_SIZE RTE_BIT64(RTE_MEM_XLAT_L2_SHIFT)
+#define XLAT_L3_SIZE RTE_BIT64(RTE_MEM_XLAT_L3_SHIFT)
+
+#define XLAT_L1_IDX(va) ((va) >> RTE_MEM_XLAT_L1_SHIFT)
+#define XLAT_L2_IDX(va) \
+	(((va) >> RTE_MEM_XLAT_L2_SHIFT) & (RTE_MEM_XLAT_L2_ENTRIES - 1))
+#define XLAT_L3_IDX(va) \
+	(((va) >> RTE_MEM_XLAT_L3_SHIFT) & (RTE_MEM_XLAT_L3_ENTRIES - 1))
+
+/*
+ * Second level table along with the third level tables ever attached to it.
+ * Third level tables are never freed while the table is in use, because a
+ * lock-free reader may still hold a reference to it. Instead, they are kept
+ * around and reused once the 2M block becomes fragmented again.
+ */
+struct xlat_l2 {
+	struct rte_mem_xlat_l2 pub; /* must be first */
+	RTE_ATOMIC(uint64_t) *l3[RTE_MEM_XLAT_L2_ENTRIES];
+};
+
+RTE_ATOMIC(struct rte_mem_xlat_l2 *) rte_mem_xlat_l1[RTE_MEM_XLAT_L1_ENTRIES];
+
+/* serializes writers, readers are lock-free */
+static rte_spinlock_t xlat_lock = RTE_SPINLOCK_INITIALIZER;
+
+#define IOVA_IDX_MIN_CAP 64
+
+/* VA- and IOVA-contiguous range of memory in the reverse index */
+struct iova_range {
+	rte_iova_t iova;
+	size_t len;
+	uintptr_t va;
+};
+
+/*
+ * IOVA-sorted array of non-overlapping ranges. Readers look it up under
+ * iova_idx_sc and retry if it was modified in the meantime, so they may see
+ * inconsistent data but never go out of bounds, as the capacity of a given
+ * table never changes. When the table needs to grow, a new one is published
+ * and the old one is kept until cleanup, as a reader may still be using it.
+ */
+struct iova_tbl {
+	struct iova_tbl *prev;
+	uint32_t cap;
+	uint32_t n;
+	struct iova_range r[];
+};
+
+static RTE_ATOMIC(struct iova_tbl *) iova_tbl;
+static rte_seqcount_t iova_idx_sc = RTE_SEQCOUNT_INITIALIZER;
+/* cleared when some memory could not be added to the reverse index */
+static RTE_ATOMIC(bool) iova_idx_complete = true;
+
+/* IOVA-contiguous run of memory being added to the table */
+struct xlat_run {
+	uintptr_t va;
+	size_t len;
+	rte_iova_t iova;
+	int ret;
+};
+
+static struct xlat_l2 *
+xlat_l2_get(uintptr_t va, bool alloc)
+{
+	struct xlat_l2 *l2;
+	unsigned int i;
+
+	l2 = (struct xlat_l2 *)rte_atomic_load_explicit(
+			&rte_mem_xlat_l1[XLAT_L1_IDX(va)],
+			rte_memory_order_relaxed);
+	if (l2 != NULL || !alloc)
+		return l2;
+
+	l2 = calloc(1, sizeof(*l2));
+	if (l2 == NULL)
+		return NULL;
+	for (i = 0; i < RTE_DIM(l2->pub.ent); i++)
+		l2->pub.ent[i] = RTE_BAD_IOVA;
+
+	rte_atomic_store_explicit(&rte_mem_xlat_l1[XLAT_L1_IDX(va)],
+			&l2->pub, rte_memory_order_release);
+	return l2;
+}
+
+/*
+ * Make sure the 2M block is described by a third level table, preserving
+ * current translations for the whole block.
+ */
+static RTE_ATOMIC(uint64_t) *
+xlat_l3_get(struct xlat_l2 *l2, unsigned int l2_idx)
+{
+	RTE_ATOMIC(uint64_t) *l3;
+	uint64_t ent;
+	unsigned int i;
+
+	ent = rte_atomic_load_explicit(&l2->pub.ent[l2_idx],
+			rte_memory_order_relaxed);
+	if (ent != RTE_BAD_IOVA && (ent & RTE_MEM_XLAT_F_L3) != 0)
+		return l2->l3[l2_idx];
+
+	l3 = l2->l3[l2_idx];
+	if (l3 == NULL) {
+		l3 = calloc(RTE_MEM_XLAT_L3_ENTRIES, sizeof(*l3));
+		if (l3 == NULL)
+			return NULL;
+		l2->l3[l2_idx] = l3;
+	}
+	/* the table is not visible to readers yet, so relaxed is enough */
+	for (i = 0; i < RTE_MEM_XLAT_L3_ENTRIES; i++)
+		rte_atomic_store_explicit(&l3[i], ent == RTE_BAD_IOVA ?
+				RTE_BAD_IOVA : ent + i * XLAT_L3_SIZE,
+				rte_memory_order_relaxed);
+
+	rte_atomic_store_explicit(&l2->pub.ent[l2_idx],
+			(uintptr_t)l3 | RTE_MEM_XLAT_F_L3,
+			rte_memory_order_release);
+	return l3;
+}
+
+/* index of the first range starting above IOVA */
+static uint32_t
+iova_idx_upper(const struct iova_tbl *tbl, uint32_t n, rte_iova_t iova)
+{
+	uint32_t lo = 0, hi = n;
+
+	while (lo < hi) {
+		uint32_t mid = lo + (hi - lo) / 2;
+
+		if (tbl->r[mid].iova <= iova)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/* make sure there is room for one more range */
+static struct iova_tbl *
+iova_idx_reserve(void)
+{
+	struct iova_tbl *tbl, *new_tbl;
+	uint32_t cap;
+
+	tbl = rte_atomic_load_explicit(&iova_tbl, rte_memory_order_relaxed);
+	if (tbl != NULL && tbl->n < tbl->cap)
+		return tbl;
+
+	cap = tbl == NULL ? IOVA_IDX_MIN_CAP : tbl->cap * 2;
+	new_tbl = malloc(sizeof(*new_tbl) + cap * sizeof(new_tbl->r[0]));
+	if (new_tbl == NULL)
+		return NULL;
+	new_tbl->prev = tbl;
+	new_tbl->cap = cap;
+	new_tbl->n = 0;
+	if (tbl != NULL) {
+		memcpy(new_tbl->r, tbl->r, tbl->n * sizeof(tbl->r[0]));
+		new_tbl->n = tbl->n;
+	}
+	rte_atomic_store_explicit(&iova_tbl, new_tbl, rte_memory_order_release);
+
+	return new_tbl;
+}
+
+static void
+iova_idx_insert(rte_iova_t iova, size_t len, uintptr_t va)
+{
+	struct iova_range *prev, *next;
+	bool merge_prev, merge_next;
+	struct iova_tbl *tbl;
+	uint32_t pos;
+
+	tbl = iova_idx_reserve();
+	if (tbl == NULL) {
+		EAL_LOG(DEBUG, "Cannot grow IOVA index");
+		goto incomplete;
+	}
+
+	pos = iova_idx_upper(tbl, tbl->n, iova);
+	prev = pos > 0 ? &tbl->r[pos - 1] : NULL;
+	next = pos < tbl->n ? &tbl->r[pos] : NULL;
+
+	/* same IOVA mapped twice, only the first mapping is indexed */
+	if ((prev != NULL && prev->iova + prev->len > iova) ||
+			(next != NULL && iova + len > next->iova)) {
+		EAL_LOG(DEBUG, "IOVA 0x%" PRIx64 " len %zu is already mapped",
+				iova, len);
+		goto incomplete;
+	}
+	merge_prev = prev != NULL && prev->iova + prev->len == iova &&
+			prev->va + prev->len == va;
+	merge_next = next != NULL && iova + len == next->iova &&
+			va + len == next->va;
+
+	rte_seqcount_write_begin(&iova_idx_sc);
+	if (merge_prev && merge_next) {
+		prev->len += len + next->len;
+		memmove(next, next + 1, (tbl->n - pos - 1) * sizeof(*next));
+		tbl->n--;
+	} else if (merge_prev) {
+		prev->len += len;
+	} else if (merge_next) {
+		next->iova = iova;
+		next->va = va;
+		next->len += len;
+	} else {
+		memmove(&tbl->r[pos + 1], &tbl->r[pos],
+				(tbl->n - pos) * sizeof(tbl->r[0]));
+		tbl->r[pos].iova = iova;
+		tbl->r[pos].len = len;
+		tbl->r[pos].va = va;
+		tbl->n++;
+	}
+	rte_seqcount_write_end(&iova_idx_sc);
+	return;
+
+incomplete:
+	rte_atomic_store_explicit(&iova_idx_complete, false,
+			rte_memory_order_relaxed);
+}
+
+static void
+iova_idx_remove(rte_iova_t iova, size_t len, uintptr_t va)
+{
+	size_t head, tail;
+	struct iova_range *r;
+	struct iova_tbl *tbl;
+	uint32_t pos;
+
+	tbl = rte_atomic_load_explicit(&iova_tbl, rte_memory_order_relaxed);
+	if (tbl == NULL)
+		return;
+	pos = iova_idx_upper(tbl, tbl->n, iova);
+	if (pos == 0)
+		return;
+	r = &tbl->r[pos - 1];
+	/* not indexed, e.g. because of overlap with another mapping */
+	if (iova + len > r->iova + r->len || r->va + (iova - r->iova) != va)
+		return;
+
+	head = iova - r->iova;
+	tail = r->iova + r->len - (iova + len);
+	if (head != 0 && tail != 0) {
+		/* splitting a range needs one more slot */
+		tbl = iova_idx_reserve();
+		if (tbl == NULL) {
+			/* drop the whole range rather than keep a stale one */
+			EAL_LOG(DEBUG, "Cannot grow IOVA index");
+			rte_atomic_store_explicit(&iova_idx_complete, false,
+					rte_memory_order_relaxed);
+			head = tail = 0;
+			tbl = rte_atomic_load_explicit(&iova_tbl,
+					rte_memory_order_relaxed);
+		}
+		r = &tbl->r[pos - 1];
+	}
+
+	rte_seqcount_write_begin(&iova_idx_sc);
+	if (head == 0 && tail == 0) {
+		memmove(r, r + 1, (tbl->n - pos) * sizeof(*r));
+		tbl->n--;
+	} else if (head == 0) {
+		r->iova += len;
+		r->va += len;
+		r->len = tail;
+	} else if (tail == 0) {
+		r->len = head;
+	} else {
+		memmove(r + 2, r + 1, (tbl->n - pos) * sizeof(*r));
+		r[1].iova = iova + len;
+		r[1].va = va + len;
+		r[1].len = tail;
+		r->len = head;
+		tbl->n++;
+	}
+	rte_seqcount_write_end(&iova_idx_sc);
+}
+
+/*
+ * Look up forward translation, also returning how many bytes starting at VA
+ * are guaranteed to share the same entry. Must be called with xlat_lock held.
+ */
+static rte_iova_t
+xlat_fwd_lookup(uintptr_t va, size_t *contig)
+{
+	const RTE_ATOMIC(uint64_t) *l3;
+	struct xlat_l2 *l2;
+	uint64_t ent;
+
+	l2 = xlat_l2_get(va, false);
+	if (l2 == NULL) {
+		*contig = RTE_ALIGN_FLOOR(va, XLAT_L1_SIZE) + XLAT_L1_SIZE - va;
+		return RTE_BAD_IOVA;
+	}
+	ent = rte_atomic_load_explicit(&l2->pub.ent[XLAT_L2_IDX(va)],
+			rte_memory_order_relaxed);
+	if ((ent & RTE_MEM_XLAT_F_L3) == 0 || ent == RTE_BAD_IOVA) {
+		*contig = RTE_ALIGN_FLOOR(va, XLAT_L2_SIZE) + XLAT_L2_SIZE - va;
+		return ent == RTE_BAD_IOVA ?
+				RTE_BAD_IOVA : ent + (va & (XLAT_L2_SIZE - 1));
+	}
+	l3 = (const RTE_ATOMIC(uint64_t) *)(uintptr_t)(ent & ~RTE_MEM_XLAT_F_L3);
+	ent = rte_atomic_load_explicit(&l3[XLAT_L3_IDX(va)],
+			rte_memory_order_relaxed);
+	*contig = RTE_ALIGN_FLOOR(va, XLAT_L3_SIZE) + XLAT_L3_SIZE - va;
+	return ent == RTE_BAD_IOVA ?
+			RTE_BAD_IOVA : ent + (va & (XLAT_L3_SIZE - 1));
+}
+
+/*
+ * Remove whatever is currently translated in the VA range from the reverse
+ * index. Must be called with xlat_lock held.
+ */
+static void
+xlat_unindex(uintptr_t va, uintptr_t end)
+{
+	struct xlat_run run = { 0 };
+
+	while (va < end) {
+		rte_iova_t iova;
+		size_t contig;
+
+		iova = xlat_fwd_lookup(va, &contig);
+		contig = RTE_MIN(contig, end - va);
+		if (iova != RTE_BAD_IOVA && run.len != 0 &&
+				run.va + run.len == va &&
+				run.iova + run.len == iova) {
+			run.len += contig;
+		} else {
+			if (run.len != 0)
+				iova_idx_remove(run.iova, run.len, run.va);
+			run.len = 0;
+			if (iova != RTE_BAD_IOVA) {
+				run.va = va;
+				run.len = contig;
+				run.iova = iova;
+			}
+		}
+		va += contig;
+	}
+	if (run.len != 0)
+		iova_idx_remove(run.iova, run.len, run.va);
+}
+
+/*
+ * Set forward translation for an IOVA-contiguous VA range, or remove it if
+ * IOVA is RTE_BAD_IOVA. Must be called with xlat_lock held.
+ */
+static int
+xlat_fwd_update(uintptr_t va, size_t len, rte_iova_t iova)
+{
+	uintptr_t start = va, end = va + len;
+	bool set = iova != RTE_BAD_IOVA;
+
+	while (va < end) {
+		uintptr_t blk_start = RTE_ALIGN_FLOOR(va, XLAT_L2_SIZE);
+		uintptr_t blk_end = blk_start + XLAT_L2_SIZE;
+		uintptr_t chunk_end = RTE_MIN(end, blk_end);
+		rte_iova_t cur = set ? iova + (va - start) : RTE_BAD_IOVA;
+		unsigned int l2_idx = XLAT_L2_IDX(va);
+		RTE_ATOMIC(uint64_t) *l3;
+		struct xlat_l2 *l2;
+
+		l2 = xlat_l2_get(va, set);
+		if (l2 == NULL) {
+			if (set) {
+				rte_errno = ENOMEM;
+				return -1;
+			}
+			/* nothing to remove in this 1G block */
+			va = RTE_MIN(end, RTE_ALIGN_FLOOR(va, XLAT_L1_SIZE) +
+					XLAT_L1_SIZE);
+			continue;
+		}
+
+		/* nothing to remove in this 2M block */
+		if (!set && rte_atomic_load_explicit(&l2->pub.ent[l2_idx],
+				rte_memory_order_relaxed) == RTE_BAD_IOVA) {
+			va = chunk_end;
+			continue;
+		}
+
+		/* whole 2M block is covered, store IOVA directly if possible */
+		if (va == blk_start && chunk_end == blk_end &&
+				(!set || (cur & RTE_MEM_XLAT_F_L3) == 0)) {
+			rte_atomic_store_explicit(&l2->pub.ent[l2_idx], cur,
+					rte_memory_order_release);
+			va = chunk_end;
+			continue;
+		}
+
+		l3 = xlat_l3_get(l2, l2_idx);
+		if (l3 == NULL) {
+			/*
+			 * we cannot split the block. when adding, leave the
+			 * block untranslated; when removing, drop translation
+			 * for the whole block - a miss is always safe.
+			 */
+			if (!set) {
+				xlat_unindex(blk_start, blk_end);
+				rte_atomic_store_explicit(&l2->pub.ent[l2_idx],
+						RTE_BAD_IOVA,
+						rte_memory_order_release);
+			}
+			rte_errno = ENOMEM;
+			return -1;
+		}
+		for (; va < chunk_end; va += XLAT_L3_SIZE) {
+			rte_atomic_store_explicit(&l3[XLAT_L3_IDX(va)], cur,
+					rte_memory_order_relaxed);
+			if (set)
+				cur += XLAT_L3_SIZE;
+		}
+	}
+	return 0;
+}
+
+/*
+ * Set translation for an IOVA-contiguous VA range, or remove it if IOVA is
+ * RTE_BAD_IOVA, keeping both the translation table and the reverse index in
+ * sync. Must be called with xlat_lock held.
+ */
+static int
+xlat_update(uintptr_t va, size_t len, rte_iova_t iova)
+{
+	uintptr_t end = va + len;
+
+	if (!rte_is_aligned((void *)va, XLAT_L3_SIZE) ||
+			!rte_is_aligned((void *)end, XLAT_L3_SIZE) ||
+			(uint64_t)(end - 1) >> RTE_MEM_XLAT_VA_BITS) {
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	/* whatever was there before is going away */
+	xlat_unindex(va, end);
+
+	if (xlat_fwd_update(va, len, iova) < 0) {
+		/* do not leave a partially translated range behind */
+		if (iova != RTE_BAD_IOVA)
+			xlat_fwd_update(va, len, RTE_BAD_IOVA);
+		rte_atomic_store_explicit(&iova_idx_complete, false,
+				rte_memory_order_relaxed);
+		return -1;
+	}
+	if (iova != RTE_BAD_IOVA)
+		iova_idx_insert(iova, len, va);
+
+	return 0;
+}
+
+static void
+xlat_run_flush(struct xlat_run *run)
+{
+	if (run->len == 0)
+		return;
+	if (xlat_update(run->va, run->len, run->iova) < 0) {
+		EAL_LOG(DEBUG, "Cannot update translation table for %#" PRIxPTR
+				" len %zu: %s", run->va, run->len,
+				rte_strerror(rte_errno));
+		run->ret = -1;
+	}
+	run->len = 0;
+}
+
+static void
+xlat_run_add(struct xlat_run *run, const struct rte_memseg *ms)
+{
+	uintptr_t va = (uintptr_t)ms->addr;
+
+	/* extend current run if both VA and IOVA are contiguous */
+	if (run->len != 0 && run->va + run->len == va &&
+			(run->iova == RTE_BAD_IOVA ? ms->iova == RTE_BAD_IOVA :
+				run->iova + run->len == ms->iova)) {
+		run->len += ms->len;
+		return;
+	}
+	xlat_run_flush(run);
+	run->va = va;
+	run->len = ms->len;
+	run->iova = ms->iova;
+}
+
+static int
+xlat_add_range(const struct rte_memseg_list *msl, const void *addr, size_t len)
+{
+	struct xlat_run run = { 0 };
+	const void *cur, *end;
+
+	end = RTE_PTR_ADD(addr, len);
+	for (cur = addr; cur < end; cur = RTE_PTR_ADD(cur, msl->page_sz)) {
+		const struct rte_memseg *ms;
+
+		ms = rte_mem_virt2memseg(cur, msl);
+		if (ms == NULL || ms->addr == NULL) {
+			xlat_run_flush(&run);
+			continue;
+		}
+		xlat_run_add(&run, ms);
+	}
+	xlat_run_flush(&run);
+
+	return run.ret;
+}
+
+static int
+xlat_memseg_walk(const struct rte_memseg_list *msl __rte_unused,
+		const struct rte_memseg *ms, void *arg)
+{
+	xlat_run_add(arg, ms);
+	return 0;
+}
+
+static void
+xlat_mem_event_cb(enum rte_mem_event type, const void *addr, size_t len,
+		void *arg __rte_unused)
+{
+	const struct rte_memseg_list *msl;
+
+	rte_spinlock_lock(&xlat_lock);
+	if (type == RTE_MEM_EVENT_FREE) {
+		xlat_update((uintptr_t)addr, len, RTE_BAD_IOVA);
+	} else {
+		msl = rte_mem_virt2memseg_list(addr);
+		if (msl != NULL)
+			xlat_add_range(msl, addr, len);
+	}
+	rte_spinlock_unlock(&xlat_lock);
+}
+
+int
+eal_mem_xlat_add_memseg_list(const struct rte_memseg_list *msl)
+{
+	int ret;
+
+	rte_spinlock_lock(&xlat_lock);
+	ret = xlat_add_range(msl, msl->base_va, msl->len);
+	rte_spinlock_unlock(&xlat_lock);
+
+	return ret;
+}
+
+void *
+rte_mem_xlat_iova2virt(rte_iova_t iova)
+{
+	const struct iova_tbl *tbl;
+	const struct iova_range *r;
+	uint32_t sn, pos;
+	uintptr_t va;
+
+	do {
+		sn = rte_seqcount_read_begin(&iova_idx_sc);
+		va = 0;
+
+		tbl = rte_atomic_load_explicit(&iova_tbl,
+				rte_memory_order_acquire);
+		if (tbl == NULL)
+			continue;
+		pos = iova_idx_upper(tbl, RTE_MIN(tbl->n, tbl->cap), iova);
+		if (pos == 0)
+			continue;
+		r = &tbl->r[pos - 1];
+		if (iova - r->iova < r->len)
+			va = r->va + (iova - r->iova);
+	} while (rte_seqcount_read_retry(&iova_idx_sc, sn));
+
+	return (void *)va;
+}
+
+bool
+eal_mem_xlat_iova_idx_complete(void)
+{
+	return rte_atomic_load_explicit(&iova_idx_complete,
+			rte_memory_order_relaxed);
+}
+
+void
+eal_mem_xlat_del(const void *addr, size_t len)
+{
+	rte_spinlock_lock(&xlat_lock);
+	xlat_update((uintptr_t)addr, len, RTE_BAD_IOVA);
+	rte_spinlock_unlock(&xlat_lock);
+}
+
+int
+eal_mem_xlat_init(void)
+{
+	struct xlat_run run = { 0 };
+
+	/*
+	 * register for memory events first, so that no update can be missed.
+	 * not using the public API, as it refuses to work in legacy mode, and
+	 * we still want to hear about external memory being added.
+	 */
+	if (eal_memalloc_mem_event_callback_register(XLAT_MEM_EVENT_CLB_NAME,
+			xlat_mem_event_cb, NULL) < 0) {
+		EAL_LOG(ERR, "Cannot register memory translation callback");
+		return -1;
+	}
+
+	rte_spinlock_lock(&xlat_lock);
+	rte_memseg_walk_thread_unsafe(xlat_memseg_walk, &run);
+	xlat_run_flush(&run);
+	rte_spinlock_unlock(&xlat_lock);
+
+	/* not fatal, lookups will simply miss */
+	if (run.ret != 0)
+		EAL_LOG(WARNING, "Memory translation table is incomplete");
+
+	return 0;
+}
+
+void
+eal_mem_xlat_cleanup(void)
+{
+	struct iova_tbl *tbl;
+	unsigned int i, j;
+
+	eal_memalloc_mem_event_callback_unregister(XLAT_MEM_EVENT_CLB_NAME,
+			NULL);
+
+	rte_spinlock_lock(&xlat_lock);
+	for (i = 0; i < RTE_MEM_XLAT_L1_ENTRIES; i++) {
+		struct xlat_l2 *l2;
+
+		l2 = (struct xlat_l2 *)rte_atomic_exchange_explicit(
+				&rte_mem_xlat_l1[i], NULL,
+				rte_memory_order_relaxed);
+		if (l2 == NULL)
+			continue;
+		for (j = 0; j < RTE_MEM_XLAT_L2_ENTRIES; j++)
+			free(l2->l3[j]);
+		free(l2);
+	}
+
+	tbl = rte_atomic_exchange_explicit(&iova_tbl, NULL,
+			rte_memory_order_relaxed);
+	while (tbl != NULL) {
+		struct iova_tbl *prev = tbl->prev;
+
+		free(tbl);
+		tbl = prev;
+	}
+	rte_spinlock_unlock(&xlat_lock);
+}
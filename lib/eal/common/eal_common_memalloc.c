@@ -233,6 +233,37 @@ eal_memalloc_mem_event_callback_unregister(const char *name, void *arg)
 	return ret;
 }
 
+void
+eal_memalloc_mark_alloc(struct rte_memseg **ms, int n_segs)
+{
+	int i;
+
+	/* best effort allocations may come as several runs of segments */
+	for (i = 0; i < n_segs; i++) {
+		if (i == 0 || ms[i]->addr !=
+				RTE_PTR_ADD(ms[i - 1]->addr, ms[i - 1]->len))
+			ms[i]->flags |= EAL_MEMSEG_FLAG_ALLOC_START;
+	}
+}
+
+bool
+eal_memalloc_is_alloc_start(const struct rte_memseg_list *msl, int idx)
+{
+	const struct rte_fbarray *arr = &msl->memseg_arr;
+	const struct rte_memseg *ms, *prev;
+
+	if (idx == 0 || idx >= (int)arr->len)
+		return true;
+
+	/* segments are zeroed when freed, so unused ones have no length */
+	ms = rte_fbarray_get(arr, idx);
+	prev = rte_fbarray_get(arr, idx - 1);
+	if (ms->len == 0 || prev->len == 0)
+		return true;
+
+	return (ms->flags & EAL_MEMSEG_FLAG_ALLOC_START) != 0;
+}
+
 void
 eal_memalloc_mem_event_notify(enum rte_mem_event event, const void *start,
 		size_t len)
@@ -17,6 +17,7 @@
 #include <rte_eal_paging.h>
 #include <rte_errno.h>
 #include <rte_log.h>
+#include <rte_mem_xlat.h>
 #ifndef RTE_EXEC_ENV_WINDOWS
 #include <rte_telemetry.h>
 #endif
@@ -26,6 +27,7 @@
 #include "eal_internal_cfg.h"
 #include "eal_memcfg.h"
 #include "eal_options.h"
+#include "malloc_cache.h"
 #include "malloc_elem.h"
 #include "malloc_heap.h"
 
@@ -385,6 +387,11 @@ rte_mem_iova2virt(rte_iova_t iova)
 	const struct internal_config *internal_conf =
 		eal_get_internal_configuration();
 
+	vi.virt = rte_mem_xlat_iova2virt(iova);
+	if (vi.virt != NULL || eal_mem_xlat_iova_idx_complete())
+		return vi.virt;
+
+	/* index is incomplete, fall back to scanning all segments */
 	memset(&vi, 0, sizeof(vi));
 
 	vi.iova = iova;
@@ -996,10 +1003,14 @@ sync_memory(void *va_addr, size_t len, bool attach)
 		ret = -1;
 		goto unlock;
 	}
-	if (attach)
+	if (attach) {
 		ret = rte_fbarray_attach(&msl->memseg_arr);
-	else
+		if (ret == 0)
+			eal_mem_xlat_add_memseg_list(msl);
+	} else {
+		eal_mem_xlat_del(msl->base_va, msl->len);
 		ret = rte_fbarray_detach(&msl->memseg_arr);
+	}
 
 unlock:
 	rte_mcfg_mem_write_unlock();
@@ -1028,6 +1039,10 @@ rte_eal_memory_detach(void)
 	size_t page_sz = rte_mem_page_size();
 	unsigned int i;
 
+	/* give cached elements back to the heaps while they are still mapped */
+	malloc_cache_cleanup();
+	eal_mem_xlat_cleanup();
+
 	if (internal_conf->in_memory == 1)
 		return 0;
 
@@ -1108,6 +1123,9 @@ rte_eal_memory_init(void)
 	if (internal_conf->no_shconf == 0 && rte_eal_memdevice_init() < 0)
 		goto fail;
 
+	if (eal_mem_xlat_init() < 0)
+		goto fail;
+
 	return 0;
 fail:
 	return -1;
@@ -97,6 +97,7 @@ eal_long_options[] = {
 	{OPT_VDEV,              1, NULL, OPT_VDEV_NUM             },
 	{OPT_VFIO_INTR,         1, NULL, OPT_VFIO_INTR_NUM        },
 	{OPT_VFIO_VF_TOKEN,     1, NULL, OPT_VFIO_VF_TOKEN_NUM    },
+	{OPT_VFIO_IOMMUFD,      0, NULL, OPT_VFIO_IOMMUFD_NUM     },
 	{OPT_VMWARE_TSC_MAP,    0, NULL, OPT_VMWARE_TSC_MAP_NUM   },
 	{OPT_LEGACY_MEM,        0, NULL, OPT_LEGACY_MEM_NUM       },
 	{OPT_SINGLE_FILE_SEGMENTS, 0, NULL, OPT_SINGLE_FILE_SEGMENTS_NUM},
@@ -105,6 +106,8 @@ eal_long_options[] = {
 	{OPT_NO_TELEMETRY,      0, NULL, OPT_NO_TELEMETRY_NUM     },
 	{OPT_FORCE_MAX_SIMD_BITWIDTH, 1, NULL, OPT_FORCE_MAX_SIMD_BITWIDTH_NUM},
 	{OPT_HUGE_WORKER_STACK, 2, NULL, OPT_HUGE_WORKER_STACK_NUM     },
+	{OPT_MALLOC_LCORE_CACHE, 2, NULL, OPT_MALLOC_LCORE_CACHE_NUM   },
+	{OPT_HUGE_PREFAULT,     2, NULL, OPT_HUGE_PREFAULT_NUM        },
 
 	{0,                     0, NULL, 0                        }
 };
@@ -357,6 +360,7 @@ eal_reset_internal_config(struct internal_config *internal_cfg)
 	internal_cfg->vfio_intr_mode = RTE_INTR_MODE_NONE;
 	memset(internal_cfg->vfio_vf_token, 0,
 			sizeof(internal_cfg->vfio_vf_token));
+	internal_cfg->vfio_iommufd = 0;
 
 #ifdef RTE_LIBEAL_USE_HPET
 	internal_cfg->no_hpet = 0;
@@ -371,6 +375,8 @@ eal_reset_internal_config(struct internal_config *internal_cfg)
 	internal_cfg->init_complete = 0;
 	internal_cfg->max_simd_bitwidth.bitwidth = RTE_VECT_DEFAULT_SIMD_BITWIDTH;
 	internal_cfg->max_simd_bitwidth.forced = 0;
+	internal_cfg->malloc_lcore_cache_size = 0;
+	internal_cfg->huge_prefault_threads = 0;
 }
 
 static int
@@ -1517,6 +1523,35 @@ eal_parse_simd_bitwidth(const char *arg)
 	return 0;
 }
 
+/* per-lcore malloc cache size used when no size is given, in kilobytes */
+#define MALLOC_LCORE_CACHE_DEFAULT_KB 256
+
+static int
+eal_parse_malloc_lcore_cache(const char *arg)
+{
+	char *end;
+	unsigned long size;
+	struct internal_config *internal_conf =
+		eal_get_internal_configuration();
+
+	if (arg == NULL || arg[0] == '\0') {
+		internal_conf->malloc_lcore_cache_size =
+				MALLOC_LCORE_CACHE_DEFAULT_KB * 1024;
+		return 0;
+	}
+
+	errno = 0;
+	size = strtoul(arg, &end, 10);
+
+	/* check for errors */
+	if (errno != 0 || end == NULL || *end != '\0' || size == 0 ||
+			size >= (size_t)-1 / 1024)
+		return -1;
+
+	internal_conf->malloc_lcore_cache_size = size * 1024;
+	return 0;
+}
+
 static int
 eal_parse_base_virtaddr(const char *arg)
 {
@@ -1942,6 +1977,13 @@ eal_parse_common_option(int opt, const char *optarg,
 			return -1;
 		}
 		break;
+	case OPT_MALLOC_LCORE_CACHE_NUM:
+		if (eal_parse_malloc_lcore_cache(optarg) < 0) {
+			EAL_LOG(ERR, "invalid parameter for --"
+					OPT_MALLOC_LCORE_CACHE);
+			return -1;
+		}
+		break;
 
 	/* don't know what to do, leave this to caller */
 	default:
@@ -2105,6 +2147,12 @@ eal_check_common_options(struct internal_config *internal_cfg)
 			"be specified together with --"OPT_NO_HUGE);
 		return -1;
 	}
+	if (internal_cfg->no_hugetlbfs &&
+			internal_cfg->huge_prefault_threads != 0) {
+		EAL_LOG(ERR, "Option --"OPT_HUGE_PREFAULT" cannot "
+			"be specified together with --"OPT_NO_HUGE);
+		return -1;
+	}
 	if (internal_conf->force_socket_limits && internal_conf->legacy_mem) {
 		EAL_LOG(ERR, "Option --"OPT_SOCKET_LIMIT
 			" is only supported in non-legacy memory mode");
@@ -2253,6 +2301,9 @@ eal_common_usage(void)
 	       "  --"OPT_TELEMETRY"   Enable telemetry support (on by default)\n"
 	       "  --"OPT_NO_TELEMETRY"   Disable telemetry support\n"
 	       "  --"OPT_FORCE_MAX_SIMD_BITWIDTH" Force the max SIMD bitwidth\n"
+	       "  --"OPT_MALLOC_LCORE_CACHE"[=size]\n"
+	       "                      Cache small rte_malloc objects per lcore,\n"
+	       "                      up to size kilobytes per lcore (256 by default)\n"
 	       "\nEAL options for DEBUG use only:\n"
 	       "  --"OPT_HUGE_UNLINK"[=existing|always|never]\n"
 	       "                      When to unlink files in hugetlbfs\n"
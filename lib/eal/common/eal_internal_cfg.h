@@ -80,6 +80,10 @@ struct internal_config {
 	 */
 	volatile unsigned match_allocations;
 	/**< true to free hugepages exactly as allocated */
+	volatile unsigned free_alloc_units;
+	/**< true to only free whole allocations of hugepages, as DMA mappings
+	 * follow them.
+	 */
 	volatile unsigned single_file_segments;
 	/**< true if storing all pages within single files (per-page-size,
 	 * per-node) non-legacy mode only.
@@ -89,6 +93,8 @@ struct internal_config {
 	volatile enum rte_intr_mode vfio_intr_mode;
 	/** the shared VF token for VFIO-PCI bound PF and VFs devices */
 	rte_uuid_t vfio_vf_token;
+	/** true to set up VFIO devices through iommufd */
+	volatile unsigned vfio_iommufd;
 	char *hugefile_prefix;      /**< the base filename of hugetlbfs files */
 	char *hugepage_dir;         /**< specific hugetlbfs directory to use */
 	char *user_mbuf_pool_ops_name;
@@ -103,6 +109,10 @@ struct internal_config {
 	struct simd_bitwidth max_simd_bitwidth;
 	/**< max simd bitwidth path to use */
 	size_t huge_worker_stack_size; /**< worker thread stack size */
+	size_t malloc_lcore_cache_size;
+	/**< per-lcore malloc cache size in bytes, 0 if disabled */
+	unsigned int huge_prefault_threads;
+	/**< threads faulting in hugepages at init, 0 to use main thread only */
 };
 
 void eal_reset_internal_config(struct internal_config *internal_cfg);
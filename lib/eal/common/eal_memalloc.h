@@ -28,6 +28,27 @@ int
 eal_memalloc_alloc_seg_bulk(struct rte_memseg **ms, int n_segs, size_t page_sz,
 		int socket, bool exact);
 
+/*
+ * Internal memseg flag, set on the first segment of memory allocated in one
+ * go. Memory is freed in such whole allocations if free_alloc_units is set
+ * in internal config.
+ */
+#define EAL_MEMSEG_FLAG_ALLOC_START RTE_BIT32(31)
+
+/*
+ * Mark `n_segs` segments allocated in one go, so that they can be freed
+ * together.
+ */
+void
+eal_memalloc_mark_alloc(struct rte_memseg **ms, int n_segs);
+
+/*
+ * Check if segment `idx` of memseg list `msl` starts an allocation, i.e. if
+ * memory can be freed up to it without splitting an allocation.
+ */
+bool
+eal_memalloc_is_alloc_start(const struct rte_memseg_list *msl, int idx);
+
 /*
  * Deallocate segment
  */
@@ -90,6 +111,18 @@ eal_memalloc_set_seg_list_fd(int list_idx, int fd);
 int
 eal_memalloc_get_seg_fd_offset(int list_idx, int seg_idx, size_t *offset);
 
+/*
+ * Call `fn` for each of `n` items from several threads, pinned to CPUs of NUMA
+ * node `socket` and preferring memory of that node, so that hugepages can be
+ * faulted in parallel at init time. `fn` must catch SIGBUS itself. Returns 0
+ * once all items have been processed, or -1 if parallel page population is
+ * disabled or not possible, in which case nothing has been done and the caller
+ * is expected to process the items on its own.
+ */
+int
+eal_memalloc_prefault_run(int socket, unsigned int n,
+		void (*fn)(unsigned int idx, void *arg), void *arg);
+
 int
 eal_memalloc_init(void)
 	__rte_shared_locks_required(rte_mcfg_mem_get_lock());
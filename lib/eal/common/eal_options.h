@@ -71,6 +71,8 @@ enum {
 	OPT_VFIO_INTR_NUM,
 #define OPT_VFIO_VF_TOKEN     "vfio-vf-token"
 	OPT_VFIO_VF_TOKEN_NUM,
+#define OPT_VFIO_IOMMUFD      "vfio-iommufd"
+	OPT_VFIO_IOMMUFD_NUM,
 #define OPT_VMWARE_TSC_MAP    "vmware-tsc-map"
 	OPT_VMWARE_TSC_MAP_NUM,
 #define OPT_LEGACY_MEM    "legacy-mem"
@@ -89,6 +91,10 @@ enum {
 	OPT_FORCE_MAX_SIMD_BITWIDTH_NUM,
 #define OPT_HUGE_WORKER_STACK  "huge-worker-stack"
 	OPT_HUGE_WORKER_STACK_NUM,
+#define OPT_MALLOC_LCORE_CACHE "malloc-lcore-cache"
+	OPT_MALLOC_LCORE_CACHE_NUM,
+#define OPT_HUGE_PREFAULT     "huge-prefault"
+	OPT_HUGE_PREFAULT_NUM,
 
 	OPT_LONG_MAX_NUM
 };
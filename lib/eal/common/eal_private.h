@@ -119,6 +119,59 @@ int rte_eal_memseg_init(void);
 int rte_eal_memory_init(void)
 	__rte_shared_locks_required(rte_mcfg_mem_get_lock());
 
+/**
+ * Initialize memory translation table from current memory layout, and
+ * subscribe to memory hotplug events to keep it up to date.
+ *
+ * This function is private to EAL.
+ *
+ * @return
+ *   0 on success, negative on error
+ */
+int eal_mem_xlat_init(void);
+
+/**
+ * Release memory translation table.
+ *
+ * This function is private to EAL.
+ */
+void eal_mem_xlat_cleanup(void);
+
+/**
+ * Add translations for all memory segments of a memseg list.
+ *
+ * This function is private to EAL.
+ *
+ * @param msl
+ *   Memseg list to add.
+ * @return
+ *   0 on success, negative on error
+ */
+int eal_mem_xlat_add_memseg_list(const struct rte_memseg_list *msl);
+
+/**
+ * Remove translations for a virtual address range.
+ *
+ * This function is private to EAL.
+ *
+ * @param addr
+ *   Start of the area.
+ * @param len
+ *   Length of the area.
+ */
+void eal_mem_xlat_del(const void *addr, size_t len);
+
+/**
+ * Check whether all memory known to EAL made it into the IOVA index.
+ *
+ * This function is private to EAL.
+ *
+ * @return
+ *   false if some memory could not be indexed, and a miss in the index
+ *   does not guarantee that the IOVA is unknown to EAL.
+ */
+bool eal_mem_xlat_iova_idx_complete(void);
+
 /**
  * Configure timers
  *
@@ -0,0 +1,347 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_bitops.h>
+#include <rte_branch_prediction.h>
+#include <rte_common.h>
+#include <rte_eal_memconfig.h>
+#include <rte_lcore.h>
+#include <rte_stdatomic.h>
+
+#include "eal_internal_cfg.h"
+#include "eal_memcfg.h"
+#include "eal_private.h"
+#include "malloc_cache.h"
+#include "malloc_elem.h"
+#include "malloc_heap.h"
+
+/*
+ * Per-lcore cache of small malloc elements.
+ *
+ * Each lcore keeps a stack of elements per power-of-two size class, taken
+ * from the heap of its own NUMA node. Small allocations and frees are served
+ * from the stack without taking the heap lock. The heap is only visited to
+ * refill an empty stack or to flush half of a full one, and in both cases a
+ * batch of elements is moved under a single lock.
+ *
+ * Cached elements are kept in ELEM_CACHED state, so the heap never merges
+ * them with their neighbours, and freeing a cached element is still caught
+ * as a double free.
+ */
+
+#define MALLOC_CACHE_MIN_SHIFT 6 /* 64 bytes */
+#define MALLOC_CACHE_MAX_SHIFT 12 /* 4 kilobytes */
+#define MALLOC_CACHE_NUM_CLASSES \
+	(MALLOC_CACHE_MAX_SHIFT - MALLOC_CACHE_MIN_SHIFT + 1)
+/* maximum number of elements held per size class */
+#define MALLOC_CACHE_MAX_OBJS 64
+
+struct malloc_cache_class {
+	unsigned int len; /**< number of cached elements */
+	unsigned int size; /**< maximum number of cached elements */
+	struct malloc_elem *objs[MALLOC_CACHE_MAX_OBJS];
+};
+
+struct __rte_cache_aligned malloc_lcore_cache {
+	struct malloc_heap *heap; /**< heap elements come from, NULL if none */
+	bool ready; /**< true once heap has been looked up */
+	/* written by the owning lcore only, read when collecting heap stats */
+	RTE_ATOMIC(unsigned int) count; /**< number of cached elements */
+	RTE_ATOMIC(size_t) bytes; /**< total size of cached elements */
+	struct malloc_cache_class cls[MALLOC_CACHE_NUM_CLASSES];
+};
+
+static struct malloc_lcore_cache *lcore_caches;
+static size_t cache_limit;
+static void *lcore_cb;
+
+static void
+cache_stats_add(struct malloc_lcore_cache *lc, unsigned int count,
+		size_t bytes)
+{
+	rte_atomic_store_explicit(&lc->count, rte_atomic_load_explicit(
+			&lc->count, rte_memory_order_relaxed) + count,
+			rte_memory_order_relaxed);
+	rte_atomic_store_explicit(&lc->bytes, rte_atomic_load_explicit(
+			&lc->bytes, rte_memory_order_relaxed) + bytes,
+			rte_memory_order_relaxed);
+}
+
+static void
+cache_stats_sub(struct malloc_lcore_cache *lc, unsigned int count,
+		size_t bytes)
+{
+	rte_atomic_store_explicit(&lc->count, rte_atomic_load_explicit(
+			&lc->count, rte_memory_order_relaxed) - count,
+			rte_memory_order_relaxed);
+	rte_atomic_store_explicit(&lc->bytes, rte_atomic_load_explicit(
+			&lc->bytes, rte_memory_order_relaxed) - bytes,
+			rte_memory_order_relaxed);
+}
+
+/* get cache of the calling thread, or NULL if it cannot use one */
+static struct malloc_lcore_cache *
+cache_get(void)
+{
+	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
+	unsigned int lcore_id = rte_lcore_id();
+	struct malloc_lcore_cache *lc;
+	int heap_id;
+
+	if (unlikely(lcore_id == LCORE_ID_ANY))
+		return NULL;
+
+	lc = &lcore_caches[lcore_id];
+	if (unlikely(!lc->ready)) {
+		/* threads not bound to a single socket are not cached */
+		heap_id = malloc_socket_to_heap_id(rte_socket_id());
+		lc->heap = heap_id < 0 ? NULL : &mcfg->malloc_heaps[heap_id];
+		lc->ready = true;
+	}
+
+	return lc->heap == NULL ? NULL : lc;
+}
+
+/* return n oldest elements of a size class to the heap */
+static void
+cache_flush(struct malloc_lcore_cache *lc, struct malloc_cache_class *cls,
+		unsigned int n)
+{
+	size_t bytes = 0;
+	unsigned int i;
+
+	for (i = 0; i < n; i++) {
+		bytes += cls->objs[i]->size;
+		cls->objs[i]->state = ELEM_BUSY;
+	}
+	/* update stats first, so that cached count never exceeds heap's */
+	cache_stats_sub(lc, n, bytes);
+
+	if (malloc_heap_free_bulk(lc->heap, cls->objs, n) < 0)
+		EAL_LOG(ERR, "Error: Invalid memory in malloc cache");
+
+	cls->len -= n;
+	memmove(&cls->objs[0], &cls->objs[n], cls->len * sizeof(cls->objs[0]));
+}
+
+static void
+cache_flush_all(struct malloc_lcore_cache *lc)
+{
+	unsigned int i;
+
+	if (lc->heap != NULL) {
+		for (i = 0; i < MALLOC_CACHE_NUM_CLASSES; i++)
+			if (lc->cls[i].len != 0)
+				cache_flush(lc, &lc->cls[i], lc->cls[i].len);
+	}
+
+	/* lcore ID may be reused by a thread running on another socket */
+	lc->heap = NULL;
+	lc->ready = false;
+}
+
+void *
+malloc_cache_alloc(size_t size, unsigned int align, int socket)
+{
+	struct malloc_lcore_cache *lc;
+	struct malloc_cache_class *cls;
+	struct malloc_elem *elem;
+	size_t bytes = 0;
+	unsigned int idx, i, n;
+
+	if (lcore_caches == NULL ||
+			size > RTE_BIT64(MALLOC_CACHE_MAX_SHIFT) ||
+			align > RTE_CACHE_LINE_SIZE)
+		return NULL;
+
+	lc = cache_get();
+	if (lc == NULL)
+		return NULL;
+
+	/* only local heap is cached */
+	if (socket != SOCKET_ID_ANY &&
+			(unsigned int)socket != lc->heap->socket_id)
+		return NULL;
+
+	size = RTE_MAX(RTE_CACHE_LINE_ROUNDUP(size),
+			RTE_BIT64(MALLOC_CACHE_MIN_SHIFT));
+	idx = rte_log2_u64(size) - MALLOC_CACHE_MIN_SHIFT;
+	cls = &lc->cls[idx];
+
+	if (unlikely(cls->len == 0)) {
+		if (cls->size == 0)
+			return NULL;
+
+		/* let the caller grow the heap if it has run out of memory */
+		n = malloc_heap_alloc_bulk(lc->heap,
+				RTE_BIT64(idx + MALLOC_CACHE_MIN_SHIFT),
+				cls->objs, (cls->size + 1) / 2);
+		if (n == 0)
+			return NULL;
+
+		for (i = 0; i < n; i++) {
+			cls->objs[i]->state = ELEM_CACHED;
+			bytes += cls->objs[i]->size;
+		}
+		cls->len = n;
+		cache_stats_add(lc, n, bytes);
+	}
+
+	elem = cls->objs[--cls->len];
+	elem->state = ELEM_BUSY;
+	cache_stats_sub(lc, 1, elem->size);
+
+	return RTE_PTR_ADD(elem, MALLOC_ELEM_HEADER_LEN + elem->pad);
+}
+
+int
+malloc_cache_free(struct malloc_elem *elem)
+{
+	struct malloc_lcore_cache *lc;
+	struct malloc_cache_class *cls;
+	size_t size, bytes;
+	unsigned int idx;
+
+	if (lcore_caches == NULL)
+		return -1;
+
+	lc = cache_get();
+	if (lc == NULL)
+		return -1;
+
+	/* let the heap deal with anything unusual, including errors */
+	if (!malloc_elem_cookies_ok(elem) || elem->state != ELEM_BUSY ||
+			elem->heap != lc->heap)
+		return -1;
+
+	/* cache element in the largest size class it can satisfy */
+	size = elem->size - elem->pad - MALLOC_ELEM_OVERHEAD;
+	if (size < RTE_BIT64(MALLOC_CACHE_MIN_SHIFT) ||
+			size >= RTE_BIT64(MALLOC_CACHE_MAX_SHIFT + 1))
+		return -1;
+	idx = rte_fls_u64(size) - 1 - MALLOC_CACHE_MIN_SHIFT;
+	cls = &lc->cls[idx];
+	if (cls->size == 0)
+		return -1;
+
+	bytes = rte_atomic_load_explicit(&lc->bytes, rte_memory_order_relaxed);
+	if (unlikely(cls->len == cls->size ||
+			bytes + elem->size > cache_limit)) {
+		if (cls->len != 0)
+			cache_flush(lc, cls, (cls->len + 1) / 2);
+		/* other size classes may be holding the memory */
+		bytes = rte_atomic_load_explicit(&lc->bytes,
+				rte_memory_order_relaxed);
+		if (bytes + elem->size > cache_limit)
+			return -1;
+	}
+
+	elem->state = ELEM_CACHED;
+	/* user data is still there, rte_zmalloc() will have to clear it */
+	elem->dirty = 1;
+	cls->objs[cls->len++] = elem;
+	cache_stats_add(lc, 1, elem->size);
+
+	return 0;
+}
+
+void
+malloc_cache_get_stats(const struct malloc_heap *heap, unsigned int *count,
+		size_t *bytes)
+{
+	const struct malloc_lcore_cache *lc;
+	unsigned int lcore_id;
+
+	*count = 0;
+	*bytes = 0;
+
+	if (lcore_caches == NULL)
+		return;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		lc = &lcore_caches[lcore_id];
+		if (lc->heap != heap)
+			continue;
+		*count += rte_atomic_load_explicit(&lc->count,
+				rte_memory_order_relaxed);
+		*bytes += rte_atomic_load_explicit(&lc->bytes,
+				rte_memory_order_relaxed);
+	}
+}
+
+static void
+cache_lcore_uninit(unsigned int lcore_id, void *arg)
+{
+	struct malloc_lcore_cache *caches = arg;
+
+	cache_flush_all(&caches[lcore_id]);
+}
+
+int
+malloc_cache_init(void)
+{
+	const struct internal_config *internal_conf =
+		eal_get_internal_configuration();
+	unsigned int lcore_id, i;
+	size_t class_limit;
+
+	cache_limit = internal_conf->malloc_lcore_cache_size;
+	if (cache_limit == 0)
+		return 0;
+
+#if defined(RTE_MALLOC_DEBUG) || defined(RTE_MALLOC_ASAN)
+	EAL_LOG(WARNING, "Malloc lcore cache is not supported in debug builds, disabling");
+	return 0;
+#endif
+
+	lcore_caches = calloc(RTE_MAX_LCORE, sizeof(*lcore_caches));
+	if (lcore_caches == NULL) {
+		EAL_LOG(ERR, "Cannot allocate malloc lcore caches");
+		return -1;
+	}
+
+	/* split the limit evenly between size classes */
+	class_limit = cache_limit / MALLOC_CACHE_NUM_CLASSES;
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		for (i = 0; i < MALLOC_CACHE_NUM_CLASSES; i++) {
+			lcore_caches[lcore_id].cls[i].size = RTE_MIN(
+				class_limit >> (i + MALLOC_CACHE_MIN_SHIFT),
+				(size_t)MALLOC_CACHE_MAX_OBJS);
+		}
+	}
+
+	/* caches are flushed when lcore goes away */
+	lcore_cb = rte_lcore_callback_register("malloc_cache", NULL,
+			cache_lcore_uninit, lcore_caches);
+	if (lcore_cb == NULL) {
+		EAL_LOG(ERR, "Cannot register malloc lcore cache callback");
+		free(lcore_caches);
+		lcore_caches = NULL;
+		return -1;
+	}
+
+	EAL_LOG(DEBUG, "Malloc lcore cache enabled, %zu kB per lcore",
+			cache_limit / 1024);
+	return 0;
+}
+
+void
+malloc_cache_cleanup(void)
+{
+	struct malloc_lcore_cache *lc = lcore_caches;
+
+	if (lc == NULL)
+		return;
+
+	/* stop caching, then return everything to the heaps */
+	lcore_caches = NULL;
+	rte_lcore_callback_unregister(lcore_cb);
+	lcore_cb = NULL;
+	free(lc);
+}
@@ -0,0 +1,30 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#ifndef MALLOC_CACHE_H
+#define MALLOC_CACHE_H
+
+#include <stddef.h>
+
+/* forward declarations */
+struct malloc_elem;
+struct malloc_heap;
+
+void *
+malloc_cache_alloc(size_t size, unsigned int align, int socket);
+
+int
+malloc_cache_free(struct malloc_elem *elem);
+
+void
+malloc_cache_get_stats(const struct malloc_heap *heap, unsigned int *count,
+		size_t *bytes);
+
+int
+malloc_cache_init(void);
+
+void
+malloc_cache_cleanup(void);
+
+#endif /* MALLOC_CACHE_H */
@@ -17,7 +17,8 @@ struct malloc_heap;
 enum elem_state {
 	ELEM_FREE = 0,
 	ELEM_BUSY,
-	ELEM_PAD  /* element is a padding-only header */
+	ELEM_PAD,  /* element is a padding-only header */
+	ELEM_CACHED /* element is held in a per-lcore cache */
 };
 
 struct __rte_cache_aligned malloc_elem {
@@ -32,7 +33,10 @@ struct __rte_cache_aligned malloc_elem {
 	/** Element state, @c dirty and @c pad validity depends on it. */
 	/* An extra bit is needed to represent enum elem_state as signed int. */
 	enum elem_state state : 3;
-	/** If state == ELEM_FREE: the memory is not filled with zeroes. */
+	/**
+	 * If state == ELEM_FREE or ELEM_CACHED:
+	 * the memory is not filled with zeroes.
+	 */
 	uint32_t dirty : 1;
 	/** Reserved for future use. */
 	uint32_t reserved : 28;
@@ -23,6 +23,7 @@
 #include "eal_memalloc.h"
 #include "eal_memcfg.h"
 #include "eal_private.h"
+#include "malloc_cache.h"
 #include "malloc_elem.h"
 #include "malloc_heap.h"
 #include "malloc_mp.h"
@@ -321,6 +322,7 @@ alloc_pages_on_heap(struct malloc_heap *heap, uint64_t pg_sz, size_t elt_size,
 
 	map_addr = ms[0]->addr;
 	msl = rte_mem_virt2memseg_list(map_addr);
+	eal_memalloc_mark_alloc(ms, n_segs);
 
 	/* check if we wanted contiguous memory but didn't get it */
 	if (contig && !eal_memalloc_is_contig(msl, map_addr, alloc_sz)) {
@@ -773,6 +775,31 @@ malloc_heap_alloc(const char *type, size_t size, int socket_arg,
 	return NULL;
 }
 
+/*
+ * Allocate up to n elements of the same size from a heap, taking the heap
+ * lock only once. Unlike malloc_heap_alloc(), this never asks the system for
+ * more memory, so fewer than n elements may be returned.
+ */
+unsigned int
+malloc_heap_alloc_bulk(struct malloc_heap *heap, size_t size,
+		struct malloc_elem *elems[], unsigned int n)
+{
+	unsigned int i;
+	void *ptr;
+
+	rte_spinlock_lock(&(heap->lock));
+
+	for (i = 0; i < n; i++) {
+		ptr = heap_alloc(heap, NULL, size, 0, 1, 0, false);
+		if (ptr == NULL)
+			break;
+		elems[i] = malloc_elem_from_data(ptr);
+	}
+
+	rte_spinlock_unlock(&(heap->lock));
+	return i;
+}
+
 static void *
 heap_alloc_biggest_on_heap_id(const char *type, unsigned int heap_id,
 		unsigned int flags, size_t align, bool contig)
@@ -861,10 +888,13 @@ malloc_heap_free_pages(void *aligned_start, size_t aligned_len)
 	return 0;
 }
 
-int
-malloc_heap_free(struct malloc_elem *elem)
+/*
+ * Return an element to the heap, and give back to the system any pages that
+ * are no longer in use as a result. Must be called with heap lock held.
+ */
+static int
+heap_free(struct malloc_heap *heap, struct malloc_elem *elem)
 {
-	struct malloc_heap *heap;
 	void *start, *aligned_start, *end, *aligned_end;
 	size_t len, aligned_len, page_sz;
 	struct rte_memseg_list *msl;
@@ -874,18 +904,11 @@ malloc_heap_free(struct malloc_elem *elem)
 	const struct internal_config *internal_conf =
 		eal_get_internal_configuration();
 
-	if (!malloc_elem_cookies_ok(elem) || elem->state != ELEM_BUSY)
-		return -1;
-
 	asan_clear_redzone(elem);
 
-	/* elem may be merged with previous element, so keep heap address */
-	heap = elem->heap;
 	msl = elem->msl;
 	page_sz = (size_t)msl->page_sz;
 
-	rte_spinlock_lock(&(heap->lock));
-
 	void *asan_ptr = RTE_PTR_ADD(elem, MALLOC_ELEM_HEADER_LEN + elem->pad);
 	size_t asan_data_len = elem->size - MALLOC_ELEM_OVERHEAD - elem->pad;
 
@@ -983,6 +1006,29 @@ malloc_heap_free(struct malloc_elem *elem)
 		n_segs--;
 	}
 
+	/* DMA mappings may follow allocations, so do not split them */
+	if (internal_conf->free_alloc_units) {
+		int start_idx, end_idx;
+
+		start_idx = RTE_PTR_DIFF(aligned_start, msl->base_va) / page_sz;
+		end_idx = start_idx + n_segs;
+		while (start_idx < end_idx &&
+				!eal_memalloc_is_alloc_start(msl, start_idx))
+			start_idx++;
+		while (end_idx > start_idx &&
+				!eal_memalloc_is_alloc_start(msl, end_idx))
+			end_idx--;
+		if (start_idx == end_idx)
+			goto free_unlock;
+
+		aligned_start = RTE_PTR_ADD(msl->base_va,
+				(size_t)start_idx * page_sz);
+		aligned_end = RTE_PTR_ADD(msl->base_va,
+				(size_t)end_idx * page_sz);
+		aligned_len = RTE_PTR_DIFF(aligned_end, aligned_start);
+		n_segs = end_idx - start_idx;
+	}
+
 	/* now we can finally free us some pages */
 
 	rte_mcfg_mem_write_lock();
@@ -1078,6 +1124,54 @@ malloc_heap_free(struct malloc_elem *elem)
 			asan_set_zone(aligned_trailer, MALLOC_ELEM_TRAILER_LEN, 0x00);
 	}
 
+	return ret;
+}
+
+int
+malloc_heap_free(struct malloc_elem *elem)
+{
+	struct malloc_heap *heap;
+	int ret;
+
+	if (!malloc_elem_cookies_ok(elem) || elem->state != ELEM_BUSY)
+		return -1;
+
+	/* elem may be merged with previous element, so keep heap address */
+	heap = elem->heap;
+
+	rte_spinlock_lock(&(heap->lock));
+
+	ret = heap_free(heap, elem);
+
+	rte_spinlock_unlock(&(heap->lock));
+	return ret;
+}
+
+/*
+ * Free a number of elements belonging to the same heap, taking the heap lock
+ * only once.
+ */
+int
+malloc_heap_free_bulk(struct malloc_heap *heap, struct malloc_elem *elems[],
+		unsigned int n)
+{
+	unsigned int i;
+	int ret = 0;
+
+	rte_spinlock_lock(&(heap->lock));
+
+	for (i = 0; i < n; i++) {
+		struct malloc_elem *elem = elems[i];
+
+		if (!malloc_elem_cookies_ok(elem) ||
+				elem->state != ELEM_BUSY || elem->heap != heap) {
+			ret = -1;
+			continue;
+		}
+		if (heap_free(heap, elem) < 0)
+			ret = -1;
+	}
+
 	rte_spinlock_unlock(&(heap->lock));
 	return ret;
 }
@@ -1106,7 +1200,8 @@ int
 malloc_heap_get_stats(struct malloc_heap *heap,
 		struct rte_malloc_socket_stats *socket_stats)
 {
-	size_t idx;
+	size_t idx, cached_bytes;
+	unsigned int cached_count;
 	struct malloc_elem *elem;
 
 	rte_spinlock_lock(&heap->lock);
@@ -1127,11 +1222,16 @@ malloc_heap_get_stats(struct malloc_heap *heap,
 				socket_stats->greatest_free_size = elem->size;
 		}
 	}
+	/* Elements held in lcore caches are free as far as users are concerned */
+	malloc_cache_get_stats(heap, &cached_count, &cached_bytes);
+	socket_stats->free_count += cached_count;
+	socket_stats->heap_freesz_bytes += cached_bytes;
+
 	/* Get stats on overall heap and allocated memory on this heap */
 	socket_stats->heap_totalsz_bytes = heap->total_size;
 	socket_stats->heap_allocsz_bytes = (socket_stats->heap_totalsz_bytes -
 			socket_stats->heap_freesz_bytes);
-	socket_stats->alloc_count = heap->alloc_count;
+	socket_stats->alloc_count = heap->alloc_count - cached_count;
 
 	rte_spinlock_unlock(&heap->lock);
 	return 0;
@@ -1238,6 +1338,8 @@ malloc_heap_create_external_seg(void *va_addr, rte_iova_t iova_addrs[],
 	msl->version = 0;
 	msl->external = 1;
 
+	eal_mem_xlat_add_memseg_list(msl);
+
 	return msl;
 }
 
@@ -1287,6 +1389,8 @@ malloc_heap_find_external_seg(void *va_addr, size_t len)
 int
 malloc_heap_destroy_external_seg(struct rte_memseg_list *msl)
 {
+	eal_mem_xlat_del(msl->base_va, msl->len);
+
 	/* destroy the fbarray backing this memory */
 	if (rte_fbarray_destroy(&msl->memseg_arr) < 0)
 		return -1;
@@ -1435,6 +1539,12 @@ rte_eal_malloc_heap_init(void)
 		return -1;
 	}
 
+	if (malloc_cache_init() < 0) {
+		EAL_LOG(ERR, "Couldn't initialize malloc lcore cache");
+		unregister_mp_requests();
+		return -1;
+	}
+
 	return 0;
 }
 
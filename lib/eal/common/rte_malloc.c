@@ -19,6 +19,7 @@
 #include <eal_trace_internal.h>
 
 #include <rte_malloc.h>
+#include "malloc_cache.h"
 #include "malloc_elem.h"
 #include "malloc_heap.h"
 #include "eal_memalloc.h"
@@ -30,11 +31,17 @@
 static void
 mem_free(void *addr, const bool trace_ena)
 {
+	struct malloc_elem *elem;
+
 	if (trace_ena)
 		rte_eal_trace_mem_free(addr);
 
 	if (addr == NULL) return;
-	if (malloc_heap_free(malloc_elem_from_data(addr)) < 0)
+
+	elem = malloc_elem_from_data(addr);
+	if (malloc_cache_free(elem) == 0)
+		return;
+	if (malloc_heap_free(elem) < 0)
 		EAL_LOG(ERR, "Error: Invalid memory");
 }
 
@@ -69,8 +76,10 @@ malloc_socket(const char *type, size_t size, unsigned int align,
 				!rte_eal_has_hugepages())
 		socket_arg = SOCKET_ID_ANY;
 
-	ptr = malloc_heap_alloc(type, size, socket_arg, 0,
-			align == 0 ? 1 : align, 0, false);
+	ptr = malloc_cache_alloc(size, align, socket_arg);
+	if (ptr == NULL)
+		ptr = malloc_heap_alloc(type, size, socket_arg, 0,
+				align == 0 ? 1 : align, 0, false);
 
 	if (trace_ena)
 		rte_eal_trace_mem_malloc(type, size, align, socket_arg, ptr);
@@ -1066,3 +1066,68 @@ rte_vfio_container_dma_unmap(__rte_unused int container_fd,
 	rte_errno = ENOTSUP;
 	return -1;
 }
+
+int
+rte_vfio_iommufd_get_fd(void)
+{
+	rte_errno = ENOTSUP;
+	return -1;
+}
+
+int
+rte_vfio_iommufd_ioas_create(__rte_unused uint32_t *ioas_id)
+{
+	rte_errno = ENOTSUP;
+	return -1;
+}
+
+int
+rte_vfio_iommufd_ioas_destroy(__rte_unused uint32_t ioas_id)
+{
+	rte_errno = ENOTSUP;
+	return -1;
+}
+
+int
+rte_vfio_iommufd_get_default_ioas(__rte_unused uint32_t *ioas_id)
+{
+	rte_errno = ENOTSUP;
+	return -1;
+}
+
+int
+rte_vfio_iommufd_dma_map(__rte_unused uint32_t ioas_id,
+			__rte_unused uint64_t vaddr,
+			__rte_unused uint64_t iova,
+			__rte_unused uint64_t len)
+{
+	rte_errno = ENOTSUP;
+	return -1;
+}
+
+int
+rte_vfio_iommufd_dma_unmap(__rte_unused uint32_t ioas_id,
+			__rte_unused uint64_t iova,
+			__rte_unused uint64_t len)
+{
+	rte_errno = ENOTSUP;
+	return -1;
+}
+
+int
+rte_vfio_iommufd_setup_device(__rte_unused const char *sysfs_base,
+			__rte_unused const char *dev_addr,
+			__rte_unused uint32_t ioas_id,
+			__rte_unused int *vfio_dev_fd,
+			__rte_unused struct vfio_device_info *device_info)
+{
+	rte_errno = ENOTSUP;
+	return -1;
+}
+
+int
+rte_vfio_iommufd_release_device(__rte_unused int vfio_dev_fd)
+{
+	rte_errno = ENOTSUP;
+	return -1;
+}
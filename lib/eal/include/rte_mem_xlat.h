@@ -0,0 +1,168 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#ifndef _RTE_MEM_XLAT_H_
+#define _RTE_MEM_XLAT_H_
+
+/**
+ * @file
+ *
+ * RTE memory translation table.
+ *
+ * EAL maintains a per-process, multi-level table translating virtual
+ * addresses of DPDK-managed memory (memseg lists and registered external
+ * memory) to IO addresses. The table is populated at memory init time and
+ * kept in sync with memory hotplug events, so that the lookup can be done
+ * without taking any locks and without making any system calls. It works
+ * regardless of the IOVA mode EAL is running in.
+ *
+ * The table is laid out like a page table:
+ *  - the first level covers the whole virtual address space, one entry per
+ *    1G of VA, and points to a second level table;
+ *  - the second level has one entry per 2M of VA, and either stores the IOVA
+ *    of the 2M block directly (when the whole block is IOVA-contiguous), or
+ *    points to a third level table;
+ *  - the third level has one entry per 4K of VA and stores the IOVA of that
+ *    4K page.
+ *
+ * Reverse translation is provided by a separate IOVA-sorted range index,
+ * updated alongside the table.
+ */
+
+#include <stdint.h>
+
+#include <rte_bitops.h>
+#include <rte_branch_prediction.h>
+#include <rte_common.h>
+#include <rte_compat.h>
+#include <rte_stdatomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of VA bits covered by the translation table. */
+#ifdef RTE_ARCH_64
+#define RTE_MEM_XLAT_VA_BITS 48
+#else
+#define RTE_MEM_XLAT_VA_BITS 32
+#endif
+
+#define RTE_MEM_XLAT_L1_SHIFT 30 /**< VA shift of first level index. */
+#define RTE_MEM_XLAT_L2_SHIFT 21 /**< VA shift of second level index. */
+#define RTE_MEM_XLAT_L3_SHIFT 12 /**< VA shift of third level index. */
+
+/** Number of first level entries. */
+#define RTE_MEM_XLAT_L1_ENTRIES \
+	(1UL << (RTE_MEM_XLAT_VA_BITS - RTE_MEM_XLAT_L1_SHIFT))
+/** Number of second level entries. */
+#define RTE_MEM_XLAT_L2_ENTRIES \
+	(1UL << (RTE_MEM_XLAT_L1_SHIFT - RTE_MEM_XLAT_L2_SHIFT))
+/** Number of third level entries. */
+#define RTE_MEM_XLAT_L3_ENTRIES \
+	(1UL << (RTE_MEM_XLAT_L2_SHIFT - RTE_MEM_XLAT_L3_SHIFT))
+
+/**
+ * Second level entry flag, indicating the entry points to a third level
+ * table rather than storing IOVA. IOVA of a page is always at least 4K
+ * aligned, so bit 0 is never set in a valid IOVA stored at this level.
+ */
+#define RTE_MEM_XLAT_F_L3 RTE_BIT64(0)
+
+/**
+ * Second level translation table.
+ */
+struct rte_mem_xlat_l2 {
+	/** IOVA of each 2M block, or pointer to third level table. */
+	RTE_ATOMIC(uint64_t) ent[RTE_MEM_XLAT_L2_ENTRIES];
+};
+
+/**
+ * First level translation table.
+ *
+ * @internal Not to be accessed directly, use rte_mem_xlat_virt2iova().
+ */
+extern RTE_ATOMIC(struct rte_mem_xlat_l2 *) rte_mem_xlat_l1[];
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get IO address of a virtual address belonging to DPDK-managed memory.
+ *
+ * The lookup is lock-free and does not make any system calls, so it is safe
+ * to use on the data path. Only memory known to EAL (i.e. memory belonging
+ * to memseg lists, including external memory registered with
+ * rte_extmem_register() or rte_malloc_heap_memory_add()) can be translated.
+ *
+ * @note The result of translating an address that is being concurrently
+ *       freed is undefined.
+ *
+ * @param virt
+ *   The virtual address.
+ * @return
+ *   The IO address, or RTE_BAD_IOVA if the address is not known to EAL or
+ *   has no IOVA associated with it.
+ */
+__rte_experimental
+static inline rte_iova_t
+rte_mem_xlat_virt2iova(const void *virt)
+{
+	uintptr_t va = (uintptr_t)virt;
+	const struct rte_mem_xlat_l2 *l2;
+	const RTE_ATOMIC(uint64_t) *l3;
+	uint64_t ent;
+
+	if (unlikely((uint64_t)va >> RTE_MEM_XLAT_VA_BITS))
+		return RTE_BAD_IOVA;
+
+	l2 = rte_atomic_load_explicit(&rte_mem_xlat_l1[va >> RTE_MEM_XLAT_L1_SHIFT],
+			rte_memory_order_acquire);
+	if (unlikely(l2 == NULL))
+		return RTE_BAD_IOVA;
+
+	ent = rte_atomic_load_explicit(&l2->ent[(va >> RTE_MEM_XLAT_L2_SHIFT) &
+			(RTE_MEM_XLAT_L2_ENTRIES - 1)], rte_memory_order_acquire);
+	if (likely((ent & RTE_MEM_XLAT_F_L3) == 0))
+		return ent + (va & (RTE_BIT64(RTE_MEM_XLAT_L2_SHIFT) - 1));
+	if (ent == RTE_BAD_IOVA)
+		return RTE_BAD_IOVA;
+
+	l3 = (const RTE_ATOMIC(uint64_t) *)(uintptr_t)(ent & ~RTE_MEM_XLAT_F_L3);
+	ent = rte_atomic_load_explicit(&l3[(va >> RTE_MEM_XLAT_L3_SHIFT) &
+			(RTE_MEM_XLAT_L3_ENTRIES - 1)], rte_memory_order_relaxed);
+	if (ent == RTE_BAD_IOVA)
+		return RTE_BAD_IOVA;
+	return ent + (va & (RTE_BIT64(RTE_MEM_XLAT_L3_SHIFT) - 1));
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get virtual address of an IO address belonging to DPDK-managed memory.
+ *
+ * Alongside the translation table, EAL maintains an IOVA-sorted index of
+ * all IOVA-contiguous ranges of memory it knows about, so the lookup is a
+ * binary search rather than a walk over all memory segments. The lookup is
+ * lock-free and does not block memory hotplug; it is retried if the index
+ * is concurrently updated.
+ *
+ * @note If the same IOVA is mapped at more than one virtual address, only
+ *       the first mapping is indexed.
+ *
+ * @param iova
+ *   The IO address.
+ * @return
+ *   The virtual address, or NULL if the IO address is not known to EAL.
+ */
+__rte_experimental
+void *
+rte_mem_xlat_iova2virt(rte_iova_t iova);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_MEM_XLAT_H_ */
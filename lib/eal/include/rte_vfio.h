@@ -364,7 +364,8 @@ rte_vfio_container_group_unbind(int container_fd, int iommu_group_num);
  *
  * @param container_fd
  *   the specified container fd. Use RTE_VFIO_DEFAULT_CONTAINER_FD to
- *   use the default container.
+ *   use the default container, which is the default IOAS when EAL runs
+ *   with --vfio-iommufd.
  *
  * @param vaddr
  *   Starting virtual address of memory to be mapped.
@@ -388,7 +389,8 @@ rte_vfio_container_dma_map(int container_fd, uint64_t vaddr,
  *
  * @param container_fd
  *   the specified container fd. Use RTE_VFIO_DEFAULT_CONTAINER_FD to
- *   use the default container.
+ *   use the default container, which is the default IOAS when EAL runs
+ *   with --vfio-iommufd.
  *
  * @param vaddr
  *   Starting virtual address of memory to be unmapped.
@@ -407,6 +409,192 @@ int
 rte_vfio_container_dma_unmap(int container_fd, uint64_t vaddr,
 		uint64_t iova, uint64_t len);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the iommufd file descriptor used by EAL, opening it if needed.
+ *
+ * This function is only relevant to Linux and will return an error on BSD.
+ *
+ * @return
+ *  >=0 iommufd file descriptor
+ *   <0 for errors, rte_errno is set
+ */
+__rte_experimental
+int
+rte_vfio_iommufd_get_fd(void);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Create a new I/O address space (IOAS) in iommufd.
+ *
+ * Devices attached to the same IOAS share all of its DMA mappings, so memory
+ * needs to be mapped only once for any number of devices.
+ *
+ * This function is only relevant to Linux and will return an error on BSD.
+ *
+ * @param ioas_id
+ *   Filled with the ID of the new IOAS.
+ *
+ * @return
+ *    0 if successful
+ *   <0 if failed, rte_errno is set
+ */
+__rte_experimental
+int
+rte_vfio_iommufd_ioas_create(uint32_t *ioas_id);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Destroy an IOAS created with rte_vfio_iommufd_ioas_create().
+ *
+ * All its DMA mappings are removed. The IOAS cannot be destroyed while
+ * devices are attached to it.
+ *
+ * @param ioas_id
+ *   ID of the IOAS.
+ *
+ * @return
+ *    0 if successful
+ *   <0 if failed, rte_errno is set
+ */
+__rte_experimental
+int
+rte_vfio_iommufd_ioas_destroy(uint32_t ioas_id);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the IOAS devices set up by EAL are attached to.
+ *
+ * The IOAS is created on first use. All DPDK memory is mapped in it, and
+ * memory hotplug is tracked.
+ *
+ * @param ioas_id
+ *   Filled with the ID of the default IOAS.
+ *
+ * @return
+ *    0 if successful
+ *   <0 if failed, rte_errno is set
+ */
+__rte_experimental
+int
+rte_vfio_iommufd_get_default_ioas(uint32_t *ioas_id);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Perform DMA mapping for all devices attached to an IOAS.
+ *
+ * The kernel uses the largest IOMMU page size that the alignment of the
+ * virtual address, IOVA and length allow, so hugepage backed memory should
+ * be mapped in as few and as large chunks as possible.
+ *
+ * @param ioas_id
+ *   ID of the IOAS.
+ *
+ * @param vaddr
+ *   Starting virtual address of memory to be mapped.
+ *
+ * @param iova
+ *   Starting IOVA address of memory to be mapped.
+ *
+ * @param len
+ *   Length of memory segment being mapped.
+ *
+ * @return
+ *    0 if successful
+ *   <0 if failed, rte_errno is set
+ */
+__rte_experimental
+int
+rte_vfio_iommufd_dma_map(uint32_t ioas_id, uint64_t vaddr, uint64_t iova,
+		uint64_t len);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Perform DMA unmapping for all devices attached to an IOAS.
+ *
+ * The area must cover whole mappings done with rte_vfio_iommufd_dma_map().
+ *
+ * @param ioas_id
+ *   ID of the IOAS.
+ *
+ * @param iova
+ *   Starting IOVA address of memory to be unmapped.
+ *
+ * @param len
+ *   Length of memory segment being unmapped.
+ *
+ * @return
+ *    0 if successful
+ *   <0 if failed, rte_errno is set
+ */
+__rte_experimental
+int
+rte_vfio_iommufd_dma_unmap(uint32_t ioas_id, uint64_t iova, uint64_t len);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Open a device through its VFIO character device and attach it to an IOAS.
+ *
+ * This is the iommufd counterpart of rte_vfio_setup_device(), the device
+ * does not need to be part of any VFIO container.
+ *
+ * @param sysfs_base
+ *   sysfs path prefix.
+ *
+ * @param dev_addr
+ *   device location.
+ *
+ * @param ioas_id
+ *   ID of the IOAS to attach the device to.
+ *
+ * @param vfio_dev_fd
+ *   VFIO fd.
+ *
+ * @param device_info
+ *   Device information.
+ *
+ * @return
+ *   0 on success.
+ *  <0 on failure, rte_errno is set.
+ *  >0 if the device is not bound to a VFIO driver.
+ */
+__rte_experimental
+int
+rte_vfio_iommufd_setup_device(const char *sysfs_base, const char *dev_addr,
+		uint32_t ioas_id, int *vfio_dev_fd,
+		struct vfio_device_info *device_info);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Release a device set up with rte_vfio_iommufd_setup_device().
+ *
+ * @param vfio_dev_fd
+ *   VFIO fd.
+ *
+ * @return
+ *   0 on success.
+ *  <0 on failure, rte_errno is set.
+ */
+__rte_experimental
+int
+rte_vfio_iommufd_release_device(int vfio_dev_fd);
+
 #ifdef __cplusplus
 }
 #endif
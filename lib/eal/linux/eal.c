@@ -450,6 +450,7 @@ eal_usage(const char *prgname)
 	       "  --"OPT_CREATE_UIO_DEV"    Create /dev/uioX (usually done by hotplug)\n"
 	       "  --"OPT_VFIO_INTR"         Interrupt mode for VFIO (legacy|msi|msix)\n"
 	       "  --"OPT_VFIO_VF_TOKEN"     VF token (UUID) shared between SR-IOV PF and VFs\n"
+	       "  --"OPT_VFIO_IOMMUFD"      Set up VFIO devices through iommufd\n"
 	       "  --"OPT_LEGACY_MEM"        Legacy memory mode (no dynamic allocation, contiguous segments)\n"
 	       "  --"OPT_SINGLE_FILE_SEGMENTS" Put all hugepage memory in single files\n"
 	       "  --"OPT_MATCH_ALLOCATIONS" Free hugepages exactly as allocated\n"
@@ -457,6 +458,10 @@ eal_usage(const char *prgname)
 	       "                      Allocate worker thread stacks from hugepage memory.\n"
 	       "                      Size is in units of kbytes and defaults to system\n"
 	       "                      thread stack size if not specified.\n"
+	       "  --"OPT_HUGE_PREFAULT"[=threads]\n"
+	       "                      Fault in hugepages at startup from several threads\n"
+	       "                      running on the NUMA node the memory belongs to.\n"
+	       "                      Defaults to one thread per CPU of the node.\n"
 	       "\n");
 	/* Allow the application to print its usage message too if hook is set */
 	if (hook) {
@@ -622,6 +627,29 @@ eal_parse_huge_worker_stack(const char *arg)
 	return 0;
 }
 
+static int
+eal_parse_huge_prefault(const char *arg)
+{
+	struct internal_config *cfg = eal_get_internal_configuration();
+	unsigned long threads;
+	char *end;
+
+	if (arg == NULL || arg[0] == '\0') {
+		/* one thread per CPU of the NUMA node */
+		cfg->huge_prefault_threads = UINT_MAX;
+		return 0;
+	}
+
+	errno = 0;
+	threads = strtoul(arg, &end, 10);
+	if (errno || end == NULL || *end != '\0' || threads == 0 ||
+			threads > CPU_SETSIZE)
+		return -1;
+
+	cfg->huge_prefault_threads = threads;
+	return 0;
+}
+
 /* Parse the argument given in the command line of the application */
 static int
 eal_parse_args(int argc, char **argv)
@@ -737,6 +765,10 @@ eal_parse_args(int argc, char **argv)
 			}
 			break;
 
+		case OPT_VFIO_IOMMUFD_NUM:
+			internal_conf->vfio_iommufd = 1;
+			break;
+
 		case OPT_CREATE_UIO_DEV_NUM:
 			internal_conf->create_uio_dev = 1;
 			break;
@@ -769,6 +801,16 @@ eal_parse_args(int argc, char **argv)
 			}
 			break;
 
+		case OPT_HUGE_PREFAULT_NUM:
+			if (eal_parse_huge_prefault(optarg) < 0) {
+				EAL_LOG(ERR, "invalid parameter for --"
+					OPT_HUGE_PREFAULT);
+				eal_usage(prgname);
+				ret = -1;
+				goto out;
+			}
+			break;
+
 		default:
 			if (opt < OPT_LONG_MIN_NUM && isprint(opt)) {
 				EAL_LOG(ERR, "Option %c is not supported "
@@ -31,12 +31,16 @@
 #include <rte_log.h>
 #include <rte_eal.h>
 #include <rte_memory.h>
+#include <rte_per_lcore.h>
+#include <rte_stdatomic.h>
+#include <rte_thread.h>
 
 #include "eal_filesystem.h"
 #include "eal_internal_cfg.h"
 #include "eal_memalloc.h"
 #include "eal_memcfg.h"
 #include "eal_private.h"
+#include "eal_thread.h"
 #include "malloc_elem.h"
 
 const int anonymous_hugepages_supported =
@@ -98,11 +102,12 @@ static struct {
 /** local copy of a memory map, used to synchronize memory hotplug in MP */
 static struct rte_memseg_list local_memsegs[RTE_MAX_MEMSEG_LISTS];
 
-static sigjmp_buf huge_jmpenv;
+/* per thread, as hugepages may be faulted in from several threads at once */
+static RTE_DEFINE_PER_LCORE(sigjmp_buf, huge_jmpenv);
 
 static void huge_sigbus_handler(int signo __rte_unused)
 {
-	siglongjmp(huge_jmpenv, 1);
+	siglongjmp(RTE_PER_LCORE(huge_jmpenv), 1);
 }
 
 /* Put setjmp into a wrap method to avoid compiling error. Any non-volatile,
@@ -111,11 +116,13 @@ static void huge_sigbus_handler(int signo __rte_unused)
  */
 static int huge_wrap_sigsetjmp(void)
 {
-	return sigsetjmp(huge_jmpenv, 1);
+	return sigsetjmp(RTE_PER_LCORE(huge_jmpenv), 1);
 }
 
 static struct sigaction huge_action_old;
 static int huge_need_recover;
+/* set while the handler is held for threads populating pages in parallel */
+static bool huge_sigbus_held;
 
 static void
 huge_register_sigbus(void)
@@ -123,6 +130,9 @@ huge_register_sigbus(void)
 	sigset_t mask;
 	struct sigaction action;
 
+	if (huge_sigbus_held)
+		return;
+
 	sigemptyset(&mask);
 	sigaddset(&mask, SIGBUS);
 	action.sa_flags = 0;
@@ -135,6 +145,9 @@ huge_register_sigbus(void)
 static void
 huge_recover_sigbus(void)
 {
+	if (huge_sigbus_held)
+		return;
+
 	if (huge_need_recover) {
 		sigaction(SIGBUS, &huge_action_old, NULL);
 		huge_need_recover = 0;
@@ -842,6 +855,116 @@ free_seg(struct rte_memseg *ms, struct hugepage_info *hi,
 	return ret < 0 ? -1 : 0;
 }
 
+struct prefault_param {
+	void (*fn)(unsigned int idx, void *arg);
+	void *arg;
+	unsigned int n;
+	int socket;
+	RTE_ATOMIC(unsigned int) next;
+};
+
+static uint32_t
+prefault_thread(void *arg)
+{
+	struct prefault_param *pp = arg;
+	unsigned int idx;
+
+#ifdef RTE_EAL_NUMA_AWARE_HUGEPAGES
+	/* hugepages are placed according to policy of the faulting thread */
+	if (pp->socket != SOCKET_ID_ANY && numa_available() == 0)
+		numa_set_preferred(pp->socket);
+#endif
+
+	for (;;) {
+		idx = rte_atomic_fetch_add_explicit(&pp->next, 1,
+				rte_memory_order_relaxed);
+		if (idx >= pp->n)
+			break;
+		pp->fn(idx, pp->arg);
+	}
+	return 0;
+}
+
+/* find CPUs of a NUMA node we are allowed to run on */
+static unsigned int
+prefault_cpuset(int socket, rte_cpuset_t *cpuset)
+{
+	rte_cpuset_t allowed;
+	unsigned int cpu;
+
+	CPU_ZERO(cpuset);
+	if (rte_thread_get_affinity_by_id(rte_thread_self(), &allowed) != 0)
+		return 0;
+
+	if (socket != SOCKET_ID_ANY) {
+		for (cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+			if (CPU_ISSET(cpu, &allowed) &&
+					eal_cpu_socket_id(cpu) == (unsigned int)socket)
+				CPU_SET(cpu, cpuset);
+		}
+	}
+	/* node without CPUs, run anywhere and rely on memory policy */
+	if (CPU_COUNT(cpuset) == 0)
+		memcpy(cpuset, &allowed, sizeof(*cpuset));
+
+	return CPU_COUNT(cpuset);
+}
+
+int
+eal_memalloc_prefault_run(int socket, unsigned int n,
+		void (*fn)(unsigned int idx, void *arg), void *arg)
+{
+	const struct internal_config *internal_conf =
+		eal_get_internal_configuration();
+	struct prefault_param pp;
+	rte_thread_attr_t attr;
+	rte_cpuset_t cpuset;
+	rte_thread_t *threads;
+	unsigned int n_threads, i, j;
+
+	/* spawning threads is only worth it for bulk allocations at init */
+	if (internal_conf->huge_prefault_threads == 0 ||
+			internal_conf->init_complete || n < 2)
+		return -1;
+
+	n_threads = RTE_MIN(internal_conf->huge_prefault_threads, n);
+	n_threads = RTE_MIN(n_threads, prefault_cpuset(socket, &cpuset));
+	if (n_threads < 2)
+		return -1;
+
+	threads = malloc(n_threads * sizeof(*threads));
+	if (threads == NULL)
+		return -1;
+
+	pp.fn = fn;
+	pp.arg = arg;
+	pp.n = n;
+	pp.socket = socket;
+	rte_atomic_store_explicit(&pp.next, 0, rte_memory_order_relaxed);
+
+	rte_thread_attr_init(&attr);
+	rte_thread_attr_set_affinity(&attr, &cpuset);
+	for (i = 0; i < n_threads; i++) {
+		if (rte_thread_create(&threads[i], &attr, prefault_thread,
+				&pp) != 0)
+			break;
+		rte_thread_set_prefixed_name(threads[i], "prefault");
+	}
+	/* items are shared between threads, any number of them will do */
+	for (j = 0; j < i; j++)
+		rte_thread_join(threads[j], NULL);
+	free(threads);
+
+	if (i == 0) {
+		EAL_LOG(DEBUG, "Cannot create threads to populate hugepages");
+		return -1;
+	}
+
+	EAL_LOG(DEBUG, "Populated %u hugepages on socket %d using %u threads",
+		n, socket, i);
+	return 0;
+}
+
 struct alloc_walk_param {
 	struct hugepage_info *hi;
 	struct rte_memseg **ms;
@@ -851,6 +974,93 @@ struct alloc_walk_param {
 	int socket;
 	bool exact;
 };
+
+struct alloc_seg_job {
+	struct alloc_walk_param *wa;
+	struct rte_memseg_list *msl;
+	unsigned int msl_idx;
+	int start_idx;
+	int *ret;
+};
+
+static void
+alloc_seg_job_fn(unsigned int idx, void *arg)
+{
+	struct alloc_seg_job *job = arg;
+	int seg_idx = job->start_idx + idx;
+	struct rte_memseg *cur;
+	void *map_addr;
+
+	cur = rte_fbarray_get(&job->msl->memseg_arr, seg_idx);
+	map_addr = RTE_PTR_ADD(job->msl->base_va,
+			(size_t)seg_idx * job->msl->page_sz);
+
+	job->ret[idx] = alloc_seg(cur, map_addr, job->wa->socket, job->wa->hi,
+			job->msl_idx, seg_idx);
+}
+
+/*
+ * Allocate `need` segments starting at `start_idx` from several threads.
+ * Returns -1 if that is not possible, and segments must be allocated one by
+ * one. Otherwise, leaves the memseg list as the serial loop would: segments
+ * are kept up to the first failure, or all of them are freed if an exact
+ * number was requested, and the number of segments kept is returned.
+ */
+static int
+alloc_segs_parallel(struct alloc_walk_param *wa, struct rte_memseg_list *msl,
+		unsigned int msl_idx, int start_idx, unsigned int need)
+{
+	const struct internal_config *internal_conf =
+		eal_get_internal_configuration();
+	struct alloc_seg_job job;
+	unsigned int i, n_ok;
+	int ret;
+
+	/* single file segments share an fd and its refcount between pages */
+	if (internal_conf->huge_prefault_threads == 0 ||
+			internal_conf->single_file_segments)
+		return -1;
+
+	job.ret = malloc(need * sizeof(*job.ret));
+	if (job.ret == NULL)
+		return -1;
+	job.wa = wa;
+	job.msl = msl;
+	job.msl_idx = msl_idx;
+	job.start_idx = start_idx;
+
+	/* handler is process-wide, hold it until all threads are done */
+	huge_register_sigbus();
+	huge_sigbus_held = true;
+	ret = eal_memalloc_prefault_run(wa->socket, need, alloc_seg_job_fn,
+			&job);
+	huge_sigbus_held = false;
+	huge_recover_sigbus();
+	if (ret < 0) {
+		free(job.ret);
+		return -1;
+	}
+
+	for (n_ok = 0; n_ok < need; n_ok++)
+		if (job.ret[n_ok] != 0)
+			break;
+	if (n_ok != need)
+		EAL_LOG(DEBUG, "attempted to allocate %u segments, but only %u were allocated",
+			need, n_ok);
+
+	for (i = wa->exact && n_ok != need ? 0 : n_ok; i < need; i++) {
+		int seg_idx = start_idx + i;
+
+		if (job.ret[i] != 0)
+			continue;
+		if (free_seg(rte_fbarray_get(&msl->memseg_arr, seg_idx),
+				wa->hi, msl_idx, seg_idx))
+			EAL_LOG(DEBUG, "Cannot free page");
+	}
+	free(job.ret);
+
+	return n_ok;
+}
 static int
 alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 {
@@ -858,7 +1068,7 @@ alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 	struct alloc_walk_param *wa = arg;
 	struct rte_memseg_list *cur_msl;
 	size_t page_sz;
-	int cur_idx, start_idx, j, dir_fd = -1;
+	int cur_idx, start_idx, j, ret, dir_fd = -1;
 	unsigned int msl_idx, need, i;
 	const struct internal_config *internal_conf =
 		eal_get_internal_configuration();
@@ -927,6 +1137,25 @@ alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 		}
 	}
 
+	ret = alloc_segs_parallel(wa, cur_msl, msl_idx, start_idx, need);
+	if (ret >= 0) {
+		if (wa->exact && (unsigned int)ret != need) {
+			/* clear the list */
+			if (wa->ms)
+				memset(wa->ms, 0, sizeof(*wa->ms) * wa->n_segs);
+			if (dir_fd >= 0)
+				close(dir_fd);
+			return -1;
+		}
+		for (i = 0; i < (unsigned int)ret; i++, cur_idx++) {
+			if (wa->ms)
+				wa->ms[i] = rte_fbarray_get(&cur_msl->memseg_arr,
+						cur_idx);
+			rte_fbarray_set_used(&cur_msl->memseg_arr, cur_idx);
+		}
+		goto out;
+	}
+
 	for (i = 0; i < need; i++, cur_idx++) {
 		struct rte_memseg *cur;
 		void *map_addr;
@@ -29,10 +29,12 @@
 
 #include <rte_errno.h>
 #include <rte_log.h>
+#include <rte_mem_xlat.h>
 #include <rte_memory.h>
 #include <rte_eal.h>
 #include <rte_lcore.h>
 #include <rte_common.h>
+#include <rte_per_lcore.h>
 
 #include "eal_private.h"
 #include "eal_memalloc.h"
@@ -148,8 +150,16 @@ rte_mem_virt2phy(const void *virtaddr)
 rte_iova_t
 rte_mem_virt2iova(const void *virtaddr)
 {
+	rte_iova_t iova;
+
 	if (rte_eal_iova_mode() == RTE_IOVA_VA)
 		return (uintptr_t)virtaddr;
+
+	/* avoid going through pagemap for memory EAL already knows about */
+	iova = rte_mem_xlat_virt2iova(virtaddr);
+	if (iova != RTE_BAD_IOVA)
+		return iova;
+
 	return rte_mem_virt2phy(virtaddr);
 }
 
@@ -218,11 +228,12 @@ aslr_enabled(void)
 	}
 }
 
-static sigjmp_buf huge_jmpenv;
+/* pages may be faulted in from several threads, see populate_hugepages() */
+static RTE_DEFINE_PER_LCORE(sigjmp_buf, huge_jmpenv);
 
 static void huge_sigbus_handler(int signo __rte_unused)
 {
-	siglongjmp(huge_jmpenv, 1);
+	siglongjmp(RTE_PER_LCORE(huge_jmpenv), 1);
 }
 
 /* Put setjmp into a wrap method to avoid compiling error. Any non-volatile,
@@ -231,7 +242,7 @@ static void huge_sigbus_handler(int signo __rte_unused)
  */
 static int huge_wrap_sigsetjmp(void)
 {
-	return sigsetjmp(huge_jmpenv, 1);
+	return sigsetjmp(RTE_PER_LCORE(huge_jmpenv), 1);
 }
 
 #ifdef RTE_EAL_NUMA_AWARE_HUGEPAGES
@@ -242,6 +253,95 @@ void numa_error(char *where)
 }
 #endif
 
+/* state of a hugepage mapped by map_all_hugepages() but not yet faulted in */
+struct hugepage_populate {
+	int node; /**< NUMA node to place the page on, or SOCKET_ID_ANY */
+	uint64_t essential; /**< essential memory accounted for the page */
+	bool failed; /**< page could not be faulted in */
+};
+
+struct populate_param {
+	struct hugepage_file *tbl;
+	struct hugepage_populate *pop;
+	unsigned int *pages; /**< indexes of pages being populated */
+};
+
+static void
+populate_hugepage(unsigned int idx, void *arg)
+{
+	struct populate_param *pp = arg;
+	unsigned int page = pp->pages[idx];
+
+	/* see map_all_hugepages() for why SIGBUS can happen here */
+	if (huge_wrap_sigsetjmp()) {
+		pp->pop[page].failed = true;
+		return;
+	}
+	*(int *)pp->tbl[page].orig_va = 0;
+}
+
+/*
+ * Fault in hugepages mapped by map_all_hugepages(), one NUMA node at a time,
+ * using several threads if possible. Pages that could not be faulted in are
+ * unmapped and removed from the table. Returns the number of pages left.
+ */
+static unsigned int
+populate_hugepages(struct hugepage_file *hugepg_tbl, unsigned int n_pages,
+		uint64_t hugepage_sz, struct hugepage_populate *pop,
+		unsigned int *pages, uint64_t *essential_memory)
+{
+	struct populate_param pp;
+	unsigned int i, n;
+	int node;
+
+	pp.tbl = hugepg_tbl;
+	pp.pop = pop;
+	pp.pages = pages;
+
+	for (node = SOCKET_ID_ANY; node < RTE_MAX_NUMA_NODES; node++) {
+		for (i = 0, n = 0; i < n_pages; i++)
+			if (pop[i].node == node)
+				pages[n++] = i;
+		if (n == 0)
+			continue;
+
+		if (eal_memalloc_prefault_run(node, n, populate_hugepage,
+				&pp) == 0)
+			continue;
+
+		/* no threads to help us, do it ourselves */
+#ifdef RTE_EAL_NUMA_AWARE_HUGEPAGES
+		if (node != SOCKET_ID_ANY)
+			numa_set_preferred(node);
+#endif
+		for (i = 0; i < n; i++)
+			populate_hugepage(i, &pp);
+	}
+
+	/* pages are sorted by physical address later, order does not matter */
+	for (i = 0, n = 0; i < n_pages; i++) {
+		struct hugepage_file *hf = &hugepg_tbl[i];
+
+		if (!pop[i].failed) {
+			if (n != i)
+				hugepg_tbl[n] = *hf;
+			n++;
+			continue;
+		}
+		EAL_LOG(DEBUG, "SIGBUS: Cannot mmap more hugepages of size %u MB",
+			(unsigned int)(hugepage_sz / 0x100000));
+		munmap(hf->orig_va, hugepage_sz);
+		unlink(hf->filepath);
+		if (pop[i].node != SOCKET_ID_ANY)
+			essential_memory[pop[i].node] += pop[i].essential;
+	}
+	/* do not leave stale entries behind */
+	if (n != n_pages)
+		memset(&hugepg_tbl[n], 0, (n_pages - n) * sizeof(*hugepg_tbl));
+
+	return n;
+}
+
 /*
  * Mmap all hugepages of hugepage table: it first open a file in
  * hugetlbfs, then mmap() hugepage_sz data in it. If orig is set, the
@@ -251,20 +351,22 @@ void numa_error(char *where)
  */
 static unsigned
 map_all_hugepages(struct hugepage_file *hugepg_tbl, struct hugepage_info *hpi,
-		  uint64_t *essential_memory __rte_unused)
+		  uint64_t *essential_memory)
 {
+	const struct internal_config *internal_conf =
+		eal_get_internal_configuration();
+	struct hugepage_populate *pop = NULL;
+	unsigned int *pop_pages = NULL;
 	int fd;
 	unsigned i;
 	void *virtaddr;
 #ifdef RTE_EAL_NUMA_AWARE_HUGEPAGES
 	int node_id = -1;
-	int essential_prev = 0;
+	uint64_t essential_prev = 0;
 	int oldpolicy;
 	struct bitmask *oldmask = NULL;
 	bool have_numa = true;
 	unsigned long maxnode = 0;
-	const struct internal_config *internal_conf =
-		eal_get_internal_configuration();
 
 	/* Check if kernel supports NUMA. */
 	if (numa_available() != 0) {
@@ -288,6 +390,18 @@ map_all_hugepages(struct hugepage_file *hugepg_tbl, struct hugepage_info *hpi,
 	}
 #endif
 
+	/* if asked to, only map pages here and fault them in all at once */
+	if (internal_conf->huge_prefault_threads != 0) {
+		pop = malloc(hpi->num_pages[0] * sizeof(*pop));
+		pop_pages = malloc(hpi->num_pages[0] * sizeof(*pop_pages));
+		if (pop == NULL || pop_pages == NULL) {
+			free(pop);
+			free(pop_pages);
+			pop = NULL;
+			pop_pages = NULL;
+		}
+	}
+
 	for (i = 0; i < hpi->num_pages[0]; i++) {
 		struct hugepage_file *hf = &hugepg_tbl[i];
 		uint64_t hugepage_sz = hpi->hugepage_sz;
@@ -344,7 +458,8 @@ map_all_hugepages(struct hugepage_file *hugepg_tbl, struct hugepage_info *hpi,
 		 * ready for us to map into.
 		 */
 		virtaddr = mmap(NULL, hugepage_sz, PROT_READ | PROT_WRITE,
-				MAP_SHARED | MAP_POPULATE, fd, 0);
+				MAP_SHARED | (pop == NULL ? MAP_POPULATE : 0),
+				fd, 0);
 		if (virtaddr == MAP_FAILED) {
 			EAL_LOG(DEBUG, "%s(): mmap failed: %s", __func__,
 					strerror(errno));
@@ -354,6 +469,21 @@ map_all_hugepages(struct hugepage_file *hugepg_tbl, struct hugepage_info *hpi,
 
 		hf->orig_va = virtaddr;
 
+		if (pop != NULL) {
+			/* memory policy is applied by the faulting thread */
+			pop[i].node = SOCKET_ID_ANY;
+			pop[i].essential = 0;
+			pop[i].failed = false;
+#ifdef RTE_EAL_NUMA_AWARE_HUGEPAGES
+			if (maxnode) {
+				pop[i].node = node_id;
+				pop[i].essential = essential_prev -
+					essential_memory[node_id];
+			}
+#endif
+			goto lock;
+		}
+
 		/* In linux, hugetlb limitations, like cgroup, are
 		 * enforced at fault time instead of mmap(), even
 		 * with the option of MAP_POPULATE. Kernel will send
@@ -377,6 +507,7 @@ map_all_hugepages(struct hugepage_file *hugepg_tbl, struct hugepage_info *hpi,
 		}
 		*(int *)virtaddr = 0;
 
+lock:
 		/* set shared lock on the file. */
 		if (flock(fd, LOCK_SH) < 0) {
 			EAL_LOG(DEBUG, "%s(): Locking file failed:%s ",
@@ -389,6 +520,12 @@ map_all_hugepages(struct hugepage_file *hugepg_tbl, struct hugepage_info *hpi,
 	}
 
 out:
+	if (pop != NULL) {
+		i = populate_hugepages(hugepg_tbl, i, hpi->hugepage_sz, pop,
+				pop_pages, essential_memory);
+		free(pop);
+		free(pop_pages);
+	}
 #ifdef RTE_EAL_NUMA_AWARE_HUGEPAGES
 	if (maxnode) {
 		EAL_LOG(DEBUG,
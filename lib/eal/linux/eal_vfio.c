@@ -8,13 +8,17 @@
 #include <unistd.h>
 #include <sys/ioctl.h>
 
+#include <rte_cycles.h>
 #include <rte_errno.h>
 #include <rte_log.h>
 #include <rte_memory.h>
 #include <rte_eal_memconfig.h>
+#include <rte_stdatomic.h>
+#include <rte_telemetry.h>
 #include <rte_vfio.h>
 
 #include "eal_filesystem.h"
+#include "eal_memalloc.h"
 #include "eal_memcfg.h"
 #include "eal_vfio.h"
 #include "eal_private.h"
@@ -41,6 +45,15 @@ struct user_mem_maps {
 	struct user_mem_map maps[VFIO_MAX_USER_MEM_MAPS];
 };
 
+#define VFIO_DMA_STATS_REQ "/eal/vfio_dma_stats"
+
+/* DMA mapping ioctl counters */
+struct vfio_dma_stats {
+	RTE_ATOMIC(uint64_t) map_ioctls;
+	RTE_ATOMIC(uint64_t) unmap_ioctls;
+	RTE_ATOMIC(uint64_t) cycles; /**< time spent in ioctls */
+};
+
 struct vfio_config {
 	int vfio_enabled;
 	int vfio_container_fd;
@@ -54,6 +67,19 @@ struct vfio_config {
 static struct vfio_config vfio_cfgs[VFIO_MAX_CONTAINERS];
 static struct vfio_config *default_vfio_cfg = &vfio_cfgs[0];
 
+static int type1_do_map(const struct vfio_dma_mem_maps *, uint64_t, uint64_t,
+		uint64_t);
+static int type1_do_unmap(const struct vfio_dma_mem_maps *, uint64_t,
+		uint64_t);
+
+/* DPDK memory mappings of default container, protected by memory hotplug lock */
+static struct vfio_dma_mem_maps dpdk_mem_maps = {
+	.fd = -1,
+	.do_map = type1_do_map,
+	.do_unmap = type1_do_unmap,
+};
+static struct vfio_dma_stats dma_stats;
+
 static int vfio_type1_dma_map(int);
 static int vfio_type1_dma_mem_map(int, uint64_t, uint64_t, uint64_t, int);
 static int vfio_spapr_dma_map(int);
@@ -602,34 +628,260 @@ vfio_group_device_count(int vfio_group_fd)
 	return vfio_cfg->vfio_groups[i].devices;
 }
 
+void
+vfio_dma_stats_update(bool map, uint64_t start)
+{
+	rte_atomic_fetch_add_explicit(map ? &dma_stats.map_ioctls :
+			&dma_stats.unmap_ioctls, 1, rte_memory_order_relaxed);
+	rte_atomic_fetch_add_explicit(&dma_stats.cycles,
+			rte_get_timer_cycles() - start, rte_memory_order_relaxed);
+}
+
+static int
+dma_mem_maps_find(const struct vfio_dma_mem_maps *maps, uint64_t addr)
+{
+	int lo = 0, hi = maps->n_maps;
+
+	/* find first map ending after addr */
+	while (lo < hi) {
+		int mid = lo + (hi - lo) / 2;
+		const struct vfio_dma_mem_map *map = &maps->maps[mid];
+
+		if (map->addr + map->len <= addr)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+static int
+dma_mem_maps_add(struct vfio_dma_mem_maps *maps, uint64_t addr, uint64_t iova,
+		uint64_t len)
+{
+	struct vfio_dma_mem_map *map;
+	int idx;
+
+	if (maps->n_maps == maps->max_maps) {
+		int max_maps = RTE_MAX(maps->max_maps * 2, 64);
+
+		map = realloc(maps->maps, max_maps * sizeof(*map));
+		if (map == NULL) {
+			EAL_LOG(ERR, "Cannot allocate DMA mappings list");
+			return -1;
+		}
+		maps->maps = map;
+		maps->max_maps = max_maps;
+	}
+
+	idx = dma_mem_maps_find(maps, addr);
+	map = &maps->maps[idx];
+	memmove(map + 1, map, (maps->n_maps - idx) * sizeof(*map));
+	map->addr = addr;
+	map->iova = iova;
+	map->len = len;
+	maps->n_maps++;
+
+	return 0;
+}
+
 static void
-vfio_mem_event_callback(enum rte_mem_event type, const void *addr, size_t len,
-		void *arg __rte_unused)
+dma_mem_maps_del(struct vfio_dma_mem_maps *maps, int idx)
 {
-	struct rte_memseg_list *msl;
-	struct rte_memseg *ms;
-	size_t cur_len = 0;
+	struct vfio_dma_mem_map *map = &maps->maps[idx];
 
-	msl = rte_mem_virt2memseg_list(addr);
+	maps->n_maps--;
+	memmove(map, map + 1, (maps->n_maps - idx) * sizeof(*map));
+}
 
-	/* for IOVA as VA mode, no need to care for IOVA addresses */
-	if (rte_eal_iova_mode() == RTE_IOVA_VA && msl->external == 0) {
-		uint64_t vfio_va = (uint64_t)(uintptr_t)addr;
-		uint64_t page_sz = msl->page_sz;
+void
+vfio_dma_mem_maps_reset(struct vfio_dma_mem_maps *maps)
+{
+	free(maps->maps);
+	maps->maps = NULL;
+	maps->n_maps = 0;
+	maps->max_maps = 0;
+}
 
-		/* Maintain granularity of DMA map/unmap to memseg size */
-		for (; cur_len < len; cur_len += page_sz) {
-			if (type == RTE_MEM_EVENT_ALLOC)
-				vfio_dma_mem_map(default_vfio_cfg, vfio_va,
-						 vfio_va, page_sz, 1);
-			else
-				vfio_dma_mem_map(default_vfio_cfg, vfio_va,
-						 vfio_va, page_sz, 0);
-			vfio_va += page_sz;
+/* map a run of VA and IOVA contiguous DPDK memory with a single call */
+static int
+dma_mem_maps_map(struct vfio_dma_mem_maps *maps, uint64_t vaddr,
+		uint64_t iova, uint64_t len, uint64_t page_sz)
+{
+	uint64_t off;
+
+	if (maps->do_map(maps, vaddr, iova, len) == 0)
+		return dma_mem_maps_add(maps, vaddr, iova, len);
+
+	if (errno != EEXIST) {
+		EAL_LOG(ERR, "Cannot set up DMA remapping, error "
+				"%i (%s)", errno, strerror(errno));
+		return -1;
+	}
+	if (len == page_sz) {
+		EAL_LOG(DEBUG, "Memory segment is already mapped, skipping");
+		return 0;
+	}
+
+	/* some of the pages are already mapped, fall back to mapping pages
+	 * one by one so that the others still get mapped.
+	 */
+	for (off = 0; off < len; off += page_sz)
+		if (dma_mem_maps_map(maps, vaddr + off, iova + off, page_sz,
+				page_sz) < 0)
+			return -1;
+	return 0;
+}
+
+/*
+ * Unmap DPDK memory in [vaddr, vaddr + len). Runs never span several
+ * allocations, and memory is only freed in whole allocations, so the range
+ * always covers whole mappings. A mapping that is only partially covered is
+ * left alone, as the kernel cannot split it.
+ */
+static int
+dma_mem_maps_unmap(struct vfio_dma_mem_maps *maps, uint64_t vaddr,
+		uint64_t len)
+{
+	uint64_t end = vaddr + len;
+	int idx, ret = 0;
+
+	idx = dma_mem_maps_find(maps, vaddr);
+	while (idx < maps->n_maps && maps->maps[idx].addr < end) {
+		const struct vfio_dma_mem_map *map = &maps->maps[idx];
+
+		if (map->addr < vaddr || map->addr + map->len > end) {
+			EAL_LOG(ERR, "DMA unmap does not match mapped memory boundaries");
+			rte_errno = EINVAL;
+			ret = -1;
+			idx++;
+			continue;
 		}
 
-		return;
+		if (maps->do_unmap(maps, map->iova, map->len) < 0) {
+			/* leave it be, but try to unmap the rest */
+			ret = -1;
+			idx++;
+			continue;
+		}
+		dma_mem_maps_del(maps, idx);
+	}
+	return ret;
+}
+
+struct dma_mem_run {
+	uint64_t addr;
+	uint64_t iova;
+	uint64_t len;
+	uint64_t page_sz;
+	const struct rte_memseg_list *msl;
+};
+
+/*
+ * Extend current run with a segment, returns false if it does not fit.
+ * Memory is freed in whole allocations, and unmapped along, so a run must not
+ * span several of them.
+ */
+static bool
+dma_mem_run_extend(struct dma_mem_run *run, const struct rte_memseg_list *msl,
+		const struct rte_memseg *ms)
+{
+	if (run->len != 0 && run->msl == msl &&
+			run->addr + run->len == ms->addr_64 &&
+			run->iova + run->len == ms->iova &&
+			!eal_memalloc_is_alloc_start(msl,
+				rte_fbarray_find_idx(&msl->memseg_arr, ms))) {
+		run->len += ms->len;
+		return true;
 	}
+	return false;
+}
+
+static void
+dma_mem_run_start(struct dma_mem_run *run, const struct rte_memseg_list *msl,
+		const struct rte_memseg *ms)
+{
+	run->addr = ms->addr_64;
+	run->iova = ms->iova;
+	run->len = ms->len;
+	run->page_sz = msl->page_sz;
+	run->msl = msl;
+}
+
+struct dma_mem_walk_param {
+	struct vfio_dma_mem_maps *maps;
+	struct dma_mem_run run; /**< contiguous segments not yet mapped */
+};
+
+static int
+dma_mem_maps_walk(const struct rte_memseg_list *msl,
+		const struct rte_memseg *ms, void *arg)
+{
+	struct dma_mem_walk_param *param = arg;
+	struct dma_mem_run *run = &param->run;
+
+	/* skip external memory that isn't a heap */
+	if (msl->external && !msl->heap)
+		return 0;
+
+	/* skip any segments with invalid IOVA addresses */
+	if (ms->iova == RTE_BAD_IOVA)
+		return 0;
+
+	if (dma_mem_run_extend(run, msl, ms))
+		return 0;
+
+	if (run->len != 0 && dma_mem_maps_map(param->maps, run->addr,
+			run->iova, run->len, run->page_sz) < 0)
+		return -1;
+
+	dma_mem_run_start(run, msl, ms);
+	return 0;
+}
+
+int
+vfio_dma_mem_maps_map_all(struct vfio_dma_mem_maps *maps)
+{
+	struct dma_mem_walk_param param;
+	uint64_t ioctls, cycles;
+	struct dma_mem_run *run = &param.run;
+
+	memset(&param, 0, sizeof(param));
+	param.maps = maps;
+
+	ioctls = rte_atomic_load_explicit(&dma_stats.map_ioctls,
+			rte_memory_order_relaxed);
+	cycles = rte_atomic_load_explicit(&dma_stats.cycles,
+			rte_memory_order_relaxed);
+
+	if (rte_memseg_walk(dma_mem_maps_walk, &param) < 0)
+		return -1;
+	if (run->len != 0 && dma_mem_maps_map(maps, run->addr, run->iova,
+			run->len, run->page_sz) < 0)
+		return -1;
+
+	ioctls = rte_atomic_load_explicit(&dma_stats.map_ioctls,
+			rte_memory_order_relaxed) - ioctls;
+	cycles = rte_atomic_load_explicit(&dma_stats.cycles,
+			rte_memory_order_relaxed) - cycles;
+	EAL_LOG(DEBUG, "Mapped DPDK memory for DMA with %"PRIu64" calls in %"PRIu64" us",
+		ioctls, cycles * US_PER_S / rte_get_timer_hz());
+
+	return 0;
+}
+
+/* call `fn` for runs of contiguous segments in [addr, addr + len) */
+static void
+dma_mem_event_runs(const void *addr, size_t len,
+		void (*fn)(const struct dma_mem_run *run, void *arg), void *arg)
+{
+	struct rte_memseg_list *msl;
+	struct rte_memseg *ms;
+	struct dma_mem_run run;
+	size_t cur_len = 0;
+
+	memset(&run, 0, sizeof(run));
+	msl = rte_mem_virt2memseg_list(addr);
 
 	/* memsegs are contiguous in memory */
 	ms = rte_mem_virt2memseg(addr, msl);
@@ -639,18 +891,57 @@ vfio_mem_event_callback(enum rte_mem_event type, const void *addr, size_t len,
 			EAL_LOG(DEBUG,
 				"Memory segment at %p has bad IOVA, skipping",
 				ms->addr);
-			goto next;
+			if (run.len != 0)
+				fn(&run, arg);
+			run.len = 0;
+		} else if (!dma_mem_run_extend(&run, msl, ms)) {
+			if (run.len != 0)
+				fn(&run, arg);
+			dma_mem_run_start(&run, msl, ms);
 		}
-		if (type == RTE_MEM_EVENT_ALLOC)
-			vfio_dma_mem_map(default_vfio_cfg, ms->addr_64,
-					ms->iova, ms->len, 1);
-		else
-			vfio_dma_mem_map(default_vfio_cfg, ms->addr_64,
-					ms->iova, ms->len, 0);
-next:
 		cur_len += ms->len;
 		++ms;
 	}
+	if (run.len != 0)
+		fn(&run, arg);
+}
+
+static void
+dma_mem_maps_event_run(const struct dma_mem_run *run, void *arg)
+{
+	dma_mem_maps_map(arg, run->addr, run->iova, run->len, run->page_sz);
+}
+
+void
+vfio_dma_mem_maps_event(struct vfio_dma_mem_maps *maps,
+		enum rte_mem_event type, const void *addr, size_t len)
+{
+	/* mappings are tracked, no need to look up IOVA addresses */
+	if (type == RTE_MEM_EVENT_FREE)
+		dma_mem_maps_unmap(maps, (uint64_t)(uintptr_t)addr, len);
+	else
+		dma_mem_event_runs(addr, len, dma_mem_maps_event_run, maps);
+}
+
+static void
+vfio_mem_event_run(const struct dma_mem_run *run, void *arg)
+{
+	const enum rte_mem_event *type = arg;
+
+	vfio_dma_mem_map(default_vfio_cfg, run->addr, run->iova, run->len,
+			*type == RTE_MEM_EVENT_ALLOC);
+}
+
+static void
+vfio_mem_event_callback(enum rte_mem_event type, const void *addr, size_t len,
+		void *arg __rte_unused)
+{
+	const struct vfio_iommu_type *t = default_vfio_cfg->vfio_iommu_type;
+
+	if (t != NULL && t->type_id == RTE_VFIO_TYPE1)
+		vfio_dma_mem_maps_event(&dpdk_mem_maps, type, addr, len);
+	else
+		dma_mem_event_runs(addr, len, vfio_mem_event_run, &type);
 }
 
 static int
@@ -753,6 +1044,16 @@ rte_vfio_setup_device(const char *sysfs_base, const char *dev_addr,
 	const struct internal_config *internal_conf =
 		eal_get_internal_configuration();
 
+	/* devices are shared through the default IOAS instead of a container */
+	if (internal_conf->vfio_iommufd) {
+		uint32_t ioas_id;
+
+		if (vfio_iommufd_default_ioas(&ioas_id) < 0)
+			return -1;
+		return vfio_iommufd_setup_device(sysfs_base, dev_addr, ioas_id,
+				vfio_dev_fd, device_info);
+	}
+
 	/* get group number */
 	ret = rte_vfio_get_group_num(sysfs_base, dev_addr, &iommu_group_num);
 	if (ret == 0) {
@@ -997,6 +1298,12 @@ rte_vfio_release_device(const char *sysfs_base, const char *dev_addr,
 	int vfio_group_fd;
 	int iommu_group_num;
 	int ret;
+	const struct internal_config *internal_conf =
+		eal_get_internal_configuration();
+
+	/* default IOAS stays in place, closing the device detaches it */
+	if (internal_conf->vfio_iommufd)
+		return rte_vfio_iommufd_release_device(vfio_dev_fd);
 
 	/* we don't want any DMA mapping messages to come while we're detaching
 	 * VFIO device, because this might be the last device and we might need
@@ -1083,7 +1390,7 @@ rte_vfio_enable(const char *modname)
 	/* initialize group list */
 	int i, j;
 	int vfio_available;
-	const struct internal_config *internal_conf =
+	struct internal_config *internal_conf =
 		eal_get_internal_configuration();
 
 	rte_spinlock_recursive_t lock = RTE_SPINLOCK_RECURSIVE_INITIALIZER;
@@ -1119,6 +1426,14 @@ rte_vfio_enable(const char *modname)
 		return 0;
 	}
 
+	if (internal_conf->vfio_iommufd) {
+		if (vfio_iommufd_enable() == 0) {
+			default_vfio_cfg->vfio_enabled = 1;
+			internal_conf->free_alloc_units = 1;
+		}
+		return 0;
+	}
+
 	if (internal_conf->process_type == RTE_PROC_PRIMARY) {
 		/* open a new container */
 		default_vfio_cfg->vfio_container_fd =
@@ -1133,6 +1448,8 @@ rte_vfio_enable(const char *modname)
 	if (default_vfio_cfg->vfio_container_fd != -1) {
 		EAL_LOG(INFO, "VFIO support initialized");
 		default_vfio_cfg->vfio_enabled = 1;
+		/* DMA mappings of DPDK memory cannot be partially unmapped */
+		internal_conf->free_alloc_units = 1;
 	} else {
 		EAL_LOG(NOTICE, "VFIO support could not be initialized");
 	}
@@ -1396,42 +1713,65 @@ rte_vfio_get_group_num(const char *sysfs_base,
 }
 
 static int
-type1_map(const struct rte_memseg_list *msl, const struct rte_memseg *ms,
-		void *arg)
+type1_do_map(const struct vfio_dma_mem_maps *maps, uint64_t vaddr,
+		uint64_t iova, uint64_t len)
 {
-	int *vfio_container_fd = arg;
+	struct vfio_iommu_type1_dma_map dma_map;
+	uint64_t start = rte_get_timer_cycles();
+	int ret;
 
-	/* skip external memory that isn't a heap */
-	if (msl->external && !msl->heap)
-		return 0;
+	memset(&dma_map, 0, sizeof(dma_map));
+	dma_map.argsz = sizeof(struct vfio_iommu_type1_dma_map);
+	dma_map.vaddr = vaddr;
+	dma_map.size = len;
+	dma_map.iova = iova;
+	dma_map.flags = VFIO_DMA_MAP_FLAG_READ |
+			VFIO_DMA_MAP_FLAG_WRITE;
 
-	/* skip any segments with invalid IOVA addresses */
-	if (ms->iova == RTE_BAD_IOVA)
-		return 0;
+	ret = ioctl(maps->fd, VFIO_IOMMU_MAP_DMA, &dma_map);
+	vfio_dma_stats_update(true, start);
 
-	return vfio_type1_dma_mem_map(*vfio_container_fd, ms->addr_64, ms->iova,
-			ms->len, 1);
+	return ret;
 }
 
 static int
-vfio_type1_dma_mem_map(int vfio_container_fd, uint64_t vaddr, uint64_t iova,
-		uint64_t len, int do_map)
+type1_do_unmap(const struct vfio_dma_mem_maps *maps, uint64_t iova,
+		uint64_t len)
 {
-	struct vfio_iommu_type1_dma_map dma_map;
 	struct vfio_iommu_type1_dma_unmap dma_unmap;
+	uint64_t start = rte_get_timer_cycles();
 	int ret;
 
-	if (do_map != 0) {
-		memset(&dma_map, 0, sizeof(dma_map));
-		dma_map.argsz = sizeof(struct vfio_iommu_type1_dma_map);
-		dma_map.vaddr = vaddr;
-		dma_map.size = len;
-		dma_map.iova = iova;
-		dma_map.flags = VFIO_DMA_MAP_FLAG_READ |
-				VFIO_DMA_MAP_FLAG_WRITE;
+	memset(&dma_unmap, 0, sizeof(dma_unmap));
+	dma_unmap.argsz = sizeof(struct vfio_iommu_type1_dma_unmap);
+	dma_unmap.size = len;
+	dma_unmap.iova = iova;
 
-		ret = ioctl(vfio_container_fd, VFIO_IOMMU_MAP_DMA, &dma_map);
-		if (ret) {
+	ret = ioctl(maps->fd, VFIO_IOMMU_UNMAP_DMA, &dma_unmap);
+	vfio_dma_stats_update(false, start);
+	if (ret) {
+		EAL_LOG(ERR, "Cannot clear DMA remapping, error "
+				"%i (%s)", errno, strerror(errno));
+		return -1;
+	} else if (dma_unmap.size != len) {
+		EAL_LOG(ERR, "Unexpected size %"PRIu64
+			" of DMA remapping cleared instead of %"PRIu64,
+			(uint64_t)dma_unmap.size, len);
+		rte_errno = EIO;
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+vfio_type1_dma_mem_map(int vfio_container_fd, uint64_t vaddr, uint64_t iova,
+		uint64_t len, int do_map)
+{
+	const struct vfio_dma_mem_maps maps = { .fd = vfio_container_fd };
+
+	if (do_map != 0) {
+		if (type1_do_map(&maps, vaddr, iova, len)) {
 			/**
 			 * In case the mapping was already done EEXIST will be
 			 * returned from kernel.
@@ -1447,24 +1787,8 @@ vfio_type1_dma_mem_map(int vfio_container_fd, uint64_t vaddr, uint64_t iova,
 			}
 		}
 	} else {
-		memset(&dma_unmap, 0, sizeof(dma_unmap));
-		dma_unmap.argsz = sizeof(struct vfio_iommu_type1_dma_unmap);
-		dma_unmap.size = len;
-		dma_unmap.iova = iova;
-
-		ret = ioctl(vfio_container_fd, VFIO_IOMMU_UNMAP_DMA,
-				&dma_unmap);
-		if (ret) {
-			EAL_LOG(ERR, "Cannot clear DMA remapping, error "
-					"%i (%s)", errno, strerror(errno));
-			return -1;
-		} else if (dma_unmap.size != len) {
-			EAL_LOG(ERR, "Unexpected size %"PRIu64
-				" of DMA remapping cleared instead of %"PRIu64,
-				(uint64_t)dma_unmap.size, len);
-			rte_errno = EIO;
+		if (type1_do_unmap(&maps, iova, len))
 			return -1;
-		}
 	}
 
 	return 0;
@@ -1473,7 +1797,11 @@ vfio_type1_dma_mem_map(int vfio_container_fd, uint64_t vaddr, uint64_t iova,
 static int
 vfio_type1_dma_map(int vfio_container_fd)
 {
-	return rte_memseg_walk(type1_map, &vfio_container_fd);
+	/* container is new or has lost all its groups, and mappings with them */
+	vfio_dma_mem_maps_reset(&dpdk_mem_maps);
+	dpdk_mem_maps.fd = vfio_container_fd;
+
+	return vfio_dma_mem_maps_map_all(&dpdk_mem_maps);
 }
 
 /* Track the size of the statically allocated DMA window for SPAPR */
@@ -2157,17 +2485,35 @@ rte_vfio_container_group_unbind(int container_fd, int iommu_group_num)
 	return 0;
 }
 
+/* with iommufd, the default container is the default IOAS */
+static bool
+default_container_is_ioas(int container_fd)
+{
+	const struct internal_config *internal_conf =
+		eal_get_internal_configuration();
+
+	return container_fd == RTE_VFIO_DEFAULT_CONTAINER_FD &&
+		internal_conf->vfio_iommufd;
+}
+
 int
 rte_vfio_container_dma_map(int container_fd, uint64_t vaddr, uint64_t iova,
 		uint64_t len)
 {
 	struct vfio_config *vfio_cfg;
+	uint32_t ioas_id;
 
 	if (len == 0) {
 		rte_errno = EINVAL;
 		return -1;
 	}
 
+	if (default_container_is_ioas(container_fd)) {
+		if (vfio_iommufd_default_ioas(&ioas_id) < 0)
+			return -1;
+		return rte_vfio_iommufd_dma_map(ioas_id, vaddr, iova, len);
+	}
+
 	vfio_cfg = get_vfio_cfg_by_container_fd(container_fd);
 	if (vfio_cfg == NULL) {
 		EAL_LOG(ERR, "Invalid VFIO container fd");
@@ -2182,12 +2528,19 @@ rte_vfio_container_dma_unmap(int container_fd, uint64_t vaddr, uint64_t iova,
 		uint64_t len)
 {
 	struct vfio_config *vfio_cfg;
+	uint32_t ioas_id;
 
 	if (len == 0) {
 		rte_errno = EINVAL;
 		return -1;
 	}
 
+	if (default_container_is_ioas(container_fd)) {
+		if (vfio_iommufd_default_ioas(&ioas_id) < 0)
+			return -1;
+		return rte_vfio_iommufd_dma_unmap(ioas_id, iova, len);
+	}
+
 	vfio_cfg = get_vfio_cfg_by_container_fd(container_fd);
 	if (vfio_cfg == NULL) {
 		EAL_LOG(ERR, "Invalid VFIO container fd");
@@ -2196,3 +2549,38 @@ rte_vfio_container_dma_unmap(int container_fd, uint64_t vaddr, uint64_t iova,
 
 	return container_dma_unmap(vfio_cfg, vaddr, iova, len);
 }
+
+static int
+handle_vfio_dma_stats_request(const char *cmd __rte_unused,
+		const char *params __rte_unused, struct rte_tel_data *d)
+{
+	uint64_t cycles;
+	int n_maps;
+
+	rte_mcfg_mem_read_lock();
+	n_maps = dpdk_mem_maps.n_maps;
+	rte_mcfg_mem_read_unlock();
+
+	cycles = rte_atomic_load_explicit(&dma_stats.cycles,
+			rte_memory_order_relaxed);
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_uint(d, "map_ioctls",
+			rte_atomic_load_explicit(&dma_stats.map_ioctls,
+				rte_memory_order_relaxed));
+	rte_tel_data_add_dict_uint(d, "unmap_ioctls",
+			rte_atomic_load_explicit(&dma_stats.unmap_ioctls,
+				rte_memory_order_relaxed));
+	rte_tel_data_add_dict_uint(d, "ioctl_time_us",
+			cycles * US_PER_S / rte_get_timer_hz());
+	rte_tel_data_add_dict_int(d, "dpdk_mem_maps", n_maps);
+
+	return 0;
+}
+
+RTE_INIT(vfio_telemetry)
+{
+	rte_telemetry_register_cmd(VFIO_DMA_STATS_REQ,
+			handle_vfio_dma_stats_request,
+			"Returns VFIO DMA mapping statistics. Takes no parameters");
+}
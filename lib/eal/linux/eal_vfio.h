@@ -6,6 +6,7 @@
 #define EAL_VFIO_H_
 
 #include <rte_common.h>
+#include <rte_memory.h>
 
 /*
  * determine if VFIO is present on the system
@@ -83,6 +84,84 @@ struct vfio_iommu_spapr_tce_info {
 #define RTE_VFIO_SPAPR VFIO_SPAPR_TCE_v2_IOMMU
 #endif
 
+/* iommufd and VFIO device cdev interfaces */
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 6, 0)
+#include <linux/iommufd.h>
+#else
+#define IOMMUFD_TYPE (';')
+#define IOMMUFD_CMD_BASE 0x80
+#define IOMMU_DESTROY _IO(IOMMUFD_TYPE, IOMMUFD_CMD_BASE)
+#define IOMMU_IOAS_ALLOC _IO(IOMMUFD_TYPE, IOMMUFD_CMD_BASE + 1)
+#define IOMMU_IOAS_MAP _IO(IOMMUFD_TYPE, IOMMUFD_CMD_BASE + 5)
+#define IOMMU_IOAS_UNMAP _IO(IOMMUFD_TYPE, IOMMUFD_CMD_BASE + 6)
+#define IOMMU_OPTION _IO(IOMMUFD_TYPE, IOMMUFD_CMD_BASE + 7)
+
+#define IOMMU_IOAS_MAP_FIXED_IOVA (1 << 0)
+#define IOMMU_IOAS_MAP_WRITEABLE (1 << 1)
+#define IOMMU_IOAS_MAP_READABLE (1 << 2)
+
+#define IOMMU_OPTION_HUGE_PAGES 1
+#define IOMMU_OPTION_OP_SET 0
+
+struct iommu_destroy {
+	uint32_t size;
+	uint32_t id;
+};
+
+struct iommu_ioas_alloc {
+	uint32_t size;
+	uint32_t flags;
+	uint32_t out_ioas_id;
+};
+
+struct iommu_ioas_map {
+	uint32_t size;
+	uint32_t flags;
+	uint32_t ioas_id;
+	uint32_t __reserved;
+	uint64_t user_va;
+	uint64_t length;
+	uint64_t iova;
+};
+
+struct iommu_ioas_unmap {
+	uint32_t size;
+	uint32_t ioas_id;
+	uint64_t iova;
+	uint64_t length;
+};
+
+struct iommu_option {
+	uint32_t size;
+	uint32_t option_id;
+	uint16_t op;
+	uint16_t __reserved;
+	uint32_t object_id;
+	uint64_t val64;
+};
+#endif /* kernel version >= 6.6.0 */
+
+#ifndef VFIO_DEVICE_BIND_IOMMUFD
+#define VFIO_DEVICE_BIND_IOMMUFD _IO(VFIO_TYPE, VFIO_BASE + 18)
+#define VFIO_DEVICE_ATTACH_IOMMUFD_PT _IO(VFIO_TYPE, VFIO_BASE + 19)
+
+struct vfio_device_bind_iommufd {
+	uint32_t argsz;
+	uint32_t flags;
+	int32_t iommufd;
+	uint32_t out_devid;
+};
+
+struct vfio_device_attach_iommufd_pt {
+	uint32_t argsz;
+	uint32_t flags;
+	uint32_t pt_id;
+};
+#endif /* VFIO_DEVICE_BIND_IOMMUFD */
+
+#define VFIO_IOMMUFD_PATH "/dev/iommu"
+#define VFIO_CDEV_DIR "/dev/vfio/devices"
+
 #define VFIO_MAX_GROUPS RTE_MAX_VFIO_GROUPS
 #define VFIO_MAX_CONTAINERS RTE_MAX_VFIO_CONTAINERS
 
@@ -135,6 +214,56 @@ vfio_has_supported_extensions(int vfio_container_fd);
 int vfio_mp_sync_setup(void);
 void vfio_mp_sync_cleanup(void);
 
+/* count a DMA map or unmap call started at `start` timer cycles */
+void vfio_dma_stats_update(bool map, uint64_t start);
+
+/*
+ * DPDK memory is mapped for DMA in runs of VA and IOVA contiguous segments of
+ * a single allocation rather than one segment at a time. Neither Type 1 IOMMU
+ * nor iommufd can unmap a part of a mapping, so the heap only frees whole
+ * allocations while VFIO is enabled, and runs are unmapped as recorded.
+ * Mappings are tracked so that they can be unmapped without looking up IOVA
+ * addresses.
+ */
+struct vfio_dma_mem_map {
+	uint64_t addr;
+	uint64_t iova;
+	uint64_t len;
+};
+
+struct vfio_dma_mem_maps {
+	int fd; /**< container or iommufd fd */
+	uint32_t ioas_id; /**< IOAS to map into, iommufd only */
+	/** map memory, returns -1 and sets errno on failure */
+	int (*do_map)(const struct vfio_dma_mem_maps *maps, uint64_t vaddr,
+			uint64_t iova, uint64_t len);
+	/** unmap memory, returns -1 on failure */
+	int (*do_unmap)(const struct vfio_dma_mem_maps *maps, uint64_t iova,
+			uint64_t len);
+	int n_maps;
+	int max_maps;
+	struct vfio_dma_mem_map *maps; /**< sorted by VA */
+};
+
+/* map all DPDK memory */
+int vfio_dma_mem_maps_map_all(struct vfio_dma_mem_maps *maps);
+
+/* map or unmap DPDK memory on memory hotplug event */
+void vfio_dma_mem_maps_event(struct vfio_dma_mem_maps *maps,
+		enum rte_mem_event type, const void *addr, size_t len);
+
+/* forget all mappings, without unmapping them */
+void vfio_dma_mem_maps_reset(struct vfio_dma_mem_maps *maps);
+
+/* iommufd backend, see eal_vfio_iommufd.c */
+int vfio_iommufd_enable(void);
+
+int vfio_iommufd_setup_device(const char *sysfs_base, const char *dev_addr,
+		uint32_t ioas_id, int *vfio_dev_fd,
+		struct vfio_device_info *device_info);
+
+int vfio_iommufd_default_ioas(uint32_t *ioas_id);
+
 #define EAL_VFIO_MP "eal_vfio_mp_sync"
 
 #define SOCKET_REQ_CONTAINER 0x100
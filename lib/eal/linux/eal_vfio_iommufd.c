@@ -0,0 +1,465 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+#include <rte_cycles.h>
+#include <rte_eal_memconfig.h>
+#include <rte_errno.h>
+#include <rte_log.h>
+#include <rte_memory.h>
+#include <rte_spinlock.h>
+#include <rte_vfio.h>
+
+#include "eal_internal_cfg.h"
+#include "eal_private.h"
+#include "eal_vfio.h"
+
+/*
+ * iommufd backend.
+ *
+ * Instead of a VFIO container per set of groups, devices are opened through
+ * their VFIO character device and attached to an I/O address space (IOAS)
+ * of iommufd. An IOAS can be shared by any number of devices, so memory is
+ * only mapped once no matter how many devices use it, and attaching another
+ * device does not replay any mappings.
+ *
+ * Applications may create their own IOAS. Devices set up by EAL, i.e. when
+ * --vfio-iommufd is given, share a default IOAS that has all DPDK memory
+ * mapped and follows memory hotplug.
+ */
+
+#define VFIO_IOMMUFD_MEM_EVENT_CLB_NAME "vfio_iommufd_mem_event_clb"
+
+static int ioas_do_map(const struct vfio_dma_mem_maps *, uint64_t, uint64_t,
+		uint64_t);
+static int ioas_do_unmap(const struct vfio_dma_mem_maps *, uint64_t,
+		uint64_t);
+
+static rte_spinlock_t iommufd_lock = RTE_SPINLOCK_INITIALIZER;
+static int iommufd = -1;
+
+/* default IOAS, protected by memory hotplug lock */
+static bool default_ioas_ready;
+static struct vfio_dma_mem_maps default_ioas_maps = {
+	.fd = -1,
+	.do_map = ioas_do_map,
+	.do_unmap = ioas_do_unmap,
+};
+
+static int
+iommufd_get(void)
+{
+	int fd;
+
+	rte_spinlock_lock(&iommufd_lock);
+	if (iommufd < 0) {
+		iommufd = open(VFIO_IOMMUFD_PATH, O_RDWR);
+		if (iommufd < 0) {
+			EAL_LOG(DEBUG, "Cannot open %s: %s",
+				VFIO_IOMMUFD_PATH, strerror(errno));
+			rte_errno = ENODEV;
+		}
+	}
+	fd = iommufd;
+	rte_spinlock_unlock(&iommufd_lock);
+
+	return fd;
+}
+
+static int
+ioas_do_map(const struct vfio_dma_mem_maps *maps, uint64_t vaddr,
+		uint64_t iova, uint64_t len)
+{
+	struct iommu_ioas_map map = {
+		.size = sizeof(map),
+		.flags = IOMMU_IOAS_MAP_FIXED_IOVA | IOMMU_IOAS_MAP_READABLE |
+			IOMMU_IOAS_MAP_WRITEABLE,
+		.ioas_id = maps->ioas_id,
+		.user_va = vaddr,
+		.length = len,
+		.iova = iova,
+	};
+	uint64_t start = rte_get_timer_cycles();
+	int ret;
+
+	ret = ioctl(maps->fd, IOMMU_IOAS_MAP, &map);
+	vfio_dma_stats_update(true, start);
+
+	return ret;
+}
+
+static int
+ioas_do_unmap(const struct vfio_dma_mem_maps *maps, uint64_t iova,
+		uint64_t len)
+{
+	struct iommu_ioas_unmap unmap = {
+		.size = sizeof(unmap),
+		.ioas_id = maps->ioas_id,
+		.iova = iova,
+		.length = len,
+	};
+	uint64_t start = rte_get_timer_cycles();
+	int ret;
+
+	ret = ioctl(maps->fd, IOMMU_IOAS_UNMAP, &unmap);
+	vfio_dma_stats_update(false, start);
+	if (ret) {
+		EAL_LOG(ERR, "Cannot clear DMA mapping of IOAS %u, error %i (%s)",
+			maps->ioas_id, errno, strerror(errno));
+		return -1;
+	} else if (unmap.length != len) {
+		EAL_LOG(ERR, "Unexpected size %"PRIu64
+			" of DMA mapping cleared instead of %"PRIu64,
+			(uint64_t)unmap.length, len);
+		rte_errno = EIO;
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+ioas_alloc(int fd, uint32_t *ioas_id)
+{
+	struct iommu_ioas_alloc alloc = { .size = sizeof(alloc) };
+	struct iommu_option option = {
+		.size = sizeof(option),
+		.option_id = IOMMU_OPTION_HUGE_PAGES,
+		.op = IOMMU_OPTION_OP_SET,
+		.val64 = 1,
+	};
+
+	if (ioctl(fd, IOMMU_IOAS_ALLOC, &alloc)) {
+		EAL_LOG(ERR, "Cannot allocate IOAS, error %i (%s)",
+			errno, strerror(errno));
+		rte_errno = errno;
+		return -1;
+	}
+
+	/* hugepage backed memory should be mapped with huge IOPTEs, so that
+	 * fewer IOTLB entries are needed. this is the default, but make sure.
+	 */
+	option.object_id = alloc.out_ioas_id;
+	if (ioctl(fd, IOMMU_OPTION, &option))
+		EAL_LOG(DEBUG, "Cannot enable huge pages for IOAS %u: %s",
+			alloc.out_ioas_id, strerror(errno));
+
+	*ioas_id = alloc.out_ioas_id;
+	return 0;
+}
+
+static int
+iommufd_destroy(int fd, uint32_t id)
+{
+	struct iommu_destroy destroy = {
+		.size = sizeof(destroy),
+		.id = id,
+	};
+
+	if (ioctl(fd, IOMMU_DESTROY, &destroy)) {
+		EAL_LOG(ERR, "Cannot destroy iommufd object %u, error %i (%s)",
+			id, errno, strerror(errno));
+		rte_errno = errno;
+		return -1;
+	}
+	return 0;
+}
+
+static void
+vfio_iommufd_mem_event_callback(enum rte_mem_event type, const void *addr,
+		size_t len, void *arg __rte_unused)
+{
+	vfio_dma_mem_maps_event(&default_ioas_maps, type, addr, len);
+}
+
+/* create default IOAS and map all DPDK memory, with hotplug lock held */
+static int
+default_ioas_init(void)
+{
+	int fd;
+
+	if (default_ioas_ready)
+		return 0;
+
+	fd = iommufd_get();
+	if (fd < 0)
+		return -1;
+
+	if (ioas_alloc(fd, &default_ioas_maps.ioas_id) < 0)
+		return -1;
+	default_ioas_maps.fd = fd;
+
+	if (vfio_dma_mem_maps_map_all(&default_ioas_maps) < 0)
+		goto err;
+
+	if (rte_mem_event_callback_register(VFIO_IOMMUFD_MEM_EVENT_CLB_NAME,
+			vfio_iommufd_mem_event_callback, NULL) &&
+			rte_errno != ENOTSUP) {
+		EAL_LOG(ERR, "Could not install memory event callback for iommufd");
+		goto err;
+	}
+
+	EAL_LOG(DEBUG, "Using IOAS %u for VFIO devices",
+		default_ioas_maps.ioas_id);
+	default_ioas_ready = true;
+	return 0;
+err:
+	/* destroying IOAS unmaps everything */
+	iommufd_destroy(fd, default_ioas_maps.ioas_id);
+	vfio_dma_mem_maps_reset(&default_ioas_maps);
+	return -1;
+}
+
+int
+vfio_iommufd_default_ioas(uint32_t *ioas_id)
+{
+	int ret;
+
+	/* lock memory hotplug so that no event gets lost while mapping */
+	rte_mcfg_mem_read_lock();
+	ret = default_ioas_init();
+	*ioas_id = default_ioas_maps.ioas_id;
+	rte_mcfg_mem_read_unlock();
+
+	return ret;
+}
+
+int
+vfio_iommufd_enable(void)
+{
+	if (iommufd_get() < 0) {
+		EAL_LOG(NOTICE, "iommufd support could not be initialized");
+		return -1;
+	}
+
+	EAL_LOG(INFO, "VFIO iommufd support initialized");
+	return 0;
+}
+
+/*
+ * find VFIO character device of a device and open it, returns -ENODEV if
+ * there is none, or -1 if it cannot be opened
+ */
+static int
+vfio_cdev_open(const char *sysfs_base, const char *dev_addr)
+{
+	char path[PATH_MAX];
+	struct dirent *e;
+	DIR *dir;
+	int fd;
+
+	snprintf(path, sizeof(path), "%s/%s/vfio-dev", sysfs_base, dev_addr);
+	dir = opendir(path);
+	if (dir == NULL)
+		return -ENODEV;
+
+	fd = -ENODEV;
+	while ((e = readdir(dir)) != NULL) {
+		if (strncmp(e->d_name, "vfio", strlen("vfio")) != 0)
+			continue;
+
+		snprintf(path, sizeof(path), VFIO_CDEV_DIR "/%s", e->d_name);
+		fd = open(path, O_RDWR);
+		if (fd < 0)
+			EAL_LOG(ERR, "Cannot open %s: %s", path,
+				strerror(errno));
+		break;
+	}
+	closedir(dir);
+
+	return fd;
+}
+
+int
+vfio_iommufd_setup_device(const char *sysfs_base, const char *dev_addr,
+		uint32_t ioas_id, int *vfio_dev_fd,
+		struct vfio_device_info *device_info)
+{
+	struct vfio_device_bind_iommufd bind = {
+		.argsz = sizeof(bind),
+	};
+	struct vfio_device_attach_iommufd_pt attach = {
+		.argsz = sizeof(attach),
+		.pt_id = ioas_id,
+	};
+	rte_uuid_t vf_token;
+	int fd, iommu_fd;
+
+	if (rte_eal_process_type() != RTE_PROC_PRIMARY) {
+		EAL_LOG(ERR, "iommufd is not supported in secondary processes");
+		rte_errno = ENOTSUP;
+		return -1;
+	}
+
+	rte_eal_vfio_get_vf_token(vf_token);
+	if (!rte_uuid_is_null(vf_token)) {
+		EAL_LOG(ERR, "VF token is not supported with iommufd");
+		rte_errno = ENOTSUP;
+		return -1;
+	}
+
+	iommu_fd = iommufd_get();
+	if (iommu_fd < 0)
+		return -1;
+
+	fd = vfio_cdev_open(sysfs_base, dev_addr);
+	if (fd == -ENODEV) {
+		EAL_LOG(NOTICE, "%s not managed by VFIO driver, skipping",
+			dev_addr);
+		return 1;
+	}
+	if (fd < 0)
+		return -1;
+
+	bind.iommufd = iommu_fd;
+	if (ioctl(fd, VFIO_DEVICE_BIND_IOMMUFD, &bind)) {
+		EAL_LOG(ERR, "%s cannot bind to iommufd, error %i (%s)",
+			dev_addr, errno, strerror(errno));
+		goto err;
+	}
+
+	if (ioctl(fd, VFIO_DEVICE_ATTACH_IOMMUFD_PT, &attach)) {
+		EAL_LOG(ERR, "%s cannot attach to IOAS %u, error %i (%s)",
+			dev_addr, ioas_id, errno, strerror(errno));
+		goto err;
+	}
+
+	if (ioctl(fd, VFIO_DEVICE_GET_INFO, device_info)) {
+		EAL_LOG(ERR, "%s cannot get device info, error %i (%s)",
+			dev_addr, errno, strerror(errno));
+		goto err;
+	}
+
+	*vfio_dev_fd = fd;
+	return 0;
+err:
+	rte_errno = errno;
+	/* closing the device also unbinds and detaches it */
+	close(fd);
+	return -1;
+}
+
+int
+rte_vfio_iommufd_get_fd(void)
+{
+	return iommufd_get();
+}
+
+int
+rte_vfio_iommufd_ioas_create(uint32_t *ioas_id)
+{
+	int fd;
+
+	if (ioas_id == NULL) {
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	fd = iommufd_get();
+	if (fd < 0)
+		return -1;
+
+	return ioas_alloc(fd, ioas_id);
+}
+
+int
+rte_vfio_iommufd_ioas_destroy(uint32_t ioas_id)
+{
+	int fd;
+
+	fd = iommufd_get();
+	if (fd < 0)
+		return -1;
+
+	if (default_ioas_ready && ioas_id == default_ioas_maps.ioas_id) {
+		EAL_LOG(ERR, "Cannot destroy default IOAS");
+		rte_errno = EBUSY;
+		return -1;
+	}
+
+	return iommufd_destroy(fd, ioas_id);
+}
+
+int
+rte_vfio_iommufd_dma_map(uint32_t ioas_id, uint64_t vaddr, uint64_t iova,
+		uint64_t len)
+{
+	struct vfio_dma_mem_maps maps = { .ioas_id = ioas_id };
+
+	if (len == 0) {
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	maps.fd = iommufd_get();
+	if (maps.fd < 0)
+		return -1;
+
+	if (ioas_do_map(&maps, vaddr, iova, len)) {
+		EAL_LOG(ERR, "Cannot map memory into IOAS %u, error %i (%s)",
+			ioas_id, errno, strerror(errno));
+		rte_errno = errno;
+		return -1;
+	}
+	return 0;
+}
+
+int
+rte_vfio_iommufd_dma_unmap(uint32_t ioas_id, uint64_t iova, uint64_t len)
+{
+	struct vfio_dma_mem_maps maps = { .ioas_id = ioas_id };
+
+	if (len == 0) {
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	maps.fd = iommufd_get();
+	if (maps.fd < 0)
+		return -1;
+
+	return ioas_do_unmap(&maps, iova, len);
+}
+
+int
+rte_vfio_iommufd_get_default_ioas(uint32_t *ioas_id)
+{
+	if (ioas_id == NULL) {
+		rte_errno = EINVAL;
+		return -1;
+	}
+	return vfio_iommufd_default_ioas(ioas_id);
+}
+
+int
+rte_vfio_iommufd_setup_device(const char *sysfs_base, const char *dev_addr,
+		uint32_t ioas_id, int *vfio_dev_fd,
+		struct vfio_device_info *device_info)
+{
+	if (sysfs_base == NULL || dev_addr == NULL || vfio_dev_fd == NULL ||
+			device_info == NULL) {
+		rte_errno = EINVAL;
+		return -1;
+	}
+	return vfio_iommufd_setup_device(sysfs_base, dev_addr, ioas_id,
+			vfio_dev_fd, device_info);
+}
+
+int
+rte_vfio_iommufd_release_device(int vfio_dev_fd)
+{
+	if (close(vfio_dev_fd) < 0) {
+		rte_errno = errno;
+		return -1;
+	}
+	return 0;
+}
@@ -714,6 +714,78 @@ rte_mempool_populate_anon(struct rte_mempool *mp)
 	return 0;
 }
 
+/* free the rings of objects returned to the adaptive caches */
+static void
+mempool_cache_adaptive_free(struct rte_mempool *mp)
+{
+	unsigned int lcore_id;
+
+	if (mp->cache_size == 0 || mp->local_cache == NULL)
+		return;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		rte_free(mp->local_cache[lcore_id].returned);
+		mp->local_cache[lcore_id].returned = NULL;
+	}
+}
+
+/*
+ * Set the size bounds of the default caches and give each EAL lcore a ring
+ * where other lcores put back the objects it allocated.
+ */
+static int
+mempool_cache_adaptive_init(struct rte_mempool *mp)
+{
+	struct rte_mempool_cache *cache;
+	unsigned int min_size, max_size;
+	unsigned int lcore_id;
+	ssize_t ring_size;
+	int ret;
+
+	min_size = RTE_MAX(mp->cache_size / 4, 1U);
+	max_size = RTE_MIN(mp->cache_size * 4, (uint32_t)RTE_MEMPOOL_CACHE_MAX_SIZE);
+	/* Do not let the caches of all lcores drain the pool */
+	max_size = RTE_MIN(max_size, (mp->size * 2) / (3 * rte_lcore_count()));
+	max_size = RTE_MAX(max_size, mp->cache_size);
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		cache = &mp->local_cache[lcore_id];
+		cache->min_size = min_size;
+		cache->max_size = max_size;
+	}
+
+	ring_size = rte_ring_get_memsize(RTE_MEMPOOL_CACHE_MAX_SIZE * 2);
+	if (ring_size < 0) {
+		rte_errno = -ring_size;
+		return -rte_errno;
+	}
+
+	RTE_LCORE_FOREACH(lcore_id) {
+		cache = &mp->local_cache[lcore_id];
+		cache->returned = rte_zmalloc_socket("MEMPOOL_RETURNED",
+				ring_size, RTE_CACHE_LINE_SIZE,
+				rte_lcore_to_socket_id(lcore_id));
+		if (cache->returned == NULL) {
+			RTE_MEMPOOL_LOG(ERR, "Cannot allocate returned objects ring.");
+			rte_errno = ENOMEM;
+			goto fail;
+		}
+
+		ret = rte_ring_init(cache->returned, mp->name,
+				RTE_MEMPOOL_CACHE_MAX_SIZE * 2, RING_F_SC_DEQ);
+		if (ret < 0) {
+			rte_errno = -ret;
+			goto fail;
+		}
+	}
+
+	return 0;
+
+fail:
+	mempool_cache_adaptive_free(mp);
+	return -rte_errno;
+}
+
 /* free a mempool */
 void
 rte_mempool_free(struct rte_mempool *mp)
@@ -742,6 +814,7 @@ rte_mempool_free(struct rte_mempool *mp)
 	rte_mempool_trace_free(mp);
 	rte_mempool_free_memchunks(mp);
 	rte_mempool_ops_free(mp);
+	mempool_cache_adaptive_free(mp);
 	rte_memzone_free(mp->mz);
 }
 
@@ -945,6 +1018,9 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
 			mempool_cache_init(&mp->local_cache[lcore_id],
 					   cache_size);
+		if ((flags & RTE_MEMPOOL_F_ADAPTIVE_CACHE) &&
+				mempool_cache_adaptive_init(mp) < 0)
+			goto exit_unlock;
 	}
 
 	te->data = mp;
@@ -1013,8 +1089,11 @@ rte_mempool_avail_count(const struct rte_mempool *mp)
 	if (mp->cache_size == 0)
 		return count;
 
-	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
 		count += mp->local_cache[lcore_id].len;
+		if (mp->local_cache[lcore_id].returned != NULL)
+			count += rte_ring_count(mp->local_cache[lcore_id].returned);
+	}
 
 	/*
 	 * due to race condition (access to len is not locked), the
@@ -1047,9 +1126,19 @@ rte_mempool_dump_cache(FILE *f, const struct rte_mempool *mp)
 		return count;
 
 	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
-		cache_count = mp->local_cache[lcore_id].len;
+		const struct rte_mempool_cache *cache = &mp->local_cache[lcore_id];
+
+		cache_count = cache->len;
 		fprintf(f, "    cache_count[%u]=%"PRIu32"\n",
 			lcore_id, cache_count);
+		if (cache->max_size != 0 && cache->size != mp->cache_size)
+			fprintf(f, "    cache_size[%u]=%"PRIu32"\n",
+				lcore_id, cache->size);
+		if (cache->returned != NULL && !rte_ring_empty(cache->returned)) {
+			fprintf(f, "    returned_count[%u]=%u\n",
+				lcore_id, rte_ring_count(cache->returned));
+			cache_count += rte_ring_count(cache->returned);
+		}
 		count += cache_count;
 	}
 	fprintf(f, "    total_cache_count=%u\n", count);
@@ -1287,6 +1376,10 @@ rte_mempool_dump(FILE *f, struct rte_mempool *mp)
 		sum.get_fail_objs += mp->stats[lcore_id].get_fail_objs;
 		sum.get_success_blks += mp->stats[lcore_id].get_success_blks;
 		sum.get_fail_blks += mp->stats[lcore_id].get_fail_blks;
+		sum.cache_grow += mp->stats[lcore_id].cache_grow;
+		sum.cache_shrink += mp->stats[lcore_id].cache_shrink;
+		sum.put_return_objs += mp->stats[lcore_id].put_return_objs;
+		sum.get_return_objs += mp->stats[lcore_id].get_return_objs;
 	}
 	if (mp->cache_size != 0) {
 		/* Add the statistics stored in the mempool caches. */
@@ -1313,6 +1406,14 @@ rte_mempool_dump(FILE *f, struct rte_mempool *mp)
 			sum.get_success_blks);
 		fprintf(f, "    get_fail_blks=%"PRIu64"\n", sum.get_fail_blks);
 	}
+	if (mp->flags & RTE_MEMPOOL_F_ADAPTIVE_CACHE) {
+		fprintf(f, "    cache_grow=%"PRIu64"\n", sum.cache_grow);
+		fprintf(f, "    cache_shrink=%"PRIu64"\n", sum.cache_shrink);
+		fprintf(f, "    put_return_objs=%"PRIu64"\n",
+			sum.put_return_objs);
+		fprintf(f, "    get_return_objs=%"PRIu64"\n",
+			sum.get_return_objs);
+	}
 #else
 	fprintf(f, "  no statistics available\n");
 #endif
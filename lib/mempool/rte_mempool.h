@@ -43,6 +43,7 @@
 #include <rte_config.h>
 #include <rte_spinlock.h>
 #include <rte_debug.h>
+#include <rte_errno.h>
 #include <rte_lcore.h>
 #include <rte_log.h>
 #include <rte_branch_prediction.h>
@@ -80,6 +81,10 @@ struct __rte_cache_aligned rte_mempool_debug_stats {
 	uint64_t get_fail_objs;        /**< Objects that failed to be allocated. */
 	uint64_t get_success_blks;     /**< Successful allocation number of contiguous blocks. */
 	uint64_t get_fail_blks;        /**< Failed allocation number of contiguous blocks. */
+	uint64_t cache_grow;           /**< Number of times the adaptive cache grew. */
+	uint64_t cache_shrink;         /**< Number of times the adaptive cache shrank. */
+	uint64_t put_return_objs;      /**< Objects returned to another lcore cache. */
+	uint64_t get_return_objs;      /**< Objects taken from those returned by other lcores. */
 	RTE_CACHE_GUARD;
 };
 #endif
@@ -91,8 +96,11 @@ struct __rte_cache_aligned rte_mempool_cache {
 	uint32_t size;	      /**< Size of the cache */
 	uint32_t flushthresh; /**< Threshold before we flush excess elements */
 	uint32_t len;	      /**< Current cache count */
+	/** Smallest size of an adaptive cache, see RTE_MEMPOOL_F_ADAPTIVE_CACHE */
+	uint16_t min_size;
+	/** Largest size of an adaptive cache, zero if the size is fixed */
+	uint16_t max_size;
 #ifdef RTE_LIBRTE_MEMPOOL_STATS
-	uint32_t unused;
 	/*
 	 * Alternative location for the most frequently updated mempool statistics (per-lcore),
 	 * providing faster update access when using a mempool cache.
@@ -104,6 +112,13 @@ struct __rte_cache_aligned rte_mempool_cache {
 		uint64_t get_success_objs;  /**< Objects successfully allocated. */
 	} stats;                        /**< Statistics */
 #endif
+	/** Objects put back by other lcores, NULL if not an adaptive cache */
+	struct rte_ring *returned;
+	uint16_t win_ops;   /**< Gets and puts in the current window */
+	uint16_t win_miss;  /**< Gets which went to the backend in the window */
+	uint16_t win_flush; /**< Puts which went to the backend in the window */
+	/** Objects reserved by the last zero-copy get or put start */
+	uint16_t zc_len;
 	/**
 	 * Cache objects
 	 *
@@ -310,6 +325,11 @@ struct __rte_cache_aligned rte_mempool {
 #define MEMPOOL_F_NO_IOVA_CONTIG	RTE_MEMPOOL_F_NO_IOVA_CONTIG
 /** Internal: no object from the pool can be used for device IO (DMA). */
 #define RTE_MEMPOOL_F_NON_IO		0x0040
+/**
+ * Resize the per-lcore caches to the observed get/put imbalance and let
+ * objects be put back into the cache of another lcore.
+ */
+#define RTE_MEMPOOL_F_ADAPTIVE_CACHE	0x0080
 
 /**
  * This macro lists all the mempool flags an application may request.
@@ -319,6 +339,7 @@ struct __rte_cache_aligned rte_mempool {
 	| RTE_MEMPOOL_F_SP_PUT \
 	| RTE_MEMPOOL_F_SC_GET \
 	| RTE_MEMPOOL_F_NO_IOVA_CONTIG \
+	| RTE_MEMPOOL_F_ADAPTIVE_CACHE \
 	)
 
 /**
@@ -1081,6 +1102,11 @@ typedef void (rte_mempool_ctor_t)(struct rte_mempool *, void *);
  *     "single-consumer". Otherwise, it is "multi-consumers".
  *   - RTE_MEMPOOL_F_NO_IOVA_CONTIG: If set, allocated objects won't
  *     necessarily be contiguous in IO memory.
+ *   - RTE_MEMPOOL_F_ADAPTIVE_CACHE: If set, the size of each per-lcore
+ *     cache follows the rate of gets and puts which had to access the
+ *     common pool, between a quarter and four times *cache_size*, and
+ *     rte_mempool_put_bulk_to_lcore() hands objects over to the cache of
+ *     the lcore which allocated them. Ignored if *cache_size* is zero.
  * @return
  *   The pointer to the new allocated mempool, on success. NULL on error
  *   with rte_errno set appropriately. Possible rte_errno values include:
@@ -1362,6 +1388,110 @@ rte_mempool_cache_flush(struct rte_mempool_cache *cache,
 	cache->len = 0;
 }
 
+/** Number of gets and puts after which an adaptive cache is resized. */
+#define RTE_MEMPOOL_CACHE_ADAPT_WINDOW 256
+
+/**
+ * An adaptive cache grows when more than one get or put out of this number
+ * had to access the common pool during the last window.
+ */
+#define RTE_MEMPOOL_CACHE_ADAPT_RATE 16
+
+/**
+ * @internal Resize an adaptive cache at the end of a window; used internally.
+ *
+ * The cache doubles when the common pool is accessed too often, because
+ * the lcore mostly gets or mostly puts objects and larger caches make for
+ * fewer and larger backend operations. It shrinks by a quarter when the
+ * common pool was not accessed at all, so that balanced lcores do not hold
+ * objects other lcores may need.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param cache
+ *   A pointer to an adaptive mempool cache.
+ */
+static inline void
+rte_mempool_cache_adapt(struct rte_mempool *mp, struct rte_mempool_cache *cache)
+{
+	uint32_t backend = cache->win_miss + cache->win_flush;
+	uint32_t size = cache->size;
+
+	if (backend * RTE_MEMPOOL_CACHE_ADAPT_RATE > cache->win_ops) {
+		size = RTE_MIN(size * 2, (uint32_t)cache->max_size);
+		if (size != cache->size)
+			RTE_MEMPOOL_STAT_ADD(mp, cache_grow, 1);
+	} else if (backend == 0) {
+		size = RTE_MAX(size - size / 4, (uint32_t)cache->min_size);
+		if (size != cache->size)
+			RTE_MEMPOOL_STAT_ADD(mp, cache_shrink, 1);
+	}
+
+	/* Same ratio as the flush threshold of fixed size caches */
+	cache->size = size;
+	cache->flushthresh = size + size / 2;
+
+	cache->win_ops = 0;
+	cache->win_miss = 0;
+	cache->win_flush = 0;
+}
+
+/**
+ * @internal Account a get or a put in the window of an adaptive cache;
+ * used internally.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param cache
+ *   A pointer to a mempool cache structure.
+ * @param miss
+ *   1 if a get had to dequeue objects from the common pool.
+ * @param flush
+ *   1 if a put had to enqueue objects to the common pool.
+ */
+static __rte_always_inline void
+rte_mempool_cache_adapt_count(struct rte_mempool *mp,
+		struct rte_mempool_cache *cache, unsigned int miss,
+		unsigned int flush)
+{
+	if (likely(cache->max_size == 0))
+		return;
+
+	cache->win_ops++;
+	cache->win_miss += miss;
+	cache->win_flush += flush;
+	if (unlikely(cache->win_ops == RTE_MEMPOOL_CACHE_ADAPT_WINDOW))
+		rte_mempool_cache_adapt(mp, cache);
+}
+
+/**
+ * @internal Move the objects other lcores put back into an adaptive cache
+ * before a get would miss; used internally.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param cache
+ *   A pointer to a mempool cache structure.
+ * @param n
+ *   The number of objects requested by the get.
+ */
+static __rte_always_inline void
+rte_mempool_cache_take_returned(struct rte_mempool *mp,
+		struct rte_mempool_cache *cache, unsigned int n)
+{
+	unsigned int count;
+
+	if (likely(cache->returned == NULL) || cache->len >= n)
+		return;
+
+	count = rte_ring_sc_dequeue_burst(cache->returned,
+			&cache->objs[cache->len],
+			RTE_MIN(cache->size, RTE_DIM(cache->objs) - cache->len),
+			NULL);
+	cache->len += count;
+	RTE_MEMPOOL_STAT_ADD(mp, get_return_objs, count);
+}
+
 /**
  * @internal Put several objects back in the mempool; used internally.
  * @param mp
@@ -1389,8 +1519,10 @@ rte_mempool_do_generic_put(struct rte_mempool *mp, void * const *obj_table,
 	RTE_MEMPOOL_CACHE_STAT_ADD(cache, put_objs, n);
 
 	/* The request itself is too big for the cache */
-	if (unlikely(n > cache->flushthresh))
+	if (unlikely(n > cache->flushthresh)) {
+		rte_mempool_cache_adapt_count(mp, cache, 0, 1);
 		goto driver_enqueue_stats_incremented;
+	}
 
 	/*
 	 * The cache follows the following algorithm:
@@ -1402,10 +1534,12 @@ rte_mempool_do_generic_put(struct rte_mempool *mp, void * const *obj_table,
 	if (cache->len + n <= cache->flushthresh) {
 		cache_objs = &cache->objs[cache->len];
 		cache->len += n;
+		rte_mempool_cache_adapt_count(mp, cache, 0, 0);
 	} else {
 		cache_objs = &cache->objs[0];
 		rte_mempool_ops_enqueue_bulk(mp, cache_objs, cache->len);
 		cache->len = n;
+		rte_mempool_cache_adapt_count(mp, cache, 0, 1);
 	}
 
 	/* Add the objects to the cache. */
@@ -1489,6 +1623,55 @@ rte_mempool_put(struct rte_mempool *mp, void *obj)
 	rte_mempool_put_bulk(mp, &obj, 1);
 }
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Put several objects back into the cache of a given lcore.
+ *
+ * This is meant for objects allocated on one lcore and freed on another:
+ * when the mempool was created with RTE_MEMPOOL_F_ADAPTIVE_CACHE, the
+ * objects are handed over to the cache of *lcore_id*, which takes them
+ * before accessing the common pool on its next gets. The objects which do
+ * not fit, or all of them if the mempool has no adaptive cache for
+ * *lcore_id*, are put as rte_mempool_put_bulk() would.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects).
+ * @param n
+ *   The number of objects to add in the mempool from obj_table.
+ * @param lcore_id
+ *   The logical core which allocated the objects.
+ */
+__rte_experimental
+static __rte_always_inline void
+rte_mempool_put_bulk_to_lcore(struct rte_mempool *mp,
+		void * const *obj_table, unsigned int n, unsigned int lcore_id)
+{
+	struct rte_mempool_cache *cache;
+	unsigned int count = 0;
+
+	RTE_MEMPOOL_CHECK_COOKIES(mp, obj_table, n, 0);
+
+	cache = rte_mempool_default_cache(mp, lcore_id);
+	if (cache != NULL && cache->returned != NULL &&
+			lcore_id != rte_lcore_id()) {
+		count = rte_ring_mp_enqueue_burst(cache->returned, obj_table,
+				n, NULL);
+		RTE_MEMPOOL_STAT_ADD(mp, put_objs, count);
+		RTE_MEMPOOL_STAT_ADD(mp, put_return_objs, count);
+		if (likely(count == n)) {
+			RTE_MEMPOOL_STAT_ADD(mp, put_bulk, 1);
+			return;
+		}
+	}
+
+	cache = rte_mempool_default_cache(mp, rte_lcore_id());
+	rte_mempool_do_generic_put(mp, obj_table + count, n - count, cache);
+}
+
 /**
  * @internal Get several objects from the mempool; used internally.
  * @param mp
@@ -1518,6 +1701,8 @@ rte_mempool_do_generic_get(struct rte_mempool *mp, void **obj_table,
 		goto driver_dequeue;
 	}
 
+	rte_mempool_cache_take_returned(mp, cache, n);
+
 	/* The cache is a stack, so copy will be in reverse order. */
 	cache_objs = &cache->objs[cache->len];
 
@@ -1533,6 +1718,7 @@ rte_mempool_do_generic_get(struct rte_mempool *mp, void **obj_table,
 
 		RTE_MEMPOOL_CACHE_STAT_ADD(cache, get_success_bulk, 1);
 		RTE_MEMPOOL_CACHE_STAT_ADD(cache, get_success_objs, n);
+		rte_mempool_cache_adapt_count(mp, cache, 0, 0);
 
 		return 0;
 	}
@@ -1559,6 +1745,7 @@ rte_mempool_do_generic_get(struct rte_mempool *mp, void **obj_table,
 
 		RTE_MEMPOOL_CACHE_STAT_ADD(cache, get_success_bulk, 1);
 		RTE_MEMPOOL_CACHE_STAT_ADD(cache, get_success_objs, n);
+		rte_mempool_cache_adapt_count(mp, cache, 0, 0);
 
 		return 0;
 	}
@@ -1589,6 +1776,7 @@ rte_mempool_do_generic_get(struct rte_mempool *mp, void **obj_table,
 
 	RTE_MEMPOOL_CACHE_STAT_ADD(cache, get_success_bulk, 1);
 	RTE_MEMPOOL_CACHE_STAT_ADD(cache, get_success_objs, n);
+	rte_mempool_cache_adapt_count(mp, cache, 1, 0);
 
 	return 0;
 
@@ -1605,6 +1793,7 @@ rte_mempool_do_generic_get(struct rte_mempool *mp, void **obj_table,
 			 * of the request back into the cache, as objects in
 			 * the cache are intact.
 			 */
+			rte_mempool_cache_adapt_count(mp, cache, 1, 0);
 		}
 
 		RTE_MEMPOOL_STAT_ADD(mp, get_fail_bulk, 1);
@@ -1613,6 +1802,7 @@ rte_mempool_do_generic_get(struct rte_mempool *mp, void **obj_table,
 		if (likely(cache != NULL)) {
 			RTE_MEMPOOL_CACHE_STAT_ADD(cache, get_success_bulk, 1);
 			RTE_MEMPOOL_CACHE_STAT_ADD(cache, get_success_objs, n);
+			rte_mempool_cache_adapt_count(mp, cache, 1, 0);
 		} else {
 			RTE_MEMPOOL_STAT_ADD(mp, get_success_bulk, 1);
 			RTE_MEMPOOL_STAT_ADD(mp, get_success_objs, n);
@@ -1711,6 +1901,208 @@ rte_mempool_get(struct rte_mempool *mp, void **obj_p)
 	return rte_mempool_get_bulk(mp, obj_p, 1);
 }
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Start a zero-copy get of several objects from a mempool cache.
+ *
+ * Instead of copying the object pointers to a table like
+ * rte_mempool_generic_get(), return a pointer to them inside the cache,
+ * so that they can be written directly where they are used, e.g. into
+ * the descriptors of a device ring. The cache is refilled from the
+ * common pool first if it holds less than *n* objects.
+ *
+ * The objects are only reserved: they are taken from the cache by
+ * rte_mempool_cache_zc_get_finish(), which must be called before any
+ * other operation on the cache.
+ *
+ * @param cache
+ *   A pointer to a mempool cache structure, not NULL.
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param n
+ *   The number of objects to reserve, at most RTE_MEMPOOL_CACHE_MAX_SIZE.
+ * @return
+ *   A pointer to the *n* reserved object pointers on success,
+ *   NULL on error with rte_errno set appropriately:
+ *   - EINVAL: *n* is too big for the cache.
+ *   - ENOENT: Not enough entries in the mempool.
+ */
+__rte_experimental
+static __rte_always_inline void **
+rte_mempool_cache_zc_get_start(struct rte_mempool_cache *cache,
+		struct rte_mempool *mp, unsigned int n)
+{
+	unsigned int len, fetch, missing;
+
+	RTE_ASSERT(cache != NULL);
+
+	if (unlikely(n > RTE_MEMPOOL_CACHE_MAX_SIZE)) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	rte_mempool_cache_take_returned(mp, cache, n);
+
+	if (cache->len >= n) {
+		rte_mempool_cache_adapt_count(mp, cache, 0, 0);
+	} else {
+		/*
+		 * Refill underneath the objects already in the cache, so that
+		 * these hot objects are handed out first, and size objects are
+		 * left once the n reserved ones are taken.
+		 */
+		len = cache->len;
+		fetch = cache->size + n - len;
+		memmove(&cache->objs[fetch], cache->objs, sizeof(void *) * len);
+		if (rte_mempool_ops_dequeue_bulk(mp, cache->objs, fetch) < 0) {
+			/* Buffer constrained, only fetch what is missing */
+			missing = n - len;
+			memmove(&cache->objs[missing], &cache->objs[fetch],
+				sizeof(void *) * len);
+			fetch = missing;
+			if (rte_mempool_ops_dequeue_bulk(mp, cache->objs,
+					fetch) < 0) {
+				memmove(cache->objs, &cache->objs[fetch],
+					sizeof(void *) * len);
+				rte_mempool_cache_adapt_count(mp, cache, 1, 0);
+				RTE_MEMPOOL_STAT_ADD(mp, get_fail_bulk, 1);
+				RTE_MEMPOOL_STAT_ADD(mp, get_fail_objs, n);
+				rte_errno = ENOENT;
+				return NULL;
+			}
+		}
+		cache->len += fetch;
+		rte_mempool_cache_adapt_count(mp, cache, 1, 0);
+	}
+
+	cache->zc_len = n;
+	return &cache->objs[cache->len - n];
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Finish a zero-copy get of several objects from a mempool cache.
+ *
+ * Take the first *n* objects reserved by rte_mempool_cache_zc_get_start()
+ * out of the cache, the other reserved objects stay in the cache.
+ *
+ * @param cache
+ *   A pointer to a mempool cache structure, not NULL.
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param n
+ *   The number of objects taken, at most the number reserved.
+ */
+__rte_experimental
+static __rte_always_inline void
+rte_mempool_cache_zc_get_finish(struct rte_mempool_cache *cache,
+		struct rte_mempool *mp, unsigned int n)
+{
+	void **zc_objs = &cache->objs[cache->len - cache->zc_len];
+
+	RTE_ASSERT(n <= cache->zc_len);
+	RTE_MEMPOOL_CHECK_COOKIES(mp, zc_objs, n, 1);
+	RTE_SET_USED(mp);
+
+	/* Keep the objects left over at the top of the cache */
+	if (unlikely(n != cache->zc_len))
+		memmove(zc_objs, zc_objs + n,
+			sizeof(void *) * (cache->zc_len - n));
+	cache->len -= n;
+	cache->zc_len = 0;
+
+	RTE_MEMPOOL_CACHE_STAT_ADD(cache, get_success_bulk, 1);
+	RTE_MEMPOOL_CACHE_STAT_ADD(cache, get_success_objs, n);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Start a zero-copy put of several objects into a mempool cache.
+ *
+ * Instead of copying the object pointers from a table like
+ * rte_mempool_generic_put(), return a pointer to room for them inside
+ * the cache, so that they can be read directly from where they were
+ * used, e.g. from the descriptors of a device ring. The cache is flushed
+ * to the common pool first if the objects would not fit below its flush
+ * threshold.
+ *
+ * The room is only reserved: the objects written to it are added to the
+ * cache by rte_mempool_cache_zc_put_finish(), which must be called before
+ * any other operation on the cache.
+ *
+ * @param cache
+ *   A pointer to a mempool cache structure, not NULL.
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param n
+ *   The number of objects to reserve room for, at most
+ *   RTE_MEMPOOL_CACHE_MAX_SIZE.
+ * @return
+ *   A pointer to room for *n* object pointers on success,
+ *   NULL with rte_errno set to EINVAL if *n* is too big for the cache.
+ */
+__rte_experimental
+static __rte_always_inline void **
+rte_mempool_cache_zc_put_start(struct rte_mempool_cache *cache,
+		struct rte_mempool *mp, unsigned int n)
+{
+	RTE_ASSERT(cache != NULL);
+
+	if (unlikely(n > RTE_MEMPOOL_CACHE_MAX_SIZE)) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	if (cache->len + n <= cache->flushthresh) {
+		rte_mempool_cache_adapt_count(mp, cache, 0, 0);
+	} else {
+		rte_mempool_ops_enqueue_bulk(mp, cache->objs, cache->len);
+		cache->len = 0;
+		rte_mempool_cache_adapt_count(mp, cache, 0, 1);
+	}
+
+	cache->zc_len = n;
+	return &cache->objs[cache->len];
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Finish a zero-copy put of several objects into a mempool cache.
+ *
+ * Add the first *n* objects written to the room reserved by
+ * rte_mempool_cache_zc_put_start() to the cache.
+ *
+ * @param cache
+ *   A pointer to a mempool cache structure, not NULL.
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param n
+ *   The number of objects put, at most the number reserved.
+ */
+__rte_experimental
+static __rte_always_inline void
+rte_mempool_cache_zc_put_finish(struct rte_mempool_cache *cache,
+		struct rte_mempool *mp, unsigned int n)
+{
+	RTE_ASSERT(n <= cache->zc_len);
+	RTE_MEMPOOL_CHECK_COOKIES(mp, &cache->objs[cache->len], n, 0);
+	RTE_SET_USED(mp);
+
+	cache->len += n;
+	cache->zc_len = 0;
+
+	RTE_MEMPOOL_CACHE_STAT_ADD(cache, put_bulk, 1);
+	RTE_MEMPOOL_CACHE_STAT_ADD(cache, put_objs, n);
+}
+
 /**
  * Get a contiguous blocks of objects from the mempool.
  *
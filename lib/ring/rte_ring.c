@@ -43,7 +43,8 @@ EAL_REGISTER_TAILQ(rte_ring_tailq)
 /* mask of all valid flag values to ring_create() */
 #define RING_F_MASK (RING_F_SP_ENQ | RING_F_SC_DEQ | RING_F_EXACT_SZ | \
 		     RING_F_MP_RTS_ENQ | RING_F_MC_RTS_DEQ |	       \
-		     RING_F_MP_HTS_ENQ | RING_F_MC_HTS_DEQ)
+		     RING_F_MP_HTS_ENQ | RING_F_MC_HTS_DEQ |	       \
+		     RING_F_MPMC_SEQ)
 
 /* true if x is a power of 2 */
 #define POWEROF2(x) ((((x)-1) & (x)) == 0)
@@ -78,6 +79,19 @@ rte_ring_get_memsize_elem(unsigned int esize, unsigned int count)
 	return sz;
 }
 
+/* return the size of memory occupied by a ring with given flags */
+ssize_t
+rte_ring_get_memsize_elem_flags(unsigned int esize, unsigned int count,
+	unsigned int flags)
+{
+	ssize_t sz;
+
+	sz = rte_ring_get_memsize_elem(esize, count);
+	if (sz >= 0 && (flags & RING_F_MPMC_SEQ))
+		sz += __rte_ring_seq_table_size(count);
+	return sz;
+}
+
 /* return the size of memory occupied by a ring */
 ssize_t
 rte_ring_get_memsize(unsigned int count)
@@ -102,6 +116,7 @@ reset_headtail(void *p)
 	switch (ht->sync_type) {
 	case RTE_RING_SYNC_MT:
 	case RTE_RING_SYNC_ST:
+	case RTE_RING_SYNC_MT_SEQ:
 		ht->head = 0;
 		ht->tail = 0;
 		break;
@@ -118,11 +133,31 @@ reset_headtail(void *p)
 	}
 }
 
+/*
+ * internal helper function to reset the sequence numbers of a SEQ ring,
+ * each slot is ready to be enqueued to at its own position.
+ */
+static void
+reset_seq(struct rte_ring *r)
+{
+	RTE_ATOMIC(uint32_t) *slots;
+	uint32_t i;
+
+	if (r->prod.sync_type != RTE_RING_SYNC_MT_SEQ)
+		return;
+
+	slots = __rte_ring_seq_slots(r);
+	for (i = 0; i != r->size; i++)
+		rte_atomic_store_explicit(&slots[i], i,
+			rte_memory_order_relaxed);
+}
+
 void
 rte_ring_reset(struct rte_ring *r)
 {
 	reset_headtail(&r->prod);
 	reset_headtail(&r->cons);
+	reset_seq(r);
 }
 
 /*
@@ -139,6 +174,15 @@ get_sync_type(uint32_t flags, enum rte_ring_sync_type *prod_st,
 	static const uint32_t cons_st_flags =
 		(RING_F_SC_DEQ | RING_F_MC_RTS_DEQ | RING_F_MC_HTS_DEQ);
 
+	/* SEQ mode is for both producers and consumers */
+	if (flags & RING_F_MPMC_SEQ) {
+		if (flags & (prod_st_flags | cons_st_flags))
+			return -EINVAL;
+		*prod_st = RTE_RING_SYNC_MT_SEQ;
+		*cons_st = RTE_RING_SYNC_MT_SEQ;
+		return 0;
+	}
+
 	switch (flags & prod_st_flags) {
 	case 0:
 		*prod_st = RTE_RING_SYNC_MT;
@@ -239,6 +283,8 @@ rte_ring_init(struct rte_ring *r, const char *name, unsigned int count,
 	if (flags & RING_F_MC_RTS_DEQ)
 		rte_ring_set_cons_htd_max(r, r->capacity / HTD_MAX_DEF);
 
+	reset_seq(r);
+
 	return 0;
 }
 
@@ -263,7 +309,7 @@ rte_ring_create_elem(const char *name, unsigned int esize, unsigned int count,
 	if (flags & RING_F_EXACT_SZ)
 		count = rte_align32pow2(count + 1);
 
-	ring_size = rte_ring_get_memsize_elem(esize, count);
+	ring_size = rte_ring_get_memsize_elem_flags(esize, count, flags);
 	if (ring_size < 0) {
 		rte_errno = -ring_size;
 		return NULL;
@@ -471,6 +517,8 @@ ring_prod_sync_type_to_name(struct rte_ring *r)
 		return "MP_RTS";
 	case RTE_RING_SYNC_MT_HTS:
 		return "MP_HTS";
+	case RTE_RING_SYNC_MT_SEQ:
+		return "MP_SEQ";
 	default:
 		return "Unknown";
 	}
@@ -488,6 +536,8 @@ ring_cons_sync_type_to_name(struct rte_ring *r)
 		return "MC_RTS";
 	case RTE_RING_SYNC_MT_HTS:
 		return "MC_HTS";
+	case RTE_RING_SYNC_MT_SEQ:
+		return "MC_SEQ";
 	default:
 		return "Unknown";
 	}
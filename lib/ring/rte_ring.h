@@ -64,6 +64,8 @@ ssize_t rte_ring_get_memsize(unsigned int count);
  * memory area must be large enough to store the ring structure and the
  * object table. It is advised to use rte_ring_get_memsize() to get the
  * appropriate size.
+ * A ring initialized with RING_F_MPMC_SEQ needs the size returned by
+ * rte_ring_get_memsize_elem_flags().
  *
  * The ring size is set to *count*, which must be a power of two.
  * The real usable ring size is *count-1* instead of *count* to
@@ -106,6 +108,10 @@ ssize_t rte_ring_get_memsize(unsigned int count);
  *        is "multi-consumer HTS mode".
  *     If none of these flags is set, then default "multi-consumer"
  *     behavior is selected.
+ *   - RING_F_MPMC_SEQ: If this flag is set, the default behavior when
+ *     using ``rte_ring_enqueue()``, ``rte_ring_dequeue()`` or their bulk
+ *     and burst versions is "multi-producer/multi-consumer SEQ mode".
+ *     It cannot be combined with the producer and consumer flags above.
  *   - RING_F_EXACT_SZ: If this flag is set, the ring will hold exactly the
  *     requested number of entries, and the requested size will be rounded up
  *     to the next power of two, but the usable space will be exactly that
@@ -166,6 +172,10 @@ int rte_ring_init(struct rte_ring *r, const char *name, unsigned int count,
  *        is "multi-consumer HTS mode".
  *     If none of these flags is set, then default "multi-consumer"
  *     behavior is selected.
+ *   - RING_F_MPMC_SEQ: If this flag is set, the default behavior when
+ *     using ``rte_ring_enqueue()``, ``rte_ring_dequeue()`` or their bulk
+ *     and burst versions is "multi-producer/multi-consumer SEQ mode".
+ *     It cannot be combined with the producer and consumer flags above.
  *   - RING_F_EXACT_SZ: If this flag is set, the ring will hold exactly the
  *     requested number of entries, and the requested size will be rounded up
  *     to the next power of two, but the usable space will be exactly that
@@ -59,6 +59,7 @@ enum rte_ring_sync_type {
 	RTE_RING_SYNC_ST,     /**< single thread only */
 	RTE_RING_SYNC_MT_RTS, /**< multi-thread relaxed tail sync */
 	RTE_RING_SYNC_MT_HTS, /**< multi-thread head/tail sync */
+	RTE_RING_SYNC_MT_SEQ, /**< multi-thread per-slot sequence numbers */
 };
 
 /**
@@ -167,6 +168,15 @@ struct rte_ring {
 #define RING_F_MP_HTS_ENQ 0x0020 /**< The default enqueue is "MP HTS". */
 #define RING_F_MC_HTS_DEQ 0x0040 /**< The default dequeue is "MC HTS". */
 
+/**
+ * The default enqueue is "MP SEQ" and the default dequeue is "MC SEQ".
+ * The producers and the consumers of such a ring both synchronize through
+ * a sequence number per slot, so this flag cannot be combined with other
+ * sync mode flags. The ring needs the memory returned by
+ * rte_ring_get_memsize_elem_flags().
+ */
+#define RING_F_MPMC_SEQ 0x0080
+
 #ifdef __cplusplus
 }
 #endif
@@ -20,6 +20,7 @@
 extern "C" {
 #endif
 
+#include <rte_compat.h>
 #include <rte_ring_core.h>
 #include <rte_ring_elem_pvt.h>
 
@@ -43,6 +44,32 @@ extern "C" {
  */
 ssize_t rte_ring_get_memsize_elem(unsigned int esize, unsigned int count);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Calculate the memory size needed for a ring with given element size
+ * and flags
+ *
+ * Same as rte_ring_get_memsize_elem(), plus the memory needed by the
+ * sync mode selected in *flags*: a ring created with RING_F_MPMC_SEQ
+ * also stores a sequence number per element.
+ *
+ * @param esize
+ *   The size of ring element, in bytes. It must be a multiple of 4.
+ * @param count
+ *   The number of elements in the ring (must be a power of 2).
+ * @param flags
+ *   The flags the ring is initialized with.
+ * @return
+ *   - The memory size needed for the ring on success.
+ *   - -EINVAL - esize is not a multiple of 4 or count provided is not a
+ *		 power of 2.
+ */
+__rte_experimental
+ssize_t rte_ring_get_memsize_elem_flags(unsigned int esize,
+	unsigned int count, unsigned int flags);
+
 /**
  * Create a new ring named *name* that stores elements with given size.
  *
@@ -92,6 +119,10 @@ ssize_t rte_ring_get_memsize_elem(unsigned int esize, unsigned int count);
  *        is "multi-consumer HTS mode".
  *     If none of these flags is set, then default "multi-consumer"
  *     behavior is selected.
+ *   - RING_F_MPMC_SEQ: If this flag is set, the default behavior when
+ *     using ``rte_ring_enqueue()``, ``rte_ring_dequeue()`` or their bulk
+ *     and burst versions is "multi-producer/multi-consumer SEQ mode".
+ *     It cannot be combined with the producer and consumer flags above.
  * @return
  *   On success, the pointer to the new allocated ring. NULL on error with
  *    rte_errno set appropriately. Possible errno values include:
@@ -166,6 +197,7 @@ rte_ring_sp_enqueue_bulk_elem(struct rte_ring *r, const void *obj_table,
 
 #include <rte_ring_hts.h>
 #include <rte_ring_rts.h>
+#include <rte_ring_seq.h>
 
 /**
  * Enqueue several objects on a ring.
@@ -207,6 +239,9 @@ rte_ring_enqueue_bulk_elem(struct rte_ring *r, const void *obj_table,
 	case RTE_RING_SYNC_MT_HTS:
 		return rte_ring_mp_hts_enqueue_bulk_elem(r, obj_table, esize, n,
 			free_space);
+	case RTE_RING_SYNC_MT_SEQ:
+		return __rte_ring_do_seq_enqueue_elem(r, obj_table, esize, n,
+			RTE_RING_QUEUE_FIXED, free_space);
 	}
 
 	/* valid ring should never reach this point */
@@ -389,6 +424,9 @@ rte_ring_dequeue_bulk_elem(struct rte_ring *r, void *obj_table,
 	case RTE_RING_SYNC_MT_HTS:
 		return rte_ring_mc_hts_dequeue_bulk_elem(r, obj_table, esize,
 			n, available);
+	case RTE_RING_SYNC_MT_SEQ:
+		return __rte_ring_do_seq_dequeue_elem(r, obj_table, esize, n,
+			RTE_RING_QUEUE_FIXED, available);
 	}
 
 	/* valid ring should never reach this point */
@@ -575,6 +613,9 @@ rte_ring_enqueue_burst_elem(struct rte_ring *r, const void *obj_table,
 	case RTE_RING_SYNC_MT_HTS:
 		return rte_ring_mp_hts_enqueue_burst_elem(r, obj_table, esize,
 			n, free_space);
+	case RTE_RING_SYNC_MT_SEQ:
+		return __rte_ring_do_seq_enqueue_elem(r, obj_table, esize, n,
+			RTE_RING_QUEUE_VARIABLE, free_space);
 	}
 
 	/* valid ring should never reach this point */
@@ -685,6 +726,9 @@ rte_ring_dequeue_burst_elem(struct rte_ring *r, void *obj_table,
 	case RTE_RING_SYNC_MT_HTS:
 		return rte_ring_mc_hts_dequeue_burst_elem(r, obj_table, esize,
 			n, available);
+	case RTE_RING_SYNC_MT_SEQ:
+		return __rte_ring_do_seq_dequeue_elem(r, obj_table, esize, n,
+			RTE_RING_QUEUE_VARIABLE, available);
 	}
 
 	/* valid ring should never reach this point */
@@ -0,0 +1,288 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2024 Intel Corporation
+ */
+
+#ifndef _RTE_RING_SEQ_ELEM_PVT_H_
+#define _RTE_RING_SEQ_ELEM_PVT_H_
+
+#include <rte_stdatomic.h>
+
+/**
+ * @file rte_ring_seq_elem_pvt.h
+ * It is not recommended to include this file directly,
+ * include <rte_ring.h> instead.
+ * Contains internal helper functions for per-slot sequence number (SEQ)
+ * ring mode.
+ * For more information please refer to <rte_ring_seq.h>.
+ */
+
+/**
+ * @internal Size of the table of sequence numbers of a SEQ ring,
+ * which is placed before the table of objects.
+ */
+static __rte_always_inline size_t
+__rte_ring_seq_table_size(uint32_t size)
+{
+	return RTE_ALIGN((size_t)size * sizeof(uint32_t), RTE_CACHE_LINE_SIZE);
+}
+
+/**
+ * @internal Sequence number of each slot of a SEQ ring.
+ */
+static __rte_always_inline RTE_ATOMIC(uint32_t) *
+__rte_ring_seq_slots(struct rte_ring *r)
+{
+	return (RTE_ATOMIC(uint32_t) *)&r[1];
+}
+
+/**
+ * @internal Table of objects of a SEQ ring.
+ */
+static __rte_always_inline void *
+__rte_ring_seq_objs(struct rte_ring *r)
+{
+	return RTE_PTR_ADD(&r[1], __rte_ring_seq_table_size(r->size));
+}
+
+/**
+ * @internal Count the slots from *pos* holding sequence number *seq*
+ * plus their distance from *pos*, up to *num* slots.
+ * Returns -1 if *pos* is behind the position of the ring, i.e. if another
+ * thread already claimed the first slot which is not ready.
+ */
+static __rte_always_inline int32_t
+__rte_ring_seq_ready(struct rte_ring *r, uint32_t pos, uint32_t seq,
+	uint32_t num)
+{
+	RTE_ATOMIC(uint32_t) *slots = __rte_ring_seq_slots(r);
+	uint32_t i, s;
+
+	for (i = 0; i != num; i++) {
+		s = rte_atomic_load_explicit(&slots[(pos + i) & r->mask],
+			rte_memory_order_relaxed);
+		if (s != seq + i)
+			return ((int32_t)(s - (seq + i)) > 0) ? -1 : (int32_t)i;
+	}
+
+	return (int32_t)num;
+}
+
+/**
+ * @internal Set the sequence number of *num* slots from *pos*,
+ * releasing the accesses to their objects.
+ */
+static __rte_always_inline void
+__rte_ring_seq_release(struct rte_ring *r, uint32_t pos, uint32_t seq,
+	uint32_t num)
+{
+	RTE_ATOMIC(uint32_t) *slots = __rte_ring_seq_slots(r);
+	uint32_t i;
+
+	rte_atomic_thread_fence(rte_memory_order_release);
+	for (i = 0; i != num; i++)
+		rte_atomic_store_explicit(&slots[(pos + i) & r->mask], seq + i,
+			rte_memory_order_relaxed);
+}
+
+/**
+ * @internal This function claims the slots to enqueue to.
+ * A slot can be enqueued to when its sequence number equals its position,
+ * i.e. once the object it held one lap before was dequeued.
+ */
+static __rte_always_inline unsigned int
+__rte_ring_seq_move_prod_head(struct rte_ring *r, unsigned int num,
+	enum rte_ring_queue_behavior behavior, uint32_t *old_head,
+	uint32_t *free_entries)
+{
+	int32_t ready;
+	uint32_t n, cons, head;
+
+	const uint32_t capacity = r->capacity;
+
+	head = rte_atomic_load_explicit(&r->prod.tail,
+		rte_memory_order_relaxed);
+
+	for (;;) {
+		/*
+		 * Read the consumer position after the producer one,
+		 * so 'free_entries' is between 0 and capacity modulo 32 bits.
+		 */
+		rte_atomic_thread_fence(rte_memory_order_acquire);
+		cons = rte_atomic_load_explicit(&r->cons.tail,
+			rte_memory_order_relaxed);
+		*free_entries = capacity + cons - head;
+
+		n = RTE_MIN(num, *free_entries);
+		ready = __rte_ring_seq_ready(r, head, head, n);
+		if (ready < 0) {
+			/* another producer moved the position */
+			head = rte_atomic_load_explicit(&r->prod.tail,
+				rte_memory_order_relaxed);
+			continue;
+		}
+
+		/*
+		 * A slot which is not ready is still being dequeued,
+		 * do not wait for the consumer.
+		 */
+		n = (uint32_t)ready;
+		if (n != num && behavior == RTE_RING_QUEUE_FIXED)
+			n = 0;
+
+		if (n == 0 || rte_atomic_compare_exchange_strong_explicit(
+				&r->prod.tail, &head, head + n,
+				rte_memory_order_relaxed,
+				rte_memory_order_relaxed) != 0)
+			break;
+	}
+
+	/* the objects of the slots are only written after they are ready */
+	rte_atomic_thread_fence(rte_memory_order_acquire);
+
+	*old_head = head;
+	return n;
+}
+
+/**
+ * @internal This function claims the slots to dequeue from.
+ * A slot can be dequeued from when its sequence number equals its position
+ * plus one, i.e. once an object was enqueued to it during this lap.
+ */
+static __rte_always_inline unsigned int
+__rte_ring_seq_move_cons_head(struct rte_ring *r, unsigned int num,
+	enum rte_ring_queue_behavior behavior, uint32_t *old_head,
+	uint32_t *entries)
+{
+	int32_t ready;
+	uint32_t n, prod, head;
+
+	head = rte_atomic_load_explicit(&r->cons.tail,
+		rte_memory_order_relaxed);
+
+	for (;;) {
+		/*
+		 * Read the producer position after the consumer one,
+		 * so 'entries' is between 0 and capacity modulo 32 bits.
+		 */
+		rte_atomic_thread_fence(rte_memory_order_acquire);
+		prod = rte_atomic_load_explicit(&r->prod.tail,
+			rte_memory_order_relaxed);
+		*entries = prod - head;
+
+		n = RTE_MIN(num, *entries);
+		ready = __rte_ring_seq_ready(r, head, head + 1, n);
+		if (ready < 0) {
+			/* another consumer moved the position */
+			head = rte_atomic_load_explicit(&r->cons.tail,
+				rte_memory_order_relaxed);
+			continue;
+		}
+
+		/*
+		 * A slot which is not ready is still being enqueued,
+		 * do not wait for the producer.
+		 */
+		n = (uint32_t)ready;
+		if (n != num && behavior == RTE_RING_QUEUE_FIXED)
+			n = 0;
+
+		if (n == 0 || rte_atomic_compare_exchange_strong_explicit(
+				&r->cons.tail, &head, head + n,
+				rte_memory_order_relaxed,
+				rte_memory_order_relaxed) != 0)
+			break;
+	}
+
+	/* the objects of the slots are only read after they are ready */
+	rte_atomic_thread_fence(rte_memory_order_acquire);
+
+	*old_head = head;
+	return n;
+}
+
+/**
+ * @internal Enqueue several objects on the SEQ ring.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param obj_table
+ *   A pointer to a table of objects.
+ * @param esize
+ *   The size of ring element, in bytes. It must be a multiple of 4.
+ *   This must be the same value used while creating the ring. Otherwise
+ *   the results are undefined.
+ * @param n
+ *   The number of objects to add in the ring from the obj_table.
+ * @param behavior
+ *   RTE_RING_QUEUE_FIXED:    Enqueue a fixed number of items from a ring
+ *   RTE_RING_QUEUE_VARIABLE: Enqueue as many items as possible from ring
+ * @param free_space
+ *   returns the amount of space after the enqueue operation has finished
+ * @return
+ *   Actual number of objects enqueued.
+ *   If behavior == RTE_RING_QUEUE_FIXED, this will be 0 or n only.
+ */
+static __rte_always_inline unsigned int
+__rte_ring_do_seq_enqueue_elem(struct rte_ring *r, const void *obj_table,
+	uint32_t esize, uint32_t n, enum rte_ring_queue_behavior behavior,
+	uint32_t *free_space)
+{
+	uint32_t free, head;
+
+	n = __rte_ring_seq_move_prod_head(r, n, behavior, &head, &free);
+
+	if (n != 0) {
+		__rte_ring_enqueue_elems_table(__rte_ring_seq_objs(r), r->size,
+			head & r->mask, obj_table, esize, n);
+		__rte_ring_seq_release(r, head, head + 1, n);
+	}
+
+	if (free_space != NULL)
+		*free_space = free - n;
+	return n;
+}
+
+/**
+ * @internal Dequeue several objects from the SEQ ring.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param obj_table
+ *   A pointer to a table of objects.
+ * @param esize
+ *   The size of ring element, in bytes. It must be a multiple of 4.
+ *   This must be the same value used while creating the ring. Otherwise
+ *   the results are undefined.
+ * @param n
+ *   The number of objects to pull from the ring.
+ * @param behavior
+ *   RTE_RING_QUEUE_FIXED:    Dequeue a fixed number of items from a ring
+ *   RTE_RING_QUEUE_VARIABLE: Dequeue as many items as possible from ring
+ * @param available
+ *   returns the number of remaining ring entries after the dequeue has finished
+ * @return
+ *   - Actual number of objects dequeued.
+ *     If behavior == RTE_RING_QUEUE_FIXED, this will be 0 or n only.
+ */
+static __rte_always_inline unsigned int
+__rte_ring_do_seq_dequeue_elem(struct rte_ring *r, void *obj_table,
+	uint32_t esize, uint32_t n, enum rte_ring_queue_behavior behavior,
+	uint32_t *available)
+{
+	uint32_t entries, head;
+
+	n = __rte_ring_seq_move_cons_head(r, n, behavior, &head, &entries);
+
+	if (n != 0) {
+		__rte_ring_dequeue_elems_table(__rte_ring_seq_objs(r), r->size,
+			head & r->mask, obj_table, esize, n);
+		__rte_ring_seq_release(r, head, head + r->size, n);
+	}
+
+	if (available != NULL)
+		*available = entries - n;
+	return n;
+}
+
+#endif /* _RTE_RING_SEQ_ELEM_PVT_H_ */
@@ -2,11 +2,16 @@
  * Copyright(c) 2010-2014 Intel Corporation
  */
 
+#include <errno.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
+#include <sys/epoll.h>
 
 #include <rte_common.h>
 #include <rte_log.h>
+#include <rte_thread.h>
 
 #include "fd_man.h"
 
@@ -15,100 +20,95 @@ RTE_LOG_REGISTER_SUFFIX(vhost_fdset_logtype, fdset, INFO);
 #define VHOST_FDMAN_LOG(level, ...) \
 	RTE_LOG_LINE(level, VHOST_FDMAN, "" __VA_ARGS__)
 
-#define FDPOLLERR (POLLERR | POLLHUP | POLLNVAL)
+#define FDSET_MAX_EVENTS 32
+#define FDSET_MIN_SIZE 64
+#define FDPOLLERR (EPOLLERR | EPOLLHUP)
+
+struct fdentry {
+	int fd;			/* -1 indicates this entry is empty */
+	uint32_t seq;		/* tag carried by the epoll events of this fd */
+	fd_cb rcb;		/* callback when this fd is readable. */
+	fd_cb wcb;		/* callback when this fd is writeable.*/
+	void *dat;		/* fd context */
+	int busy;		/* whether this entry is being used in cb. */
+	bool detached;		/* fd number reused while cb was running */
+	struct fdset_thread *thread;	/* thread dispatching this fd */
+};
+
+static uint64_t
+fdentry_event_data(const struct fdentry *pfdentry)
+{
+	return (uint64_t)pfdentry->seq << 32 | (uint32_t)pfdentry->fd;
+}
 
+/* make room for fd in the entry array */
 static int
-get_last_valid_idx(struct fdset *pfdset, int last_valid_idx)
+fdset_grow_nolock(struct fdset *pfdset, int fd)
 {
-	int i;
+	struct fdentry **fds;
+	int size;
+
+	if (fd < pfdset->fd_size)
+		return 0;
 
-	for (i = last_valid_idx; i >= 0 && pfdset->fd[i].fd == -1; i--)
-		;
+	size = RTE_MAX(pfdset->fd_size, FDSET_MIN_SIZE);
+	while (size <= fd)
+		size *= 2;
 
-	return i;
+	fds = realloc(pfdset->fd, size * sizeof(*fds));
+	if (fds == NULL)
+		return -1;
+	memset(&fds[pfdset->fd_size], 0,
+		(size - pfdset->fd_size) * sizeof(*fds));
+
+	pfdset->fd = fds;
+	pfdset->fd_size = size;
+	return 0;
 }
 
-static void
-fdset_move(struct fdset *pfdset, int dst, int src)
+static struct fdentry *
+fdset_find_nolock(struct fdset *pfdset, int fd)
 {
-	pfdset->fd[dst]    = pfdset->fd[src];
-	pfdset->rwfds[dst] = pfdset->rwfds[src];
+	if (fd < 0 || fd >= pfdset->fd_size)
+		return NULL;
+
+	return pfdset->fd[fd];
 }
 
-static void
-fdset_shrink_nolock(struct fdset *pfdset)
+static struct fdset_thread *
+fdset_pick_thread_nolock(struct fdset *pfdset)
 {
-	int i;
-	int last_valid_idx = get_last_valid_idx(pfdset, pfdset->num - 1);
+	struct fdset_thread *thread = &pfdset->threads[0];
+	unsigned int i;
 
-	for (i = 0; i < last_valid_idx; i++) {
-		if (pfdset->fd[i].fd != -1)
-			continue;
-
-		fdset_move(pfdset, i, last_valid_idx);
-		last_valid_idx = get_last_valid_idx(pfdset, last_valid_idx - 1);
+	for (i = 1; i < pfdset->nb_threads; i++) {
+		if (pfdset->threads[i].num < thread->num)
+			thread = &pfdset->threads[i];
 	}
-	pfdset->num = last_valid_idx + 1;
+
+	return thread;
 }
 
 /*
- * Find deleted fd entries and remove them
+ * Take the entry out of its slot and stop watching its fd.
+ * The fd may have been closed already, so errors are expected.
  */
 static void
-fdset_shrink(struct fdset *pfdset)
+fdset_unlink_nolock(struct fdset *pfdset, struct fdentry *pfdentry)
 {
-	pthread_mutex_lock(&pfdset->fd_mutex);
-	fdset_shrink_nolock(pfdset);
-	pthread_mutex_unlock(&pfdset->fd_mutex);
-}
-
-/**
- * Returns the index in the fdset for a given fd.
- * @return
- *   index for the fd, or -1 if fd isn't in the fdset.
- */
-static int
-fdset_find_fd(struct fdset *pfdset, int fd)
-{
-	int i;
-
-	for (i = 0; i < pfdset->num && pfdset->fd[i].fd != fd; i++)
-		;
+	if (pfdset->fd[pfdentry->fd] != pfdentry)
+		return;
 
-	return i == pfdset->num ? -1 : i;
+	pfdset->fd[pfdentry->fd] = NULL;
+	epoll_ctl(pfdentry->thread->epfd, EPOLL_CTL_DEL, pfdentry->fd, NULL);
 }
 
 static void
-fdset_add_fd(struct fdset *pfdset, int idx, int fd,
-	fd_cb rcb, fd_cb wcb, void *dat)
+fdset_free_nolock(struct fdset *pfdset, struct fdentry *pfdentry)
 {
-	struct fdentry *pfdentry = &pfdset->fd[idx];
-	struct pollfd *pfd = &pfdset->rwfds[idx];
-
-	pfdentry->fd  = fd;
-	pfdentry->rcb = rcb;
-	pfdentry->wcb = wcb;
-	pfdentry->dat = dat;
-
-	pfd->fd = fd;
-	pfd->events  = rcb ? POLLIN : 0;
-	pfd->events |= wcb ? POLLOUT : 0;
-	pfd->revents = 0;
-}
-
-void
-fdset_init(struct fdset *pfdset)
-{
-	int i;
-
-	if (pfdset == NULL)
-		return;
-
-	for (i = 0; i < MAX_FDS; i++) {
-		pfdset->fd[i].fd = -1;
-		pfdset->fd[i].dat = NULL;
-	}
-	pfdset->num = 0;
+	pfdentry->thread->num--;
+	pfdset->num--;
+	free(pfdentry);
 }
 
 /**
@@ -117,25 +117,59 @@ fdset_init(struct fdset *pfdset)
 int
 fdset_add(struct fdset *pfdset, int fd, fd_cb rcb, fd_cb wcb, void *dat)
 {
-	int i;
+	struct fdentry *pfdentry, *old;
+	struct epoll_event ev;
 
-	if (pfdset == NULL || fd == -1)
+	if (pfdset == NULL || fd < 0)
+		return -1;
+
+	pfdentry = malloc(sizeof(*pfdentry));
+	if (pfdentry == NULL)
 		return -1;
 
 	pthread_mutex_lock(&pfdset->fd_mutex);
-	i = pfdset->num < MAX_FDS ? pfdset->num++ : -1;
-	if (i == -1) {
-		pthread_mutex_lock(&pfdset->fd_pooling_mutex);
-		fdset_shrink_nolock(pfdset);
-		pthread_mutex_unlock(&pfdset->fd_pooling_mutex);
-		i = pfdset->num < MAX_FDS ? pfdset->num++ : -1;
-		if (i == -1) {
-			pthread_mutex_unlock(&pfdset->fd_mutex);
-			return -2;
-		}
+	if (pfdset->nb_threads == 0 || fdset_grow_nolock(pfdset, fd) < 0) {
+		pthread_mutex_unlock(&pfdset->fd_mutex);
+		free(pfdentry);
+		return -2;
 	}
 
-	fdset_add_fd(pfdset, i, fd, rcb, wcb, dat);
+	/*
+	 * A callback closed the fd and its number got reused before the entry
+	 * was removed: the dispatcher frees the stale entry once done.
+	 */
+	old = pfdset->fd[fd];
+	if (old != NULL) {
+		fdset_unlink_nolock(pfdset, old);
+		if (old->busy)
+			old->detached = true;
+		else
+			fdset_free_nolock(pfdset, old);
+	}
+
+	pfdentry->fd = fd;
+	pfdentry->seq = pfdset->seq++;
+	pfdentry->rcb = rcb;
+	pfdentry->wcb = wcb;
+	pfdentry->dat = dat;
+	pfdentry->busy = 0;
+	pfdentry->detached = false;
+	pfdentry->thread = fdset_pick_thread_nolock(pfdset);
+
+	ev.events = rcb ? EPOLLIN : 0;
+	ev.events |= wcb ? EPOLLOUT : 0;
+	ev.data.u64 = fdentry_event_data(pfdentry);
+	if (epoll_ctl(pfdentry->thread->epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+		VHOST_FDMAN_LOG(ERR, "failed to add fd %d to epoll: %s",
+			fd, strerror(errno));
+		pthread_mutex_unlock(&pfdset->fd_mutex);
+		free(pfdentry);
+		return -1;
+	}
+
+	pfdset->fd[fd] = pfdentry;
+	pfdentry->thread->num++;
+	pfdset->num++;
 	pthread_mutex_unlock(&pfdset->fd_mutex);
 
 	return 0;
@@ -148,7 +182,7 @@ fdset_add(struct fdset *pfdset, int fd, fd_cb rcb, fd_cb wcb, void *dat)
 void *
 fdset_del(struct fdset *pfdset, int fd)
 {
-	int i;
+	struct fdentry *pfdentry;
 	void *dat = NULL;
 
 	if (pfdset == NULL || fd == -1)
@@ -157,17 +191,16 @@ fdset_del(struct fdset *pfdset, int fd)
 	do {
 		pthread_mutex_lock(&pfdset->fd_mutex);
 
-		i = fdset_find_fd(pfdset, fd);
-		if (i != -1 && pfdset->fd[i].busy == 0) {
+		pfdentry = fdset_find_nolock(pfdset, fd);
+		if (pfdentry != NULL && pfdentry->busy == 0) {
 			/* busy indicates r/wcb is executing! */
-			dat = pfdset->fd[i].dat;
-			pfdset->fd[i].fd = -1;
-			pfdset->fd[i].rcb = pfdset->fd[i].wcb = NULL;
-			pfdset->fd[i].dat = NULL;
-			i = -1;
+			dat = pfdentry->dat;
+			fdset_unlink_nolock(pfdset, pfdentry);
+			fdset_free_nolock(pfdset, pfdentry);
+			pfdentry = NULL;
 		}
 		pthread_mutex_unlock(&pfdset->fd_mutex);
-	} while (i != -1);
+	} while (pfdentry != NULL);
 
 	return dat;
 }
@@ -183,22 +216,21 @@ fdset_del(struct fdset *pfdset, int fd)
 int
 fdset_try_del(struct fdset *pfdset, int fd)
 {
-	int i;
+	struct fdentry *pfdentry;
 
 	if (pfdset == NULL || fd == -1)
 		return -2;
 
 	pthread_mutex_lock(&pfdset->fd_mutex);
-	i = fdset_find_fd(pfdset, fd);
-	if (i != -1 && pfdset->fd[i].busy) {
+	pfdentry = fdset_find_nolock(pfdset, fd);
+	if (pfdentry != NULL && pfdentry->busy) {
 		pthread_mutex_unlock(&pfdset->fd_mutex);
 		return -1;
 	}
 
-	if (i != -1) {
-		pfdset->fd[i].fd = -1;
-		pfdset->fd[i].rcb = pfdset->fd[i].wcb = NULL;
-		pfdset->fd[i].dat = NULL;
+	if (pfdentry != NULL) {
+		fdset_unlink_nolock(pfdset, pfdentry);
+		fdset_free_nolock(pfdset, pfdentry);
 	}
 
 	pthread_mutex_unlock(&pfdset->fd_mutex);
@@ -206,65 +238,46 @@ fdset_try_del(struct fdset *pfdset, int fd)
 }
 
 /**
- * This functions runs in infinite blocking loop until there is no fd in
- * pfdset. It calls corresponding r/w handler if there is event on the fd.
+ * This functions runs in infinite blocking loop, waiting for events on the
+ * fds given to this thread. It calls corresponding r/w handler if there is
+ * event on the fd.
  *
  * Before the callback is called, we set the flag to busy status; If other
  * thread(now rte_vhost_driver_unregister) calls fdset_del concurrently, it
  * will wait until the flag is reset to zero(which indicates the callback is
  * finished), then it could free the context after fdset_del.
  */
-uint32_t
+static uint32_t
 fdset_event_dispatch(void *arg)
 {
-	int i;
-	struct pollfd *pfd;
+	struct epoll_event events[FDSET_MAX_EVENTS];
+	struct fdset_thread *thread = arg;
+	struct fdset *pfdset = thread->fdset;
 	struct fdentry *pfdentry;
 	fd_cb rcb, wcb;
 	void *dat;
-	int fd, numfds;
+	int fd, numfds, i;
+	uint32_t seq, revents;
 	int remove1, remove2;
-	int need_shrink;
-	struct fdset *pfdset = arg;
-	int val;
-
-	if (pfdset == NULL)
-		return 0;
 
 	while (1) {
-
-		/*
-		 * When poll is blocked, other threads might unregister
-		 * listenfds from and register new listenfds into fdset.
-		 * When poll returns, the entries for listenfds in the fdset
-		 * might have been updated. It is ok if there is unwanted call
-		 * for new listenfds.
-		 */
-		pthread_mutex_lock(&pfdset->fd_mutex);
-		numfds = pfdset->num;
-		pthread_mutex_unlock(&pfdset->fd_mutex);
-
-		pthread_mutex_lock(&pfdset->fd_pooling_mutex);
-		val = poll(pfdset->rwfds, numfds, 1000 /* millisecs */);
-		pthread_mutex_unlock(&pfdset->fd_pooling_mutex);
-		if (val < 0)
+		numfds = epoll_wait(thread->epfd, events, RTE_DIM(events), -1);
+		if (numfds < 0)
 			continue;
 
-		need_shrink = 0;
 		for (i = 0; i < numfds; i++) {
-			pthread_mutex_lock(&pfdset->fd_mutex);
+			fd = (int)(uint32_t)events[i].data.u64;
+			seq = events[i].data.u64 >> 32;
+			revents = events[i].events;
 
-			pfdentry = &pfdset->fd[i];
-			fd = pfdentry->fd;
-			pfd = &pfdset->rwfds[i];
-
-			if (fd < 0) {
-				need_shrink = 1;
-				pthread_mutex_unlock(&pfdset->fd_mutex);
-				continue;
-			}
+			pthread_mutex_lock(&pfdset->fd_mutex);
 
-			if (!pfd->revents) {
+			/*
+			 * The fd may have been deleted, or even deleted and
+			 * added again, since epoll_wait() returned.
+			 */
+			pfdentry = fdset_find_nolock(pfdset, fd);
+			if (pfdentry == NULL || pfdentry->seq != seq) {
 				pthread_mutex_unlock(&pfdset->fd_mutex);
 				continue;
 			}
@@ -278,10 +291,12 @@ fdset_event_dispatch(void *arg)
 
 			pthread_mutex_unlock(&pfdset->fd_mutex);
 
-			if (rcb && pfd->revents & (POLLIN | FDPOLLERR))
+			if (rcb && revents & (EPOLLIN | FDPOLLERR))
 				rcb(fd, dat, &remove1);
-			if (wcb && pfd->revents & (POLLOUT | FDPOLLERR))
+			if (wcb && revents & (EPOLLOUT | FDPOLLERR))
 				wcb(fd, dat, &remove2);
+
+			pthread_mutex_lock(&pfdset->fd_mutex);
 			pfdentry->busy = 0;
 			/*
 			 * fdset_del needs to check busy flag.
@@ -295,95 +310,82 @@ fdset_event_dispatch(void *arg)
 			 * listen fd in another thread, we couldn't call
 			 * fdset_del.
 			 */
-			if (remove1 || remove2) {
-				pfdentry->fd = -1;
-				need_shrink = 1;
+			if (remove1 || remove2 || pfdentry->detached) {
+				fdset_unlink_nolock(pfdset, pfdentry);
+				fdset_free_nolock(pfdset, pfdentry);
 			}
+			pthread_mutex_unlock(&pfdset->fd_mutex);
 		}
-
-		if (need_shrink)
-			fdset_shrink(pfdset);
 	}
 
 	return 0;
 }
 
-static void
-fdset_pipe_read_cb(int readfd, void *dat,
-		   int *remove __rte_unused)
-{
-	char charbuf[16];
-	struct fdset *fdset = dat;
-	int r = read(readfd, charbuf, sizeof(charbuf));
-	/*
-	 * Just an optimization, we don't care if read() failed
-	 * so ignore explicitly its return value to make the
-	 * compiler happy
-	 */
-	RTE_SET_USED(r);
-
-	pthread_mutex_lock(&fdset->sync_mutex);
-	fdset->sync = true;
-	pthread_cond_broadcast(&fdset->sync_cond);
-	pthread_mutex_unlock(&fdset->sync_mutex);
-}
-
-void
-fdset_pipe_uninit(struct fdset *fdset)
-{
-	fdset_del(fdset, fdset->u.readfd);
-	close(fdset->u.readfd);
-	close(fdset->u.writefd);
-}
-
+/**
+ * Create the threads dispatching events of the fdset.
+ *
+ * A single thread is named after the fdset, several ones get an index
+ * appended. Returns 0 on success, or if the threads are already running.
+ */
 int
-fdset_pipe_init(struct fdset *fdset)
+fdset_start(struct fdset *pfdset, const char *name, unsigned int nb_threads)
 {
+	char thread_name[RTE_THREAD_INTERNAL_NAME_SIZE];
+	struct fdset_thread *thread;
+	unsigned int i;
 	int ret;
 
-	if (pipe(fdset->u.pipefd) < 0) {
-		VHOST_FDMAN_LOG(ERR,
-			"failed to create pipe for vhost fdset");
+	if (pfdset == NULL || nb_threads == 0 ||
+			nb_threads > FDSET_MAX_THREADS)
 		return -1;
-	}
 
-	ret = fdset_add(fdset, fdset->u.readfd,
-			fdset_pipe_read_cb, NULL, fdset);
-
-	if (ret < 0) {
-		VHOST_FDMAN_LOG(ERR,
-			"failed to add pipe readfd %d into vhost server fdset",
-			fdset->u.readfd);
-
-		fdset_pipe_uninit(fdset);
-		return -1;
+	pthread_mutex_lock(&pfdset->fd_mutex);
+	if (pfdset->nb_threads != 0) {
+		pthread_mutex_unlock(&pfdset->fd_mutex);
+		return 0;
 	}
 
-	return 0;
-}
+	for (i = 0; i < nb_threads; i++) {
+		thread = &pfdset->threads[i];
+		thread->fdset = pfdset;
+		thread->num = 0;
+		thread->epfd = epoll_create1(EPOLL_CLOEXEC);
+		if (thread->epfd < 0) {
+			VHOST_FDMAN_LOG(ERR, "failed to create epoll for %s: %s",
+				name, strerror(errno));
+			goto err;
+		}
 
-void
-fdset_pipe_notify(struct fdset *fdset)
-{
-	int r = write(fdset->u.writefd, "1", 1);
-	/*
-	 * Just an optimization, we don't care if write() failed
-	 * so ignore explicitly its return value to make the
-	 * compiler happy
-	 */
-	RTE_SET_USED(r);
-}
+		if (nb_threads == 1)
+			snprintf(thread_name, sizeof(thread_name), "%s", name);
+		else
+			snprintf(thread_name, sizeof(thread_name), "%.*s%u",
+				(int)(sizeof(thread_name) - 3), name, i);
+
+		ret = rte_thread_create_internal_control(&thread->tid,
+				thread_name, fdset_event_dispatch, thread);
+		if (ret != 0) {
+			VHOST_FDMAN_LOG(ERR, "failed to create %s thread",
+				thread_name);
+			close(thread->epfd);
+			goto err;
+		}
+	}
 
-void
-fdset_pipe_notify_sync(struct fdset *fdset)
-{
-	pthread_mutex_lock(&fdset->sync_mutex);
+	pfdset->nb_threads = nb_threads;
+	pthread_mutex_unlock(&pfdset->fd_mutex);
 
-	fdset->sync = false;
-	fdset_pipe_notify(fdset);
+	return 0;
 
-	while (!fdset->sync)
-		pthread_cond_wait(&fdset->sync_cond, &fdset->sync_mutex);
+err:
+	/* no fd was added yet, threads can go away with their epoll */
+	while (i-- > 0) {
+		thread = &pfdset->threads[i];
+		pthread_cancel((pthread_t)thread->tid.opaque_id);
+		rte_thread_join(thread->tid, NULL);
+		close(thread->epfd);
+	}
+	pthread_mutex_unlock(&pfdset->fd_mutex);
 
-	pthread_mutex_unlock(&fdset->sync_mutex);
+	return -1;
 }
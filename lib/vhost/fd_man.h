@@ -5,45 +5,45 @@
 #ifndef _FD_MAN_H_
 #define _FD_MAN_H_
 #include <pthread.h>
-#include <poll.h>
 #include <stdbool.h>
+#include <stdint.h>
 
-#define MAX_FDS 1024
+#include <rte_thread.h>
+
+/* Maximum number of threads dispatching events of a fdset */
+#define FDSET_MAX_THREADS 16
 
 typedef void (*fd_cb)(int fd, void *dat, int *remove);
 
-struct fdentry {
-	int fd;		/* -1 indicates this entry is empty */
-	fd_cb rcb;	/* callback when this fd is readable. */
-	fd_cb wcb;	/* callback when this fd is writeable.*/
-	void *dat;	/* fd context */
-	int busy;	/* whether this entry is being used in cb. */
+struct fdset;
+struct fdentry;
+
+struct fdset_thread {
+	struct fdset *fdset;
+	int epfd;		/* epoll instance of this thread */
+	unsigned int num;	/* number of fds dispatched by this thread */
+	rte_thread_t tid;
 };
 
+/*
+ * Each fd is dispatched by a single thread, so that its callbacks never run
+ * concurrently. New fds go to the thread having the fewest.
+ */
 struct fdset {
-	struct pollfd rwfds[MAX_FDS];
-	struct fdentry fd[MAX_FDS];
 	pthread_mutex_t fd_mutex;
-	pthread_mutex_t fd_pooling_mutex;
-	int num;	/* current fd number of this fdset */
-
-	union pipefds {
-		struct {
-			int pipefd[2];
-		};
-		struct {
-			int readfd;
-			int writefd;
-		};
-	} u;
-
-	pthread_mutex_t sync_mutex;
-	pthread_cond_t sync_cond;
-	bool sync;
+	struct fdentry **fd;	/* entries indexed by fd, NULL if empty */
+	int fd_size;		/* size of fd array */
+	int num;		/* current fd number of this fdset */
+	uint32_t seq;		/* tag of next entry, to spot stale events */
+
+	unsigned int nb_threads;
+	struct fdset_thread threads[FDSET_MAX_THREADS];
 };
 
+#define FDSET_INITIALIZER { .fd_mutex = PTHREAD_MUTEX_INITIALIZER }
 
-void fdset_init(struct fdset *pfdset);
+int fdset_start(struct fdset *pfdset, const char *name,
+	unsigned int nb_threads);
 
 int fdset_add(struct fdset *pfdset, int fd,
 	fd_cb rcb, fd_cb wcb, void *dat);
@@ -51,13 +51,4 @@ int fdset_add(struct fdset *pfdset, int fd,
 void *fdset_del(struct fdset *pfdset, int fd);
 int fdset_try_del(struct fdset *pfdset, int fd);
 
-uint32_t fdset_event_dispatch(void *arg);
-
-int fdset_pipe_init(struct fdset *fdset);
-
-void fdset_pipe_uninit(struct fdset *fdset);
-
-void fdset_pipe_notify(struct fdset *fdset);
-void fdset_pipe_notify_sync(struct fdset *fdset);
-
 #endif
@@ -21,6 +21,23 @@ struct vhost_iotlb_entry {
 	uint64_t size;
 	uint8_t page_shift;
 	uint8_t perm;
+	bool cached;
+	/* virtqueue whose miss added the pending entry */
+	uint32_t vq_idx;
+	/* set on lookup, cleared by the eviction clock */
+	RTE_ATOMIC(bool) referenced;
+};
+
+/*
+ * Cached entries are indexed by a sorted array. Along with its start IOVA,
+ * each slot holds the largest end IOVA of all entries up to it. As those are
+ * increasing, two binary searches find the first entry containing an IOVA,
+ * even if entries overlap.
+ */
+struct vhost_iotlb_slot {
+	uint64_t start;
+	uint64_t max_end;
+	struct vhost_iotlb_entry *node;
 };
 
 #define IOTLB_CACHE_SIZE 2048
@@ -106,7 +123,7 @@ vhost_user_iotlb_pool_put(struct virtio_net *dev, struct vhost_iotlb_entry *node
 }
 
 static void
-vhost_user_iotlb_cache_random_evict(struct virtio_net *dev);
+vhost_user_iotlb_cache_evict(struct virtio_net *dev, struct vhost_virtqueue *vq);
 
 static void
 vhost_user_iotlb_pending_remove_all(struct virtio_net *dev)
@@ -143,8 +160,31 @@ vhost_user_iotlb_pending_miss(struct virtio_net *dev, uint64_t iova, uint8_t per
 	return found;
 }
 
+/* virtqueue which missed an IOVA of the range, NULL if none */
+static struct vhost_virtqueue *
+vhost_user_iotlb_pending_vq(struct virtio_net *dev, uint64_t iova, uint64_t size)
+{
+	struct vhost_iotlb_entry *node;
+	struct vhost_virtqueue *vq = NULL;
+
+	rte_rwlock_read_lock(&dev->iotlb_pending_lock);
+
+	TAILQ_FOREACH(node, &dev->iotlb_pending_list, next) {
+		if (node->iova < iova || node->iova >= iova + size)
+			continue;
+		if (node->vq_idx < dev->nr_vring)
+			vq = dev->virtqueue[node->vq_idx];
+		break;
+	}
+
+	rte_rwlock_read_unlock(&dev->iotlb_pending_lock);
+
+	return vq;
+}
+
 void
-vhost_user_iotlb_pending_insert(struct virtio_net *dev, uint64_t iova, uint8_t perm)
+vhost_user_iotlb_pending_insert(struct virtio_net *dev, struct vhost_virtqueue *vq,
+		uint64_t iova, uint8_t perm)
 {
 	struct vhost_iotlb_entry *node;
 
@@ -155,7 +195,7 @@ vhost_user_iotlb_pending_insert(struct virtio_net *dev, uint64_t iova, uint8_t p
 		if (!TAILQ_EMPTY(&dev->iotlb_pending_list))
 			vhost_user_iotlb_pending_remove_all(dev);
 		else
-			vhost_user_iotlb_cache_random_evict(dev);
+			vhost_user_iotlb_cache_evict(dev, vq);
 		node = vhost_user_iotlb_pool_get(dev);
 		if (node == NULL) {
 			VHOST_CONFIG_LOG(dev->ifname, ERR,
@@ -166,6 +206,7 @@ vhost_user_iotlb_pending_insert(struct virtio_net *dev, uint64_t iova, uint8_t p
 
 	node->iova = iova;
 	node->perm = perm;
+	node->vq_idx = vq->index;
 
 	rte_rwlock_write_lock(&dev->iotlb_pending_lock);
 
@@ -196,50 +237,127 @@ vhost_user_iotlb_pending_remove(struct virtio_net *dev, uint64_t iova, uint64_t
 	rte_rwlock_write_unlock(&dev->iotlb_pending_lock);
 }
 
-static void
-vhost_user_iotlb_cache_remove_all(struct virtio_net *dev)
+/* number of cached entries starting at or below iova */
+static int
+vhost_user_iotlb_index_upper(struct virtio_net *dev, uint64_t iova)
 {
-	struct vhost_iotlb_entry *node, *temp_node;
+	int lo = 0, hi = dev->iotlb_cache_nr, mid;
 
-	vhost_user_iotlb_wr_lock_all(dev);
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (dev->iotlb_index[mid].start <= iova)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
 
-	RTE_TAILQ_FOREACH_SAFE(node, &dev->iotlb_list, next, temp_node) {
-		vhost_user_iotlb_clear_dump(dev, node, NULL, NULL);
+	return lo;
+}
 
-		TAILQ_REMOVE(&dev->iotlb_list, node, next);
-		vhost_user_iotlb_remove_notify(dev, node);
-		vhost_user_iotlb_pool_put(dev, node);
+/* first of the n first cached entries ending above iova, n if none */
+static int
+vhost_user_iotlb_index_first_end(struct virtio_net *dev, uint64_t iova, int n)
+{
+	int lo = 0, hi = n, mid;
+
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (dev->iotlb_index[mid].max_end > iova)
+			hi = mid;
+		else
+			lo = mid + 1;
 	}
 
-	dev->iotlb_cache_nr = 0;
+	return lo;
+}
 
-	vhost_user_iotlb_wr_unlock_all(dev);
+static void
+vhost_user_iotlb_index_update(struct virtio_net *dev, int idx)
+{
+	struct vhost_iotlb_slot *slot;
+	uint64_t max_end;
+
+	max_end = idx > 0 ? dev->iotlb_index[idx - 1].max_end : 0;
+	for (; idx < dev->iotlb_cache_nr; idx++) {
+		slot = &dev->iotlb_index[idx];
+		max_end = RTE_MAX(max_end, slot->node->iova + slot->node->size);
+		slot->max_end = max_end;
+	}
+}
+
+static struct vhost_iotlb_entry *
+vhost_user_iotlb_index_node(struct virtio_net *dev, int idx)
+{
+	if (idx < 0 || idx >= dev->iotlb_cache_nr)
+		return NULL;
+	return dev->iotlb_index[idx].node;
 }
 
 static void
-vhost_user_iotlb_cache_random_evict(struct virtio_net *dev)
+vhost_user_iotlb_cache_remove_idx(struct virtio_net *dev, int idx)
 {
-	struct vhost_iotlb_entry *node, *temp_node, *prev_node = NULL;
-	int entry_idx;
+	struct vhost_iotlb_entry *node = dev->iotlb_index[idx].node;
+
+	vhost_user_iotlb_clear_dump(dev, node, vhost_user_iotlb_index_node(dev, idx - 1),
+		vhost_user_iotlb_index_node(dev, idx + 1));
+
+	memmove(&dev->iotlb_index[idx], &dev->iotlb_index[idx + 1],
+		(dev->iotlb_cache_nr - idx - 1) * sizeof(dev->iotlb_index[0]));
+	dev->iotlb_cache_nr--;
+	vhost_user_iotlb_index_update(dev, idx);
+	/* invalidate last entry hit of all virtqueues */
+	dev->iotlb_gen++;
 
+	node->cached = false;
+	vhost_user_iotlb_remove_notify(dev, node);
+	vhost_user_iotlb_pool_put(dev, node);
+}
+
+static void
+vhost_user_iotlb_cache_remove_all(struct virtio_net *dev)
+{
 	vhost_user_iotlb_wr_lock_all(dev);
 
-	entry_idx = rte_rand() % dev->iotlb_cache_nr;
+	while (dev->iotlb_cache_nr > 0)
+		vhost_user_iotlb_cache_remove_idx(dev, dev->iotlb_cache_nr - 1);
+
+	vhost_user_iotlb_wr_unlock_all(dev);
+}
+
+/*
+ * CLOCK eviction, entries looked up since the hand last passed are spared.
+ * The eviction is counted on the virtqueue whose miss caused it, if any.
+ */
+static void
+vhost_user_iotlb_cache_evict(struct virtio_net *dev, struct vhost_virtqueue *vq)
+{
+	struct vhost_iotlb_entry *node;
+	unsigned int i;
+	int idx;
 
-	RTE_TAILQ_FOREACH_SAFE(node, &dev->iotlb_list, next, temp_node) {
-		if (!entry_idx) {
-			struct vhost_iotlb_entry *next_node = RTE_TAILQ_NEXT(node, next);
+	vhost_user_iotlb_wr_lock_all(dev);
 
-			vhost_user_iotlb_clear_dump(dev, node, prev_node, next_node);
+	for (i = 0; i < 2 * IOTLB_CACHE_SIZE; i++) {
+		node = &dev->iotlb_pool[dev->iotlb_clock];
+		dev->iotlb_clock = (dev->iotlb_clock + 1) % IOTLB_CACHE_SIZE;
 
-			TAILQ_REMOVE(&dev->iotlb_list, node, next);
-			vhost_user_iotlb_remove_notify(dev, node);
-			vhost_user_iotlb_pool_put(dev, node);
-			dev->iotlb_cache_nr--;
-			break;
+		if (!node->cached)
+			continue;
+		if (rte_atomic_load_explicit(&node->referenced, rte_memory_order_relaxed)) {
+			rte_atomic_store_explicit(&node->referenced, false,
+				rte_memory_order_relaxed);
+			continue;
 		}
-		prev_node = node;
-		entry_idx--;
+
+		/* several entries may start at the same IOVA */
+		for (idx = vhost_user_iotlb_index_upper(dev, node->iova) - 1;
+				dev->iotlb_index[idx].node != node; idx--)
+			;
+		vhost_user_iotlb_cache_remove_idx(dev, idx);
+
+		if ((dev->flags & VIRTIO_DEV_STATS_ENABLED) && vq != NULL)
+			vq->stats.iotlb_evictions++;
+		break;
 	}
 
 	vhost_user_iotlb_wr_unlock_all(dev);
@@ -249,14 +367,16 @@ void
 vhost_user_iotlb_cache_insert(struct virtio_net *dev, uint64_t iova, uint64_t uaddr,
 				uint64_t uoffset, uint64_t size, uint64_t page_size, uint8_t perm)
 {
-	struct vhost_iotlb_entry *node, *new_node;
+	struct vhost_iotlb_entry *new_node;
+	int idx;
 
 	new_node = vhost_user_iotlb_pool_get(dev);
 	if (new_node == NULL) {
 		VHOST_CONFIG_LOG(dev->ifname, DEBUG,
 			"IOTLB pool empty, clear entries for cache insertion");
-		if (!TAILQ_EMPTY(&dev->iotlb_list))
-			vhost_user_iotlb_cache_random_evict(dev);
+		if (dev->iotlb_cache_nr > 0)
+			vhost_user_iotlb_cache_evict(dev,
+				vhost_user_iotlb_pending_vq(dev, iova, size));
 		else
 			vhost_user_iotlb_pending_remove_all(dev);
 		new_node = vhost_user_iotlb_pool_get(dev);
@@ -273,30 +393,29 @@ vhost_user_iotlb_cache_insert(struct virtio_net *dev, uint64_t iova, uint64_t ua
 	new_node->size = size;
 	new_node->page_shift = rte_ctz64(page_size);
 	new_node->perm = perm;
+	rte_atomic_store_explicit(&new_node->referenced, true, rte_memory_order_relaxed);
 
 	vhost_user_iotlb_wr_lock_all(dev);
 
-	TAILQ_FOREACH(node, &dev->iotlb_list, next) {
-		/*
-		 * Entries must be invalidated before being updated.
-		 * So if iova already in list, assume identical.
-		 */
-		if (node->iova == new_node->iova) {
-			vhost_user_iotlb_pool_put(dev, new_node);
-			goto unlock;
-		} else if (node->iova > new_node->iova) {
-			vhost_user_iotlb_set_dump(dev, new_node);
-
-			TAILQ_INSERT_BEFORE(node, new_node, next);
-			dev->iotlb_cache_nr++;
-			goto unlock;
-		}
+	/*
+	 * Entries must be invalidated before being updated.
+	 * So if iova already in index, assume identical.
+	 */
+	idx = vhost_user_iotlb_index_upper(dev, iova);
+	if (idx > 0 && dev->iotlb_index[idx - 1].start == iova) {
+		vhost_user_iotlb_pool_put(dev, new_node);
+		goto unlock;
 	}
 
 	vhost_user_iotlb_set_dump(dev, new_node);
 
-	TAILQ_INSERT_TAIL(&dev->iotlb_list, new_node, next);
+	memmove(&dev->iotlb_index[idx + 1], &dev->iotlb_index[idx],
+		(dev->iotlb_cache_nr - idx) * sizeof(dev->iotlb_index[0]));
+	dev->iotlb_index[idx].start = iova;
+	dev->iotlb_index[idx].node = new_node;
+	new_node->cached = true;
 	dev->iotlb_cache_nr++;
+	vhost_user_iotlb_index_update(dev, idx);
 
 unlock:
 	vhost_user_iotlb_pending_remove(dev, iova, size, perm);
@@ -307,46 +426,63 @@ vhost_user_iotlb_cache_insert(struct virtio_net *dev, uint64_t iova, uint64_t ua
 void
 vhost_user_iotlb_cache_remove(struct virtio_net *dev, uint64_t iova, uint64_t size)
 {
-	struct vhost_iotlb_entry *node, *temp_node, *prev_node = NULL;
+	struct vhost_iotlb_entry *node;
+	int idx;
 
 	if (unlikely(!size))
 		return;
 
 	vhost_user_iotlb_wr_lock_all(dev);
 
-	RTE_TAILQ_FOREACH_SAFE(node, &dev->iotlb_list, next, temp_node) {
-		/* Sorted list */
+	idx = vhost_user_iotlb_index_first_end(dev, iova, dev->iotlb_cache_nr);
+	while (idx < dev->iotlb_cache_nr) {
+		node = dev->iotlb_index[idx].node;
+
+		/* Sorted index */
 		if (unlikely(iova + size < node->iova))
 			break;
 
-		if (iova < node->iova + node->size) {
-			struct vhost_iotlb_entry *next_node = RTE_TAILQ_NEXT(node, next);
-
-			vhost_user_iotlb_clear_dump(dev, node, prev_node, next_node);
-
-			TAILQ_REMOVE(&dev->iotlb_list, node, next);
-			vhost_user_iotlb_remove_notify(dev, node);
-			vhost_user_iotlb_pool_put(dev, node);
-			dev->iotlb_cache_nr--;
-		} else {
-			prev_node = node;
-		}
+		if (iova < node->iova + node->size)
+			vhost_user_iotlb_cache_remove_idx(dev, idx);
+		else
+			idx++;
 	}
 
 	vhost_user_iotlb_wr_unlock_all(dev);
 }
 
 uint64_t
-vhost_user_iotlb_cache_find(struct virtio_net *dev, uint64_t iova, uint64_t *size, uint8_t perm)
+vhost_user_iotlb_cache_find(struct virtio_net *dev, struct vhost_virtqueue *vq,
+		uint64_t iova, uint64_t *size, uint8_t perm)
 {
 	struct vhost_iotlb_entry *node;
 	uint64_t offset, vva = 0, mapped = 0;
+	int idx, n;
 
 	if (unlikely(!*size))
 		goto out;
 
-	TAILQ_FOREACH(node, &dev->iotlb_list, next) {
-		/* List sorted by iova */
+	/* most lookups hit the same entry as the previous one */
+	node = vq->iotlb_last;
+	if (likely(node != NULL && vq->iotlb_last_gen == dev->iotlb_gen &&
+			iova >= node->iova && (perm & node->perm) == perm)) {
+		offset = iova - node->iova;
+		if (offset < node->size && *size <= node->size - offset) {
+			rte_atomic_store_explicit(&node->referenced, true,
+				rte_memory_order_relaxed);
+			return node->uaddr + node->uoffset + offset;
+		}
+	}
+
+	n = vhost_user_iotlb_index_upper(dev, iova);
+	if (n == 0 || dev->iotlb_index[n - 1].max_end <= iova)
+		goto out;
+
+	for (idx = vhost_user_iotlb_index_first_end(dev, iova, n);
+			idx < dev->iotlb_cache_nr; idx++) {
+		node = dev->iotlb_index[idx].node;
+
+		/* Index sorted by iova */
 		if (unlikely(iova < node->iova))
 			break;
 
@@ -358,9 +494,16 @@ vhost_user_iotlb_cache_find(struct virtio_net *dev, uint64_t iova, uint64_t *siz
 			break;
 		}
 
+		if (!rte_atomic_load_explicit(&node->referenced, rte_memory_order_relaxed))
+			rte_atomic_store_explicit(&node->referenced, true,
+				rte_memory_order_relaxed);
+
 		offset = iova - node->iova;
-		if (!vva)
+		if (!vva) {
 			vva = node->uaddr + node->uoffset + offset;
+			vq->iotlb_last = node;
+			vq->iotlb_last_gen = dev->iotlb_gen;
+		}
 
 		mapped += node->size - offset;
 		iova = node->iova + node->size;
@@ -397,6 +540,9 @@ vhost_user_iotlb_init(struct virtio_net *dev)
 		 */
 		vhost_user_iotlb_flush_all(dev);
 		rte_free(dev->iotlb_pool);
+		rte_free(dev->iotlb_index);
+		dev->iotlb_pool = NULL;
+		dev->iotlb_index = NULL;
 	}
 
 #ifdef RTE_LIBRTE_VHOST_NUMA
@@ -408,7 +554,6 @@ vhost_user_iotlb_init(struct virtio_net *dev)
 	rte_rwlock_init(&dev->iotlb_pending_lock);
 
 	SLIST_INIT(&dev->iotlb_free_list);
-	TAILQ_INIT(&dev->iotlb_list);
 	TAILQ_INIT(&dev->iotlb_pending_list);
 
 	if (dev->flags & VIRTIO_DEV_SUPPORT_IOMMU) {
@@ -418,11 +563,22 @@ vhost_user_iotlb_init(struct virtio_net *dev)
 			VHOST_CONFIG_LOG(dev->ifname, ERR, "Failed to create IOTLB cache pool");
 			return -1;
 		}
+		dev->iotlb_index = rte_calloc_socket("iotlb_index", IOTLB_CACHE_SIZE,
+			sizeof(struct vhost_iotlb_slot), 0, socket);
+		if (!dev->iotlb_index) {
+			VHOST_CONFIG_LOG(dev->ifname, ERR, "Failed to create IOTLB cache index");
+			rte_free(dev->iotlb_pool);
+			dev->iotlb_pool = NULL;
+			return -1;
+		}
 		for (i = 0; i < IOTLB_CACHE_SIZE; i++)
 			vhost_user_iotlb_pool_put(dev, &dev->iotlb_pool[i]);
 	}
 
 	dev->iotlb_cache_nr = 0;
+	dev->iotlb_clock = 0;
+	/* forget last entry hit by virtqueues, it may belong to the old pool */
+	dev->iotlb_gen++;
 
 	return 0;
 }
@@ -431,4 +587,5 @@ void
 vhost_user_iotlb_destroy(struct virtio_net *dev)
 {
 	rte_free(dev->iotlb_pool);
+	rte_free(dev->iotlb_index);
 }
@@ -60,10 +60,12 @@ vhost_user_iotlb_wr_unlock_all(struct virtio_net *dev)
 void vhost_user_iotlb_cache_insert(struct virtio_net *dev, uint64_t iova, uint64_t uaddr,
 		uint64_t uoffset, uint64_t size, uint64_t page_size, uint8_t perm);
 void vhost_user_iotlb_cache_remove(struct virtio_net *dev, uint64_t iova, uint64_t size);
-uint64_t vhost_user_iotlb_cache_find(struct virtio_net *dev, uint64_t iova,
-					uint64_t *size, uint8_t perm);
+uint64_t vhost_user_iotlb_cache_find(struct virtio_net *dev, struct vhost_virtqueue *vq,
+		uint64_t iova, uint64_t *size, uint8_t perm)
+	__rte_shared_locks_required(&vq->iotlb_lock);
 bool vhost_user_iotlb_pending_miss(struct virtio_net *dev, uint64_t iova, uint8_t perm);
-void vhost_user_iotlb_pending_insert(struct virtio_net *dev, uint64_t iova, uint8_t perm);
+void vhost_user_iotlb_pending_insert(struct virtio_net *dev, struct vhost_virtqueue *vq,
+		uint64_t iova, uint8_t perm);
 void vhost_user_iotlb_pending_remove(struct virtio_net *dev, uint64_t iova,
 						uint64_t size, uint8_t perm);
 void vhost_user_iotlb_flush_all(struct virtio_net *dev);
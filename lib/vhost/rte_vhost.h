@@ -41,6 +41,8 @@ extern "C" {
 #define RTE_VHOST_USER_ASYNC_COPY	(1ULL << 7)
 #define RTE_VHOST_USER_NET_COMPLIANT_OL_FLAGS	(1ULL << 8)
 #define RTE_VHOST_USER_NET_STATS_ENABLE	(1ULL << 9)
+/* fault guest memory in from several threads when it is mapped */
+#define RTE_VHOST_USER_PREFAULT_MEM	(1ULL << 10)
 
 /* Features. */
 #ifndef VIRTIO_NET_F_GUEST_ANNOUNCE
@@ -394,6 +396,158 @@ rte_vhost_va_from_guest_pa(struct rte_vhost_memory *mem,
 	return 0;
 }
 
+/** Each first level entry of the translation table covers 1 GB. */
+#define RTE_VHOST_MEM_XLAT_L1_SHIFT 30
+/** Translation table entry not backed by guest memory. */
+#define RTE_VHOST_MEM_XLAT_INVALID UINT32_MAX
+
+/**
+ * Guest memory area contiguous in guest physical, host virtual and
+ * host IOVA address spaces.
+ */
+struct rte_vhost_mem_xlat_page {
+	uint64_t guest_phys_addr; /**< start guest physical address */
+	uint64_t host_iova; /**< start host IOVA */
+	uint64_t host_user_addr; /**< start host virtual address */
+	uint64_t size; /**< size of the area */
+	/** size of host virtual address contiguous memory, at least size */
+	uint64_t va_size;
+};
+
+/**
+ * Two-level translation table of guest physical addresses.
+ *
+ * Guest physical address space is split in 1 GB chunks, each of which is
+ * split in blocks of 2^page_shift bytes. Every block refers to the page it
+ * belongs to, so a lookup is two array reads whatever the number of pages.
+ */
+struct rte_vhost_mem_xlat {
+	uint32_t page_shift; /**< log2 of block size */
+	uint32_t nb_l1; /**< number of 1 GB chunks covered */
+	/** index of second level table of each chunk, or invalid */
+	const uint32_t *l1;
+	/** index of the page of each block, or invalid */
+	const uint32_t *l2;
+	const struct rte_vhost_mem_xlat_page *pages; /**< guest pages */
+	uint32_t nb_pages; /**< number of guest pages */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Look up the guest page a guest physical address belongs to.
+ *
+ * @param xlat
+ *  the translation table, see rte_vhost_get_mem_xlat()
+ * @param gpa
+ *  the guest physical address for querying
+ * @return
+ *  the guest page on success, NULL if the address is not guest memory
+ */
+__rte_experimental
+static __rte_always_inline const struct rte_vhost_mem_xlat_page *
+rte_vhost_mem_xlat_lookup(const struct rte_vhost_mem_xlat *xlat, uint64_t gpa)
+{
+	uint64_t l1_idx = gpa >> RTE_VHOST_MEM_XLAT_L1_SHIFT;
+	uint32_t l2_shift = RTE_VHOST_MEM_XLAT_L1_SHIFT - xlat->page_shift;
+	uint64_t l2_idx;
+	uint32_t chunk, page;
+
+	if (unlikely(l1_idx >= xlat->nb_l1))
+		return NULL;
+	chunk = xlat->l1[l1_idx];
+	if (unlikely(chunk == RTE_VHOST_MEM_XLAT_INVALID))
+		return NULL;
+
+	l2_idx = ((uint64_t)chunk << l2_shift) |
+		((gpa >> xlat->page_shift) & ((1ULL << l2_shift) - 1));
+	page = xlat->l2[l2_idx];
+	if (unlikely(page == RTE_VHOST_MEM_XLAT_INVALID))
+		return NULL;
+
+	return &xlat->pages[page];
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Convert guest physical address to host virtual address in constant time.
+ *
+ * @param xlat
+ *  the translation table, see rte_vhost_get_mem_xlat()
+ * @param gpa
+ *  the guest physical address for querying
+ * @param len
+ *  the size of the requested area to map, updated with actual size mapped
+ * @return
+ *  the host virtual address on success, 0 on failure
+ */
+__rte_experimental
+static __rte_always_inline uint64_t
+rte_vhost_mem_xlat_gpa_to_vva(const struct rte_vhost_mem_xlat *xlat,
+		uint64_t gpa, uint64_t *len)
+{
+	const struct rte_vhost_mem_xlat_page *page;
+	uint64_t offset;
+
+	page = rte_vhost_mem_xlat_lookup(xlat, gpa);
+	if (unlikely(page == NULL)) {
+		*len = 0;
+		return 0;
+	}
+
+	offset = gpa - page->guest_phys_addr;
+	if (unlikely(*len > page->va_size - offset))
+		*len = page->va_size - offset;
+
+	return page->host_user_addr + offset;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Convert guest physical address to host IOVA in constant time.
+ *
+ * @param xlat
+ *  the translation table, see rte_vhost_get_mem_xlat()
+ * @param gpa
+ *  the guest physical address for querying
+ * @param len
+ *  the size of the requested area to map, updated with actual size
+ *  contiguous in IOVA space
+ * @return
+ *  the host IOVA on success, 0 on failure
+ */
+__rte_experimental
+static __rte_always_inline uint64_t
+rte_vhost_mem_xlat_gpa_to_iova(const struct rte_vhost_mem_xlat *xlat,
+		uint64_t gpa, uint64_t *len)
+{
+	const struct rte_vhost_mem_xlat_page *page;
+	uint64_t offset;
+
+	page = rte_vhost_mem_xlat_lookup(xlat, gpa);
+	if (unlikely(page == NULL)) {
+		*len = 0;
+		return 0;
+	}
+
+	/* no IOVA without async copy, see rte_vhost_get_mem_xlat() */
+	if (unlikely(page->host_iova == RTE_BAD_IOVA)) {
+		*len = 0;
+		return 0;
+	}
+
+	offset = gpa - page->guest_phys_addr;
+	if (unlikely(*len > page->size - offset))
+		*len = page->size - offset;
+
+	return page->host_iova + offset;
+}
+
 #define RTE_VHOST_NEED_LOG(features)	((features) & (1ULL << VHOST_F_LOG_ALL))
 
 /**
@@ -668,6 +822,25 @@ int rte_vhost_driver_callback_register(const char *path,
  */
 int rte_vhost_driver_start(const char *path);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Set the number of threads handling vhost-user socket events,
+ * such as new connections and vhost-user messages. Messages of a given
+ * connection are always handled by the same thread, in order.
+ *
+ * Default is a single thread. It must be called before the first
+ * rte_vhost_driver_start(), as threads are created then.
+ *
+ * @param nb_threads
+ *  Number of event threads, from 1 to 16
+ * @return
+ *  0 on success, -1 on failure
+ */
+__rte_experimental
+int rte_vhost_driver_set_event_threads(unsigned int nb_threads);
+
 /**
  * Get the MTU value of the device if set in QEMU.
  *
@@ -792,6 +965,35 @@ uint16_t rte_vhost_dequeue_burst(int vid, uint16_t queue_id,
  */
 int rte_vhost_get_mem_table(int vid, struct rte_vhost_memory **mem);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the translation table of guest physical addresses of a device,
+ * to be used with rte_vhost_mem_xlat_gpa_to_vva() and
+ * rte_vhost_mem_xlat_gpa_to_iova().
+ *
+ * IOVAs are only known for devices using async copy, for other devices
+ * the table translates to host virtual addresses only and
+ * rte_vhost_mem_xlat_gpa_to_iova() fails. The table belongs to the
+ * device, and is freed and rebuilt on every guest memory table change:
+ * a table got before must not be used once the change starts, i.e. after
+ * vring_state_changed() callback disabled the queues, and must be got again
+ * once they are enabled back. It must not be used after destroy_device()
+ * callback either.
+ *
+ * @param vid
+ *  vhost device ID
+ * @param xlat
+ *  To store the translation table
+ * @return
+ *  0 on success, -1 on failure, e.g. when guest memory layout is too
+ *  fragmented for a table, in which case rte_vhost_va_from_guest_pa()
+ *  should be used instead
+ */
+__rte_experimental
+int rte_vhost_get_mem_xlat(int vid, const struct rte_vhost_mem_xlat **xlat);
+
 /**
  * Get guest vring info, including the vring address, vring size, etc.
  *
@@ -45,6 +45,7 @@ struct vhost_user_socket {
 	bool async_copy;
 	bool net_compliant_ol_flags;
 	bool stats_enabled;
+	bool mem_prefault;
 
 	/*
 	 * The "supported_features" indicates the feature bits the
@@ -77,6 +78,7 @@ struct vhost_user_connection {
 struct vhost_user {
 	struct vhost_user_socket *vsockets[MAX_VHOST_SOCKET];
 	struct fdset fdset;
+	unsigned int nb_event_threads;
 	int vsocket_cnt;
 	pthread_mutex_t mutex;
 };
@@ -89,13 +91,8 @@ static int create_unix_socket(struct vhost_user_socket *vsocket);
 static int vhost_user_start_client(struct vhost_user_socket *vsocket);
 
 static struct vhost_user vhost_user = {
-	.fdset = {
-		.fd = { [0 ... MAX_FDS - 1] = {-1, NULL, NULL, NULL, 0} },
-		.fd_mutex = PTHREAD_MUTEX_INITIALIZER,
-		.fd_pooling_mutex = PTHREAD_MUTEX_INITIALIZER,
-		.sync_mutex = PTHREAD_MUTEX_INITIALIZER,
-		.num = 0
-	},
+	.fdset = FDSET_INITIALIZER,
+	.nb_event_threads = 1,
 	.vsocket_cnt = 0,
 	.mutex = PTHREAD_MUTEX_INITIALIZER,
 };
@@ -246,6 +243,9 @@ vhost_user_add_connection(int fd, struct vhost_user_socket *vsocket)
 	if (vsocket->linearbuf)
 		vhost_enable_linearbuf(vid);
 
+	if (vsocket->mem_prefault)
+		vhost_enable_mem_prefault(vid);
+
 	if (vsocket->async_copy) {
 		dev = get_device(vid);
 
@@ -268,6 +268,12 @@ vhost_user_add_connection(int fd, struct vhost_user_socket *vsocket)
 	conn->connfd = fd;
 	conn->vsocket = vsocket;
 	conn->vid = vid;
+
+	/* read callback may run in another thread as soon as fd is added */
+	pthread_mutex_lock(&vsocket->conn_mutex);
+	TAILQ_INSERT_TAIL(&vsocket->conn_list, conn, next);
+	pthread_mutex_unlock(&vsocket->conn_mutex);
+
 	ret = fdset_add(&vhost_user.fdset, fd, vhost_user_read_cb,
 			NULL, conn);
 	if (ret < 0) {
@@ -275,17 +281,16 @@ vhost_user_add_connection(int fd, struct vhost_user_socket *vsocket)
 			"failed to add fd %d into vhost server fdset",
 			fd);
 
+		pthread_mutex_lock(&vsocket->conn_mutex);
+		TAILQ_REMOVE(&vsocket->conn_list, conn, next);
+		pthread_mutex_unlock(&vsocket->conn_mutex);
+
 		if (vsocket->notify_ops->destroy_connection)
 			vsocket->notify_ops->destroy_connection(conn->vid);
 
 		goto err_cleanup;
 	}
 
-	pthread_mutex_lock(&vsocket->conn_mutex);
-	TAILQ_INSERT_TAIL(&vsocket->conn_list, conn, next);
-	pthread_mutex_unlock(&vsocket->conn_mutex);
-
-	fdset_pipe_notify(&vhost_user.fdset);
 	return;
 
 err_cleanup:
@@ -930,6 +935,7 @@ rte_vhost_driver_register(const char *path, uint64_t flags)
 	vsocket->async_copy = flags & RTE_VHOST_USER_ASYNC_COPY;
 	vsocket->net_compliant_ol_flags = flags & RTE_VHOST_USER_NET_COMPLIANT_OL_FLAGS;
 	vsocket->stats_enabled = flags & RTE_VHOST_USER_NET_STATS_ENABLE;
+	vsocket->mem_prefault = flags & RTE_VHOST_USER_PREFAULT_MEM;
 	if (vsocket->is_vduse)
 		vsocket->iommu_support = true;
 	else
@@ -1171,11 +1177,29 @@ vhost_driver_callback_get(const char *path)
 	return vsocket ? vsocket->notify_ops : NULL;
 }
 
+int
+rte_vhost_driver_set_event_threads(unsigned int nb_threads)
+{
+	int ret = 0;
+
+	if (nb_threads == 0 || nb_threads > FDSET_MAX_THREADS)
+		return -1;
+
+	pthread_mutex_lock(&vhost_user.mutex);
+	/* threads are already running */
+	if (vhost_user.fdset.nb_threads != 0)
+		ret = -1;
+	else
+		vhost_user.nb_event_threads = nb_threads;
+	pthread_mutex_unlock(&vhost_user.mutex);
+
+	return ret;
+}
+
 int
 rte_vhost_driver_start(const char *path)
 {
 	struct vhost_user_socket *vsocket;
-	static rte_thread_t fdset_tid;
 
 	pthread_mutex_lock(&vhost_user.mutex);
 	vsocket = find_vhost_user_socket(path);
@@ -1187,24 +1211,14 @@ rte_vhost_driver_start(const char *path)
 	if (vsocket->is_vduse)
 		return vduse_device_create(path, vsocket->net_compliant_ol_flags);
 
-	if (fdset_tid.opaque_id == 0) {
-		/**
-		 * create a pipe which will be waited by poll and notified to
-		 * rebuild the wait list of poll.
-		 */
-		if (fdset_pipe_init(&vhost_user.fdset) < 0) {
-			VHOST_CONFIG_LOG(path, ERR, "failed to create pipe for vhost fdset");
-			return -1;
-		}
-
-		int ret = rte_thread_create_internal_control(&fdset_tid,
-				"vhost-evt", fdset_event_dispatch, &vhost_user.fdset);
-		if (ret != 0) {
-			VHOST_CONFIG_LOG(path, ERR, "failed to create fdset handling thread");
-			fdset_pipe_uninit(&vhost_user.fdset);
-			return -1;
-		}
+	pthread_mutex_lock(&vhost_user.mutex);
+	if (fdset_start(&vhost_user.fdset, "vhost-evt",
+			vhost_user.nb_event_threads) < 0) {
+		pthread_mutex_unlock(&vhost_user.mutex);
+		VHOST_CONFIG_LOG(path, ERR, "failed to create fdset handling threads");
+		return -1;
 	}
+	pthread_mutex_unlock(&vhost_user.mutex);
 
 	if (vsocket->is_server)
 		return vhost_user_start_server(vsocket);
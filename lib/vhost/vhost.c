@@ -4,6 +4,7 @@
 
 #include <linux/vhost.h>
 #include <linux/virtio_net.h>
+#include <ctype.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <pthread.h>
@@ -16,6 +17,7 @@
 #include <rte_log.h>
 #include <rte_memory.h>
 #include <rte_malloc.h>
+#include <rte_telemetry.h>
 #include <rte_vhost.h>
 
 #include "iotlb.h"
@@ -53,6 +55,7 @@ static const struct vhost_vq_stats_name_off vhost_vq_stat_strings[] = {
 		stats.guest_notifications_suppressed)},
 	{"iotlb_hits",             offsetof(struct vhost_virtqueue, stats.iotlb_hits)},
 	{"iotlb_misses",           offsetof(struct vhost_virtqueue, stats.iotlb_misses)},
+	{"iotlb_evictions",        offsetof(struct vhost_virtqueue, stats.iotlb_evictions)},
 	{"inflight_submitted",     offsetof(struct vhost_virtqueue, stats.inflight_submitted)},
 	{"inflight_completed",     offsetof(struct vhost_virtqueue, stats.inflight_completed)},
 	{"mbuf_alloc_failed",      offsetof(struct vhost_virtqueue, stats.mbuf_alloc_failed)},
@@ -77,7 +80,7 @@ __vhost_iova_to_vva(struct virtio_net *dev, struct vhost_virtqueue *vq,
 
 	tmp_size = *size;
 
-	vva = vhost_user_iotlb_cache_find(dev, iova, &tmp_size, perm);
+	vva = vhost_user_iotlb_cache_find(dev, vq, iova, &tmp_size, perm);
 	if (tmp_size == *size) {
 		if (dev->flags & VIRTIO_DEV_STATS_ENABLED)
 			vq->stats.iotlb_hits++;
@@ -99,7 +102,7 @@ __vhost_iova_to_vva(struct virtio_net *dev, struct vhost_virtqueue *vq,
 		 */
 		vhost_user_iotlb_rd_unlock(vq);
 
-		vhost_user_iotlb_pending_insert(dev, iova, perm);
+		vhost_user_iotlb_pending_insert(dev, vq, iova, perm);
 		if (vhost_iotlb_miss(dev, iova, perm)) {
 			VHOST_DATA_LOG(dev->ifname, ERR,
 				"IOTLB miss req failed for IOVA 0x%" PRIx64,
@@ -112,7 +115,7 @@ __vhost_iova_to_vva(struct virtio_net *dev, struct vhost_virtqueue *vq,
 
 	tmp_size = *size;
 	/* Retry in case of VDUSE, as it is synchronous */
-	vva = vhost_user_iotlb_cache_find(dev, iova, &tmp_size, perm);
+	vva = vhost_user_iotlb_cache_find(dev, vq, iova, &tmp_size, perm);
 	if (tmp_size == *size)
 		return vva;
 
@@ -773,9 +776,23 @@ vhost_destroy_device(int vid)
 	vhost_destroy_device_notify(dev);
 
 	cleanup_device(dev, 1);
-	free_device(dev);
 
+	/* telemetry looks devices up under the lock */
+	pthread_mutex_lock(&vhost_dev_lock);
 	vhost_devices[vid] = NULL;
+	pthread_mutex_unlock(&vhost_dev_lock);
+
+	free_device(dev);
+}
+
+void
+vhost_set_mem_timing(struct virtio_net *dev,
+		const struct vhost_mem_table_timing *timing)
+{
+	/* telemetry reads it under the lock */
+	pthread_mutex_lock(&vhost_dev_lock);
+	dev->mem_timing = *timing;
+	pthread_mutex_unlock(&vhost_dev_lock);
 }
 
 void
@@ -859,6 +876,17 @@ vhost_enable_linearbuf(int vid)
 	dev->linearbuf = 1;
 }
 
+void
+vhost_enable_mem_prefault(int vid)
+{
+	struct virtio_net *dev = get_device(vid);
+
+	if (dev == NULL)
+		return;
+
+	dev->mem_prefault = 1;
+}
+
 int
 rte_vhost_get_mtu(int vid, uint16_t *mtu)
 {
@@ -981,6 +1009,20 @@ rte_vhost_get_mem_table(int vid, struct rte_vhost_memory **mem)
 	return 0;
 }
 
+int
+rte_vhost_get_mem_xlat(int vid, const struct rte_vhost_mem_xlat **xlat)
+{
+	struct virtio_net *dev;
+
+	dev = get_device(vid);
+	if (dev == NULL || xlat == NULL || dev->mem_xlat == NULL)
+		return -1;
+
+	*xlat = dev->mem_xlat;
+
+	return 0;
+}
+
 int
 rte_vhost_get_vhost_vring(int vid, uint16_t vring_idx,
 			  struct rte_vhost_vring *vring)
@@ -2329,5 +2371,75 @@ rte_vhost_async_dma_unconfigure(int16_t dma_id, uint16_t vchan_id)
 	return -1;
 }
 
+static int
+vhost_handle_dev_list(const char *cmd __rte_unused,
+		const char *params __rte_unused,
+		struct rte_tel_data *d)
+{
+	int vid;
+
+	rte_tel_data_start_array(d, RTE_TEL_INT_VAL);
+	pthread_mutex_lock(&vhost_dev_lock);
+	for (vid = 0; vid < RTE_MAX_VHOST_DEVICE; vid++) {
+		if (vhost_devices[vid] != NULL)
+			rte_tel_data_add_array_int(d, vid);
+	}
+	pthread_mutex_unlock(&vhost_dev_lock);
+
+	return 0;
+}
+
+static int
+vhost_handle_dev_mem_table(const char *cmd __rte_unused,
+		const char *params,
+		struct rte_tel_data *d)
+{
+	struct vhost_mem_table_timing timing;
+	struct virtio_net *dev;
+	uint32_t nr_guest_pages;
+	char *end_param;
+	int vid;
+
+	if (params == NULL || strlen(params) == 0 || !isdigit(*params))
+		return -EINVAL;
+
+	vid = strtoul(params, &end_param, 0);
+	if (*end_param != '\0')
+		VHOST_CONFIG_LOG("telemetry", WARNING,
+			"Extra parameters passed to vhost telemetry command, ignoring");
+	if (vid < 0 || vid >= RTE_MAX_VHOST_DEVICE)
+		return -EINVAL;
+
+	pthread_mutex_lock(&vhost_dev_lock);
+	dev = vhost_devices[vid];
+	if (dev == NULL) {
+		pthread_mutex_unlock(&vhost_dev_lock);
+		return -EINVAL;
+	}
+	timing = dev->mem_timing;
+	nr_guest_pages = dev->nr_guest_pages;
+	pthread_mutex_unlock(&vhost_dev_lock);
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_uint(d, "guest_pages", nr_guest_pages);
+	rte_tel_data_add_dict_uint(d, "map_us", timing.map_us);
+	rte_tel_data_add_dict_uint(d, "prefault_us", timing.prefault_us);
+	rte_tel_data_add_dict_uint(d, "prefault_threads",
+			timing.prefault_threads);
+	rte_tel_data_add_dict_uint(d, "guest_pages_us", timing.guest_pages_us);
+	rte_tel_data_add_dict_uint(d, "xlat_us", timing.xlat_us);
+	rte_tel_data_add_dict_uint(d, "total_us", timing.total_us);
+
+	return 0;
+}
+
+RTE_INIT(vhost_init_telemetry)
+{
+	rte_telemetry_register_cmd("/vhost/list", vhost_handle_dev_list,
+			"Returns list of vhost device IDs. No parameters.");
+	rte_telemetry_register_cmd("/vhost/mem_table", vhost_handle_dev_mem_table,
+			"Returns time taken to set the last guest memory table of a vhost device. Parameters: int vid");
+}
+
 RTE_LOG_REGISTER_SUFFIX(vhost_config_log_level, config, INFO);
 RTE_LOG_REGISTER_SUFFIX(vhost_data_log_level, data, WARNING);
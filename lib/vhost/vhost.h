@@ -154,6 +154,7 @@ struct virtqueue_stats {
 	uint64_t size_bins[8];
 	uint64_t iotlb_hits;
 	uint64_t iotlb_misses;
+	uint64_t iotlb_evictions;
 	uint64_t inflight_submitted;
 	uint64_t inflight_completed;
 	uint64_t mbuf_alloc_failed;
@@ -325,6 +326,9 @@ struct __rte_cache_aligned vhost_virtqueue {
 	struct log_cache_entry	*log_cache;
 
 	rte_rwlock_t	iotlb_lock;
+	/* Last IOTLB entry hit, valid as long as dev->iotlb_gen is unchanged */
+	struct vhost_iotlb_entry *iotlb_last;
+	uint64_t		iotlb_last_gen;
 
 	/* Used to notify the guest (trigger interrupt) */
 	int			callfd;
@@ -469,6 +473,16 @@ struct guest_page {
 	uint64_t size;
 };
 
+/* Time spent handling the last memory table, in microseconds */
+struct vhost_mem_table_timing {
+	uint64_t map_us;	/* mmap() of regions */
+	uint64_t prefault_us;	/* faulting pages in */
+	uint64_t guest_pages_us;	/* building guest pages */
+	uint64_t xlat_us;	/* building translation table */
+	uint64_t total_us;
+	unsigned int prefault_threads;
+};
+
 struct inflight_mem_info {
 	int		fd;
 	void		*addr;
@@ -494,11 +508,17 @@ struct __rte_cache_aligned virtio_net {
 
 	int			extbuf;
 	int			linearbuf;
+	int			mem_prefault;
 	struct vhost_virtqueue	*virtqueue[VHOST_MAX_QUEUE_PAIRS * 2];
 
 	rte_rwlock_t	iotlb_pending_lock;
 	struct vhost_iotlb_entry *iotlb_pool;
-	TAILQ_HEAD(, vhost_iotlb_entry) iotlb_list;
+	/* Cached entries sorted by IOVA */
+	struct vhost_iotlb_slot *iotlb_index;
+	/* Bumped whenever cached entries are removed */
+	uint64_t			iotlb_gen;
+	/* Next pool entry considered for eviction */
+	uint32_t			iotlb_clock;
 	TAILQ_HEAD(, vhost_iotlb_entry) iotlb_pending_list;
 	int				iotlb_cache_nr;
 	rte_spinlock_t	iotlb_free_lock;
@@ -519,6 +539,9 @@ struct __rte_cache_aligned virtio_net {
 	uint32_t		nr_guest_pages;
 	uint32_t		max_guest_pages;
 	struct guest_page       *guest_pages;
+	/* constant time lookup of guest_pages, NULL if too fragmented */
+	struct rte_vhost_mem_xlat *mem_xlat;
+	struct vhost_mem_table_timing mem_timing;
 
 	int			backend_req_fd;
 	rte_spinlock_t		backend_req_lock;
@@ -749,6 +772,10 @@ gpa_to_first_hpa(struct virtio_net *dev, uint64_t gpa,
 	struct guest_page key;
 
 	*hpa_size = gpa_size;
+	if (likely(dev->mem_xlat != NULL))
+		return rte_vhost_mem_xlat_gpa_to_iova(dev->mem_xlat, gpa,
+				hpa_size);
+
 	if (dev->nr_guest_pages >= VHOST_BINARY_SEARCH_THRESH) {
 		key.guest_phys_addr = gpa;
 		page = bsearch(&key, dev->guest_pages, dev->nr_guest_pages,
@@ -855,6 +882,9 @@ void vhost_setup_virtio_net(int vid, bool enable, bool legacy_ol_flags, bool sta
 	bool support_iommu);
 void vhost_enable_extbuf(int vid);
 void vhost_enable_linearbuf(int vid);
+void vhost_enable_mem_prefault(int vid);
+void vhost_set_mem_timing(struct virtio_net *dev,
+		const struct vhost_mem_table_timing *timing);
 int vhost_enable_guest_notification(struct virtio_net *dev,
 		struct vhost_virtqueue *vq, int enable);
 
@@ -888,8 +918,12 @@ vhost_iova_to_vva(struct virtio_net *dev, struct vhost_virtqueue *vq,
 			uint64_t iova, uint64_t *len, uint8_t perm)
 	__rte_shared_locks_required(&vq->iotlb_lock)
 {
-	if (!(dev->features & (1ULL << VIRTIO_F_IOMMU_PLATFORM)))
+	if (!(dev->features & (1ULL << VIRTIO_F_IOMMU_PLATFORM))) {
+		if (likely(dev->mem_xlat != NULL))
+			return rte_vhost_mem_xlat_gpa_to_vva(dev->mem_xlat,
+					iova, len);
 		return rte_vhost_va_from_guest_pa(dev->mem, iova, len);
+	}
 
 	return __vhost_iova_to_vva(dev, vq, iova, len, perm);
 }
@@ -41,7 +41,9 @@
 #define MEMFD_SUPPORTED
 #endif
 
+#include <rte_bitops.h>
 #include <rte_common.h>
+#include <rte_cycles.h>
 #include <rte_malloc.h>
 #include <rte_log.h>
 #include <rte_vfio.h>
@@ -247,6 +249,13 @@ free_mem_region(struct virtio_net *dev)
 	}
 }
 
+static void
+free_mem_xlat(struct virtio_net *dev)
+{
+	rte_free(dev->mem_xlat);
+	dev->mem_xlat = NULL;
+}
+
 void
 vhost_backend_cleanup(struct virtio_net *dev)
 {
@@ -262,6 +271,7 @@ vhost_backend_cleanup(struct virtio_net *dev)
 		dev->mem = NULL;
 	}
 
+	free_mem_xlat(dev);
 	rte_free(dev->guest_pages);
 	dev->guest_pages = NULL;
 
@@ -1126,11 +1136,30 @@ add_guest_pages(struct virtio_net *dev, struct rte_vhost_mem_region *reg,
 		reg_size -= size;
 	}
 
-	/* sort guest page array if over binary search threshold */
-	if (dev->nr_guest_pages >= VHOST_BINARY_SEARCH_THRESH) {
-		qsort((void *)dev->guest_pages, dev->nr_guest_pages,
-			sizeof(struct guest_page), guest_page_addrcmp);
-	}
+	return 0;
+}
+
+/* make room for nb_pages guest pages, so that adding them never reallocates */
+static int
+reserve_guest_pages(struct virtio_net *dev, uint64_t nb_pages, int numa_node)
+{
+	struct guest_page *pages;
+
+	if (nb_pages <= dev->max_guest_pages)
+		return 0;
+	if (nb_pages > UINT32_MAX)
+		return -1;
+
+	pages = rte_malloc_socket(NULL, nb_pages * sizeof(*pages),
+			RTE_CACHE_LINE_SIZE, numa_node);
+	if (pages == NULL)
+		return -1;
+
+	memcpy(pages, dev->guest_pages,
+		dev->nr_guest_pages * sizeof(*pages));
+	rte_free(dev->guest_pages);
+	dev->guest_pages = pages;
+	dev->max_guest_pages = nb_pages;
 
 	return 0;
 }
@@ -1159,6 +1188,162 @@ dump_guest_pages(struct virtio_net *dev)
 #define dump_guest_pages(dev)
 #endif
 
+/* second level entries of a translation table, i.e. 16 MB at most */
+#define VHOST_MEM_XLAT_MAX_ENTRIES (1U << 22)
+#define VHOST_MEM_XLAT_MIN_SHIFT 12
+
+/*
+ * Build constant time lookup table of guest pages. Blocks are as large as
+ * alignment of all page boundaries allows, so that no block spans two pages.
+ * No table is built if it would be too large, e.g. for guest memory backed
+ * by small, physically scattered pages, and lookups keep searching guest
+ * pages instead.
+ *
+ * Guest pages are only built for async copy, which needs their IOVAs. Other
+ * devices get a table of their memory regions, which have no IOVA.
+ */
+static void
+build_mem_xlat(struct virtio_net *dev, int numa_node)
+{
+	struct rte_vhost_mem_xlat *xlat;
+	struct rte_vhost_mem_xlat_page *pages;
+	struct rte_vhost_mem_region *reg;
+	const struct guest_page *gp;
+	uint32_t shift = RTE_VHOST_MEM_XLAT_L1_SHIFT;
+	uint64_t start, end, gpa, reg_end, max_end = 0;
+	uint64_t nb_l1, nb_l2, l2_mask, l2_idx;
+	uint32_t *l1, *l2, *chunks;
+	struct guest_page *reg_pages = NULL;
+	const struct guest_page *gps;
+	uint32_t nr, nb_chunks = 0;
+	uint32_t i, j;
+	size_t size;
+
+	free_mem_xlat(dev);
+
+	gps = dev->guest_pages;
+	nr = dev->nr_guest_pages;
+	if (nr == 0) {
+		nr = dev->mem->nregions;
+		if (nr == 0)
+			return;
+		reg_pages = malloc(nr * sizeof(*reg_pages));
+		if (reg_pages == NULL)
+			goto no_table;
+		for (i = 0; i < nr; i++) {
+			reg = &dev->mem->regions[i];
+			reg_pages[i].guest_phys_addr = reg->guest_phys_addr;
+			reg_pages[i].host_iova = RTE_BAD_IOVA;
+			reg_pages[i].host_user_addr = reg->host_user_addr;
+			reg_pages[i].size = reg->size;
+		}
+		gps = reg_pages;
+	}
+
+	for (i = 0; i < nr; i++) {
+		gp = &gps[i];
+		start = gp->guest_phys_addr;
+		end = start + gp->size;
+		if (start != 0)
+			shift = RTE_MIN(shift, rte_ctz64(start));
+		shift = RTE_MIN(shift, rte_ctz64(end));
+		max_end = RTE_MAX(max_end, end);
+	}
+
+	nb_l1 = RTE_ALIGN_CEIL(max_end, 1ULL << RTE_VHOST_MEM_XLAT_L1_SHIFT) >>
+		RTE_VHOST_MEM_XLAT_L1_SHIFT;
+	if (shift < VHOST_MEM_XLAT_MIN_SHIFT ||
+			nb_l1 > VHOST_MEM_XLAT_MAX_ENTRIES)
+		goto no_table;
+
+	/* only chunks holding guest memory get a second level table */
+	chunks = malloc(nb_l1 * sizeof(*chunks));
+	if (chunks == NULL)
+		goto no_table;
+	memset(chunks, 0xff, nb_l1 * sizeof(*chunks));
+	for (i = 0; i < nr; i++) {
+		gp = &gps[i];
+		start = gp->guest_phys_addr >> RTE_VHOST_MEM_XLAT_L1_SHIFT;
+		end = (gp->guest_phys_addr + gp->size - 1) >>
+			RTE_VHOST_MEM_XLAT_L1_SHIFT;
+		for (gpa = start; gpa <= end; gpa++) {
+			if (chunks[gpa] == RTE_VHOST_MEM_XLAT_INVALID)
+				chunks[gpa] = nb_chunks++;
+		}
+	}
+
+	nb_l2 = (uint64_t)nb_chunks << (RTE_VHOST_MEM_XLAT_L1_SHIFT - shift);
+	if (nb_l2 > VHOST_MEM_XLAT_MAX_ENTRIES) {
+		free(chunks);
+		goto no_table;
+	}
+
+	size = sizeof(*xlat) + nr * sizeof(*pages) +
+		(nb_l1 + nb_l2) * sizeof(*l1);
+	xlat = rte_zmalloc_socket("vhost-mem-xlat", size, RTE_CACHE_LINE_SIZE,
+			numa_node);
+	if (xlat == NULL) {
+		free(chunks);
+		goto no_table;
+	}
+	pages = RTE_PTR_ADD(xlat, sizeof(*xlat));
+	l1 = RTE_PTR_ADD(pages, nr * sizeof(*pages));
+	l2 = l1 + nb_l1;
+
+	memcpy(l1, chunks, nb_l1 * sizeof(*l1));
+	free(chunks);
+	memset(l2, 0xff, nb_l2 * sizeof(*l2));
+
+	l2_mask = (1ULL << (RTE_VHOST_MEM_XLAT_L1_SHIFT - shift)) - 1;
+	for (i = 0; i < nr; i++) {
+		gp = &gps[i];
+		pages[i].guest_phys_addr = gp->guest_phys_addr;
+		pages[i].host_iova = gp->host_iova;
+		pages[i].host_user_addr = gp->host_user_addr;
+		pages[i].size = gp->size;
+
+		/* virtual addresses are contiguous up to the end of the region */
+		pages[i].va_size = gp->size;
+		for (j = 0; j < dev->mem->nregions; j++) {
+			reg = &dev->mem->regions[j];
+			reg_end = reg->guest_phys_addr + reg->size;
+			if (gp->guest_phys_addr >= reg->guest_phys_addr &&
+					gp->guest_phys_addr < reg_end) {
+				pages[i].va_size = RTE_MAX(gp->size,
+					reg_end - gp->guest_phys_addr);
+				break;
+			}
+		}
+
+		end = gp->guest_phys_addr + gp->size;
+		for (gpa = gp->guest_phys_addr; gpa < end; gpa += 1ULL << shift) {
+			l2_idx = ((uint64_t)l1[gpa >> RTE_VHOST_MEM_XLAT_L1_SHIFT] <<
+				(RTE_VHOST_MEM_XLAT_L1_SHIFT - shift)) |
+				((gpa >> shift) & l2_mask);
+			l2[l2_idx] = i;
+		}
+	}
+
+	xlat->page_shift = shift;
+	xlat->nb_l1 = nb_l1;
+	xlat->l1 = l1;
+	xlat->l2 = l2;
+	xlat->pages = pages;
+	xlat->nb_pages = nr;
+	dev->mem_xlat = xlat;
+	free(reg_pages);
+
+	VHOST_CONFIG_LOG(dev->ifname, DEBUG,
+		"guest memory translation table: %u pages, %" PRIu64 " blocks of %" PRIu64 " bytes",
+		nr, nb_l2, RTE_BIT64(shift));
+	return;
+
+no_table:
+	free(reg_pages);
+	VHOST_CONFIG_LOG(dev->ifname, INFO,
+		"guest memory too fragmented for translation table, using search");
+}
+
 static bool
 vhost_memory_changed(struct VhostUserMemory *new,
 		     struct rte_vhost_memory *old)
@@ -1287,12 +1472,11 @@ vhost_user_postcopy_register(struct virtio_net *dev, int main_fd,
 static int
 vhost_user_mmap_region(struct virtio_net *dev,
 		struct rte_vhost_mem_region *region,
-		uint64_t mmap_offset)
+		uint64_t mmap_offset, uint64_t *page_size)
 {
 	void *mmap_addr;
 	uint64_t mmap_size;
 	uint64_t alignment;
-	int populate;
 
 	/* Check for memory_size + mmap_offset overflow */
 	if (mmap_offset >= -region->size) {
@@ -1331,9 +1515,9 @@ vhost_user_mmap_region(struct virtio_net *dev,
 		return -1;
 	}
 
-	populate = dev->async_copy ? MAP_POPULATE : 0;
+	/* pages are faulted in later, if needed, see prefault_mem_table() */
 	mmap_addr = mmap(NULL, mmap_size, PROT_READ | PROT_WRITE,
-			MAP_SHARED | populate, region->fd, 0);
+			MAP_SHARED, region->fd, 0);
 
 	if (mmap_addr == MAP_FAILED) {
 		VHOST_CONFIG_LOG(dev->ifname, ERR, "mmap failed (%s).", strerror(errno));
@@ -1344,14 +1528,7 @@ vhost_user_mmap_region(struct virtio_net *dev,
 	region->mmap_size = mmap_size;
 	region->host_user_addr = (uint64_t)(uintptr_t)mmap_addr + mmap_offset;
 	mem_set_dump(dev, mmap_addr, mmap_size, false, alignment);
-
-	if (dev->async_copy) {
-		if (add_guest_pages(dev, region, alignment) < 0) {
-			VHOST_CONFIG_LOG(dev->ifname, ERR,
-				"adding guest pages to region failed.");
-			return -1;
-		}
-	}
+	*page_size = alignment;
 
 	VHOST_CONFIG_LOG(dev->ifname, INFO,
 		"guest memory region size: 0x%" PRIx64,
@@ -1381,6 +1558,132 @@ vhost_user_mmap_region(struct virtio_net *dev,
 	return 0;
 }
 
+/*
+ * Guest memory is faulted in by chunks, which threads pick in turn,
+ * so that a single large region is spread over threads too.
+ */
+#define VHOST_PREFAULT_CHUNK_SIZE (1ULL << 30)
+#define VHOST_PREFAULT_MAX_THREADS 16
+
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23 /* since Linux 5.14 */
+#endif
+
+struct prefault_ctx {
+	const struct rte_vhost_memory *mem;
+	const uint64_t *page_size;
+	uint64_t chunk_size[VHOST_MEMORY_MAX_NREGIONS];
+	/* index of the first chunk of each region, then number of chunks */
+	uint64_t first_chunk[VHOST_MEMORY_MAX_NREGIONS + 1];
+	RTE_ATOMIC(uint64_t) next_chunk;
+	RTE_ATOMIC(uint32_t) nb_errors;
+};
+
+static uint64_t
+elapsed_us(uint64_t start)
+{
+	return (rte_get_timer_cycles() - start) * US_PER_S / rte_get_timer_hz();
+}
+
+static int
+prefault_range(void *addr, uint64_t len, uint64_t page_size)
+{
+	uint64_t off;
+
+	if (madvise(addr, len, MADV_POPULATE_WRITE) == 0)
+		return 0;
+	if (errno != EINVAL)
+		return -1;
+
+	/* not supported by the kernel, reading is enough to fault pages in */
+	for (off = 0; off < len; off += page_size)
+		(void)*(volatile const uint8_t *)RTE_PTR_ADD(addr, off);
+
+	return 0;
+}
+
+static uint32_t
+prefault_chunks(void *arg)
+{
+	struct prefault_ctx *ctx = arg;
+	const struct rte_vhost_mem_region *reg;
+	uint64_t chunk, off, len;
+	uint32_t i;
+
+	while (1) {
+		chunk = rte_atomic_fetch_add_explicit(&ctx->next_chunk, 1,
+				rte_memory_order_relaxed);
+		if (chunk >= ctx->first_chunk[ctx->mem->nregions])
+			break;
+
+		for (i = 0; chunk >= ctx->first_chunk[i + 1]; i++)
+			;
+		reg = &ctx->mem->regions[i];
+		off = (chunk - ctx->first_chunk[i]) * ctx->chunk_size[i];
+		len = RTE_MIN(ctx->chunk_size[i], reg->mmap_size - off);
+
+		if (prefault_range(RTE_PTR_ADD(reg->mmap_addr, off), len,
+				ctx->page_size[i]) < 0)
+			rte_atomic_fetch_add_explicit(&ctx->nb_errors, 1,
+					rte_memory_order_relaxed);
+	}
+
+	return 0;
+}
+
+/*
+ * Fault all guest memory in, so that first accesses from the datapath do not
+ * stall, and IOVAs of pages can be looked up. Returns number of threads used.
+ */
+static unsigned int
+prefault_mem_table(struct virtio_net *dev, const uint64_t *page_size)
+{
+	rte_thread_t tids[VHOST_PREFAULT_MAX_THREADS - 1];
+	char name[RTE_THREAD_INTERNAL_NAME_SIZE];
+	struct prefault_ctx ctx;
+	const struct rte_vhost_mem_region *reg;
+	unsigned int nb_threads, nb_started = 0;
+	long nb_cpus;
+	uint32_t i;
+
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.mem = dev->mem;
+	ctx.page_size = page_size;
+	for (i = 0; i < dev->mem->nregions; i++) {
+		reg = &dev->mem->regions[i];
+		ctx.chunk_size[i] = RTE_MAX(VHOST_PREFAULT_CHUNK_SIZE,
+				page_size[i]);
+		ctx.first_chunk[i + 1] = ctx.first_chunk[i] +
+			RTE_ALIGN_CEIL(reg->mmap_size, ctx.chunk_size[i]) /
+			ctx.chunk_size[i];
+	}
+
+	nb_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	nb_threads = RTE_MIN(ctx.first_chunk[dev->mem->nregions],
+			(uint64_t)VHOST_PREFAULT_MAX_THREADS);
+	if (nb_cpus > 0)
+		nb_threads = RTE_MIN(nb_threads, (unsigned int)nb_cpus);
+
+	/* calling thread does its share too */
+	for (i = 0; i + 1 < nb_threads; i++) {
+		snprintf(name, sizeof(name), "vhost-pf%u", i);
+		if (rte_thread_create_internal_control(&tids[i], name,
+				prefault_chunks, &ctx) != 0)
+			break;
+		nb_started++;
+	}
+	prefault_chunks(&ctx);
+	for (i = 0; i < nb_started; i++)
+		rte_thread_join(tids[i], NULL);
+
+	i = rte_atomic_load_explicit(&ctx.nb_errors, rte_memory_order_relaxed);
+	if (i != 0)
+		VHOST_CONFIG_LOG(dev->ifname, WARNING,
+			"failed to fault in %u chunks of guest memory", i);
+
+	return nb_started + 1;
+}
+
 static int
 vhost_user_set_mem_table(struct virtio_net **pdev,
 			struct vhu_msg_context *ctx,
@@ -1388,9 +1691,12 @@ vhost_user_set_mem_table(struct virtio_net **pdev,
 {
 	struct virtio_net *dev = *pdev;
 	struct VhostUserMemory *memory = &ctx->msg.payload.memory;
+	struct vhost_mem_table_timing timing;
 	struct rte_vhost_mem_region *reg;
+	uint64_t page_size[VHOST_MEMORY_MAX_NREGIONS];
 	int numa_node = SOCKET_ID_ANY;
-	uint64_t mmap_offset;
+	uint64_t mmap_offset, nb_pages;
+	uint64_t start, step;
 	uint32_t i;
 	bool async_notify = false;
 
@@ -1437,6 +1743,7 @@ vhost_user_set_mem_table(struct virtio_net **pdev,
 		free_mem_region(dev);
 		rte_free(dev->mem);
 		dev->mem = NULL;
+		free_mem_xlat(dev);
 	}
 
 	/*
@@ -1446,6 +1753,9 @@ vhost_user_set_mem_table(struct virtio_net **pdev,
 	if (dev->nr_vring > 0)
 		numa_node = dev->virtqueue[0]->numa_node;
 
+	memset(&timing, 0, sizeof(timing));
+	start = rte_get_timer_cycles();
+
 	dev->nr_guest_pages = 0;
 	if (dev->guest_pages == NULL) {
 		dev->max_guest_pages = 8;
@@ -1468,6 +1778,7 @@ vhost_user_set_mem_table(struct virtio_net **pdev,
 		goto free_guest_pages;
 	}
 
+	step = rte_get_timer_cycles();
 	for (i = 0; i < memory->nregions; i++) {
 		reg = &dev->mem->regions[i];
 
@@ -1484,13 +1795,79 @@ vhost_user_set_mem_table(struct virtio_net **pdev,
 
 		mmap_offset = memory->regions[i].mmap_offset;
 
-		if (vhost_user_mmap_region(dev, reg, mmap_offset) < 0) {
+		if (vhost_user_mmap_region(dev, reg, mmap_offset,
+				&page_size[i]) < 0) {
 			VHOST_CONFIG_LOG(dev->ifname, ERR, "failed to mmap region %u", i);
 			goto free_mem_table;
 		}
 
 		dev->mem->nregions++;
 	}
+	timing.map_us = elapsed_us(step);
+
+	/*
+	 * IOVAs of pages can only be looked up once they are in. With postcopy
+	 * live migration, pages are not there yet and must be faulted in
+	 * through userfaultfd, which is only registered below.
+	 */
+	if (dev->postcopy_listening) {
+		VHOST_CONFIG_LOG(dev->ifname, DEBUG,
+			"postcopy listening, guest memory not faulted in");
+	} else if (dev->mem_prefault || dev->async_copy) {
+		step = rte_get_timer_cycles();
+		timing.prefault_threads = prefault_mem_table(dev, page_size);
+		timing.prefault_us = elapsed_us(step);
+	}
+
+	/*
+	 * Guest pages are only needed for async copy, as their IOVAs are
+	 * looked up. Contiguous pages are merged, which is always the case
+	 * with IOVA as VA, so that each region takes at most two guest pages.
+	 */
+	if (dev->async_copy) {
+		step = rte_get_timer_cycles();
+		nb_pages = 0;
+		for (i = 0; i < dev->mem->nregions; i++) {
+			if (rte_eal_iova_mode() == RTE_IOVA_VA)
+				nb_pages += 2;
+			else
+				nb_pages += dev->mem->regions[i].size / page_size[i] + 2;
+		}
+		if (reserve_guest_pages(dev, nb_pages, numa_node) < 0) {
+			VHOST_CONFIG_LOG(dev->ifname, ERR,
+				"failed to allocate memory for %" PRIu64 " guest pages",
+				nb_pages);
+			goto free_mem_table;
+		}
+
+		for (i = 0; i < dev->mem->nregions; i++) {
+			if (add_guest_pages(dev, &dev->mem->regions[i],
+					page_size[i]) < 0) {
+				VHOST_CONFIG_LOG(dev->ifname, ERR,
+					"adding guest pages to region %u failed", i);
+				goto free_mem_table;
+			}
+		}
+
+		/* sort guest page array if over binary search threshold */
+		if (dev->nr_guest_pages >= VHOST_BINARY_SEARCH_THRESH) {
+			qsort((void *)dev->guest_pages, dev->nr_guest_pages,
+				sizeof(struct guest_page), guest_page_addrcmp);
+		}
+		timing.guest_pages_us = elapsed_us(step);
+	}
+
+	step = rte_get_timer_cycles();
+	build_mem_xlat(dev, numa_node);
+	timing.xlat_us = elapsed_us(step);
+	timing.total_us = elapsed_us(start);
+
+	VHOST_CONFIG_LOG(dev->ifname, INFO,
+		"memory table set in %" PRIu64 " us: map %" PRIu64 " us, prefault %" PRIu64 " us (%u threads), guest pages %" PRIu64 " us, translation %" PRIu64 " us",
+		timing.total_us, timing.map_us, timing.prefault_us,
+		timing.prefault_threads, timing.guest_pages_us,
+		timing.xlat_us);
+	vhost_set_mem_timing(dev, &timing);
 
 	if (dev->async_copy && rte_vfio_is_enabled("vfio"))
 		async_dma_map(dev, true);
@@ -1533,6 +1910,7 @@ vhost_user_set_mem_table(struct virtio_net **pdev,
 	free_mem_region(dev);
 	rte_free(dev->mem);
 	dev->mem = NULL;
+	free_mem_xlat(dev);
 
 free_guest_pages:
 	rte_free(dev->guest_pages);